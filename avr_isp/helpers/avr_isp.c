@@ -1,31 +1,147 @@
 #include "avr_isp.h"
 #include "../lib/driver/avr_isp_prog_cmd.h"
 #include "../lib/driver/avr_isp_spi_sw.h"
+#include "../lib/driver/avr_isp_spi_hw.h"
 
 #include <furi.h>
 
 #define AVR_ISP_PROG_TX_RX_BUF_SIZE 320
+#define AVR_ISP_SPI_BURST_BUF_SIZE 512
 #define TAG "AvrIsp"
 
+typedef struct {
+    AvrIspSpiBackend backend;
+    uint32_t speed;
+} AvrIspSpiSpeed;
+
+// From fastest to slowest, hardware SPI can't go below 250KHz
+static const AvrIspSpiSpeed avr_isp_spi_speed_hw[] = {
+    {AvrIspSpiBackendHw, AvrIspSpiHwSpeed2Mhz},
+    {AvrIspSpiBackendHw, AvrIspSpiHwSpeed1Mhz},
+    {AvrIspSpiBackendHw, AvrIspSpiHwSpeed500Khz},
+    {AvrIspSpiBackendHw, AvrIspSpiHwSpeed250Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed125Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed60Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed40Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed20Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed10Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed5Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed1Khz},
+};
+
+static const AvrIspSpiSpeed avr_isp_spi_speed_sw[] = {
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed1Mhz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed400Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed250Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed125Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed60Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed40Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed20Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed10Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed5Khz},
+    {AvrIspSpiBackendSw, AvrIspSpiSwSpeed1Khz},
+};
+
 struct AvrIsp {
     AvrIspSpiSw* spi;
+    AvrIspSpiHw* spi_hw;
+    AvrIspSpiBackend spi_backend;
+    uint8_t* burst_tx;
+    uint8_t* burst_rx;
     bool pmode;
+    bool poll_rdy_bsy;
     AvrIspCallback callback;
     void* context;
 };
 
 AvrIsp* avr_isp_alloc(void) {
     AvrIsp* instance = malloc(sizeof(AvrIsp));
+    instance->spi_backend = AvrIspSpiBackendHw;
+    instance->poll_rdy_bsy = false;
+    instance->burst_tx = malloc(AVR_ISP_SPI_BURST_BUF_SIZE);
+    instance->burst_rx = malloc(AVR_ISP_SPI_BURST_BUF_SIZE);
     return instance;
 }
 
+static bool avr_isp_spi_is_init(AvrIsp* instance) {
+    return instance->spi || instance->spi_hw;
+}
+
+static void avr_isp_spi_free(AvrIsp* instance) {
+    if(instance->spi) avr_isp_spi_sw_free(instance->spi);
+    if(instance->spi_hw) avr_isp_spi_hw_free(instance->spi_hw);
+    instance->spi = NULL;
+    instance->spi_hw = NULL;
+}
+
+static void avr_isp_spi_init(AvrIsp* instance, const AvrIspSpiSpeed* spi_speed) {
+    avr_isp_spi_free(instance);
+    if(spi_speed->backend == AvrIspSpiBackendHw) {
+        instance->spi_hw = avr_isp_spi_hw_init(spi_speed->speed);
+    } else {
+        instance->spi = avr_isp_spi_sw_init(spi_speed->speed);
+    }
+}
+
+static uint8_t avr_isp_spi_txrx(AvrIsp* instance, uint8_t data) {
+    if(instance->spi_hw) return avr_isp_spi_hw_txrx(instance->spi_hw, data);
+    return avr_isp_spi_sw_txrx(instance->spi, data);
+}
+
+static void avr_isp_spi_res_set(AvrIsp* instance, bool state) {
+    if(instance->spi_hw) {
+        avr_isp_spi_hw_res_set(instance->spi_hw, state);
+    } else {
+        avr_isp_spi_sw_res_set(instance->spi, state);
+    }
+}
+
+/** Sends size bytes of burst_tx, answer goes to burst_rx */
+static void avr_isp_spi_burst(AvrIsp* instance, size_t size) {
+    furi_assert(size <= AVR_ISP_SPI_BURST_BUF_SIZE);
+    if(!size) return;
+    if(instance->spi_hw) {
+        avr_isp_spi_hw_txrx_burst(instance->spi_hw, instance->burst_tx, instance->burst_rx, size);
+    } else {
+        for(size_t i = 0; i < size; i++) {
+            instance->burst_rx[i] = avr_isp_spi_sw_txrx(instance->spi, instance->burst_tx[i]);
+        }
+    }
+}
+
+static size_t avr_isp_burst_add(
+    AvrIsp* instance,
+    size_t pos,
+    uint8_t cmd,
+    uint8_t addr_hi,
+    uint8_t addr_lo,
+    uint8_t data) {
+    instance->burst_tx[pos++] = cmd;
+    instance->burst_tx[pos++] = addr_hi;
+    instance->burst_tx[pos++] = addr_lo;
+    instance->burst_tx[pos++] = data;
+    return pos;
+}
+
 void avr_isp_free(AvrIsp* instance) {
     furi_assert(instance);
 
-    if(instance->spi) avr_isp_end_pmode(instance);
+    if(avr_isp_spi_is_init(instance)) avr_isp_end_pmode(instance);
+    free(instance->burst_tx);
+    free(instance->burst_rx);
     free(instance);
 }
 
+void avr_isp_set_spi_backend(AvrIsp* instance, AvrIspSpiBackend backend) {
+    furi_assert(instance);
+    instance->spi_backend = backend;
+}
+
+void avr_isp_set_poll_rdy_bsy(AvrIsp* instance, bool poll_rdy_bsy) {
+    furi_assert(instance);
+    instance->poll_rdy_bsy = poll_rdy_bsy;
+}
+
 void avr_isp_set_tx_callback(AvrIsp* instance, AvrIspCallback callback, void* context) {
     furi_assert(instance);
     furi_assert(context);
@@ -42,20 +158,20 @@ uint8_t avr_isp_spi_transaction(
     uint8_t data) {
     furi_assert(instance);
 
-    avr_isp_spi_sw_txrx(instance->spi, cmd);
-    avr_isp_spi_sw_txrx(instance->spi, addr_hi);
-    avr_isp_spi_sw_txrx(instance->spi, addr_lo);
-    return avr_isp_spi_sw_txrx(instance->spi, data);
+    avr_isp_spi_txrx(instance, cmd);
+    avr_isp_spi_txrx(instance, addr_hi);
+    avr_isp_spi_txrx(instance, addr_lo);
+    return avr_isp_spi_txrx(instance, data);
 }
 
 static bool avr_isp_set_pmode(AvrIsp* instance, uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
     furi_assert(instance);
 
     uint8_t res = 0;
-    avr_isp_spi_sw_txrx(instance->spi, a);
-    avr_isp_spi_sw_txrx(instance->spi, b);
-    res = avr_isp_spi_sw_txrx(instance->spi, c);
-    avr_isp_spi_sw_txrx(instance->spi, d);
+    avr_isp_spi_txrx(instance, a);
+    avr_isp_spi_txrx(instance, b);
+    res = avr_isp_spi_txrx(instance, c);
+    avr_isp_spi_txrx(instance, d);
     return res == 0x53;
 }
 
@@ -63,17 +179,16 @@ void avr_isp_end_pmode(AvrIsp* instance) {
     furi_assert(instance);
 
     if(instance->pmode) {
-        avr_isp_spi_sw_res_set(instance->spi, true);
+        avr_isp_spi_res_set(instance, true);
         // We're about to take the target out of reset
         // so configure SPI pins as input
-        if(instance->spi) avr_isp_spi_sw_free(instance->spi);
-        instance->spi = NULL;
+        avr_isp_spi_free(instance);
     }
 
     instance->pmode = false;
 }
 
-static bool avr_isp_start_pmode(AvrIsp* instance, AvrIspSpiSwSpeed spi_speed) {
+static bool avr_isp_start_pmode(AvrIsp* instance, const AvrIspSpiSpeed* spi_speed) {
     furi_assert(instance);
 
     // Reset target before driving PIN_SCK or PIN_MOSI
@@ -84,24 +199,23 @@ static bool avr_isp_start_pmode(AvrIsp* instance, AvrIspSpiSwSpeed spi_speed) {
     // which for many arduino's is not the SS pin.
     // So we have to configure RESET as output here,
     // (reset_target() first sets the correct level)
-    if(instance->spi) avr_isp_spi_sw_free(instance->spi);
-    instance->spi = avr_isp_spi_sw_init(spi_speed);
+    avr_isp_spi_init(instance, spi_speed);
 
-    avr_isp_spi_sw_res_set(instance->spi, false);
+    avr_isp_spi_res_set(instance, false);
     // See avr datasheets, chapter "SERIAL_PRG Programming Algorithm":
 
-    // Pulse RESET after PIN_SCK is low:
-    avr_isp_spi_sw_sck_set(instance->spi, false);
+    // Pulse RESET after PIN_SCK is low, hardware SPI keeps it low when idle:
+    if(instance->spi) avr_isp_spi_sw_sck_set(instance->spi, false);
 
     // discharge PIN_SCK, value arbitrally chosen
     furi_delay_ms(20);
-    avr_isp_spi_sw_res_set(instance->spi, true);
+    avr_isp_spi_res_set(instance, true);
 
     // Pulse must be minimum 2 target CPU speed cycles
     // so 100 usec is ok for CPU speeds above 20KHz
     furi_delay_ms(1);
 
-    avr_isp_spi_sw_res_set(instance->spi, false);
+    avr_isp_spi_res_set(instance, false);
 
     // Send the enable programming command:
     // datasheet: must be > 20 msec
@@ -116,20 +230,15 @@ static bool avr_isp_start_pmode(AvrIsp* instance, AvrIspSpiSwSpeed spi_speed) {
 bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance) {
     furi_assert(instance);
 
-    AvrIspSpiSwSpeed spi_speed[] = {
-        AvrIspSpiSwSpeed1Mhz,
-        AvrIspSpiSwSpeed400Khz,
-        AvrIspSpiSwSpeed250Khz,
-        AvrIspSpiSwSpeed125Khz,
-        AvrIspSpiSwSpeed60Khz,
-        AvrIspSpiSwSpeed40Khz,
-        AvrIspSpiSwSpeed20Khz,
-        AvrIspSpiSwSpeed10Khz,
-        AvrIspSpiSwSpeed5Khz,
-        AvrIspSpiSwSpeed1Khz,
-    };
-    for(uint8_t i = 0; i < COUNT_OF(spi_speed); i++) {
-        if(avr_isp_start_pmode(instance, spi_speed[i])) {
+    const AvrIspSpiSpeed* spi_speed = avr_isp_spi_speed_sw;
+    size_t spi_speed_count = COUNT_OF(avr_isp_spi_speed_sw);
+    if(instance->spi_backend == AvrIspSpiBackendHw) {
+        spi_speed = avr_isp_spi_speed_hw;
+        spi_speed_count = COUNT_OF(avr_isp_spi_speed_hw);
+    }
+
+    for(uint8_t i = 0; i < spi_speed_count; i++) {
+        if(avr_isp_start_pmode(instance, &spi_speed[i])) {
             AvrIspSignature sig = avr_isp_read_signature(instance);
             AvrIspSignature sig_examination = avr_isp_read_signature(instance); //-V656
             uint8_t y = 0;
@@ -141,11 +250,11 @@ bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance) {
                 y++;
             }
             if(y == 8) {
-                if(spi_speed[i] > AvrIspSpiSwSpeed1Mhz) {
-                    if(i < (COUNT_OF(spi_speed) - 1)) {
+                if(i > 0) {
+                    if(i < (spi_speed_count - 1)) {
                         avr_isp_end_pmode(instance);
                         i++;
-                        return avr_isp_start_pmode(instance, spi_speed[i]);
+                        return avr_isp_start_pmode(instance, &spi_speed[i]);
                     }
                 }
                 return true;
@@ -153,19 +262,34 @@ bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance) {
         }
     }
 
-    if(instance->spi) {
-        avr_isp_spi_sw_free(instance->spi);
-        instance->spi = NULL;
+    avr_isp_spi_free(instance);
+
+    return false;
+}
+
+static bool avr_isp_wait_ready(AvrIsp* instance, uint32_t delay_ms, uint32_t timeout_ms) {
+    furi_assert(instance);
+
+    // Parts without RDY/BSY get the fixed datasheet delay and can't time out
+    if(!instance->poll_rdy_bsy) {
+        furi_delay_ms(delay_ms);
+        return true;
     }
 
+    uint32_t starttime = furi_get_tick();
+    while((furi_get_tick() - starttime) < timeout_ms) {
+        if(!(avr_isp_spi_transaction(instance, AVR_ISP_POLL_RDY_BSY) & 0x01)) return true;
+    }
     return false;
 }
 
-static void avr_isp_commit(AvrIsp* instance, uint16_t addr, uint8_t data) {
+static bool avr_isp_commit(AvrIsp* instance, uint16_t addr, uint8_t data) {
     furi_assert(instance);
 
     avr_isp_spi_transaction(instance, AVR_ISP_COMMIT(addr));
-    /* polling flash */
+    /* polling RDY/BSY, works for any data unlike polling flash */
+    if(instance->poll_rdy_bsy) return avr_isp_wait_ready(instance, 0, 30);
+
     if(data == 0xFF) {
         furi_delay_ms(5);
     } else {
@@ -177,6 +301,7 @@ static void avr_isp_commit(AvrIsp* instance, uint16_t addr, uint8_t data) {
             };
         }
     }
+    return true;
 }
 
 static uint16_t avr_isp_current_page(AvrIsp* instance, uint32_t addr, uint16_t page_size) {
@@ -214,19 +339,30 @@ static bool avr_isp_flash_write_pages(
     furi_assert(instance);
 
     size_t x = 0;
+    size_t burst_size = 0;
     uint16_t page = avr_isp_current_page(instance, addr, page_size);
 
+    // Page buffer loads don't need answers, they go out in one burst per page
     while(x < data_size) {
         if(page != avr_isp_current_page(instance, addr, page_size)) {
-            avr_isp_commit(instance, page, data[x - 1]);
+            avr_isp_spi_burst(instance, burst_size);
+            burst_size = 0;
+            if(!avr_isp_commit(instance, page, data[x - 1])) return false;
             page = avr_isp_current_page(instance, addr, page_size);
+        } else if(burst_size == AVR_ISP_SPI_BURST_BUF_SIZE) {
+            avr_isp_spi_burst(instance, burst_size);
+            burst_size = 0;
         }
-        avr_isp_spi_transaction(instance, AVR_ISP_WRITE_FLASH_LO(addr, data[x++]));
-        avr_isp_spi_transaction(instance, AVR_ISP_WRITE_FLASH_HI(addr, data[x++]));
+        burst_size = avr_isp_burst_add(
+            instance, burst_size, AVR_ISP_WRITE_FLASH_LO(addr, data[x]));
+        x++;
+        burst_size = avr_isp_burst_add(
+            instance, burst_size, AVR_ISP_WRITE_FLASH_HI(addr, data[x]));
+        x++;
         addr++;
     }
-    avr_isp_commit(instance, page, data[x - 1]);
-    return true;
+    avr_isp_spi_burst(instance, burst_size);
+    return avr_isp_commit(instance, page, data[x - 1]);
 }
 
 bool avr_isp_erase_chip(AvrIsp* instance) {
@@ -236,9 +372,8 @@ bool avr_isp_erase_chip(AvrIsp* instance) {
     if(!instance->pmode) avr_isp_auto_set_spi_speed_start_pmode(instance);
     if(instance->pmode) {
         avr_isp_spi_transaction(instance, AVR_ISP_ERASE_CHIP);
-        furi_delay_ms(100);
+        ret = avr_isp_wait_ready(instance, 100, 100);
         avr_isp_end_pmode(instance);
-        ret = true;
     }
     return ret;
 }
@@ -249,7 +384,7 @@ static bool
 
     for(uint16_t i = 0; i < data_size; i++) {
         avr_isp_spi_transaction(instance, AVR_ISP_WRITE_EEPROM(addr, data[i]));
-        furi_delay_ms(10);
+        if(!avr_isp_wait_ready(instance, 10, 50)) return false;
         addr++;
     }
     return true;
@@ -296,10 +431,19 @@ static bool avr_isp_flash_read_page(
     furi_assert(instance);
 
     if(page_size > data_size) return false;
-    for(uint16_t i = 0; i < page_size; i += 2) {
-        data[i] = avr_isp_spi_transaction(instance, AVR_ISP_READ_FLASH_LO(addr));
-        data[i + 1] = avr_isp_spi_transaction(instance, AVR_ISP_READ_FLASH_HI(addr));
-        addr++;
+    // Every read command answers with its last byte, so whole page goes in bursts
+    for(uint16_t i = 0; i < page_size;) {
+        size_t burst_size = 0;
+        uint16_t start = i;
+        for(; (i < page_size) && (burst_size < AVR_ISP_SPI_BURST_BUF_SIZE); i += 2) {
+            burst_size = avr_isp_burst_add(instance, burst_size, AVR_ISP_READ_FLASH_LO(addr));
+            burst_size = avr_isp_burst_add(instance, burst_size, AVR_ISP_READ_FLASH_HI(addr));
+            addr++;
+        }
+        avr_isp_spi_burst(instance, burst_size);
+        for(size_t j = 0; j < burst_size / 4; j++) {
+            data[start + j] = instance->burst_rx[j * 4 + 3];
+        }
     }
     return true;
 }
@@ -13,12 +13,25 @@ struct AvrIspSignature {
 
 typedef struct AvrIspSignature AvrIspSignature;
 
+typedef enum {
+    AvrIspSpiBackendHw, /**< SPI peripheral, slow targets fall back to software */
+    AvrIspSpiBackendSw, /**< Bit-banged GPIO */
+} AvrIspSpiBackend;
+
 AvrIsp* avr_isp_alloc(void);
 
 void avr_isp_free(AvrIsp* instance);
 
 void avr_isp_set_tx_callback(AvrIsp* instance, AvrIspCallback callback, void* context);
 
+void avr_isp_set_spi_backend(AvrIsp* instance, AvrIspSpiBackend backend);
+
+/** Wait for flash, EEPROM and erase by polling RDY/BSY instead of fixed delays
+ *
+ * Off by default, older parts don't support the command.
+ */
+void avr_isp_set_poll_rdy_bsy(AvrIsp* instance, bool poll_rdy_bsy);
+
 bool avr_isp_auto_set_spi_speed_start_pmode(AvrIsp* instance);
 
 AvrIspSignature avr_isp_read_signature(AvrIsp* instance);
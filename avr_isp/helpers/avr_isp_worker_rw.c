@@ -15,6 +15,8 @@
 #define NAME_PATERN_FLASH_FILE "flash.hex"
 #define NAME_PATERN_EEPROM_FILE "eeprom.hex"
 
+#define AVR_ISP_WORKER_RW_PAGE_SIZE_MAX 256
+
 struct AvrIspWorkerRW {
     AvrIsp* avr_isp;
     FuriThread* thread;
@@ -131,6 +133,12 @@ static int32_t avr_isp_worker_rw_thread(void* context) {
     return 0;
 }
 
+static bool avr_isp_worker_rw_chip_has_rdy_bsy(uint32_t ind) {
+    // Poll RDY/BSY came with paged flash, the ATmega103 is the one paged part without it
+    return (avr_isp_chip_arr[ind].pagesize > 1) &&
+           (strcmp(avr_isp_chip_arr[ind].name, "ATmega103") != 0);
+}
+
 bool avr_isp_worker_rw_detect_chip(AvrIspWorkerRW* instance) {
     furi_assert(instance);
 
@@ -200,6 +208,8 @@ bool avr_isp_worker_rw_detect_chip(AvrIspWorkerRW* instance) {
                         }
                         instance->chip_detect = true;
                         instance->chip_arr_ind = ind;
+                        avr_isp_set_poll_rdy_bsy(
+                            instance->avr_isp, avr_isp_worker_rw_chip_has_rdy_bsy(ind));
                         break;
                     }
                 }
@@ -518,13 +528,155 @@ void avr_isp_worker_rw_read_dump_start(
     furi_thread_flags_set(furi_thread_get_id(instance->thread), AvrIspWorkerRWEvtReading);
 }
 
-static bool avr_isp_worker_rw_verification_flash(AvrIspWorkerRW* instance, const char* file_path) {
-    furi_assert(instance);
-    furi_assert(file_path);
+static bool avr_isp_worker_rw_flash_is_paged(AvrIspWorkerRW* instance) {
+    // Old AT90S and ATtiny1x parts write flash a byte at a time, page size is 1 or -1
+    return avr_isp_chip_arr[instance->chip_arr_ind].pagesize > 1;
+}
 
-    FURI_LOG_D(TAG, "Verification flash %s", file_path);
+typedef struct {
+    uint8_t data[AVR_ISP_WORKER_RW_PAGE_SIZE_MAX];
+    uint8_t mask[AVR_ISP_WORKER_RW_PAGE_SIZE_MAX / 8]; // bytes present in hex file
+    uint32_t addr; // word address
+    uint16_t size;
+} AvrIspWorkerRWPage;
+
+typedef bool (*AvrIspWorkerRWPageCallback)(AvrIspWorkerRW* instance, AvrIspWorkerRWPage* page);
+
+static bool avr_isp_worker_rw_page_is_blank(AvrIspWorkerRWPage* page) {
+    for(uint16_t i = 0; i < page->size; i++) {
+        if((page->mask[i / 8] & (1 << (i % 8))) && (page->data[i] != 0xFF)) return false;
+    }
+    return true;
+}
+
+static bool avr_isp_worker_rw_flash_page_flush(
+    AvrIspWorkerRW* instance,
+    AvrIspWorkerRWPage* page,
+    uint8_t* extended_addr,
+    AvrIspWorkerRWPageCallback callback) {
+    const AvrIspChipArr* chip = &avr_isp_chip_arr[instance->chip_arr_ind];
+
+    // Nothing to do for blank pages, chip erase leaves them 0xFF
+    if(page->addr == UINT32_MAX || avr_isp_worker_rw_page_is_blank(page)) return true;
+
+    if((chip->flashsize / 2) > 0x10000) {
+        if(*extended_addr <= ((page->addr >> 16) & 0xFF)) {
+            avr_isp_write_extended_addr(instance->avr_isp, *extended_addr);
+            *extended_addr = ((page->addr >> 16) & 0xFF) + 1;
+        }
+    }
+    instance->progress_flash = (float)(page->addr) / ((float)chip->flashsize / 2.0f);
+    return callback(instance, page);
+}
+
+/** Goes through flash hex file page by page
+ * 
+ * Records are gathered into chip pages, pages with nothing but 0xFF are skipped.
+ * 
+ * @param instance AvrIspWorkerRW instance
+ * @param file_path path to flash hex file
+ * @param callback called for every page with data, returns false to stop
+ * @return false if callback failed
+ */
+static bool avr_isp_worker_rw_flash_for_each_page(
+    AvrIspWorkerRW* instance,
+    const char* file_path,
+    AvrIspWorkerRWPageCallback callback) {
+    const AvrIspChipArr* chip = &avr_isp_chip_arr[instance->chip_arr_ind];
+    furi_check(chip->pagesize > 0 && chip->pagesize <= AVR_ISP_WORKER_RW_PAGE_SIZE_MAX);
 
-    instance->progress_flash = 0.0;
+    bool ret = true;
+    uint8_t data[288] = {0};
+    AvrIspWorkerRWPage* page = malloc(sizeof(AvrIspWorkerRWPage));
+    page->size = chip->pagesize;
+    page->addr = UINT32_MAX;
+
+    FlipperI32HexFile* flipper_hex_flash = flipper_i32hex_file_open_read(file_path);
+
+    uint32_t addr = chip->flashoffset;
+    uint8_t extended_addr = 0;
+
+    FlipperI32HexFileRet flipper_hex_ret =
+        flipper_i32hex_file_i32hex_to_bin_get_data(flipper_hex_flash, data, sizeof(data));
+
+    while(((flipper_hex_ret.status == FlipperI32HexFileStatusData) ||
+           (flipper_hex_ret.status == FlipperI32HexFileStatusUdateAddr)) &&
+          ret) {
+        switch(flipper_hex_ret.status) {
+        case FlipperI32HexFileStatusData:
+            for(uint32_t i = 0; (i < flipper_hex_ret.data_size) && ret; i++) {
+                uint32_t byte_addr = addr * 2 + i;
+                uint32_t offset = byte_addr % page->size;
+                uint32_t page_addr = (byte_addr - offset) / 2;
+                if(page_addr != page->addr) {
+                    ret = avr_isp_worker_rw_flash_page_flush(
+                        instance, page, &extended_addr, callback);
+                    memset(page->data, 0xFF, sizeof(page->data));
+                    memset(page->mask, 0, sizeof(page->mask));
+                    page->addr = page_addr;
+                }
+                page->data[offset] = data[i];
+                page->mask[offset / 8] |= (1 << (offset % 8));
+            }
+            addr += flipper_hex_ret.data_size / 2;
+            break;
+
+        case FlipperI32HexFileStatusUdateAddr:
+            addr = (data[0] << 24 | data[1] << 16) / 2;
+            break;
+
+        default:
+            furi_crash(TAG " Incorrect status.");
+            break;
+        }
+
+        flipper_hex_ret =
+            flipper_i32hex_file_i32hex_to_bin_get_data(flipper_hex_flash, data, sizeof(data));
+    }
+    if(ret) ret = avr_isp_worker_rw_flash_page_flush(instance, page, &extended_addr, callback);
+
+    flipper_i32hex_file_close(flipper_hex_flash);
+    free(page);
+    instance->progress_flash = 1.0f;
+
+    return ret;
+}
+
+static bool avr_isp_worker_rw_verification_flash_page(
+    AvrIspWorkerRW* instance,
+    AvrIspWorkerRWPage* page) {
+    uint8_t data_read_flash[AVR_ISP_WORKER_RW_PAGE_SIZE_MAX] = {0};
+
+    avr_isp_read_page(
+        instance->avr_isp,
+        STK_SET_FLASH_TYPE,
+        (uint16_t)page->addr,
+        page->size,
+        data_read_flash,
+        sizeof(data_read_flash));
+
+    for(uint16_t i = 0; i < page->size; i++) {
+        if(!(page->mask[i / 8] & (1 << (i % 8)))) continue;
+        if(data_read_flash[i] != page->data[i]) {
+            FURI_LOG_E(TAG, "Verification flash error");
+            FURI_LOG_E(TAG, "Addr: 0x%04lX", page->addr);
+            for(uint32_t j = 0; j < page->size; j++) {
+                FURI_LOG_RAW_E("%02X ", page->data[j]);
+            }
+            FURI_LOG_RAW_E("\r\n");
+            for(uint32_t j = 0; j < page->size; j++) {
+                FURI_LOG_RAW_E("%02X ", data_read_flash[j]);
+            }
+            FURI_LOG_RAW_E("\r\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool avr_isp_worker_rw_verification_flash_records(
+    AvrIspWorkerRW* instance,
+    const char* file_path) {
     bool ret = true;
 
     FlipperI32HexFile* flipper_hex_flash = flipper_i32hex_file_open_read(file_path);
@@ -533,8 +685,6 @@ static bool avr_isp_worker_rw_verification_flash(AvrIspWorkerRW* instance, const
     uint8_t data_read_hex[272] = {0};
 
     uint32_t addr = avr_isp_chip_arr[instance->chip_arr_ind].flashoffset;
-    bool send_extended_addr = ((avr_isp_chip_arr[instance->chip_arr_ind].flashsize / 2) > 0x10000);
-    uint8_t extended_addr = 0;
 
     FlipperI32HexFileRet flipper_hex_ret = flipper_i32hex_file_i32hex_to_bin_get_data(
         flipper_hex_flash, data_read_hex, sizeof(data_read_hex));
@@ -544,14 +694,6 @@ static bool avr_isp_worker_rw_verification_flash(AvrIspWorkerRW* instance, const
           ret) {
         switch(flipper_hex_ret.status) {
         case FlipperI32HexFileStatusData:
-
-            if(send_extended_addr) {
-                if(extended_addr <= ((addr >> 16) & 0xFF)) {
-                    avr_isp_write_extended_addr(instance->avr_isp, extended_addr);
-                    extended_addr = ((addr >> 16) & 0xFF) + 1;
-                }
-            }
-
             avr_isp_read_page(
                 instance->avr_isp,
                 STK_SET_FLASH_TYPE,
@@ -599,6 +741,23 @@ static bool avr_isp_worker_rw_verification_flash(AvrIspWorkerRW* instance, const
     return ret;
 }
 
+static bool avr_isp_worker_rw_verification_flash(AvrIspWorkerRW* instance, const char* file_path) {
+    furi_assert(instance);
+    furi_assert(file_path);
+
+    FURI_LOG_D(TAG, "Verification flash %s", file_path);
+
+    instance->progress_flash = 0.0;
+
+    if(!avr_isp_worker_rw_flash_is_paged(instance)) {
+        return avr_isp_worker_rw_verification_flash_records(instance, file_path);
+    }
+
+    // Blank pages are not programmed, so only pages with data are read back
+    return avr_isp_worker_rw_flash_for_each_page(
+        instance, file_path, avr_isp_worker_rw_verification_flash_page);
+}
+
 static bool
     avr_isp_worker_rw_verification_eeprom(AvrIspWorkerRW* instance, const char* file_path) {
     furi_assert(instance);
@@ -721,47 +880,44 @@ void avr_isp_worker_rw_verification_start(
     furi_thread_flags_set(furi_thread_get_id(instance->thread), AvrIspWorkerRWEvtVerification);
 }
 
-static void avr_isp_worker_rw_write_flash(AvrIspWorkerRW* instance, const char* file_path) {
-    furi_assert(instance);
-    furi_check(instance->avr_isp);
-
-    instance->progress_flash = 0.0;
-
-    FURI_LOG_D(TAG, "Write Flash %s", file_path);
+static bool
+    avr_isp_worker_rw_write_flash_page(AvrIspWorkerRW* instance, AvrIspWorkerRWPage* page) {
+    return avr_isp_write_page(
+        instance->avr_isp,
+        STK_SET_FLASH_TYPE,
+        avr_isp_chip_arr[instance->chip_arr_ind].flashsize,
+        (uint16_t)page->addr,
+        page->size,
+        page->data,
+        page->size);
+}
 
+static bool
+    avr_isp_worker_rw_write_flash_records(AvrIspWorkerRW* instance, const char* file_path) {
+    bool ret = true;
     uint8_t data[288] = {0};
 
     FlipperI32HexFile* flipper_hex_flash = flipper_i32hex_file_open_read(file_path);
 
     uint32_t addr = avr_isp_chip_arr[instance->chip_arr_ind].flashoffset;
-    bool send_extended_addr = ((avr_isp_chip_arr[instance->chip_arr_ind].flashsize / 2) > 0x10000);
-    uint8_t extended_addr = 0;
 
     FlipperI32HexFileRet flipper_hex_ret =
         flipper_i32hex_file_i32hex_to_bin_get_data(flipper_hex_flash, data, sizeof(data));
 
-    while((flipper_hex_ret.status == FlipperI32HexFileStatusData) ||
-          (flipper_hex_ret.status == FlipperI32HexFileStatusUdateAddr)) {
+    while(((flipper_hex_ret.status == FlipperI32HexFileStatusData) ||
+           (flipper_hex_ret.status == FlipperI32HexFileStatusUdateAddr)) &&
+          ret) {
         switch(flipper_hex_ret.status) {
         case FlipperI32HexFileStatusData:
-
-            if(send_extended_addr) {
-                if(extended_addr <= ((addr >> 16) & 0xFF)) {
-                    avr_isp_write_extended_addr(instance->avr_isp, extended_addr);
-                    extended_addr = ((addr >> 16) & 0xFF) + 1;
-                }
-            }
-
-            if(!avr_isp_write_page(
-                   instance->avr_isp,
-                   STK_SET_FLASH_TYPE,
-                   avr_isp_chip_arr[instance->chip_arr_ind].flashsize,
-                   (uint16_t)addr,
-                   avr_isp_chip_arr[instance->chip_arr_ind].pagesize,
-                   data,
-                   flipper_hex_ret.data_size)) {
-                break;
-            }
+            // Page size of 1 makes every word its own commit
+            ret = avr_isp_write_page(
+                instance->avr_isp,
+                STK_SET_FLASH_TYPE,
+                avr_isp_chip_arr[instance->chip_arr_ind].flashsize,
+                (uint16_t)addr,
+                1,
+                data,
+                flipper_hex_ret.data_size);
             addr += flipper_hex_ret.data_size / 2;
             instance->progress_flash =
                 (float)(addr) / ((float)avr_isp_chip_arr[instance->chip_arr_ind].flashsize / 2.0f);
@@ -782,6 +938,24 @@ static void avr_isp_worker_rw_write_flash(AvrIspWorkerRW* instance, const char*
 
     flipper_i32hex_file_close(flipper_hex_flash);
     instance->progress_flash = 1.0f;
+
+    return ret;
+}
+
+static bool avr_isp_worker_rw_write_flash(AvrIspWorkerRW* instance, const char* file_path) {
+    furi_assert(instance);
+    furi_check(instance->avr_isp);
+
+    instance->progress_flash = 0.0;
+
+    FURI_LOG_D(TAG, "Write Flash %s", file_path);
+
+    if(!avr_isp_worker_rw_flash_is_paged(instance)) {
+        return avr_isp_worker_rw_write_flash_records(instance, file_path);
+    }
+
+    return avr_isp_worker_rw_flash_for_each_page(
+        instance, file_path, avr_isp_worker_rw_write_flash_page);
 }
 
 static void avr_isp_worker_rw_write_eeprom(AvrIspWorkerRW* instance, const char* file_path) {
@@ -970,7 +1144,11 @@ bool avr_isp_worker_rw_write_dump(
             //write flash
             furi_string_printf(
                 file_path_name, "%s/%s", file_path, furi_string_get_cstr(temp_str_1));
-            avr_isp_worker_rw_write_flash(instance, furi_string_get_cstr(file_path_name));
+            if(!avr_isp_worker_rw_write_flash(instance, furi_string_get_cstr(file_path_name))) {
+                FURI_LOG_E(TAG, "Write flash: Error");
+                avr_isp_end_pmode(instance->avr_isp);
+                break;
+            }
 
             //write eeprom
             if(furi_string_size(temp_str_2) > 4) {
@@ -32,6 +32,8 @@
 
 #define AVR_ISP_OSCCAL(add) 0x38, 0x00, add, 0x00
 
+#define AVR_ISP_POLL_RDY_BSY 0xF0, 0x00, 0x00, 0x00 //Last byte bit 0 is set while busy
+
 #define AVR_ISP_WRITE_LOCK_BYTE(data) 0xAC, 0xE0, 0x00, data //Send cmd, Wait N ms
 #define AVR_ISP_READ_LOCK_BYTE 0x58, 0x00, 0x00, 0x00
 #define AVR_ISP_WRITE_FUSE_LOW(data) 0xAC, 0xA0, 0x00, data //Send cmd, Wait N ms
@@ -0,0 +1,103 @@
+#include "avr_isp_spi_hw.h"
+
+#include <furi.h>
+
+#define AVR_ISP_SPI_HW_TIMEOUT 100
+#define AVR_ISP_RESET &gpio_ext_pb2
+
+// MISO/MOSI/SCK of avr_isp_spi_sw are PA6/PA7/PB3, the pins of external SPI bus.
+// Bus stays acquired while instance exists, so SCK is driven low between transactions,
+// CS of external bus (PA4) is not touched, it's target clock output
+struct AvrIspSpiHw {
+    FuriHalSpiBusHandle handle;
+    LL_SPI_InitTypeDef preset;
+    const GpioPin* res;
+};
+
+static void avr_isp_spi_hw_event_callback(
+    FuriHalSpiBusHandle* handle,
+    FuriHalSpiBusHandleEvent event) {
+    AvrIspSpiHw* instance = (AvrIspSpiHw*)handle;
+
+    if(event == FuriHalSpiBusHandleEventActivate) {
+        LL_SPI_Init(handle->bus->spi, &instance->preset);
+        LL_SPI_SetRxFIFOThreshold(handle->bus->spi, LL_SPI_RX_FIFO_TH_QUARTER);
+        LL_SPI_Enable(handle->bus->spi);
+
+        furi_hal_gpio_init_ex(
+            handle->miso,
+            GpioModeAltFunctionPushPull,
+            GpioPullNo,
+            GpioSpeedVeryHigh,
+            GpioAltFn5SPI1);
+        furi_hal_gpio_init_ex(
+            handle->mosi,
+            GpioModeAltFunctionPushPull,
+            GpioPullNo,
+            GpioSpeedVeryHigh,
+            GpioAltFn5SPI1);
+        furi_hal_gpio_init_ex(
+            handle->sck,
+            GpioModeAltFunctionPushPull,
+            GpioPullNo,
+            GpioSpeedVeryHigh,
+            GpioAltFn5SPI1);
+    } else if(event == FuriHalSpiBusHandleEventDeactivate) {
+        furi_hal_gpio_init(handle->miso, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+        furi_hal_gpio_init(handle->mosi, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+        furi_hal_gpio_init(handle->sck, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+
+        LL_SPI_Disable(handle->bus->spi);
+    }
+}
+
+AvrIspSpiHw* avr_isp_spi_hw_init(AvrIspSpiHwSpeed speed) {
+    AvrIspSpiHw* instance = malloc(sizeof(AvrIspSpiHw));
+    memcpy(&instance->handle, &furi_hal_spi_bus_handle_external, sizeof(FuriHalSpiBusHandle));
+    instance->handle.callback = avr_isp_spi_hw_event_callback;
+
+    // Mode 0, MSB first, as in AVR serial programming
+    instance->preset.Mode = LL_SPI_MODE_MASTER;
+    instance->preset.TransferDirection = LL_SPI_FULL_DUPLEX;
+    instance->preset.DataWidth = LL_SPI_DATAWIDTH_8BIT;
+    instance->preset.ClockPolarity = LL_SPI_POLARITY_LOW;
+    instance->preset.ClockPhase = LL_SPI_PHASE_1EDGE;
+    instance->preset.NSS = LL_SPI_NSS_SOFT;
+    instance->preset.BaudRate = speed;
+    instance->preset.BitOrder = LL_SPI_MSB_FIRST;
+    instance->preset.CRCCalculation = LL_SPI_CRCCALCULATION_DISABLE;
+    instance->preset.CRCPoly = 7;
+
+    instance->res = AVR_ISP_RESET;
+    furi_hal_gpio_init(instance->res, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+
+    furi_hal_spi_bus_handle_init(&instance->handle);
+    furi_hal_spi_acquire(&instance->handle);
+
+    return instance;
+}
+
+void avr_isp_spi_hw_free(AvrIspSpiHw* instance) {
+    furi_assert(instance);
+    furi_hal_spi_release(&instance->handle);
+    furi_hal_spi_bus_handle_deinit(&instance->handle);
+    furi_hal_gpio_init(instance->res, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+    free(instance);
+}
+
+uint8_t avr_isp_spi_hw_txrx(AvrIspSpiHw* instance, uint8_t data) {
+    furi_assert(instance);
+    uint8_t rx = 0;
+    furi_hal_spi_bus_trx(&instance->handle, &data, &rx, 1, AVR_ISP_SPI_HW_TIMEOUT);
+    return rx;
+}
+
+bool avr_isp_spi_hw_txrx_burst(AvrIspSpiHw* instance, uint8_t* tx, uint8_t* rx, size_t size) {
+    furi_assert(instance);
+    return furi_hal_spi_bus_trx_dma(&instance->handle, tx, rx, size, AVR_ISP_SPI_HW_TIMEOUT);
+}
+
+void avr_isp_spi_hw_res_set(AvrIspSpiHw* instance, bool state) {
+    furi_assert(instance);
+    furi_hal_gpio_write(instance->res, state);
+}
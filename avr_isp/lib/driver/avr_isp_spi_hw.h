@@ -0,0 +1,19 @@
+#pragma once
+
+#include <furi_hal.h>
+
+// SPI1 runs from 64MHz, speed is set by bus prescaler
+typedef enum {
+    AvrIspSpiHwSpeed2Mhz = LL_SPI_BAUDRATEPRESCALER_DIV32,
+    AvrIspSpiHwSpeed1Mhz = LL_SPI_BAUDRATEPRESCALER_DIV64,
+    AvrIspSpiHwSpeed500Khz = LL_SPI_BAUDRATEPRESCALER_DIV128,
+    AvrIspSpiHwSpeed250Khz = LL_SPI_BAUDRATEPRESCALER_DIV256,
+} AvrIspSpiHwSpeed;
+
+typedef struct AvrIspSpiHw AvrIspSpiHw;
+
+AvrIspSpiHw* avr_isp_spi_hw_init(AvrIspSpiHwSpeed speed);
+void avr_isp_spi_hw_free(AvrIspSpiHw* instance);
+uint8_t avr_isp_spi_hw_txrx(AvrIspSpiHw* instance, uint8_t data);
+bool avr_isp_spi_hw_txrx_burst(AvrIspSpiHw* instance, uint8_t* tx, uint8_t* rx, size_t size);
+void avr_isp_spi_hw_res_set(AvrIspSpiHw* instance, bool state);
@@ -0,0 +1,197 @@
+#ifndef SMALLCHESSLIB_BENCH_H
+#define SMALLCHESSLIB_BENCH_H
+
+/**
+  @file smallchesslib_bench.h
+
+  Perft and search benchmark for smallchesslib. Like the library itself this is
+  a single header, it has to be included AFTER smallchesslib.h in the same
+  translation unit. It doesn't depend on anything else, so the same code runs
+  on the host (e.g. to check move generator changes on Linux) and on device.
+
+  Perft walks the full legal move tree using only SCL_boardGetMoves,
+  SCL_boardMakeMove and SCL_boardUndoMove and compares the leaf count with
+  well known reference values, so it catches move generator bugs (castling,
+  en passant, promotions, pins) as well as measuring raw speed.
+
+  The search benchmark runs SCL_getAIMove at fixed depth on the same positions
+  and reports nodes per second. The node count is only available if the
+  library was compiled with SCL_COUNT_EVALUATED_POSITIONS set to 1.
+*/
+
+#ifndef SMALLCHESSLIB_H
+#error "smallchesslib_bench.h has to be included after smallchesslib.h"
+#endif
+
+#ifndef SCL_COUNT_EVALUATED_POSITIONS
+#define SCL_COUNT_EVALUATED_POSITIONS 0
+#endif
+
+/**
+  Returns a monotonic time in milliseconds, e.g. furi_get_tick on device or
+  a clock_gettime wrapper on the host. Only differences are used, so it may
+  wrap around.
+*/
+typedef uint32_t (*SCL_BenchClockFunction)(void);
+
+#define SCL_BENCH_PERFT_MAX_DEPTH 5
+
+typedef struct {
+    const char* name;
+    const char* fen;
+    /** Reference leaf counts for depth 1, 2, ... (0 = unknown). */
+    uint32_t nodes[SCL_BENCH_PERFT_MAX_DEPTH];
+} SCL_BenchPosition;
+
+/**
+  Standard perft positions (chessprogramming.org/Perft_Results). Position 2
+  ("kiwipete") and 4 are the usual castling/promotion torture tests.
+*/
+static const SCL_BenchPosition SCL_benchPositions[] = {
+    {"start", SCL_FEN_START, {20, 400, 8902, 197281, 4865609}},
+    {"kiwipete",
+     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     {48, 2039, 97862, 4085603, 0}},
+    {"pos3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238, 674624}},
+    {"pos4",
+     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+     {6, 264, 9467, 422333, 0}},
+    {"pos5",
+     "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+     {44, 1486, 62379, 2103487, 0}},
+};
+
+#define SCL_BENCH_POSITION_COUNT (sizeof(SCL_benchPositions) / sizeof(SCL_BenchPosition))
+
+typedef struct {
+    uint32_t nodes; ///< leaf nodes (perft) or evaluated positions (search)
+    uint32_t expected; ///< reference node count, 0 if unknown
+    uint32_t timeMs;
+    uint32_t nodesPerSecond;
+} SCL_BenchResult;
+
+static uint32_t _SCL_benchNodesPerSecond(uint32_t nodes, uint32_t timeMs) {
+    if(timeMs == 0) timeMs = 1;
+
+    return (uint32_t)(((uint64_t)nodes * 1000) / timeMs);
+}
+
+/**
+  Counts leaf nodes of the legal move tree of given depth. Promotions count as
+  four distinct moves. The board is restored to its original state.
+*/
+static uint32_t SCL_perft(SCL_Board board, uint8_t depth) {
+    static const char promotions[4] = {'q', 'r', 'b', 'n'};
+
+    if(depth == 0) return 1;
+
+    uint32_t result = 0;
+    uint8_t whitesTurn = SCL_boardWhitesTurn(board);
+
+    for(uint8_t i = 0; i < SCL_BOARD_SQUARES; ++i) {
+        char piece = board[i];
+
+        if(piece == '.' || SCL_pieceIsWhite(piece) != whitesTurn) continue;
+
+        SCL_SquareSet moves = SCL_SQUARE_SET_EMPTY;
+
+        SCL_boardGetMoves(board, i, moves);
+
+        uint8_t isPawn = piece == 'p' || piece == 'P';
+
+        SCL_SQUARE_SET_ITERATE_BEGIN(moves)
+        uint8_t promotes = isPawn && (iteratedSquare / 8 == 0 || iteratedSquare / 8 == 7);
+
+        for(uint8_t p = 0; p < (promotes ? 4 : 1); ++p) {
+            if(depth == 1) {
+                result++;
+                continue;
+            }
+
+            SCL_MoveUndo undo = SCL_boardMakeMove(board, i, iteratedSquare, promotions[p]);
+
+            result += SCL_perft(board, depth - 1);
+
+            SCL_boardUndoMove(board, undo);
+        }
+        SCL_SQUARE_SET_ITERATE_END
+    }
+
+    return result;
+}
+
+/**
+  Runs perft on one of SCL_benchPositions. Returns 1 if the node count matches
+  the reference value (or if there is no reference value for that depth).
+*/
+static uint8_t SCL_benchPerft(
+    uint8_t positionIndex,
+    uint8_t depth,
+    SCL_BenchClockFunction clockFunc,
+    SCL_BenchResult* result) {
+    const SCL_BenchPosition* position = &SCL_benchPositions[positionIndex];
+    SCL_Board board;
+
+    SCL_boardFromFEN(board, position->fen);
+
+    uint32_t start = clockFunc();
+    result->nodes = SCL_perft(board, depth);
+    result->timeMs = clockFunc() - start;
+    result->nodesPerSecond = _SCL_benchNodesPerSecond(result->nodes, result->timeMs);
+    result->expected =
+        (depth > 0 && depth <= SCL_BENCH_PERFT_MAX_DEPTH) ? position->nodes[depth - 1] : 0;
+
+    return result->expected == 0 || result->expected == result->nodes;
+}
+
+/**
+  Lets the AI search one of SCL_benchPositions at fixed depth (no extensions,
+  no randomness so that runs are repeatable) and measures the search speed.
+  Returns the value of the best move found.
+*/
+static int16_t SCL_benchSearch(
+    uint8_t positionIndex,
+    uint8_t depth,
+    SCL_BenchClockFunction clockFunc,
+    SCL_BenchResult* result) {
+    SCL_Board board;
+    uint8_t from, to;
+    char promotion;
+
+    SCL_boardFromFEN(board, SCL_benchPositions[positionIndex].fen);
+
+#if SCL_COUNT_EVALUATED_POSITIONS
+    SCL_positionsEvaluated = 0;
+#endif
+
+    uint32_t start = clockFunc();
+
+    int16_t value = SCL_getAIMove(
+        board,
+        depth,
+        0,
+        0,
+        SCL_boardEvaluateStatic,
+        0,
+        0,
+        255,
+        255,
+        &from,
+        &to,
+        &promotion);
+
+    result->timeMs = clockFunc() - start;
+    result->expected = 0;
+
+#if SCL_COUNT_EVALUATED_POSITIONS
+    result->nodes = SCL_positionsEvaluated;
+#else
+    result->nodes = 0;
+#endif
+
+    result->nodesPerSecond = _SCL_benchNodesPerSecond(result->nodes, result->timeMs);
+
+    return value;
+}
+
+#endif // guard
@@ -120,6 +120,10 @@ FlipChess* flipchess_app_alloc() {
     view_dispatcher_add_view(
         app->view_dispatcher, FlipChessViewIdTextInput, text_input_get_view(app->text_input));
 
+    app->text_box = text_box_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, FlipChessViewIdBench, text_box_get_view(app->text_box));
+
     //End Scene Additions
 
     return app;
@@ -132,12 +136,14 @@ void flipchess_app_free(FlipChess* app) {
     scene_manager_free(app->scene_manager);
 
     text_input_free(app->text_input);
+    text_box_free(app->text_box);
 
     // View Dispatcher
     view_dispatcher_remove_view(app->view_dispatcher, FlipChessViewIdMenu);
     view_dispatcher_remove_view(app->view_dispatcher, FlipChessViewIdScene1);
     view_dispatcher_remove_view(app->view_dispatcher, FlipChessViewIdSettings);
     view_dispatcher_remove_view(app->view_dispatcher, FlipChessViewIdTextInput);
+    view_dispatcher_remove_view(app->view_dispatcher, FlipChessViewIdBench);
     submenu_free(app->submenu);
 
     view_dispatcher_free(app->view_dispatcher);
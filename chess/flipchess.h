@@ -12,6 +12,7 @@
 #include <gui/scene_manager.h>
 #include <gui/modules/variable_item_list.h>
 #include <gui/modules/text_input.h>
+#include <gui/modules/text_box.h>
 #include "scenes/flipchess_scene.h"
 #include "views/flipchess_startscreen.h"
 #include "views/flipchess_scene_1.h"
@@ -29,6 +30,7 @@ typedef struct {
     SceneManager* scene_manager;
     VariableItemList* variable_item_list;
     TextInput* text_input;
+    TextBox* text_box;
     FlipChessStartscreen* flipchess_startscreen;
     FlipChessScene1* flipchess_scene_1;
     // Settings options
@@ -51,6 +53,7 @@ typedef enum {
     FlipChessViewIdScene1,
     FlipChessViewIdSettings,
     FlipChessViewIdTextInput,
+    FlipChessViewIdBench,
 } FlipChessViewId;
 
 typedef enum {
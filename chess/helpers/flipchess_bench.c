@@ -0,0 +1,74 @@
+#include "flipchess_bench.h"
+
+struct FlipChessBench {
+    FuriThread* thread;
+    FuriMutex* mutex;
+    FuriString* log;
+    volatile bool abort;
+    FlipChessBenchUpdateCallback callback;
+    void* context;
+};
+
+static void flipchess_bench_line_callback(const char* line, void* context) {
+    FlipChessBench* bench = context;
+
+    furi_mutex_acquire(bench->mutex, FuriWaitForever);
+    furi_string_cat_printf(bench->log, "%s\n", line);
+    furi_mutex_release(bench->mutex);
+
+    bench->callback(bench->context);
+}
+
+static int32_t flipchess_bench_worker(void* context) {
+    FlipChessBench* bench = context;
+
+    bool passed = flipchess_bench_run(flipchess_bench_line_callback, bench, &bench->abort);
+    if(!bench->abort) {
+        flipchess_bench_line_callback(passed ? "perft: PASS" : "perft: FAIL", bench);
+    }
+
+    return 0;
+}
+
+FlipChessBench* flipchess_bench_alloc(FlipChessBenchUpdateCallback callback, void* context) {
+    FlipChessBench* bench = malloc(sizeof(FlipChessBench));
+    bench->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    bench->log = furi_string_alloc();
+    bench->abort = false;
+    bench->callback = callback;
+    bench->context = context;
+    // perft recursion needs a board and a move set per ply
+    bench->thread =
+        furi_thread_alloc_ex("FlipChessBench", 4 * 1024, flipchess_bench_worker, bench);
+
+    return bench;
+}
+
+void flipchess_bench_free(FlipChessBench* bench) {
+    furi_assert(bench);
+
+    bench->abort = true;
+    if(furi_thread_get_state(bench->thread) != FuriThreadStateStopped) {
+        furi_thread_join(bench->thread);
+    }
+    furi_thread_free(bench->thread);
+    furi_string_free(bench->log);
+    furi_mutex_free(bench->mutex);
+    free(bench);
+}
+
+void flipchess_bench_start(FlipChessBench* bench) {
+    furi_assert(bench);
+
+    furi_string_set(bench->log, "");
+    bench->abort = false;
+    furi_thread_start(bench->thread);
+}
+
+void flipchess_bench_get_text(FlipChessBench* bench, FuriString* text) {
+    furi_assert(bench);
+
+    furi_mutex_acquire(bench->mutex, FuriWaitForever);
+    furi_string_set(text, bench->log);
+    furi_mutex_release(bench->mutex);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct FlipChessBench FlipChessBench;
+
+typedef void (*FlipChessBenchLineCallback)(const char* line, void* context);
+typedef void (*FlipChessBenchUpdateCallback)(void* context);
+
+/**
+ * Runs the perft and search benchmarks from smallchesslib_bench.h, reporting
+ * one line of text per result. Implemented next to the game view because
+ * smallchesslib can only be compiled into one translation unit.
+ * Returns false if any perft node count didn't match its reference value.
+ */
+bool flipchess_bench_run(
+    FlipChessBenchLineCallback callback,
+    void* context,
+    const volatile bool* abort);
+
+FlipChessBench* flipchess_bench_alloc(FlipChessBenchUpdateCallback callback, void* context);
+
+// stops the worker if it is still running
+void flipchess_bench_free(FlipChessBench* bench);
+
+void flipchess_bench_start(FlipChessBench* bench);
+
+// copies the results gathered so far into text
+void flipchess_bench_get_text(FlipChessBench* bench, FuriString* text);
@@ -13,4 +13,6 @@ typedef enum {
     FlipChessCustomEventScene1Right,
     FlipChessCustomEventScene1Ok,
     FlipChessCustomEventScene1Back,
+    // kept clear of the menu submenu indices, late updates can reach the menu scene
+    FlipChessCustomEventBenchUpdate = 100,
 } FlipChessCustomEvent;
\ No newline at end of file
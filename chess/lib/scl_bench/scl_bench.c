@@ -0,0 +1,88 @@
+// Host driver for smallchesslib_bench.h: perft on every position with reference node counts,
+// then fixed depth search with nodes per second. Same engine configuration as the game view,
+// so move generator changes can be checked for correctness and speed before going on device.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SCL_960_CASTLING 0
+#define SCL_EVALUATION_FUNCTION SCL_boardEvaluateStatic
+#define SCL_DEBUG_AI 0
+#define SCL_COUNT_EVALUATED_POSITIONS 1
+
+#include "smallchesslib.h"
+#include "smallchesslib_bench.h"
+
+#define DEFAULT_PERFT_DEPTH (4)
+#define DEFAULT_SEARCH_DEPTH (3)
+
+static uint32_t get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+int main(int argc, char** argv) {
+    int perft_depth = DEFAULT_PERFT_DEPTH;
+    int search_depth = DEFAULT_SEARCH_DEPTH;
+    int failures = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "p:s:h")) != -1) {
+        if(opt == 'p') {
+            perft_depth = atoi(optarg);
+        } else if(opt == 's') {
+            search_depth = atoi(optarg);
+        } else {
+            printf("Usage: %s [-p perft depth] [-s search depth]\n", argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    SCL_BenchResult result;
+    uint64_t total_nodes = 0, total_ms = 0;
+
+    for(uint8_t i = 0; i < SCL_BENCH_POSITION_COUNT && perft_depth > 0; i++) {
+        uint8_t ok = SCL_benchPerft(i, perft_depth, get_time_ms, &result);
+        if(!ok) failures++;
+        total_nodes += result.nodes;
+        total_ms += result.timeMs;
+        printf(
+            "perft  %-9s d%d %9lu %-9s %6lu ms %10lu nodes/s\n",
+            SCL_benchPositions[i].name,
+            perft_depth,
+            (unsigned long)result.nodes,
+            !result.expected ? "(no ref)" :
+            ok               ? "ok" :
+                               "BAD",
+            (unsigned long)result.timeMs,
+            (unsigned long)result.nodesPerSecond);
+        if(!ok) printf("       expected %lu\n", (unsigned long)result.expected);
+    }
+    if(total_ms) {
+        printf(
+            "perft  total %llu nodes, %llu nodes/s\n",
+            (unsigned long long)total_nodes,
+            (unsigned long long)(total_nodes * 1000 / total_ms));
+    }
+
+    for(uint8_t i = 0; i < SCL_BENCH_POSITION_COUNT && search_depth > 0; i++) {
+        int16_t value = SCL_benchSearch(i, search_depth, get_time_ms, &result);
+        printf(
+            "search %-9s d%d %9lu value %6d %6lu ms %10lu nodes/s\n",
+            SCL_benchPositions[i].name,
+            search_depth,
+            (unsigned long)result.nodes,
+            value,
+            (unsigned long)result.timeMs,
+            (unsigned long)result.nodesPerSecond);
+    }
+
+    if(failures) {
+        printf("%d perft counts don't match\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "../flipchess.h"
+#include "../helpers/flipchess_bench.h"
+#include "../helpers/flipchess_custom_event.h"
+
+static FlipChessBench* bench = NULL;
+static FuriString* bench_text = NULL;
+
+static void flipchess_scene_bench_update_callback(void* context) {
+    FlipChess* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, FlipChessCustomEventBenchUpdate);
+}
+
+void flipchess_scene_bench_on_enter(void* context) {
+    FlipChess* app = context;
+
+    bench_text = furi_string_alloc_set("Running perft...\n");
+    text_box_reset(app->text_box);
+    text_box_set_font(app->text_box, TextBoxFontText);
+    text_box_set_text(app->text_box, furi_string_get_cstr(bench_text));
+    view_dispatcher_switch_to_view(app->view_dispatcher, FlipChessViewIdBench);
+
+    bench = flipchess_bench_alloc(flipchess_scene_bench_update_callback, app);
+    flipchess_bench_start(bench);
+}
+
+bool flipchess_scene_bench_on_event(void* context, SceneManagerEvent event) {
+    FlipChess* app = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom &&
+       event.event == FlipChessCustomEventBenchUpdate) {
+        flipchess_bench_get_text(bench, bench_text);
+        text_box_set_text(app->text_box, furi_string_get_cstr(bench_text));
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void flipchess_scene_bench_on_exit(void* context) {
+    FlipChess* app = context;
+
+    flipchess_bench_free(bench);
+    bench = NULL;
+    text_box_reset(app->text_box);
+    furi_string_free(bench_text);
+    bench_text = NULL;
+}
@@ -5,6 +5,7 @@ enum SubmenuIndex {
     SubmenuIndexScene1Resume,
     SubmenuIndexScene1Import,
     SubmenuIndexSettings,
+    SubmenuIndexBench,
 };
 
 void flipchess_scene_menu_submenu_callback(void* context, uint32_t index) {
@@ -41,6 +42,12 @@ void flipchess_scene_menu_on_enter(void* context) {
     submenu_add_item(
         app->submenu, "Settings", SubmenuIndexSettings, flipchess_scene_menu_submenu_callback, app);
 
+    // hidden perft/search benchmark, only shown in debug mode
+    if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
+        submenu_add_item(
+            app->submenu, "Benchmark", SubmenuIndexBench, flipchess_scene_menu_submenu_callback, app);
+    }
+
     submenu_set_selected_item(
         app->submenu, scene_manager_get_scene_state(app->scene_manager, FlipChessSceneMenu));
 
@@ -80,6 +87,11 @@ bool flipchess_scene_menu_on_event(void* context, SceneManagerEvent event) {
                 app->scene_manager, FlipChessSceneMenu, SubmenuIndexSettings);
             scene_manager_next_scene(app->scene_manager, FlipChessSceneSettings);
             return true;
+        } else if(event.event == SubmenuIndexBench) {
+            scene_manager_set_scene_state(
+                app->scene_manager, FlipChessSceneMenu, SubmenuIndexBench);
+            scene_manager_next_scene(app->scene_manager, FlipChessSceneBench);
+            return true;
         }
     }
     return false;
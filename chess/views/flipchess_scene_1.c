@@ -9,18 +9,23 @@
 //#include "flipchess_icons.h"
 #include "../helpers/flipchess_voice.h"
 #include "../helpers/flipchess_haptic.h"
+#include "../helpers/flipchess_bench.h"
 
 #define SCL_960_CASTLING 0 // setting to 1 compiles a 960 version of smolchess
 #define XBOARD_DEBUG 0 // will create files with xboard communication
 #define SCL_EVALUATION_FUNCTION SCL_boardEvaluateStatic
 #define SCL_DEBUG_AI 0
+#define SCL_COUNT_EVALUATED_POSITIONS 1 // needed for search benchmark node counts
 
 #include "../chess/smallchesslib.h"
+#include "../chess/smallchesslib_bench.h"
 
 #define ENABLE_960 0 // setting to 1 enables 960 chess
 #define MAX_TEXT_LEN 15 // 15 = max length of text
 #define MAX_TEXT_BUF (MAX_TEXT_LEN + 1) // max length of text + null terminator
 #define THREAD_WAIT_TIME 20 // time to wait for draw thread to finish
+#define BENCH_PERFT_DEPTH 3 // perft depth for the on-device benchmark
+#define BENCH_SEARCH_DEPTH 2 // AI search depth for the on-device benchmark
 
 struct FlipChessScene1 {
     View* view;
@@ -724,4 +729,49 @@ void flipchess_scene_1_free(FlipChessScene1* instance) {
 View* flipchess_scene_1_get_view(FlipChessScene1* instance) {
     furi_assert(instance);
     return instance->view;
-}
\ No newline at end of file
+}
+
+static uint32_t flipchess_bench_clock() {
+    // ticks * 1000 overflows 32 bits after ~71 minutes of uptime, only differences are used so
+    // it is fine for the result to wrap
+    return (uint64_t)furi_get_tick() * 1000 / furi_kernel_get_tick_frequency();
+}
+
+bool flipchess_bench_run(
+    FlipChessBenchLineCallback callback,
+    void* context,
+    const volatile bool* abort) {
+    char line[48];
+    bool passed = true;
+    SCL_BenchResult result;
+
+    for(uint8_t i = 0; i < SCL_BENCH_POSITION_COUNT && !*abort; i++) {
+        bool ok = SCL_benchPerft(i, BENCH_PERFT_DEPTH, flipchess_bench_clock, &result);
+        passed &= ok;
+        snprintf(
+            line,
+            sizeof(line),
+            "p %s d%u %lu %s %lu/s",
+            SCL_benchPositions[i].name,
+            BENCH_PERFT_DEPTH,
+            result.nodes,
+            ok ? "ok" : "BAD",
+            result.nodesPerSecond);
+        callback(line, context);
+    }
+
+    for(uint8_t i = 0; i < SCL_BENCH_POSITION_COUNT && !*abort; i++) {
+        SCL_benchSearch(i, BENCH_SEARCH_DEPTH, flipchess_bench_clock, &result);
+        snprintf(
+            line,
+            sizeof(line),
+            "s %s d%u %lu %lu/s",
+            SCL_benchPositions[i].name,
+            BENCH_SEARCH_DEPTH,
+            result.nodes,
+            result.nodesPerSecond);
+        callback(line, context);
+    }
+
+    return passed;
+}
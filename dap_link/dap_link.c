@@ -113,14 +113,44 @@ static void dap_app_process_v1() {
     dap_v1_usb_tx(tx_packet.data, DAP_CONFIG_PACKET_SIZE);
 }
 
-static void dap_app_process_v2() {
+_Static_assert(
+    DAP_CONFIG_PACKET_COUNT <= DAP_V2_USB_PACKET_COUNT,
+    "DAP packet count exceeds USB queue depth");
+
+// QueueCommands packets are held until a non-queued packet arrives or the queue is full
+static DapPacket dap_v2_queue[DAP_CONFIG_PACKET_COUNT];
+static size_t dap_v2_queue_count = 0;
+
+static uint32_t dap_app_process_v2() {
+    uint32_t processed = 0;
     DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
-    rx_packet.size = dap_v2_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    size_t len = dap_process_request(
-        rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v2_usb_tx(tx_packet.data, len);
+
+    while(1) {
+        DapPacket* rx_packet = &dap_v2_queue[dap_v2_queue_count];
+        rx_packet->size = dap_v2_usb_rx(rx_packet->data, DAP_CONFIG_PACKET_SIZE);
+        if(!rx_packet->size) break;
+
+        dap_v2_queue_count++;
+        if(dap_is_queued_request(rx_packet->data) &&
+           dap_v2_queue_count < DAP_CONFIG_PACKET_COUNT) {
+            continue;
+        }
+
+        for(size_t i = 0; i < dap_v2_queue_count; i++) {
+            memset(&tx_packet, 0, sizeof(DapPacket));
+            size_t len = dap_process_request(
+                dap_v2_queue[i].data,
+                dap_v2_queue[i].size,
+                tx_packet.data,
+                DAP_CONFIG_PACKET_SIZE);
+            dap_v2_usb_tx(tx_packet.data, len);
+        }
+
+        processed += dap_v2_queue_count;
+        dap_v2_queue_count = 0;
+    }
+
+    return processed;
 }
 
 void dap_app_vendor_cmd(uint8_t cmd) {
@@ -205,6 +235,7 @@ static int32_t dap_process(void* p) {
     dap_common_usb_set_context(furi_thread_get_id(furi_thread_get_current()));
     dap_v1_usb_set_rx_callback(dap_app_rx1_callback);
     dap_v2_usb_set_rx_callback(dap_app_rx2_callback);
+    dap_v2_usb_set_rx_filter(dap_filter_request);
     dap_common_usb_set_state_callback(dap_app_usb_state_callback);
     furi_hal_usb_set_config(&dap_v2_usb_hid, NULL);
 
@@ -221,8 +252,7 @@ static int32_t dap_process(void* p) {
             }
 
             if(events & DapThreadEventRxV2) {
-                dap_app_process_v2();
-                dap_state->dap_counter++;
+                dap_state->dap_counter += dap_app_process_v2();
                 dap_state->dap_version = DapVersionV2;
             }
 
@@ -233,6 +263,7 @@ static int32_t dap_process(void* p) {
             if(events & DapThreadEventUsbDisconnect) {
                 dap_state->usb_connected = false;
                 dap_state->dap_version = DapVersionUnknown;
+                dap_v2_queue_count = 0;
             }
 
             if(events & DapThreadEventApplyConfig) {
@@ -251,6 +251,7 @@ static int dap_req_ptr;
 static uint8_t *dap_resp_buf;
 static int dap_resp_size;
 static int dap_resp_ptr;
+static int dap_resp_cmd;
 
 static bool dap_buf_error;
 
@@ -698,6 +699,7 @@ static void dap_buf_init(uint8_t *req, int req_size, uint8_t *resp, int resp_siz
   dap_resp_buf  = resp;
   dap_resp_size = resp_size;
   dap_resp_ptr  = 0;
+  dap_resp_cmd  = 0;
 
   dap_buf_error = false;
 }
@@ -781,6 +783,9 @@ void dap_resp_add_word(uint32_t value)
 //-----------------------------------------------------------------------------
 void dap_resp_set_byte(int index, uint8_t value)
 {
+  // Index is relative to the response of the command being processed
+  index += dap_resp_cmd;
+
   if (index < dap_resp_ptr)
     dap_resp_buf[index] = value;
 }
@@ -798,7 +803,7 @@ static void dap_info(void)
 
   if (DAP_INFO_CAPABILITIES == index)
   {
-    int cap = DAP_CAP_SWD;
+    int cap = DAP_CAP_SWD | DAP_CAP_ATOMIC_CMD;
 #ifdef DAP_CONFIG_ENABLE_JTAG
     cap |= DAP_CAP_JTAG;
 #endif
@@ -830,7 +835,7 @@ static void dap_info(void)
           dap_resp_add_byte(*str++);
         dap_resp_add_byte(0);
 
-        dap_resp_set_byte(1, dap_resp_ptr-2);
+        dap_resp_set_byte(1, dap_resp_ptr - dap_resp_cmd - 2);
 
         break;
       }
@@ -1424,7 +1429,13 @@ bool dap_filter_request(uint8_t *req)
 }
 
 //-----------------------------------------------------------------------------
-int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size)
+bool dap_is_queued_request(uint8_t *req)
+{
+  return ID_DAP_QUEUE_COMMANDS == req[0];
+}
+
+//-----------------------------------------------------------------------------
+static void dap_process_command(int cmd)
 {
   static const struct
   {
@@ -1452,17 +1463,8 @@ int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size
     { ID_DAP_JTAG_CONFIGURE,		dap_jtag_configure },
     { ID_DAP_JTAG_IDCODE,		dap_jtag_idcode },
   };
-  int cmd;
+  dap_resp_cmd = dap_resp_ptr;
 
-  dap_buf_init(req, req_size, resp, resp_size);
-
-  dap_abort = false;
-
-#ifdef DAP_CONFIG_ENABLE_JTAG
-  dap_jtag_ir = JTAG_INVALID;
-#endif
-
-  cmd = dap_req_get_byte();
   dap_resp_add_byte(cmd);
 
   for (int i = 0; i < ARRAY_SIZE(handlers); i++)
@@ -1470,7 +1472,7 @@ int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size
     if (cmd == handlers[i].cmd)
     {
       handlers[i].handler();
-      return dap_resp_ptr;
+      return;
     }
   }
 
@@ -1481,10 +1483,61 @@ int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size
 #else
     dap_resp_add_byte(DAP_ERROR);
 #endif
-    return dap_resp_ptr;
+    return;
   }
 
   dap_resp_set_byte(0, ID_DAP_INVALID);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_execute_commands(void)
+{
+  int count = dap_req_get_byte();
+  int executed = 0;
+
+  dap_resp_add_byte(0); // Count
+
+  // Commands can't be nested, stop at the first one that doesn't fit
+  for (int i = 0; i < count && !dap_buf_error; i++)
+  {
+    int cmd = dap_req_get_byte();
+
+    if (dap_buf_error || ID_DAP_QUEUE_COMMANDS == cmd || ID_DAP_EXECUTE_COMMANDS == cmd)
+      break;
+
+    dap_process_command(cmd);
+    executed++;
+  }
+
+  dap_resp_cmd = 0;
+  dap_resp_set_byte(1, executed);
+}
+
+//-----------------------------------------------------------------------------
+int dap_process_request(uint8_t *req, int req_size, uint8_t *resp, int resp_size)
+{
+  int cmd;
+
+  dap_buf_init(req, req_size, resp, resp_size);
+
+  dap_abort = false;
+
+#ifdef DAP_CONFIG_ENABLE_JTAG
+  dap_jtag_ir = JTAG_INVALID;
+#endif
+
+  cmd = dap_req_get_byte();
+
+  // Queued packets are held back by the caller and executed the same way,
+  // hosts expect ExecuteCommands responses to both, as the reference firmware sends
+  if (ID_DAP_QUEUE_COMMANDS == cmd || ID_DAP_EXECUTE_COMMANDS == cmd)
+  {
+    dap_resp_add_byte(ID_DAP_EXECUTE_COMMANDS);
+    dap_execute_commands();
+    return dap_resp_ptr;
+  }
+
+  dap_process_command(cmd);
 
   return dap_resp_ptr;
 }
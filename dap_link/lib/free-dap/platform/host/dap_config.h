@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef _DAP_CONFIG_H_
+#define _DAP_CONFIG_H_
+
+/*- Includes ----------------------------------------------------------------*/
+#include "swd_sim.h"
+
+/*- Definitions -------------------------------------------------------------*/
+#define DAP_CONFIG_DEFAULT_PORT        DAP_PORT_SWD
+#define DAP_CONFIG_DEFAULT_CLOCK       4200000 // Hz
+
+// Packet geometry matches the Flipper v2 bulk endpoint unless overridden
+#ifndef DAP_CONFIG_PACKET_SIZE
+#define DAP_CONFIG_PACKET_SIZE         64
+#endif
+#ifndef DAP_CONFIG_PACKET_COUNT
+#define DAP_CONFIG_PACKET_COUNT        8
+#endif
+
+#define DAP_CONFIG_JTAG_DEV_COUNT      8
+
+// DAP_CONFIG_PRODUCT_STR must contain "CMSIS-DAP" to be compatible with the standard
+#define DAP_CONFIG_VENDOR_STR          "Host"
+#define DAP_CONFIG_PRODUCT_STR         "Simulated CMSIS-DAP Adapter"
+#define DAP_CONFIG_SER_NUM_STR         "SIM"
+#define DAP_CONFIG_CMSIS_DAP_VER_STR   "2.0.0"
+
+// Attribute to use for performance-critical functions
+#define DAP_CONFIG_PERFORMANCE_ATTR
+
+// Delay loop is not executed, its iterations are counted by the simulator and
+// converted into an estimated target time using these values
+#ifndef DAP_CONFIG_DELAY_CONSTANT
+#define DAP_CONFIG_DELAY_CONSTANT      6290
+#endif
+
+#ifndef DAP_CONFIG_FAST_CLOCK
+#define DAP_CONFIG_FAST_CLOCK          2400000 // Hz
+#endif
+
+/*- Implementations ---------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWCLK_TCK_write(int value)
+{
+  swd_sim_swclk_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_write(int value)
+{
+  swd_sim_swdio_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_TDI_write(int value)
+{
+  (void)value;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_TDO_write(int value)
+{
+  (void)value;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_nTRST_write(int value)
+{
+  (void)value;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_nRESET_write(int value)
+{
+  swd_sim_nreset_write(value);
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_SWCLK_TCK_read(void)
+{
+  return swd_sim_swclk_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_SWDIO_TMS_read(void)
+{
+  return swd_sim_swdio_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_TDI_read(void)
+{
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_TDO_read(void)
+{
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_nTRST_read(void)
+{
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+static inline int DAP_CONFIG_nRESET_read(void)
+{
+  return swd_sim_nreset_read();
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWCLK_TCK_set(void)
+{
+  swd_sim_swclk_write(1);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWCLK_TCK_clr(void)
+{
+  swd_sim_swclk_write(0);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_in(void)
+{
+  swd_sim_swdio_dir(false);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SWDIO_TMS_out(void)
+{
+  swd_sim_swdio_dir(true);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_SETUP(void)
+{
+  swd_sim_swdio_dir(false);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_DISCONNECT(void)
+{
+  swd_sim_swdio_dir(false);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_CONNECT_SWD(void)
+{
+  swd_sim_swdio_dir(true);
+  swd_sim_swdio_write(1);
+  swd_sim_swclk_write(1);
+  swd_sim_nreset_write(1);
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_CONNECT_JTAG(void)
+{
+  DAP_CONFIG_CONNECT_SWD();
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_LED(int index, int state)
+{
+  (void)index;
+  (void)state;
+}
+
+//-----------------------------------------------------------------------------
+static inline void DAP_CONFIG_DELAY(uint32_t cycles)
+{
+  swd_sim_delay(cycles);
+}
+
+#endif // _DAP_CONFIG_H_
@@ -0,0 +1,534 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*- Includes ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "dap.h"
+#include "dap_config.h"
+#include "swd_sim.h"
+
+/*- Definitions -------------------------------------------------------------*/
+#define ID_DAP_CONNECT            0x02
+#define ID_DAP_TRANSFER_CONFIGURE 0x04
+#define ID_DAP_TRANSFER           0x05
+#define ID_DAP_TRANSFER_BLOCK     0x06
+#define ID_DAP_SWJ_CLOCK          0x11
+#define ID_DAP_SWJ_SEQUENCE       0x12
+#define ID_DAP_SWD_CONFIGURE      0x13
+#define ID_DAP_QUEUE_COMMANDS     0x7e
+#define ID_DAP_EXECUTE_COMMANDS   0x7f
+
+#define DAP_PORT_SWD              1
+#define DAP_TRANSFER_OK           1
+
+#define REQ_AP                    (1 << 0)
+#define REQ_READ                  (1 << 1)
+#define REQ_A(x)                  ((x) & 0xc)
+
+#define DP_IDCODE                 0x00
+#define DP_ABORT                  0x00
+#define DP_CTRL_STAT              0x04
+#define DP_SELECT                 0x08
+#define AP_CSW                    0x00
+#define AP_TAR                    0x04
+#define AP_DRW                    0x0c
+
+#define CSW_WORD_AUTOINC          0x23000052
+#define CSW_WORD_NOINC            0x23000002
+
+#define TAR_BLOCK_SIZE            1024
+
+#define DEFAULT_MEM_SIZE          (64 * 1024)
+#define DEFAULT_SINGLE_WORDS      1024
+
+// DAP_Transfer with a TAR write and a DRW read, and its response
+#define QUEUED_TRANSFER_REQ_SIZE  9
+#define QUEUED_TRANSFER_RESP_SIZE 7
+#define QUEUED_PER_PACKET         ((DAP_CONFIG_PACKET_SIZE - 2) / QUEUED_TRANSFER_REQ_SIZE)
+
+/*- Types -------------------------------------------------------------------*/
+typedef struct
+{
+  const char   *name;
+  uint32_t     words;
+  uint32_t     packets;
+  double       wall;
+  swd_sim_stats_t stats;
+} bench_result_t;
+
+/*- Variables ---------------------------------------------------------------*/
+static uint8_t app_request[DAP_CONFIG_PACKET_SIZE];
+static uint8_t app_response[DAP_CONFIG_PACKET_SIZE];
+static uint32_t app_packets;
+static uint32_t app_clock = DAP_CONFIG_DEFAULT_CLOCK;
+static uint8_t app_queue[DAP_CONFIG_PACKET_COUNT][DAP_CONFIG_PACKET_SIZE];
+static int app_queue_size[DAP_CONFIG_PACKET_COUNT];
+
+/*- Implementations ---------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+static double get_time(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+static void error_exit(const char *text)
+{
+  fprintf(stderr, "Error: %s\n", text);
+  exit(1);
+}
+
+//-----------------------------------------------------------------------------
+static void put_word(uint8_t *buf, uint32_t value)
+{
+  buf[0] = value;
+  buf[1] = value >> 8;
+  buf[2] = value >> 16;
+  buf[3] = value >> 24;
+}
+
+//-----------------------------------------------------------------------------
+static uint32_t get_word(uint8_t *buf)
+{
+  return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+//-----------------------------------------------------------------------------
+static int dap_command(int size)
+{
+  app_packets++;
+  return dap_process_request(app_request, size, app_response, DAP_CONFIG_PACKET_SIZE);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_simple_command(int size)
+{
+  dap_command(size);
+
+  if (app_response[0] != app_request[0] || app_response[1] == 0xff)
+    error_exit("command failed");
+}
+
+//-----------------------------------------------------------------------------
+static void dap_swj_sequence(int bits, uint8_t *data)
+{
+  app_request[0] = ID_DAP_SWJ_SEQUENCE;
+  app_request[1] = bits;
+  memcpy(&app_request[2], data, (bits + 7) / 8);
+  dap_simple_command(2 + (bits + 7) / 8);
+}
+
+//-----------------------------------------------------------------------------
+static void dap_transfer(int count, const uint8_t *reqs, uint32_t *data)
+{
+  int size = 3, reads = 0;
+
+  app_request[0] = ID_DAP_TRANSFER;
+  app_request[1] = 0;
+  app_request[2] = count;
+
+  for (int i = 0; i < count; i++)
+  {
+    app_request[size++] = reqs[i];
+
+    if (0 == (reqs[i] & REQ_READ))
+    {
+      put_word(&app_request[size], data[i]);
+      size += 4;
+    }
+  }
+
+  dap_command(size);
+
+  if (app_response[1] != count || app_response[2] != DAP_TRANSFER_OK)
+    error_exit("transfer failed");
+
+  for (int i = 0; i < count; i++)
+  {
+    if (reqs[i] & REQ_READ)
+      data[i] = get_word(&app_response[3 + 4 * reads++]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+static void dap_transfer_block(int req, int count, uint32_t *data)
+{
+  int size = 5;
+
+  app_request[0] = ID_DAP_TRANSFER_BLOCK;
+  app_request[1] = 0;
+  app_request[2] = count;
+  app_request[3] = count >> 8;
+  app_request[4] = req;
+
+  if (0 == (req & REQ_READ))
+  {
+    for (int i = 0; i < count; i++, size += 4)
+      put_word(&app_request[size], data[i]);
+  }
+
+  dap_command(size);
+
+  if ((app_response[1] | (app_response[2] << 8)) != count ||
+      app_response[3] != DAP_TRANSFER_OK)
+    error_exit("block transfer failed");
+
+  if (req & REQ_READ)
+  {
+    for (int i = 0; i < count; i++)
+      data[i] = get_word(&app_response[4 + i * 4]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+static void target_connect(void)
+{
+  uint8_t line_reset[7] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+  uint8_t jtag_to_swd[2] = { 0x9e, 0xe7 };
+  uint8_t idle[1] = { 0x00 };
+  uint8_t reqs[4];
+  uint32_t data[4];
+
+  app_request[0] = ID_DAP_CONNECT;
+  app_request[1] = DAP_PORT_SWD;
+  dap_command(2);
+
+  if (DAP_PORT_SWD != app_response[1])
+    error_exit("connect failed");
+
+  app_request[0] = ID_DAP_SWJ_CLOCK;
+  put_word(&app_request[1], app_clock);
+  dap_simple_command(5);
+
+  app_request[0] = ID_DAP_TRANSFER_CONFIGURE;
+  app_request[1] = 0;   // Idle cycles
+  app_request[2] = 100; // WAIT retry
+  app_request[3] = 0;
+  app_request[4] = 0;   // Match retry
+  app_request[5] = 0;
+  dap_simple_command(6);
+
+  app_request[0] = ID_DAP_SWD_CONFIGURE;
+  app_request[1] = 0;
+  dap_simple_command(2);
+
+  dap_swj_sequence(51, line_reset);
+  dap_swj_sequence(16, jtag_to_swd);
+  dap_swj_sequence(51, line_reset);
+  dap_swj_sequence(8, idle);
+
+  reqs[0] = REQ_READ | REQ_A(DP_IDCODE);
+  dap_transfer(1, reqs, data);
+
+  if (SWD_SIM_IDCODE != data[0])
+    error_exit("unexpected IDCODE");
+
+  reqs[0] = REQ_A(DP_ABORT);
+  data[0] = 0x1e;
+  reqs[1] = REQ_A(DP_SELECT);
+  data[1] = 0;
+  reqs[2] = REQ_A(DP_CTRL_STAT);
+  data[2] = 0x50000000;
+  reqs[3] = REQ_READ | REQ_A(DP_CTRL_STAT);
+  dap_transfer(4, reqs, data);
+
+  if (0xf0000000 != (data[3] & 0xf0000000))
+    error_exit("power up failed");
+}
+
+//-----------------------------------------------------------------------------
+static void target_set_tar(uint32_t csw, uint32_t addr)
+{
+  uint8_t reqs[2] = { REQ_AP | REQ_A(AP_CSW), REQ_AP | REQ_A(AP_TAR) };
+  uint32_t data[2] = { csw, addr };
+
+  dap_transfer(2, reqs, data);
+}
+
+//-----------------------------------------------------------------------------
+// Same split as OpenOCD: TAR is written once per 1 KB block, then the block
+// is streamed through DRW with TAR auto-increment, as many words per packet
+// as fit into a request (writes) or a response (reads).
+static uint32_t target_mem_block(uint32_t addr, uint32_t *data, uint32_t words, bool read)
+{
+  int max = read ? (DAP_CONFIG_PACKET_SIZE - 4) / 4 : (DAP_CONFIG_PACKET_SIZE - 5) / 4;
+  int req = REQ_AP | REQ_A(AP_DRW) | (read ? REQ_READ : 0);
+  uint32_t done = 0;
+
+  while (done < words)
+  {
+    uint32_t block = (TAR_BLOCK_SIZE - (addr & (TAR_BLOCK_SIZE - 1))) / 4;
+
+    if (block > words - done)
+      block = words - done;
+
+    target_set_tar(CSW_WORD_AUTOINC, addr);
+
+    for (uint32_t i = 0; i < block;)
+    {
+      int count = (block - i) < (uint32_t)max ? (int)(block - i) : max;
+
+      dap_transfer_block(req, count, &data[done + i]);
+      i += count;
+    }
+
+    addr += block * 4;
+    done += block;
+  }
+
+  return done;
+}
+
+//-----------------------------------------------------------------------------
+// Word by word access with TAR written for every word, as done by debuggers
+// when auto-increment can't be used
+static uint32_t target_mem_single(uint32_t addr, uint32_t *data, uint32_t words)
+{
+  uint8_t reqs[2] = { REQ_AP | REQ_A(AP_TAR), REQ_AP | REQ_READ | REQ_A(AP_DRW) };
+  uint32_t buf[2];
+
+  target_set_tar(CSW_WORD_NOINC, addr);
+
+  for (uint32_t i = 0; i < words; i++)
+  {
+    buf[0] = addr + i * 4;
+    dap_transfer(2, reqs, buf);
+    data[i] = buf[1];
+  }
+
+  return words;
+}
+
+//-----------------------------------------------------------------------------
+// Checks the response to a packet of queued_count word reads, see target_mem_queued()
+static void queued_response(uint32_t *data, int queued_count)
+{
+  if (ID_DAP_EXECUTE_COMMANDS != app_response[0] || queued_count != app_response[1])
+    error_exit("queued commands failed");
+
+  for (int i = 0; i < queued_count; i++)
+  {
+    uint8_t *resp = &app_response[2 + i * QUEUED_TRANSFER_RESP_SIZE];
+
+    if (ID_DAP_TRANSFER != resp[0] || 2 != resp[1] || DAP_TRANSFER_OK != resp[2])
+      error_exit("queued transfer failed");
+
+    data[i] = get_word(&resp[3]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Word by word reads batched the way pyOCD does it: a stream of QueueCommands
+// packets closed by an ExecuteCommands one. As the firmware does, queued
+// packets are held back until a packet that isn't queued arrives or the
+// queue is full, then all of them are executed in order.
+static uint32_t target_mem_queued(uint32_t addr, uint32_t *data, uint32_t words)
+{
+  int held = 0;
+  uint32_t done = 0, answered = 0;
+
+  target_set_tar(CSW_WORD_NOINC, addr);
+
+  while (done < words)
+  {
+    int count = (words - done) < QUEUED_PER_PACKET ? (int)(words - done) : QUEUED_PER_PACKET;
+    uint8_t *req = app_queue[held];
+    int size = 2;
+
+    req[0] = (done + count < words) ? ID_DAP_QUEUE_COMMANDS : ID_DAP_EXECUTE_COMMANDS;
+    req[1] = count;
+
+    for (int i = 0; i < count; i++)
+    {
+      req[size++] = ID_DAP_TRANSFER;
+      req[size++] = 0;
+      req[size++] = 2;
+      req[size++] = REQ_AP | REQ_A(AP_TAR);
+      put_word(&req[size], addr + (done + i) * 4);
+      size += 4;
+      req[size++] = REQ_AP | REQ_READ | REQ_A(AP_DRW);
+    }
+
+    app_queue_size[held++] = size;
+    done += count;
+
+    if (ID_DAP_QUEUE_COMMANDS == req[0] && held < DAP_CONFIG_PACKET_COUNT)
+      continue;
+
+    for (int i = 0; i < held; i++)
+    {
+      count = app_queue[i][1];
+      memcpy(app_request, app_queue[i], app_queue_size[i]);
+      dap_command(app_queue_size[i]);
+      queued_response(&data[answered], count);
+      answered += count;
+    }
+
+    held = 0;
+  }
+
+  return words;
+}
+
+//-----------------------------------------------------------------------------
+static void bench_start(bench_result_t *result, const char *name)
+{
+  result->name = name;
+  result->packets = app_packets;
+  swd_sim_reset_stats();
+  result->wall = get_time();
+}
+
+//-----------------------------------------------------------------------------
+static void bench_stop(bench_result_t *result, uint32_t words)
+{
+  result->wall = get_time() - result->wall;
+  result->packets = app_packets - result->packets;
+  result->words = words;
+  result->stats = *swd_sim_stats();
+}
+
+//-----------------------------------------------------------------------------
+// DAP_CONFIG_DELAY_CONSTANT is the delay at which a full SWCLK period takes
+// 1 ms, above DAP_CONFIG_FAST_CLOCK no delays are inserted at all
+static double bench_target_time(swd_sim_stats_t *stats)
+{
+  if (app_clock > DAP_CONFIG_FAST_CLOCK)
+    return (double)stats->clock_cycles / DAP_CONFIG_FAST_CLOCK;
+
+  return (double)stats->delay_cycles / (2000.0 * DAP_CONFIG_DELAY_CONSTANT);
+}
+
+//-----------------------------------------------------------------------------
+static void bench_print(bench_result_t *result)
+{
+  swd_sim_stats_t *stats = &result->stats;
+  double target = bench_target_time(stats);
+
+  printf("%-16s %8u %7u %10.0f %9.1f %12.1f %9.1f %6u\n",
+      result->name, result->words, result->packets,
+      result->words / result->wall,
+      (double)stats->clock_cycles / result->words,
+      target > 0 ? result->words / target : 0,
+      target > 0 ? result->words * 4 / target / 1024 : 0,
+      stats->ack_wait);
+}
+
+//-----------------------------------------------------------------------------
+static void print_help(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -c <hz>     SWCLK frequency requested with DAP_SWJ_Clock (default %d)\n",
+      DAP_CONFIG_DEFAULT_CLOCK);
+  printf("  -s <bytes>  size of the block transfers (default %d)\n", DEFAULT_MEM_SIZE);
+  printf("  -w <count>  WAIT responses before every AP access (default 0)\n");
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  uint32_t size = DEFAULT_MEM_SIZE;
+  uint32_t *pattern, *data;
+  uint32_t words, single;
+  bench_result_t results[5];
+  uint32_t errors = 0, faults = 0;
+  int wait = 0, opt;
+
+  while ((opt = getopt(argc, argv, "c:s:w:h")) != -1)
+  {
+    if ('c' == opt)
+      app_clock = strtoul(optarg, NULL, 0);
+    else if ('s' == opt)
+      size = strtoul(optarg, NULL, 0) & ~3u;
+    else if ('w' == opt)
+      wait = strtoul(optarg, NULL, 0);
+    else
+    {
+      print_help(argv[0]);
+      return 'h' == opt ? 0 : 1;
+    }
+  }
+
+  if (0 == size || 0 == app_clock)
+    error_exit("invalid arguments");
+
+  words = size / 4;
+  single = words < DEFAULT_SINGLE_WORDS ? words : DEFAULT_SINGLE_WORDS;
+  pattern = malloc(size);
+  data = malloc(size);
+
+  if (!pattern || !data)
+    error_exit("out of memory");
+
+  for (uint32_t i = 0; i < words; i++)
+    pattern[i] = i * 0x9e3779b9 ^ (i >> 3);
+
+  swd_sim_init(size);
+  swd_sim_set_wait_count(wait);
+  dap_init();
+
+  bench_start(&results[0], "connect");
+  target_connect();
+  bench_stop(&results[0], 1);
+
+  bench_start(&results[1], "block write");
+  target_mem_block(SWD_SIM_MEM_BASE, pattern, words, false);
+  bench_stop(&results[1], words);
+
+  if (memcmp(swd_sim_memory(), pattern, size))
+    error_exit("target memory does not match written data");
+
+  bench_start(&results[2], "block read");
+  target_mem_block(SWD_SIM_MEM_BASE, data, words, true);
+  bench_stop(&results[2], words);
+
+  if (memcmp(data, pattern, size))
+    error_exit("block read does not match target memory");
+
+  bench_start(&results[3], "single read");
+  target_mem_single(SWD_SIM_MEM_BASE, data, single);
+  bench_stop(&results[3], single);
+
+  if (memcmp(data, pattern, single * 4))
+    error_exit("single read does not match target memory");
+
+  memset(data, 0, single * 4);
+  bench_start(&results[4], "queued read");
+  target_mem_queued(SWD_SIM_MEM_BASE, data, single);
+  bench_stop(&results[4], single);
+
+  if (memcmp(data, pattern, single * 4))
+    error_exit("queued read does not match target memory");
+
+  printf("SWCLK %u Hz, packet %d bytes, DELAY_CONSTANT %d, FAST_CLOCK %d Hz, WAIT %d\n\n",
+      app_clock, DAP_CONFIG_PACKET_SIZE, DAP_CONFIG_DELAY_CONSTANT, DAP_CONFIG_FAST_CLOCK, wait);
+  printf("%-16s %8s %7s %10s %9s %12s %9s %6s\n", "test", "words", "packets",
+      "host wps", "clk/word", "target wps", "KiB/s", "waits");
+
+  for (int i = 0; i < 5; i++)
+    bench_print(&results[i]);
+
+  // Connect sequence is excluded, JTAG-to-SWD is expected to look like a bad request
+  for (int i = 1; i < 5; i++)
+  {
+    errors += results[i].stats.protocol_errors;
+    faults += results[i].stats.ack_fault;
+  }
+
+  printf("\nprotocol errors: %u, faults: %u\n", errors, faults);
+
+  free(pattern);
+  free(data);
+
+  return (errors || faults) ? 1 : 0;
+}
@@ -0,0 +1,516 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+/*- Includes ----------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "swd_sim.h"
+
+/*- Definitions -------------------------------------------------------------*/
+#define SWD_TURNAROUND         1
+#define SWD_LINE_RESET_BITS    50
+
+#define SWD_ACK_OK             0x1
+#define SWD_ACK_WAIT           0x2
+#define SWD_ACK_FAULT          0x4
+
+#define DP_ABORT_STKCMPCLR     (1 << 1)
+#define DP_ABORT_STKERRCLR     (1 << 2)
+#define DP_ABORT_WDERRCLR      (1 << 3)
+#define DP_ABORT_ORUNERRCLR    (1 << 4)
+
+#define DP_CTRL_STICKYORUN     (1 << 1)
+#define DP_CTRL_STICKYCMP      (1 << 4)
+#define DP_CTRL_STICKYERR      (1 << 5)
+#define DP_CTRL_WDATAERR       (1 << 7)
+#define DP_CTRL_CDBGPWRUPREQ   (1 << 28)
+#define DP_CTRL_CSYSPWRUPREQ   (1 << 30)
+#define DP_CTRL_STICKY_MASK    (DP_CTRL_STICKYORUN | DP_CTRL_STICKYCMP | \
+                                DP_CTRL_STICKYERR | DP_CTRL_WDATAERR)
+
+#define AP_CSW                 0x00
+#define AP_TAR                 0x04
+#define AP_DRW                 0x0c
+#define AP_BD0                 0x10
+#define AP_BD3                 0x1c
+#define AP_BASE                0xf8
+#define AP_IDR                 0xfc
+
+#define AP_CSW_SIZE_MASK       0x7
+#define AP_CSW_ADDRINC_SINGLE  (1 << 4)
+#define AP_CSW_DEVICEEN        (1 << 6)
+
+#define AP_BASE_VALUE          0xe00ff003
+
+/*- Types -------------------------------------------------------------------*/
+enum
+{
+  SWD_STATE_LOCKOUT,
+  SWD_STATE_RESET,
+  SWD_STATE_IDLE,
+  SWD_STATE_HEADER,
+  SWD_STATE_RESPONSE,
+};
+
+/*- Variables ---------------------------------------------------------------*/
+static swd_sim_stats_t sim_stats;
+
+static int sim_swclk;
+static int sim_swdio;
+static bool sim_host_drives;
+static int sim_nreset;
+
+static int sim_state;
+static int sim_ones;
+static uint32_t sim_header;
+static int sim_header_bits;
+static int sim_cycle;
+static int sim_end_cycle;
+static bool sim_apndp;
+static bool sim_rnw;
+static int sim_addr;
+static int sim_ack;
+static uint32_t sim_data;
+static int sim_wait_count;
+static int sim_wait_left;
+
+static uint32_t dp_ctrl;
+static uint32_t dp_select;
+static uint32_t dp_rdbuff;
+static uint32_t dp_resend;
+
+static uint32_t ap_csw;
+static uint32_t ap_tar;
+
+static uint8_t *sim_mem;
+static uint32_t sim_mem_size;
+
+/*- Implementations ---------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------
+static inline uint32_t sim_parity(uint32_t value)
+{
+  value ^= value >> 16;
+  value ^= value >> 8;
+  value ^= value >> 4;
+  value &= 0x0f;
+
+  return (0x6996 >> value) & 1;
+}
+
+//-----------------------------------------------------------------------------
+static bool sim_mem_access(uint32_t addr, int size, uint32_t *value, bool write)
+{
+  uint32_t offset = addr - SWD_SIM_MEM_BASE;
+  int lane = (addr & 3) * 8;
+
+  if (addr < SWD_SIM_MEM_BASE || offset + size > sim_mem_size || (addr & (size - 1)))
+  {
+    dp_ctrl |= DP_CTRL_STICKYERR;
+    return false;
+  }
+
+  if (write)
+  {
+    for (int i = 0; i < size; i++)
+      sim_mem[offset + i] = *value >> (lane + i * 8);
+
+    sim_stats.mem_writes++;
+  }
+  else
+  {
+    *value = 0;
+
+    for (int i = 0; i < size; i++)
+      *value |= (uint32_t)sim_mem[offset + i] << (lane + i * 8);
+
+    sim_stats.mem_reads++;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+static void sim_ap_access(int addr, uint32_t *value, bool write)
+{
+  if (dp_select >> 24)
+  {
+    if (!write)
+      *value = 0;
+    return;
+  }
+
+  if (AP_CSW == addr)
+  {
+    if (write)
+      ap_csw = *value & ~AP_CSW_DEVICEEN;
+    else
+      *value = ap_csw | AP_CSW_DEVICEEN;
+  }
+  else if (AP_TAR == addr)
+  {
+    if (write)
+      ap_tar = *value;
+    else
+      *value = ap_tar;
+  }
+  else if (AP_DRW == addr)
+  {
+    int size = 1 << (ap_csw & AP_CSW_SIZE_MASK);
+
+    if (size > 4)
+      size = 4;
+
+    sim_mem_access(ap_tar, size, value, write);
+
+    // TAR auto-increment is only guaranteed within a 1 KB block
+    if (ap_csw & AP_CSW_ADDRINC_SINGLE)
+      ap_tar = (ap_tar & ~0x3ffu) | ((ap_tar + size) & 0x3ff);
+  }
+  else if (AP_BD0 <= addr && addr <= AP_BD3)
+  {
+    sim_mem_access((ap_tar & ~0xfu) | (addr & 0xc), 4, value, write);
+  }
+  else if (!write)
+  {
+    if (AP_BASE == addr)
+      *value = AP_BASE_VALUE;
+    else if (AP_IDR == addr)
+      *value = SWD_SIM_AP_IDR;
+    else
+      *value = 0;
+  }
+}
+
+//-----------------------------------------------------------------------------
+static uint32_t sim_read(bool apndp, int a)
+{
+  uint32_t value = 0;
+
+  if (apndp)
+  {
+    // AP reads are posted, the result is returned by the next AP or RDBUFF read
+    uint32_t result = 0;
+
+    sim_ap_access((dp_select & 0xf0) | (a << 2), &result, false);
+    value = dp_rdbuff;
+    dp_rdbuff = result;
+  }
+  else if (0 == a)
+  {
+    value = SWD_SIM_IDCODE;
+  }
+  else if (1 == a)
+  {
+    value = dp_ctrl;
+    value |= (dp_ctrl & DP_CTRL_CDBGPWRUPREQ) << 1;
+    value |= (dp_ctrl & DP_CTRL_CSYSPWRUPREQ) << 1;
+  }
+  else if (2 == a)
+  {
+    value = dp_resend;
+  }
+  else
+  {
+    value = dp_rdbuff;
+  }
+
+  dp_resend = value;
+
+  return value;
+}
+
+//-----------------------------------------------------------------------------
+static void sim_write(bool apndp, int a, uint32_t value)
+{
+  if (apndp)
+  {
+    sim_ap_access((dp_select & 0xf0) | (a << 2), &value, true);
+  }
+  else if (0 == a)
+  {
+    if (value & DP_ABORT_STKCMPCLR)
+      dp_ctrl &= ~DP_CTRL_STICKYCMP;
+    if (value & DP_ABORT_STKERRCLR)
+      dp_ctrl &= ~DP_CTRL_STICKYERR;
+    if (value & DP_ABORT_WDERRCLR)
+      dp_ctrl &= ~DP_CTRL_WDATAERR;
+    if (value & DP_ABORT_ORUNERRCLR)
+      dp_ctrl &= ~DP_CTRL_STICKYORUN;
+  }
+  else if (1 == a)
+  {
+    dp_ctrl = (dp_ctrl & DP_CTRL_STICKY_MASK) |
+        (value & (DP_CTRL_CDBGPWRUPREQ | DP_CTRL_CSYSPWRUPREQ));
+  }
+  else if (2 == a)
+  {
+    dp_select = value;
+  }
+}
+
+//-----------------------------------------------------------------------------
+static void sim_request(void)
+{
+  int req = (sim_header >> 1) & 0xf;
+
+  sim_stats.requests++;
+
+  if (((sim_header >> 5) & 1) != sim_parity(req) || (sim_header & 0xc0) != 0x80)
+  {
+    sim_stats.protocol_errors++;
+    sim_state = SWD_STATE_LOCKOUT;
+    return;
+  }
+
+  sim_apndp = req & 1;
+  sim_rnw = (req >> 1) & 1;
+  sim_addr = req >> 2;
+
+  if (sim_apndp && sim_wait_left > 0)
+  {
+    sim_wait_left--;
+    sim_ack = SWD_ACK_WAIT;
+    sim_stats.ack_wait++;
+  }
+  else if (sim_apndp && (dp_ctrl & DP_CTRL_STICKYERR))
+  {
+    sim_ack = SWD_ACK_FAULT;
+    sim_stats.ack_fault++;
+  }
+  else
+  {
+    sim_ack = SWD_ACK_OK;
+    sim_stats.ack_ok++;
+
+    if (sim_apndp)
+      sim_wait_left = sim_wait_count;
+  }
+
+  if (SWD_ACK_OK == sim_ack)
+  {
+    sim_data = sim_rnw ? sim_read(sim_apndp, sim_addr) : 0;
+    sim_end_cycle = 2 * SWD_TURNAROUND + 36;
+  }
+  else
+  {
+    sim_end_cycle = 2 * SWD_TURNAROUND + 3;
+  }
+
+  sim_cycle = 0;
+  sim_state = SWD_STATE_RESPONSE;
+}
+
+//-----------------------------------------------------------------------------
+static void sim_response_cycle(int bit)
+{
+  int data_start = 2 * SWD_TURNAROUND + 3;
+
+  if (SWD_ACK_OK == sim_ack && !sim_rnw && sim_cycle >= data_start)
+  {
+    int index = sim_cycle - data_start;
+
+    if (index < 32)
+    {
+      sim_data |= (uint32_t)bit << index;
+    }
+    else if ((uint32_t)bit != sim_parity(sim_data))
+    {
+      dp_ctrl |= DP_CTRL_WDATAERR;
+      sim_stats.protocol_errors++;
+    }
+    else
+    {
+      sim_write(sim_apndp, sim_addr, sim_data);
+    }
+  }
+
+  if (++sim_cycle == sim_end_cycle)
+    sim_state = SWD_STATE_IDLE;
+}
+
+//-----------------------------------------------------------------------------
+static int sim_response_bit(void)
+{
+  int index = sim_cycle - SWD_TURNAROUND;
+
+  if (index < 0)
+    return 1;
+
+  if (index < 3)
+    return (sim_ack >> index) & 1;
+
+  if (SWD_ACK_OK != sim_ack || !sim_rnw)
+    return 1;
+
+  index -= 3;
+
+  if (index < 32)
+    return (sim_data >> index) & 1;
+
+  if (32 == index)
+    return sim_parity(sim_data);
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+static void sim_clock(void)
+{
+  int bit = sim_host_drives ? sim_swdio : 1;
+
+  sim_stats.clock_cycles++;
+
+  if (SWD_STATE_RESPONSE == sim_state)
+  {
+    sim_response_cycle(bit);
+    return;
+  }
+
+  sim_ones = bit ? (sim_ones + 1) : 0;
+
+  if (sim_ones >= SWD_LINE_RESET_BITS)
+  {
+    if (SWD_STATE_RESET != sim_state)
+      sim_stats.line_resets++;
+
+    sim_state = SWD_STATE_RESET;
+    return;
+  }
+
+  if (SWD_STATE_RESET == sim_state)
+  {
+    if (0 == bit)
+      sim_state = SWD_STATE_IDLE;
+  }
+  else if (SWD_STATE_IDLE == sim_state)
+  {
+    if (bit)
+    {
+      sim_header = 1;
+      sim_header_bits = 1;
+      sim_state = SWD_STATE_HEADER;
+    }
+  }
+  else if (SWD_STATE_HEADER == sim_state)
+  {
+    sim_header |= (uint32_t)bit << sim_header_bits++;
+
+    if (8 == sim_header_bits)
+      sim_request();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_init(uint32_t mem_size)
+{
+  free(sim_mem);
+  sim_mem = calloc(1, mem_size);
+  sim_mem_size = mem_size;
+
+  sim_swclk = 1;
+  sim_swdio = 1;
+  sim_host_drives = false;
+  sim_nreset = 1;
+
+  sim_state = SWD_STATE_LOCKOUT;
+  sim_ones = 0;
+  sim_wait_left = sim_wait_count;
+
+  dp_ctrl = 0;
+  dp_select = 0;
+  dp_rdbuff = 0;
+  dp_resend = 0;
+  ap_csw = 0;
+  ap_tar = 0;
+
+  swd_sim_reset_stats();
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_set_wait_count(int count)
+{
+  sim_wait_count = count;
+  sim_wait_left = count;
+}
+
+//-----------------------------------------------------------------------------
+uint8_t *swd_sim_memory(void)
+{
+  return sim_mem;
+}
+
+//-----------------------------------------------------------------------------
+uint32_t swd_sim_memory_size(void)
+{
+  return sim_mem_size;
+}
+
+//-----------------------------------------------------------------------------
+swd_sim_stats_t *swd_sim_stats(void)
+{
+  return &sim_stats;
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_reset_stats(void)
+{
+  memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_swclk_write(int value)
+{
+  // The target samples SWDIO and advances on the rising edge
+  if (!sim_swclk && value)
+    sim_clock();
+
+  sim_swclk = value;
+}
+
+//-----------------------------------------------------------------------------
+int swd_sim_swclk_read(void)
+{
+  return sim_swclk;
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_swdio_write(int value)
+{
+  sim_swdio = value ? 1 : 0;
+}
+
+//-----------------------------------------------------------------------------
+int swd_sim_swdio_read(void)
+{
+  if (sim_host_drives)
+    return sim_swdio;
+
+  if (SWD_STATE_RESPONSE == sim_state)
+    return sim_response_bit();
+
+  return 1; // Pull-up
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_swdio_dir(bool output)
+{
+  sim_host_drives = output;
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_nreset_write(int value)
+{
+  sim_nreset = value;
+}
+
+//-----------------------------------------------------------------------------
+int swd_sim_nreset_read(void)
+{
+  return sim_nreset;
+}
+
+//-----------------------------------------------------------------------------
+void swd_sim_delay(uint32_t cycles)
+{
+  sim_stats.delay_cycles += cycles;
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef _SWD_SIM_H_
+#define _SWD_SIM_H_
+
+/*- Includes ----------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*- Definitions -------------------------------------------------------------*/
+#define SWD_SIM_IDCODE         0x2ba01477 // ARM Cortex-M4 SW-DP
+#define SWD_SIM_AP_IDR         0x24770011 // AHB-AP
+#define SWD_SIM_MEM_BASE       0x20000000
+
+/*- Types -------------------------------------------------------------------*/
+typedef struct
+{
+  uint64_t     clock_cycles;
+  uint64_t     delay_cycles;
+  uint32_t     requests;
+  uint32_t     ack_ok;
+  uint32_t     ack_wait;
+  uint32_t     ack_fault;
+  uint32_t     protocol_errors;
+  uint32_t     line_resets;
+  uint32_t     mem_reads;
+  uint32_t     mem_writes;
+} swd_sim_stats_t;
+
+/*- Prototypes --------------------------------------------------------------*/
+void swd_sim_init(uint32_t mem_size);
+void swd_sim_set_wait_count(int count);
+uint8_t *swd_sim_memory(void);
+uint32_t swd_sim_memory_size(void);
+swd_sim_stats_t *swd_sim_stats(void);
+void swd_sim_reset_stats(void);
+
+void swd_sim_swclk_write(int value);
+int swd_sim_swclk_read(void);
+void swd_sim_swdio_write(int value);
+int swd_sim_swdio_read(void);
+void swd_sim_swdio_dir(bool output);
+void swd_sim_nreset_write(int value);
+int swd_sim_nreset_read(void);
+void swd_sim_delay(uint32_t cycles);
+
+#endif // _SWD_SIM_H_
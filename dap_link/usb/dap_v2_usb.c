@@ -439,6 +439,18 @@ const usb_msos_descriptor_set_t usb_msos_descriptor_set = {
         },
 };
 
+typedef struct {
+    uint8_t data[DAP_HID_EP_SIZE];
+    uint8_t size;
+} DapUsbPacket;
+
+typedef struct {
+    DapUsbPacket packets[DAP_V2_USB_PACKET_COUNT];
+    volatile uint8_t wr_ptr;
+    volatile uint8_t rd_ptr;
+    volatile uint8_t count;
+} DapUsbQueue;
+
 typedef struct {
     FuriSemaphore* semaphore_v1;
     FuriSemaphore* semaphore_v2;
@@ -448,12 +460,18 @@ typedef struct {
     DapStateCallback state_callback;
     DapRxCallback rx_callback_v1;
     DapRxCallback rx_callback_v2;
+    DapRxFilter rx_filter_v2;
     DapRxCallback rx_callback_cdc;
     DapRxCallback tx_complete_cdc;
     DapCDCControlLineCallback control_line_callback_cdc;
     DapCDCConfigCallback config_callback_cdc;
     void* context;
     void* context_cdc;
+
+    DapUsbQueue rx_queue_v2;
+    bool rx_pending_v2; // packet is left in endpoint until queue has space
+    DapUsbQueue tx_queue_v2;
+    bool tx_busy_v2;
 } DAPState;
 
 static DAPState dap_state = {
@@ -465,6 +483,7 @@ static DAPState dap_state = {
     .state_callback = NULL,
     .rx_callback_v1 = NULL,
     .rx_callback_v2 = NULL,
+    .rx_filter_v2 = NULL,
     .rx_callback_cdc = NULL,
     .control_line_callback_cdc = NULL,
     .config_callback_cdc = NULL,
@@ -506,16 +525,40 @@ int32_t dap_v1_usb_tx(uint8_t* buffer, uint8_t size) {
     }
 }
 
+static void dap_v2_usb_send_next() {
+    DapUsbQueue* queue = &dap_state.tx_queue_v2;
+    if(dap_state.tx_busy_v2 || !queue->count) return;
+
+    dap_state.tx_busy_v2 = true;
+    DapUsbPacket* packet = &queue->packets[queue->rd_ptr];
+    int32_t len = usbd_ep_write(dap_state.usb_dev, DAP_HID_EP_BULK_IN, packet->data, packet->size);
+    furi_console_log_printf("v2 tx %ld", len);
+    UNUSED(len);
+}
+
 int32_t dap_v2_usb_tx(uint8_t* buffer, uint8_t size) {
     if((dap_state.semaphore_v2 == NULL) || (dap_state.connected == false)) return 0;
 
+    // semaphore counts free slots of tx queue, blocks only when all of them wait for host
     furi_check(furi_semaphore_acquire(dap_state.semaphore_v2, FuriWaitForever) == FuriStatusOk);
 
     if(dap_state.connected) {
-        int32_t len = usbd_ep_write(dap_state.usb_dev, DAP_HID_EP_BULK_IN, buffer, size);
-        furi_console_log_printf("v2 tx %ld", len);
-        return len;
+        DapUsbQueue* queue = &dap_state.tx_queue_v2;
+        size = MIN(size, DAP_HID_EP_SIZE);
+
+        FURI_CRITICAL_ENTER();
+        DapUsbPacket* packet = &queue->packets[queue->wr_ptr];
+        memcpy(packet->data, buffer, size);
+        packet->size = size;
+        queue->wr_ptr = (queue->wr_ptr + 1) % DAP_V2_USB_PACKET_COUNT;
+        queue->count++;
+        dap_v2_usb_send_next();
+        FURI_CRITICAL_EXIT();
+
+        return size;
     } else {
+        // slot was taken after disconnect, nothing is queued into it
+        furi_semaphore_release(dap_state.semaphore_v2);
         return 0;
     }
 }
@@ -542,6 +585,10 @@ void dap_v2_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_v2 = callback;
 }
 
+void dap_v2_usb_set_rx_filter(DapRxFilter filter) {
+    dap_state.rx_filter_v2 = filter;
+}
+
 void dap_cdc_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_cdc = callback;
 }
@@ -620,7 +667,9 @@ static void hid_init(usbd_device* dev, FuriHalUsbInterface* intf, void* ctx) {
 
     dap_state.usb_dev = dev;
     if(dap_state.semaphore_v1 == NULL) dap_state.semaphore_v1 = furi_semaphore_alloc(1, 1);
-    if(dap_state.semaphore_v2 == NULL) dap_state.semaphore_v2 = furi_semaphore_alloc(1, 1);
+    if(dap_state.semaphore_v2 == NULL)
+        dap_state.semaphore_v2 =
+            furi_semaphore_alloc(DAP_V2_USB_PACKET_COUNT, DAP_V2_USB_PACKET_COUNT);
     if(dap_state.semaphore_cdc == NULL) dap_state.semaphore_cdc = furi_semaphore_alloc(1, 1);
 
     usbd_reg_config(dev, hid_ep_config);
@@ -643,6 +692,24 @@ static void hid_deinit(usbd_device* dev) {
     usbd_reg_control(dev, NULL);
 }
 
+// Packets in flight are lost on reconnect or suspend, tx completion never comes for them
+static void dap_v2_usb_reset_queues() {
+    dap_state.rx_queue_v2.wr_ptr = 0;
+    dap_state.rx_queue_v2.rd_ptr = 0;
+    dap_state.rx_queue_v2.count = 0;
+    dap_state.rx_pending_v2 = false;
+    dap_state.tx_queue_v2.wr_ptr = 0;
+    dap_state.tx_queue_v2.rd_ptr = 0;
+    dap_state.tx_queue_v2.count = 0;
+    dap_state.tx_busy_v2 = false;
+
+    if(dap_state.semaphore_v2 != NULL) {
+        while(furi_semaphore_get_count(dap_state.semaphore_v2) < DAP_V2_USB_PACKET_COUNT) {
+            furi_semaphore_release(dap_state.semaphore_v2);
+        }
+    }
+}
+
 static void hid_on_wakeup(usbd_device* dev) {
     UNUSED(dev);
     if(!dap_state.connected) {
@@ -657,6 +724,7 @@ static void hid_on_suspend(usbd_device* dev) {
     UNUSED(dev);
     if(dap_state.connected) {
         dap_state.connected = false;
+        dap_v2_usb_reset_queues();
         if(dap_state.state_callback != NULL) {
             dap_state.state_callback(dap_state.connected, dap_state.context);
         }
@@ -673,11 +741,44 @@ size_t dap_v1_usb_rx(uint8_t* buffer, size_t size) {
     return len;
 }
 
+/** Reads bulk endpoint into rx queue, called from USB interrupt or with interrupts masked */
+static void dap_v2_usb_receive() {
+    DapUsbQueue* queue = &dap_state.rx_queue_v2;
+    if(queue->count == DAP_V2_USB_PACKET_COUNT) {
+        // endpoint NAKs host until packet is read
+        dap_state.rx_pending_v2 = true;
+        return;
+    }
+
+    dap_state.rx_pending_v2 = false;
+    DapUsbPacket* packet = &queue->packets[queue->wr_ptr];
+    int32_t len =
+        usbd_ep_read(dap_state.usb_dev, DAP_HID_EP_BULK_OUT, packet->data, DAP_HID_EP_SIZE);
+    if(len <= 0) return;
+    packet->size = len;
+
+    if(dap_state.rx_filter_v2 == NULL || dap_state.rx_filter_v2(packet->data)) {
+        queue->wr_ptr = (queue->wr_ptr + 1) % DAP_V2_USB_PACKET_COUNT;
+        queue->count++;
+    }
+}
+
 size_t dap_v2_usb_rx(uint8_t* buffer, size_t size) {
     size_t len = 0;
 
     if(dap_state.connected) {
-        len = usbd_ep_read(dap_state.usb_dev, DAP_HID_EP_BULK_OUT, buffer, size);
+        DapUsbQueue* queue = &dap_state.rx_queue_v2;
+
+        FURI_CRITICAL_ENTER();
+        if(queue->count) {
+            DapUsbPacket* packet = &queue->packets[queue->rd_ptr];
+            len = MIN(size, packet->size);
+            memcpy(buffer, packet->data, len);
+            queue->rd_ptr = (queue->rd_ptr + 1) % DAP_V2_USB_PACKET_COUNT;
+            queue->count--;
+        }
+        if(dap_state.rx_pending_v2) dap_v2_usb_receive();
+        FURI_CRITICAL_EXIT();
     }
 
     return len;
@@ -719,10 +820,18 @@ static void hid_txrx_ep_bulk_callback(usbd_device* dev, uint8_t event, uint8_t e
 
     switch(event) {
     case usbd_evt_eptx:
-        furi_semaphore_release(dap_state.semaphore_v2);
+        if(dap_state.tx_queue_v2.count) {
+            dap_state.tx_queue_v2.rd_ptr =
+                (dap_state.tx_queue_v2.rd_ptr + 1) % DAP_V2_USB_PACKET_COUNT;
+            dap_state.tx_queue_v2.count--;
+            furi_semaphore_release(dap_state.semaphore_v2);
+        }
+        dap_state.tx_busy_v2 = false;
+        dap_v2_usb_send_next();
         furi_console_log_printf("bulk tx complete");
         break;
     case usbd_evt_eprx:
+        dap_v2_usb_receive();
         if(dap_state.rx_callback_v2 != NULL) {
             dap_state.rx_callback_v2(dap_state.context);
         }
@@ -772,6 +881,7 @@ static usbd_respond hid_ep_config(usbd_device* dev, uint8_t cfg) {
         usbd_reg_endpoint(dev, DAP_HID_EP_BULK_OUT, NULL);
         usbd_reg_endpoint(dev, HID_EP_IN | DAP_CDC_EP_SEND, 0);
         usbd_reg_endpoint(dev, HID_EP_OUT | DAP_CDC_EP_RECV, 0);
+        dap_v2_usb_reset_queues();
         return usbd_ack;
     case EP_CFG_CONFIGURE:
         usbd_ep_config(dev, DAP_HID_EP_IN, USB_EPTYPE_INTERRUPT, DAP_HID_EP_SIZE);
@@ -787,6 +897,7 @@ static usbd_respond hid_ep_config(usbd_device* dev, uint8_t cfg) {
         usbd_reg_endpoint(dev, DAP_HID_EP_BULK_IN, hid_txrx_ep_bulk_callback);
         usbd_reg_endpoint(dev, HID_EP_OUT | DAP_CDC_EP_RECV, cdc_txrx_ep_callback);
         usbd_reg_endpoint(dev, HID_EP_IN | DAP_CDC_EP_SEND, cdc_txrx_ep_callback);
+        dap_v2_usb_reset_queues();
         // usbd_ep_write(dev, DAP_HID_EP_IN, NULL, 0);
         // usbd_ep_write(dev, DAP_HID_EP_BULK_IN, NULL, 0);
         // usbd_ep_write(dev, HID_EP_IN | DAP_CDC_EP_SEND, NULL, 0);
@@ -19,12 +19,20 @@ void dap_v1_usb_set_rx_callback(DapRxCallback callback);
 
 /************************************ V2 ***************************************/
 
+// Bulk endpoint packets are queued in both directions, so host can keep several requests in flight
+#define DAP_V2_USB_PACKET_COUNT 8
+
+// return false to drop packet from queue (handled right away in USB interrupt)
+typedef bool (*DapRxFilter)(uint8_t* data);
+
 int32_t dap_v2_usb_tx(uint8_t* buffer, uint8_t size);
 
 size_t dap_v2_usb_rx(uint8_t* buffer, size_t size);
 
 void dap_v2_usb_set_rx_callback(DapRxCallback callback);
 
+void dap_v2_usb_set_rx_filter(DapRxFilter filter);
+
 /************************************ CDC **************************************/
 
 typedef void (*DapCDCControlLineCallback)(uint8_t state, void* context);
@@ -180,6 +180,54 @@ bool flipbip_save_file(
     return ret;
 }
 
+bool flipbip_load_file_raw(void* data, const size_t dlen, const char* file_name) {
+    bool ret = false;
+    char path_buf[FILE_MAX_PATH_LEN] = {0};
+    strcpy(path_buf, FLIPBIP_APP_BASE_FOLDER); // 22
+    strcpy(path_buf + strlen(path_buf), "/");
+    strcpy(path_buf + strlen(path_buf), file_name);
+
+    Storage* fs_api = furi_record_open(RECORD_STORAGE);
+    File* raw_file = storage_file_alloc(fs_api);
+    // file has to be exactly dlen bytes long
+    if(storage_file_open(raw_file, path_buf, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_size(raw_file) == dlen) {
+        ret = storage_file_read(raw_file, data, dlen) == dlen;
+    }
+    storage_file_close(raw_file);
+    storage_file_free(raw_file);
+    furi_record_close(RECORD_STORAGE);
+
+    return ret;
+}
+
+bool flipbip_save_file_raw(const void* data, const size_t dlen, const char* file_name) {
+    bool ret = false;
+    char path_buf[FILE_MAX_PATH_LEN] = {0};
+    strcpy(path_buf, FLIPBIP_APP_BASE_FOLDER); // 22
+    strcpy(path_buf + strlen(path_buf), "/");
+    strcpy(path_buf + strlen(path_buf), file_name);
+
+    Storage* fs_api = furi_record_open(RECORD_STORAGE);
+    // try to create the folder
+    storage_simply_mkdir(fs_api, FLIPBIP_APP_BASE_FOLDER);
+
+    File* raw_file = storage_file_alloc(fs_api);
+    if(storage_file_open(raw_file, path_buf, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        ret = storage_file_write(raw_file, data, dlen) == dlen;
+    }
+    storage_file_close(raw_file);
+    storage_file_free(raw_file);
+
+    // don't leave a truncated file behind
+    if(!ret) {
+        storage_simply_remove(fs_api, path_buf);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    return ret;
+}
+
 bool flipbip_save_qrfile(
     const char* qr_msg_prefix,
     const char* qr_msg_content,
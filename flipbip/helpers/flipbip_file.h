@@ -19,6 +19,9 @@ bool flipbip_save_file(
     const char* file_name,
     const bool append);
 
+bool flipbip_load_file_raw(void* data, const size_t dlen, const char* file_name);
+bool flipbip_save_file_raw(const void* data, const size_t dlen, const char* file_name);
+
 bool flipbip_save_qrfile(
     const char* qr_msg_prefix,
     const char* qr_msg_content,
@@ -530,12 +530,17 @@ int point_multiply(
     return 0;
 }
 
-#if USE_PRECOMPUTED_CP
+#if USE_PRECOMPUTED_CP || USE_PRECOMPUTED_CP_RUNTIME
 
-// res = k * G
+// res = k * G using table cp of odd multiples of G
+// cp[i][j] = (2*j+1) * 16^i * G
 // k must be a normalized number with 0 <= k < curve->order
 // returns 0 on success
-int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
+static int scalar_multiply_cp(
+    const ecdsa_curve* curve,
+    const curve_point cp[64][8],
+    const bignum256* k,
+    curve_point* res) {
     if(!bn_is_less(k, &curve->order)) {
         return 1;
     }
@@ -580,9 +585,9 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
     // Since k = a - 2^256 (mod curve->order), we can compute
     //   k*G = sum_{i=0..63} a[i] 16^i * G
     //
-    // We have a big table curve->cp that stores all possible
+    // We have a big table cp that stores all possible
     // values of |a[i]| 16^i * G.
-    // curve->cp[i][j] = (2*j+1) * 16^i * G
+    // cp[i][j] = (2*j+1) * 16^i * G
 
     // now compute  res = sum_{i=0..63} a[i] * 16^i * G step by step.
     // initial res = |a[0]| * G.  Note that a[0] = a & 0xf if (a&0x10) != 0
@@ -592,7 +597,7 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
     lowbits = a.val[0] & ((1 << 5) - 1);
     lowbits ^= (lowbits >> 4) - 1;
     lowbits &= 15;
-    curve_to_jacobian(&curve->cp[0][lowbits >> 1], &jres, prime);
+    curve_to_jacobian(&cp[0][lowbits >> 1], &jres, prime);
     for(i = 1; i < 64; i++) {
         // invariant res = sign(a[i-1]) sum_{j=0..i-1} (a[j] * 16^j * G)
 
@@ -612,7 +617,7 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
         bn_cnegate(~lowbits & 1, &jres.y, prime);
 
         // add odd factor
-        point_jacobian_add(&curve->cp[i][lowbits >> 1], &jres, curve);
+        point_jacobian_add(&cp[i][lowbits >> 1], &jres, curve);
     }
     bn_cnegate(~(a.val[0] >> 4) & 1, &jres.y, prime);
     jacobian_to_curve(&jres, res, prime);
@@ -622,6 +627,55 @@ int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* r
     return 0;
 }
 
+#endif
+
+#if USE_PRECOMPUTED_CP
+
+// res = k * G
+// k must be a normalized number with 0 <= k < curve->order
+// returns 0 on success
+int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
+    return scalar_multiply_cp(curve, curve->cp, k, res);
+}
+
+#elif USE_PRECOMPUTED_CP_RUNTIME
+
+static const ecdsa_curve* runtime_cp_curve = NULL;
+static const curve_point (*runtime_cp)[8] = NULL;
+
+// fills cp[i][j] = (2*j+1) * 16^i * G, same layout as the compiled in tables
+void ecdsa_precompute_cp(const ecdsa_curve* curve, curve_point cp[64][8]) {
+    curve_point base = curve->G, twice = {0};
+    for(int i = 0; i < 64; i++) {
+        point_copy(&base, &twice);
+        point_double(curve, &twice);
+        point_copy(&base, &cp[i][0]);
+        for(int j = 1; j < 8; j++) {
+            point_copy(&cp[i][j - 1], &cp[i][j]);
+            point_add(curve, &twice, &cp[i][j]);
+        }
+        for(int j = 0; j < 4; j++) {
+            point_double(curve, &base);
+        }
+    }
+}
+
+// cp must stay valid until it is replaced or cleared with NULL
+void ecdsa_set_precomputed_cp(const ecdsa_curve* curve, const curve_point cp[64][8]) {
+    runtime_cp_curve = cp ? curve : NULL;
+    runtime_cp = cp;
+}
+
+// res = k * G
+// k must be a normalized number with 0 <= k < curve->order
+// returns 0 on success
+int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
+    if(runtime_cp != NULL && curve == runtime_cp_curve) {
+        return scalar_multiply_cp(curve, runtime_cp, k, res);
+    }
+    return point_multiply(curve, k, &curve->G, res);
+}
+
 #else
 
 int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res) {
@@ -74,6 +74,10 @@ int point_is_infinity(const curve_point* p);
 int point_is_equal(const curve_point* p, const curve_point* q);
 int point_is_negative_of(const curve_point* p, const curve_point* q);
 int scalar_multiply(const ecdsa_curve* curve, const bignum256* k, curve_point* res);
+#if USE_PRECOMPUTED_CP_RUNTIME && !USE_PRECOMPUTED_CP
+void ecdsa_precompute_cp(const ecdsa_curve* curve, curve_point cp[64][8]);
+void ecdsa_set_precomputed_cp(const ecdsa_curve* curve, const curve_point cp[64][8]);
+#endif
 int ecdh_multiply(
     const ecdsa_curve* curve,
     const uint8_t* priv_key,
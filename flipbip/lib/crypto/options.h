@@ -28,6 +28,12 @@
 #define USE_PRECOMPUTED_CP 0
 #endif
 
+// use precomputed Curve Points table built at runtime (in RAM) instead of the
+// compiled in one, see ecdsa_precompute_cp and ecdsa_set_precomputed_cp
+#ifndef USE_PRECOMPUTED_CP_RUNTIME
+#define USE_PRECOMPUTED_CP_RUNTIME 1
+#endif
+
 // use fast inverse method
 #ifndef USE_INVERSE_FAST
 #define USE_INVERSE_FAST 1
@@ -1100,6 +1100,116 @@ void sha512_Transform(const sha2_word64* state_in, const sha2_word64* data, sha2
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/*
+ * Padding of a block that holds a SHA-512 digest following exactly one
+ * already compressed block, i.e. the inner and outer hash blocks of
+ * HMAC-SHA512 over a digest, as used by every PBKDF2 iteration.
+ */
+#define SHA512_DIGEST_BLOCK_PAD_START 0x8000000000000000ULL
+#define SHA512_DIGEST_BLOCK_BIT_LENGTH ((SHA512_BLOCK_LENGTH + SHA512_DIGEST_LENGTH) * 8)
+
+/* K512[j] + W512[j] for the constant padding words 8..15 of such block */
+static const sha2_word64 K512_DIGEST_BLOCK_PAD[8] = {
+    0x5807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692c94ULL};
+
+/* Rounds 0..7 take the digest words, rounds 8..15 only constants */
+#define ROUND512_DIGEST(a, b, c, d, e, f, g, h)                                     \
+    T1 = (h) + Sigma1_512(e) + Ch((e), (f), (g)) + K512[j] + (W512[j] = digest[j]); \
+    (d) += T1;                                                                      \
+    (h) = T1 + Sigma0_512(a) + Maj((a), (b), (c));                                  \
+    j++
+
+#define ROUND512_DIGEST_PAD(a, b, c, d, e, f, g, h)                                  \
+    T1 = (h) + Sigma1_512(e) + Ch((e), (f), (g)) + K512_DIGEST_BLOCK_PAD[j - 8]; \
+    (d) += T1;                                                                   \
+    (h) = T1 + Sigma0_512(a) + Maj((a), (b), (c));                               \
+    j++
+
+#define ROUND512_DIGEST_EXPAND(a, b, c, d, e, f, g, h)       \
+    s0 = W512[(j + 1) & 0x0f];                               \
+    s0 = sigma0_512(s0);                                     \
+    s1 = W512[(j + 14) & 0x0f];                              \
+    s1 = sigma1_512(s1);                                     \
+    T1 = (h) + Sigma1_512(e) + Ch((e), (f), (g)) + K512[j] + \
+         (W512[j & 0x0f] += s1 + W512[(j + 9) & 0x0f] + s0); \
+    (d) += T1;                                               \
+    (h) = T1 + Sigma0_512(a) + Maj((a), (b), (c));           \
+    j++
+
+/*
+ * Same as sha512_Transform on a block made of the 8 word digest followed by
+ * SHA512_DIGEST_BLOCK_PAD_START, six zero words and SHA512_DIGEST_BLOCK_BIT_LENGTH,
+ * but the padding words are never loaded and their round constants are folded
+ * into K512_DIGEST_BLOCK_PAD. It is always unrolled by 8 rounds, so working
+ * variables are renamed instead of being shifted through a..h every round,
+ * which matters on 32-bit cores where they don't fit into registers.
+ */
+void sha512_Transform_digest(
+    const sha2_word64* state_in,
+    const sha2_word64* digest,
+    sha2_word64* state_out) {
+    sha2_word64 a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0, s0 = 0, s1 = 0;
+    sha2_word64 T1 = 0, W512[16] = {0};
+    int j = 0;
+
+    /* Initialize registers with the prev. intermediate value */
+    a = state_in[0];
+    b = state_in[1];
+    c = state_in[2];
+    d = state_in[3];
+    e = state_in[4];
+    f = state_in[5];
+    g = state_in[6];
+    h = state_in[7];
+
+    ROUND512_DIGEST(a, b, c, d, e, f, g, h);
+    ROUND512_DIGEST(h, a, b, c, d, e, f, g);
+    ROUND512_DIGEST(g, h, a, b, c, d, e, f);
+    ROUND512_DIGEST(f, g, h, a, b, c, d, e);
+    ROUND512_DIGEST(e, f, g, h, a, b, c, d);
+    ROUND512_DIGEST(d, e, f, g, h, a, b, c);
+    ROUND512_DIGEST(c, d, e, f, g, h, a, b);
+    ROUND512_DIGEST(b, c, d, e, f, g, h, a);
+
+    ROUND512_DIGEST_PAD(a, b, c, d, e, f, g, h);
+    ROUND512_DIGEST_PAD(h, a, b, c, d, e, f, g);
+    ROUND512_DIGEST_PAD(g, h, a, b, c, d, e, f);
+    ROUND512_DIGEST_PAD(f, g, h, a, b, c, d, e);
+    ROUND512_DIGEST_PAD(e, f, g, h, a, b, c, d);
+    ROUND512_DIGEST_PAD(d, e, f, g, h, a, b, c);
+    ROUND512_DIGEST_PAD(c, d, e, f, g, h, a, b);
+    ROUND512_DIGEST_PAD(b, c, d, e, f, g, h, a);
+
+    /* Words 9..14 stay zero for the message expansion */
+    W512[8] = SHA512_DIGEST_BLOCK_PAD_START;
+    W512[15] = SHA512_DIGEST_BLOCK_BIT_LENGTH;
+
+    do {
+        ROUND512_DIGEST_EXPAND(a, b, c, d, e, f, g, h);
+        ROUND512_DIGEST_EXPAND(h, a, b, c, d, e, f, g);
+        ROUND512_DIGEST_EXPAND(g, h, a, b, c, d, e, f);
+        ROUND512_DIGEST_EXPAND(f, g, h, a, b, c, d, e);
+        ROUND512_DIGEST_EXPAND(e, f, g, h, a, b, c, d);
+        ROUND512_DIGEST_EXPAND(d, e, f, g, h, a, b, c);
+        ROUND512_DIGEST_EXPAND(c, d, e, f, g, h, a, b);
+        ROUND512_DIGEST_EXPAND(b, c, d, e, f, g, h, a);
+    } while(j < 80);
+
+    /* Compute the current intermediate hash value */
+    state_out[0] = state_in[0] + a;
+    state_out[1] = state_in[1] + b;
+    state_out[2] = state_in[2] + c;
+    state_out[3] = state_in[3] + d;
+    state_out[4] = state_in[4] + e;
+    state_out[5] = state_in[5] + f;
+    state_out[6] = state_in[6] + g;
+    state_out[7] = state_in[7] + h;
+
+    /* Clean up */
+    a = b = c = d = e = f = g = h = T1 = 0;
+}
+
 void sha512_Update(SHA512_CTX* context, const sha2_byte* data, size_t len) {
     unsigned int freespace = 0, usedspace = 0;
 
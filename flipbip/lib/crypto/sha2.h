@@ -82,6 +82,7 @@ void sha256_Raw(const uint8_t*, size_t, uint8_t[SHA256_DIGEST_LENGTH]);
 char* sha256_Data(const uint8_t*, size_t, char[SHA256_DIGEST_STRING_LENGTH]);
 
 void sha512_Transform(const uint64_t* state_in, const uint64_t* data, uint64_t* state_out);
+void sha512_Transform_digest(const uint64_t* state_in, const uint64_t* digest, uint64_t* state_out);
 void sha512_Init(SHA512_CTX*);
 void sha512_Update(SHA512_CTX*, const uint8_t*, size_t);
 void sha512_Final(SHA512_CTX*, uint8_t[SHA512_DIGEST_LENGTH]);
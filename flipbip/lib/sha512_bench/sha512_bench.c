@@ -0,0 +1,223 @@
+// Host checks and benchmark of SHA-512 as BIP39 uses it. Runs the NIST SHA-512 vectors and
+// PBKDF2-HMAC-SHA512 vectors through the app's crypto lib, checks sha512_Transform_digest
+// against the generic sha512_Transform on random digests, then times 2048 PBKDF2 iterations
+// (one mnemonic_to_seed) with both.
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pbkdf2.h"
+#include "sha2.h"
+
+#define DEFAULT_RUNS (100)
+#define SEED_ROUNDS (2048)
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+typedef void (*PbkdfUpdate)(PBKDF2_HMAC_SHA512_CTX* pctx, uint32_t iterations);
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool hex_is(const uint8_t* data, size_t size, const char* hex) {
+    char buf[3];
+    if(strlen(hex) != size * 2) return false;
+    for(size_t i = 0; i < size; i++) {
+        snprintf(buf, sizeof(buf), "%02x", data[i]);
+        if(memcmp(buf, hex + i * 2, 2)) return false;
+    }
+    return true;
+}
+
+// pbkdf2_hmac_sha512_Update before sha512_Transform_digest, g holds the full padded block
+static void pbkdf2_update_generic(PBKDF2_HMAC_SHA512_CTX* pctx, uint32_t iterations) {
+    for(uint32_t i = pctx->first; i < iterations; i++) {
+        sha512_Transform(pctx->idig, pctx->g, pctx->g);
+        sha512_Transform(pctx->odig, pctx->g, pctx->g);
+        for(uint32_t j = 0; j < SHA512_DIGEST_LENGTH / sizeof(uint64_t); j++) {
+            pctx->f[j] ^= pctx->g[j];
+        }
+    }
+    pctx->first = 0;
+}
+
+static void pbkdf2_run(
+    PbkdfUpdate update,
+    const char* pass,
+    const char* salt,
+    uint32_t iterations,
+    uint8_t key[SHA512_DIGEST_LENGTH]) {
+    PBKDF2_HMAC_SHA512_CTX pctx;
+    pbkdf2_hmac_sha512_Init(
+        &pctx, (const uint8_t*)pass, strlen(pass), (const uint8_t*)salt, strlen(salt), 1);
+    update(&pctx, iterations);
+    pbkdf2_hmac_sha512_Final(&pctx, key);
+}
+
+static void test_sha512_nist(void) {
+    uint8_t digest[SHA512_DIGEST_LENGTH];
+
+    sha512_Raw((const uint8_t*)"", 0, digest);
+    CHECK(hex_is(
+        digest,
+        sizeof(digest),
+        "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+        "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e"));
+
+    sha512_Raw((const uint8_t*)"abc", 3, digest);
+    CHECK(hex_is(
+        digest,
+        sizeof(digest),
+        "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+        "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"));
+
+    // 896-bit message, two blocks once padded
+    const char* msg = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+                      "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+    CHECK(strlen(msg) * 8 == 896);
+    sha512_Raw((const uint8_t*)msg, strlen(msg), digest);
+    CHECK(hex_is(
+        digest,
+        sizeof(digest),
+        "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+        "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"));
+
+    // Same message fed in uneven pieces
+    SHA512_CTX ctx;
+    sha512_Init(&ctx);
+    sha512_Update(&ctx, (const uint8_t*)msg, 1);
+    sha512_Update(&ctx, (const uint8_t*)msg + 1, 100);
+    sha512_Update(&ctx, (const uint8_t*)msg + 101, strlen(msg) - 101);
+    sha512_Final(&ctx, digest);
+    CHECK(hex_is(
+        digest,
+        sizeof(digest),
+        "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+        "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"));
+}
+
+static void test_transform_digest(void) {
+    uint64_t state[8], block[16] = {0}, generic[8], digest[8];
+
+    block[8] = 0x8000000000000000;
+    block[15] = (SHA512_BLOCK_LENGTH + SHA512_DIGEST_LENGTH) * 8;
+    for(int n = 0; n < 1000; n++) {
+        for(int i = 0; i < 8; i++) {
+            state[i] = ((uint64_t)rand() << 33) ^ ((uint64_t)rand() << 11) ^ rand();
+            block[i] = ((uint64_t)rand() << 33) ^ ((uint64_t)rand() << 11) ^ rand();
+        }
+        sha512_Transform(state, block, generic);
+        sha512_Transform_digest(state, block, digest);
+        CHECK(!memcmp(generic, digest, sizeof(digest)));
+    }
+
+    // In place, the way PBKDF2 calls it
+    memcpy(digest, block, sizeof(digest));
+    sha512_Transform(state, block, block);
+    sha512_Transform_digest(state, digest, digest);
+    CHECK(!memcmp(block, digest, sizeof(digest)));
+}
+
+static void test_pbkdf2(void) {
+    uint8_t key[SHA512_DIGEST_LENGTH];
+
+    pbkdf2_run(pbkdf2_hmac_sha512_Update, "password", "salt", 1, key);
+    CHECK(hex_is(
+        key,
+        sizeof(key),
+        "867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252"
+        "c02d470a285a0501bad999bfe943c08f050235d7d68b1da55e63f73b60a57fce"));
+
+    pbkdf2_run(pbkdf2_hmac_sha512_Update, "password", "salt", 2, key);
+    CHECK(hex_is(
+        key,
+        sizeof(key),
+        "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c"
+        "f76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e"));
+
+    pbkdf2_run(pbkdf2_hmac_sha512_Update, "password", "salt", 4096, key);
+    CHECK(hex_is(
+        key,
+        sizeof(key),
+        "d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5"
+        "143f30602641b3d55cd335988cb36b84376060ecd532e039b742a239434af2d5"));
+
+    // BIP39 seed of "abandon ... about" with passphrase "TREZOR"
+    const char* mnemonic = "abandon abandon abandon abandon abandon abandon abandon abandon "
+                           "abandon abandon abandon about";
+    pbkdf2_run(pbkdf2_hmac_sha512_Update, mnemonic, "mnemonicTREZOR", SEED_ROUNDS, key);
+    CHECK(hex_is(
+        key,
+        sizeof(key),
+        "c55257c360c07c72029aebc1b53c05ed0362ada38ead3e3e9efa3708e5349553"
+        "1f09a6987599d18264c1e1c92f2cf141630c7a3c4ab7c81b2f001698e7463b04"));
+}
+
+// Best of runs, one run is a whole mnemonic_to_seed worth of iterations
+static double bench_pbkdf2(PbkdfUpdate update, int runs, uint8_t key[SHA512_DIGEST_LENGTH]) {
+    double best = 0;
+    for(int i = 0; i < runs; i++) {
+        double start = get_time();
+        pbkdf2_run(update, "bench", "mnemonic", SEED_ROUNDS, key);
+        double time = get_time() - start;
+        if(!i || time < best) best = time;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int runs = DEFAULT_RUNS;
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:h")) != -1) {
+        if(opt == 'n') {
+            runs = atoi(optarg);
+        } else {
+            printf("Usage: %s [-n runs]\n", argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if(runs < 1) runs = 1;
+
+    srand(1);
+    test_sha512_nist();
+    test_transform_digest();
+    test_pbkdf2();
+
+    uint8_t generic_key[SHA512_DIGEST_LENGTH], digest_key[SHA512_DIGEST_LENGTH];
+    double generic = bench_pbkdf2(pbkdf2_update_generic, runs, generic_key);
+    double digest = bench_pbkdf2(pbkdf2_hmac_sha512_Update, runs, digest_key);
+    CHECK(!memcmp(generic_key, digest_key, sizeof(digest_key)));
+
+    // Two compressions per iteration
+    printf(
+        "sha512_Transform         %8.3f ms per seed  %6.0f ns per block\n",
+        generic * 1e3,
+        generic * 1e9 / (2 * SEED_ROUNDS));
+    printf(
+        "sha512_Transform_digest  %8.3f ms per seed  %6.0f ns per block  %.2fx\n",
+        digest * 1e3,
+        digest * 1e9 / (2 * SEED_ROUNDS),
+        generic / digest);
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -12,6 +12,9 @@
 #include <memzero.h>
 #include <rand.h>
 #include <curves.h>
+#include <ecdsa.h>
+#include <secp256k1.h>
+#include <sha2.h>
 #include <bip32.h>
 #include <bip39.h>
 
@@ -50,6 +53,7 @@ const char* TEXT_INFO = "-Scroll pages with up/down-"
 
 // #define TEXT_SAVE_QR "Save QR"
 #define TEXT_QRFILE_EXT ".qrcode" // 7 chars + 1 null
+#define CP_TABLE_FILE_NAME ".secp256k1.cp"
 
 // bip44_coin, xprv_version, xpub_version, addr_version, wif_version, addr_format
 const uint32_t COIN_INFO_ARRAY[4][6] = {
@@ -105,6 +109,44 @@ static bool s_warn_insecure = false;
 #define WARN_INSECURE_TEXT_2 "Set BIP39 Passphrase"
 //static bool s_busy = false;
 
+#if USE_PRECOMPUTED_CP_RUNTIME
+// Precomputed multiples of the secp256k1 base point (~36KB), cached on the SD card.
+// Makes every public key computation (fingerprints, xpubs, addresses) ~4x faster
+typedef struct {
+    curve_point cp[64][8];
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+} FlipBipCpTable;
+static FlipBipCpTable* s_cp_table = NULL;
+
+static void flipbip_scene_1_load_cp_table() {
+    if(s_cp_table != NULL) return;
+    s_cp_table = malloc(sizeof(FlipBipCpTable));
+
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    bool loaded = flipbip_load_file_raw(s_cp_table, sizeof(FlipBipCpTable), CP_TABLE_FILE_NAME);
+    if(loaded) {
+        // a broken table would silently produce wrong keys, check it before use
+        sha256_Raw((const uint8_t*)s_cp_table->cp, sizeof(s_cp_table->cp), digest);
+        loaded = memcmp(digest, s_cp_table->digest, SHA256_DIGEST_LENGTH) == 0 &&
+                 point_is_equal(&s_cp_table->cp[0][0], &secp256k1.G);
+    }
+    if(!loaded) {
+        // one time cost, roughly 20 plain scalar multiplications
+        ecdsa_precompute_cp(&secp256k1, s_cp_table->cp);
+        sha256_Raw((const uint8_t*)s_cp_table->cp, sizeof(s_cp_table->cp), s_cp_table->digest);
+        flipbip_save_file_raw(s_cp_table, sizeof(FlipBipCpTable), CP_TABLE_FILE_NAME);
+    }
+
+    ecdsa_set_precomputed_cp(&secp256k1, (const curve_point(*)[8])s_cp_table->cp);
+}
+
+static void flipbip_scene_1_free_cp_table() {
+    ecdsa_set_precomputed_cp(&secp256k1, NULL);
+    free(s_cp_table);
+    s_cp_table = NULL;
+}
+#endif
+
 void flipbip_scene_1_set_callback(
     FlipBipScene1* instance,
     FlipBipScene1Callback callback,
@@ -426,6 +468,11 @@ static int flipbip_scene_1_model_init(
     // Generate a BIP39 seed from the mnemonic
     mnemonic_to_seed(model->mnemonic, passphrase_text, model->seed, 0);
 
+#if USE_PRECOMPUTED_CP_RUNTIME
+    // Speed up all the public key derivations below
+    flipbip_scene_1_load_cp_table();
+#endif
+
     // Generate a BIP32 root HD node from the mnemonic
     HDNode* root = malloc(sizeof(HDNode));
     hdnode_from_seed(model->seed, 64, SECP256K1_NAME, root);
@@ -488,6 +535,10 @@ static int flipbip_scene_1_model_init(
 
     model->node = node;
 
+    // Addresses are derived from the change level node above, with its public key
+    // already filled each address costs a single base point multiplication
+    hdnode_fill_public_key(node);
+
     // Initialize addresses
     for(uint8_t a = 0; a < NUM_ADDRS; a++) {
         model->recv_addresses[a] = malloc(MAX_ADDR_BUF);
@@ -622,6 +673,10 @@ void flipbip_scene_1_exit(void* context) {
         },
         true);
 
+#if USE_PRECOMPUTED_CP_RUNTIME
+    flipbip_scene_1_free_cp_table();
+#endif
+
     flipbip_scene_1_clear_text();
 }
 
@@ -14,18 +14,26 @@
 #include <hex_editor_icons.h>
 #include <assets_icons.h>
 
+#include "hex_editor_cache.h"
+#include "hex_editor_pieces.h"
+
 #define TAG "HexEditor"
 
-#define STEP 6u
+#define ROW_BYTES 4u
+#define ROWS 5u
+#define SCREEN_BYTES (ROW_BYTES * ROWS)
+#define ROW_HEIGHT 10u
 
 typedef struct {
-    uint32_t file_offset;
-    uint32_t file_read_bytes;
     uint32_t file_size;
-    uint8_t string_offset;
-    char editable_char;
-    Stream* stream;
+    uint32_t top;
+    uint32_t cursor;
+    uint8_t screen[SCREEN_BYTES];
+    size_t screen_size;
+    uint8_t edit_value;
+    uint8_t edit_nibble;
     bool mode;
+    bool dirty;
 } HexEditorModel;
 
 typedef struct {
@@ -36,56 +44,90 @@ typedef struct {
     ViewPort* view_port;
     Gui* gui;
     Storage* storage;
+    DialogsApp* dialogs;
 
-    FuriString* buffer;
+    Stream* stream;
+    HexEditorCache* cache;
+    HexEditorPieces* pieces;
 } HexEditor;
 
+static char printable(uint8_t byte) {
+    return (byte >= 0x20 && byte < 0x7F) ? byte : '.';
+}
+
 static void draw_callback(Canvas* canvas, void* ctx) {
     HexEditor* hex_editor = ctx;
+    HexEditorModel* model = hex_editor->model;
+    char text[24];
 
     canvas_clear(canvas);
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 0, 10, "Line and mode:");
-
     canvas_set_font(canvas, FontSecondary);
 
-    uint8_t com_str_offset = 0;
-    uint8_t local_offset = MAX(hex_editor->model->string_offset - 5, 0);
-    // TODO UTF ?
-    for(uint8_t i = 0; i < MIN((uint8_t)128 / STEP, furi_string_size(hex_editor->buffer)); i++) {
-        if(i + local_offset >= furi_string_size(hex_editor->buffer)) {
-            break;
-        }
-        char a = furi_string_get_char(hex_editor->buffer, i + local_offset);
-        canvas_draw_glyph(
-            canvas, 0 + com_str_offset + (STEP - canvas_glyph_width(canvas, a)) / 2, 20, a);
-
-        com_str_offset += STEP;
+    if(!model->file_size) {
+        canvas_draw_str(canvas, 0, 10, "Empty file");
+        return;
     }
 
-    canvas_draw_icon(
+    snprintf(
+        text,
+        sizeof(text),
+        "%08lX/%08lX",
+        (unsigned long)model->cursor,
+        (unsigned long)model->file_size);
+    canvas_draw_str(canvas, 0, 8, text);
+    canvas_draw_str_aligned(
         canvas,
-        0 + MIN(hex_editor->model->string_offset, 5) * STEP - 4 + STEP / 2,
-        21,
-        &I_Pin_arrow_up_7x9);
-
-    if(hex_editor->model->mode) {
-        elements_button_left(canvas, "ASCII -");
-        elements_button_right(canvas, "ASCII +");
-        elements_button_center(canvas, "");
-
-        canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 0, 45, "edit");
-    } else {
-        elements_button_left(canvas, "");
-        elements_button_right(canvas, "");
-        elements_button_center(canvas, "chmod");
-
-        canvas_set_font(canvas, FontPrimary);
-        canvas_draw_str(canvas, 0, 45, "seek");
-    }
+        128,
+        0,
+        AlignRight,
+        AlignTop,
+        model->mode ? "edit" : (model->dirty ? "seek*" : "seek"));
 
-    canvas_draw_glyph(canvas, 30, 45, hex_editor->model->editable_char);
+    canvas_set_font(canvas, FontKeyboard);
+
+    for(uint8_t row = 0; row < ROWS; row++) {
+        uint32_t row_offset = model->top + row * ROW_BYTES;
+        uint8_t y = 19 + row * ROW_HEIGHT;
+
+        if(row * ROW_BYTES >= model->screen_size) break;
+
+        snprintf(text, sizeof(text), "%06lX", (unsigned long)(row_offset & 0xFFFFFF));
+        canvas_draw_str(canvas, 0, y, text);
+
+        for(uint8_t col = 0; col < ROW_BYTES; col++) {
+            size_t index = row * ROW_BYTES + col;
+            if(index >= model->screen_size) break;
+
+            uint8_t byte = model->screen[index];
+            bool selected = (row_offset + col == model->cursor);
+            uint8_t hex_x = 40 + col * 15;
+            uint8_t ascii_x = 104 + col * 6;
+
+            if(selected && model->mode) {
+                byte = model->edit_value;
+            }
+            snprintf(text, sizeof(text), "%02X", byte);
+
+            if(selected) {
+                canvas_draw_box(canvas, hex_x - 1, y - 8, 14, ROW_HEIGHT);
+                canvas_set_color(canvas, ColorWhite);
+                canvas_draw_str(canvas, hex_x, y, text);
+                canvas_set_color(canvas, ColorBlack);
+                canvas_draw_frame(canvas, ascii_x - 1, y - 8, 7, ROW_HEIGHT);
+                if(model->mode) {
+                    canvas_draw_line(
+                        canvas,
+                        hex_x + model->edit_nibble * 6,
+                        y + 1,
+                        hex_x + model->edit_nibble * 6 + 5,
+                        y + 1);
+                }
+            } else {
+                canvas_draw_str(canvas, hex_x, y, text);
+            }
+            canvas_draw_glyph(canvas, ascii_x, y, printable(byte));
+        }
+    }
 }
 
 static void input_callback(InputEvent* input_event, void* ctx) {
@@ -98,12 +140,11 @@ static void input_callback(InputEvent* input_event, void* ctx) {
 
 static HexEditor* hex_editor_alloc() {
     HexEditor* instance = malloc(sizeof(HexEditor));
+    memset(instance, 0x0, sizeof(HexEditor));
 
     instance->model = malloc(sizeof(HexEditorModel));
     memset(instance->model, 0x0, sizeof(HexEditorModel));
 
-    instance->model->editable_char = ' ';
-
     instance->input_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
 
     instance->view_port = view_port_alloc();
@@ -114,13 +155,13 @@ static HexEditor* hex_editor_alloc() {
     gui_add_view_port(instance->gui, instance->view_port, GuiLayerFullscreen);
 
     instance->storage = furi_record_open(RECORD_STORAGE);
-
-    instance->buffer = furi_string_alloc();
+    instance->dialogs = furi_record_open(RECORD_DIALOGS);
 
     return instance;
 }
 
 static void hex_editor_free(HexEditor* instance) {
+    furi_record_close(RECORD_DIALOGS);
     furi_record_close(RECORD_STORAGE);
 
     gui_remove_view_port(instance->gui, instance->view_port);
@@ -129,12 +170,16 @@ static void hex_editor_free(HexEditor* instance) {
 
     furi_message_queue_free(instance->input_queue);
 
-    if(instance->model->stream) {
-        buffered_file_stream_close(instance->model->stream);
-        stream_free(instance->model->stream);
+    if(instance->pieces) {
+        hex_editor_pieces_free(instance->pieces);
+    }
+    if(instance->cache) {
+        hex_editor_cache_free(instance->cache);
+    }
+    if(instance->stream) {
+        buffered_file_stream_close(instance->stream);
+        stream_free(instance->stream);
     }
-
-    furi_string_free(instance->buffer);
 
     free(instance->model);
     free(instance);
@@ -144,15 +189,154 @@ static bool hex_editor_open_file(HexEditor* hex_editor, const char* file_path) {
     furi_assert(hex_editor);
     furi_assert(file_path);
 
-    hex_editor->model->stream = buffered_file_stream_alloc(hex_editor->storage);
+    hex_editor->stream = buffered_file_stream_alloc(hex_editor->storage);
 
     if(!buffered_file_stream_open(
-           hex_editor->model->stream, file_path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
+           hex_editor->stream, file_path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING)) {
         FURI_LOG_E(TAG, "Unable to open stream: %s", file_path);
         return false;
     };
 
-    hex_editor->model->file_size = stream_size(hex_editor->model->stream);
+    hex_editor->cache = hex_editor_cache_alloc(hex_editor->stream);
+    hex_editor->pieces = hex_editor_pieces_alloc(hex_editor->cache);
+    hex_editor->model->file_size = hex_editor_pieces_size(hex_editor->pieces);
+
+    return true;
+}
+
+/* keep the cursor on screen and fetch the visible bytes through the piece table */
+static void hex_editor_refresh(HexEditor* hex_editor) {
+    HexEditorModel* model = hex_editor->model;
+    uint32_t cursor_row = model->cursor - (model->cursor % ROW_BYTES);
+
+    if(cursor_row < model->top) {
+        model->top = cursor_row;
+    } else if(cursor_row >= model->top + SCREEN_BYTES) {
+        model->top = cursor_row - (ROWS - 1) * ROW_BYTES;
+    }
+
+    model->screen_size =
+        hex_editor_pieces_read(hex_editor->pieces, model->top, model->screen, SCREEN_BYTES);
+    model->dirty = hex_editor_pieces_is_dirty(hex_editor->pieces);
+}
+
+static void hex_editor_move(HexEditor* hex_editor, int32_t delta) {
+    HexEditorModel* model = hex_editor->model;
+    int64_t cursor = (int64_t)model->cursor + delta;
+
+    model->cursor = CLAMP(cursor, (int64_t)model->file_size - 1, 0);
+}
+
+static bool hex_editor_save(HexEditor* hex_editor) {
+    bool success = hex_editor_pieces_save(hex_editor->pieces, hex_editor->stream) &&
+                   buffered_file_stream_sync(hex_editor->stream);
+
+    if(!success) {
+        FURI_LOG_E(TAG, "Unable to save");
+        DialogMessage* message = dialog_message_alloc();
+        dialog_message_set_text(message, "Unable to save file", 64, 32, AlignCenter, AlignCenter);
+        dialog_message_set_buttons(message, NULL, "Ok", NULL);
+        dialog_message_show(hex_editor->dialogs, message);
+        dialog_message_free(message);
+    }
+
+    return success;
+}
+
+static void hex_editor_commit(HexEditor* hex_editor) {
+    HexEditorModel* model = hex_editor->model;
+
+    if(!hex_editor_pieces_write(hex_editor->pieces, model->cursor, &model->edit_value, 1)) {
+        FURI_LOG_E(TAG, "Unable to edit %lu", (unsigned long)model->cursor);
+    }
+}
+
+static void hex_editor_start_edit(HexEditor* hex_editor, uint8_t nibble) {
+    HexEditorModel* model = hex_editor->model;
+
+    hex_editor_pieces_read(hex_editor->pieces, model->cursor, &model->edit_value, 1);
+    model->edit_nibble = nibble;
+    model->mode = true;
+}
+
+static void hex_editor_seek_input(HexEditor* hex_editor, InputEvent* event) {
+    HexEditorModel* model = hex_editor->model;
+
+    if(event->type == InputTypeLong) {
+        if(event->key == InputKeyLeft) {
+            model->cursor = 0;
+        } else if(event->key == InputKeyRight) {
+            model->cursor = model->file_size - 1;
+        } else if(event->key == InputKeyUp) {
+            hex_editor_move(hex_editor, -(int32_t)MAX(model->file_size / 16, SCREEN_BYTES));
+        } else if(event->key == InputKeyDown) {
+            hex_editor_move(hex_editor, MAX(model->file_size / 16, SCREEN_BYTES));
+        } else if(event->key == InputKeyOk && model->dirty) {
+            hex_editor_save(hex_editor);
+        }
+        return;
+    }
+
+    bool repeat = (event->type == InputTypeRepeat);
+    if(event->key == InputKeyLeft) {
+        hex_editor_move(hex_editor, repeat ? -(int32_t)ROW_BYTES : -1);
+    } else if(event->key == InputKeyRight) {
+        hex_editor_move(hex_editor, repeat ? ROW_BYTES : 1);
+    } else if(event->key == InputKeyUp) {
+        hex_editor_move(hex_editor, repeat ? -(int32_t)SCREEN_BYTES : -(int32_t)ROW_BYTES);
+    } else if(event->key == InputKeyDown) {
+        hex_editor_move(hex_editor, repeat ? SCREEN_BYTES : ROW_BYTES);
+    } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
+        hex_editor_start_edit(hex_editor, 0);
+    }
+}
+
+static void hex_editor_edit_input(HexEditor* hex_editor, InputEvent* event) {
+    HexEditorModel* model = hex_editor->model;
+    uint8_t shift = model->edit_nibble ? 0 : 4;
+    uint8_t nibble = (model->edit_value >> shift) & 0x0F;
+
+    if(event->key == InputKeyUp || event->key == InputKeyDown) {
+        nibble = (nibble + (event->key == InputKeyUp ? 1 : 15)) & 0x0F;
+        model->edit_value = (model->edit_value & ~(0x0F << shift)) | (nibble << shift);
+    } else if(event->key == InputKeyRight) {
+        if(!model->edit_nibble) {
+            model->edit_nibble = 1;
+        } else if(model->cursor + 1 < model->file_size) {
+            /* typing on into the next byte, consecutive edits share one piece */
+            hex_editor_commit(hex_editor);
+            model->cursor++;
+            hex_editor_start_edit(hex_editor, 0);
+        }
+    } else if(event->key == InputKeyLeft) {
+        if(model->edit_nibble) {
+            model->edit_nibble = 0;
+        } else if(model->cursor > 0) {
+            hex_editor_commit(hex_editor);
+            model->cursor--;
+            hex_editor_start_edit(hex_editor, 1);
+        }
+    } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
+        hex_editor_commit(hex_editor);
+        model->mode = false;
+    } else if(event->key == InputKeyBack && event->type == InputTypeShort) {
+        model->mode = false;
+    }
+}
+
+/* asks what to do with unsaved edits, returns true when the app may exit */
+static bool hex_editor_confirm_exit(HexEditor* hex_editor) {
+    if(!hex_editor->model->dirty) return true;
+
+    DialogMessage* message = dialog_message_alloc();
+    dialog_message_set_header(message, "Unsaved changes", 64, 0, AlignCenter, AlignTop);
+    dialog_message_set_text(message, "Save before exit?", 64, 32, AlignCenter, AlignCenter);
+    dialog_message_set_buttons(message, "Discard", "Stay", "Save");
+    DialogMessageButton button = dialog_message_show(hex_editor->dialogs, message);
+    dialog_message_free(message);
+
+    if(button == DialogMessageButtonCenter || button == DialogMessageButtonBack) return false;
+    if(button == DialogMessageButtonRight) return hex_editor_save(hex_editor);
 
     return true;
 }
@@ -176,10 +360,9 @@ int32_t hex_editor_app(void* p) {
             browser_options.hide_ext = false;
             browser_options.hide_dot_files = false;
 
-            DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
-            bool res = dialog_file_browser_show(dialogs, file_path, file_path, &browser_options);
+            bool res = dialog_file_browser_show(
+                hex_editor->dialogs, file_path, file_path, &browser_options);
 
-            furi_record_close(RECORD_DIALOGS);
             if(!res) {
                 FURI_LOG_I(TAG, "No file selected");
                 break;
@@ -190,13 +373,10 @@ int32_t hex_editor_app(void* p) {
 
         if(!hex_editor_open_file(hex_editor, furi_string_get_cstr(file_path))) break;
 
-        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-            FURI_LOG_T(TAG, "No keys left in dict");
-            break;
-        }
+        hex_editor_refresh(hex_editor);
+        view_port_update(hex_editor->view_port);
 
         InputEvent event;
-        int8_t offset_modifier;
         while(1) {
             // Выбираем событие из очереди в переменную event (ждем бесконечно долго, если очередь пуста)
             // и проверяем, что у нас получилось это сделать
@@ -204,141 +384,20 @@ int32_t hex_editor_app(void* p) {
                 furi_message_queue_get(hex_editor->input_queue, &event, FuriWaitForever) ==
                 FuriStatusOk);
 
-            // Если нажата кнопка "назад", то выходим из цикла, а следовательно и из приложения
-            if(event.type == InputTypeShort || event.type == InputTypeRepeat) {
-                if(!hex_editor->model->mode) {
-                    offset_modifier = 1;
-                    if(event.type == InputTypeRepeat) {
-                        offset_modifier = 3;
-                    }
-                    if(event.key == InputKeyRight) {
-                        hex_editor->model->string_offset += offset_modifier;
-                        if(hex_editor->model->string_offset >=
-                           furi_string_size(hex_editor->buffer)) {
-                            // dengeros
-                            hex_editor->model->string_offset -=
-                                furi_string_size(hex_editor->buffer);
-                        }
-                    }
-                    if(event.key == InputKeyLeft) {
-                        if(hex_editor->model->string_offset - offset_modifier < 0) {
-                            // dengeros
-                            hex_editor->model->string_offset +=
-                                furi_string_size(hex_editor->buffer);
-                        }
-                        hex_editor->model->string_offset -= offset_modifier;
-                    }
-                    if(event.key == InputKeyDown) {
-                        hex_editor->model->string_offset = 0;
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                        }
-                    }
-                    if(event.key == InputKeyUp) {
-                        hex_editor->model->string_offset = 0;
-
-                        if(!stream_seek(hex_editor->model->stream, -1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-                        // NOT work on first line
-                        stream_seek_to_char(
-                            hex_editor->model->stream, '\n', StreamDirectionBackward);
-
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            stream_rewind(hex_editor->model->stream);
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream, 1, StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek stream");
-                                break;
-                            }
-                        }
-
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                            break;
-                        }
-                    }
-
-                    if(event.key == InputKeyOk) {
-                        hex_editor->model->editable_char = furi_string_get_char(
-                            hex_editor->buffer, hex_editor->model->string_offset);
-
-                        hex_editor->model->mode = 1;
-                    }
-                } else {
-                    offset_modifier = 1;
-                    if(event.type == InputTypeRepeat) {
-                        offset_modifier = 4;
-                    }
-                    if(event.key == InputKeyRight) {
-                        hex_editor->model->editable_char += offset_modifier;
-                    }
-                    if(event.key == InputKeyLeft) {
-                        hex_editor->model->editable_char -= offset_modifier;
-                    }
-
-                    if(event.key == InputKeyOk) {
-                        if(!stream_seek(hex_editor->model->stream, -1, StreamOffsetFromCurrent)) {
-                            FURI_LOG_E(TAG, "Unable to seek stream");
-                            break;
-                        }
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            FURI_LOG_E(TAG, "Unable to stream_seek_to_char n");
-                            // first line
-                            stream_seek(hex_editor->model->stream, 0, StreamOffsetFromStart);
-                            if(!stream_seek(
-                                   hex_editor->model->stream,
-                                   hex_editor->model->string_offset,
-                                   StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek string_offset");
-                            }
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream,
-                                   hex_editor->model->string_offset + 1,
-                                   StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek string_offset +1");
-                            }
-                        }
-
-                        if(!stream_write_char(
-                               hex_editor->model->stream, hex_editor->model->editable_char)) {
-                            FURI_LOG_E(TAG, "Unable to stream_write_char");
-                            break;
-                        }
-
-                        hex_editor->model->editable_char = ' ';
-
-                        hex_editor->model->mode = 0;
-
-                        if(!stream_seek_to_char(
-                               hex_editor->model->stream, '\n', StreamDirectionBackward)) {
-                            FURI_LOG_E(TAG, "Unable to stream_seek_to_char n 2");
-                            // first line
-                            stream_seek(hex_editor->model->stream, 0, StreamOffsetFromStart);
-                        } else {
-                            if(!stream_seek(
-                                   hex_editor->model->stream, 1, StreamOffsetFromCurrent)) {
-                                FURI_LOG_E(TAG, "Unable to seek stream");
-                                break;
-                            }
-                        }
-
-                        if(!stream_read_line(hex_editor->model->stream, hex_editor->buffer)) {
-                            FURI_LOG_T(TAG, "No keys left in dict");
-                            break;
-                        }
-                    }
-                }
+            if(event.type != InputTypeShort && event.type != InputTypeRepeat &&
+               event.type != InputTypeLong) {
+                continue;
             }
-            if(event.key == InputKeyBack) {
-                break;
+
+            if(hex_editor->model->mode) {
+                hex_editor_edit_input(hex_editor, &event);
+            } else if(event.key == InputKeyBack) {
+                if(event.type == InputTypeShort && hex_editor_confirm_exit(hex_editor)) break;
+            } else if(hex_editor->model->file_size) {
+                hex_editor_seek_input(hex_editor, &event);
             }
-            // ?
+
+            hex_editor_refresh(hex_editor);
             view_port_update(hex_editor->view_port);
         }
     } while(false);
@@ -347,4 +406,4 @@ int32_t hex_editor_app(void* p) {
     hex_editor_free(hex_editor);
 
     return 0;
-}
\ No newline at end of file
+}
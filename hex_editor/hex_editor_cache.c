@@ -0,0 +1,113 @@
+#include "hex_editor_cache.h"
+
+#include <furi.h>
+
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t used;
+    uint8_t data[HEX_EDITOR_PAGE_SIZE];
+} HexEditorPage;
+
+struct HexEditorCache {
+    Stream* stream;
+    uint32_t size;
+    uint32_t clock;
+    uint32_t hits;
+    uint32_t misses;
+    HexEditorPage* last;
+    HexEditorPage pages[HEX_EDITOR_PAGE_COUNT];
+};
+
+HexEditorCache* hex_editor_cache_alloc(Stream* stream) {
+    furi_assert(stream);
+
+    HexEditorCache* cache = malloc(sizeof(HexEditorCache));
+    memset(cache, 0, sizeof(HexEditorCache));
+    cache->stream = stream;
+    cache->size = stream_size(stream);
+
+    return cache;
+}
+
+void hex_editor_cache_free(HexEditorCache* cache) {
+    furi_assert(cache);
+    free(cache);
+}
+
+uint32_t hex_editor_cache_size(HexEditorCache* cache) {
+    return cache->size;
+}
+
+void hex_editor_cache_invalidate(HexEditorCache* cache) {
+    for(size_t i = 0; i < HEX_EDITOR_PAGE_COUNT; i++) {
+        cache->pages[i].length = 0;
+        cache->pages[i].used = 0;
+    }
+    cache->last = NULL;
+    cache->size = stream_size(cache->stream);
+}
+
+void hex_editor_cache_stats(HexEditorCache* cache, uint32_t* hits, uint32_t* misses) {
+    *hits = cache->hits;
+    *misses = cache->misses;
+}
+
+static HexEditorPage* hex_editor_cache_page(HexEditorCache* cache, uint32_t page_offset) {
+    /* consecutive reads mostly stay within one page */
+    if(cache->last && cache->last->length && cache->last->offset == page_offset) {
+        cache->hits++;
+        cache->last->used = ++cache->clock;
+        return cache->last;
+    }
+
+    HexEditorPage* victim = &cache->pages[0];
+    for(size_t i = 0; i < HEX_EDITOR_PAGE_COUNT; i++) {
+        HexEditorPage* page = &cache->pages[i];
+        if(page->length && page->offset == page_offset) {
+            cache->hits++;
+            page->used = ++cache->clock;
+            cache->last = page;
+            return page;
+        }
+        if(page->used < victim->used) {
+            victim = page;
+        }
+    }
+
+    cache->misses++;
+    victim->length = 0;
+    if(!stream_seek(cache->stream, page_offset, StreamOffsetFromStart)) {
+        return NULL;
+    }
+    victim->length = stream_read(cache->stream, victim->data, HEX_EDITOR_PAGE_SIZE);
+    if(!victim->length) {
+        return NULL;
+    }
+    victim->offset = page_offset;
+    victim->used = ++cache->clock;
+    cache->last = victim;
+
+    return victim;
+}
+
+size_t hex_editor_cache_read(HexEditorCache* cache, uint32_t offset, uint8_t* data, size_t size) {
+    furi_assert(cache);
+    size_t done = 0;
+
+    while(done < size && offset < cache->size) {
+        uint32_t page_offset = offset - (offset % HEX_EDITOR_PAGE_SIZE);
+        HexEditorPage* page = hex_editor_cache_page(cache, page_offset);
+        if(!page) break;
+
+        uint32_t in_page = offset - page_offset;
+        if(in_page >= page->length) break;
+
+        size_t chunk = MIN(size - done, page->length - in_page);
+        memcpy(data + done, page->data + in_page, chunk);
+        done += chunk;
+        offset += chunk;
+    }
+
+    return done;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <toolbox/stream/stream.h>
+
+/* Fixed size LRU cache of file pages, the view and the piece table read through it so
+   scrolling and jumping only touch the SD card when a page is not resident */
+
+#define HEX_EDITOR_PAGE_SIZE 256u
+#define HEX_EDITOR_PAGE_COUNT 8u
+
+typedef struct HexEditorCache HexEditorCache;
+
+HexEditorCache* hex_editor_cache_alloc(Stream* stream);
+
+void hex_editor_cache_free(HexEditorCache* cache);
+
+uint32_t hex_editor_cache_size(HexEditorCache* cache);
+
+/** Copy up to size bytes starting at offset, returns the number of bytes read */
+size_t hex_editor_cache_read(HexEditorCache* cache, uint32_t offset, uint8_t* data, size_t size);
+
+/** Drop all pages, called after the file was written behind the cache */
+void hex_editor_cache_invalidate(HexEditorCache* cache);
+
+void hex_editor_cache_stats(HexEditorCache* cache, uint32_t* hits, uint32_t* misses);
@@ -0,0 +1,214 @@
+#include "hex_editor_pieces.h"
+
+#include <furi.h>
+
+#define HEX_EDITOR_PIECES_STEP 16u
+#define HEX_EDITOR_ADDED_STEP 64u
+
+typedef struct {
+    /* position in the file, pieces are sorted and cover it without gaps */
+    uint32_t offset;
+    uint32_t length;
+    /* position in the add buffer, only for edited pieces */
+    uint32_t source;
+    bool edited;
+} HexEditorPiece;
+
+struct HexEditorPieces {
+    HexEditorCache* cache;
+    uint32_t size;
+
+    HexEditorPiece* list;
+    size_t count;
+    size_t capacity;
+
+    uint8_t* added;
+    size_t added_size;
+    size_t added_capacity;
+};
+
+static void hex_editor_pieces_reset(HexEditorPieces* pieces) {
+    pieces->size = hex_editor_cache_size(pieces->cache);
+    pieces->count = 0;
+    if(pieces->size) {
+        pieces->list[0] = (HexEditorPiece){.offset = 0, .length = pieces->size};
+        pieces->count = 1;
+    }
+    pieces->added_size = 0;
+}
+
+HexEditorPieces* hex_editor_pieces_alloc(HexEditorCache* cache) {
+    furi_assert(cache);
+
+    HexEditorPieces* pieces = malloc(sizeof(HexEditorPieces));
+    memset(pieces, 0, sizeof(HexEditorPieces));
+    pieces->cache = cache;
+    pieces->capacity = HEX_EDITOR_PIECES_STEP;
+    pieces->list = malloc(pieces->capacity * sizeof(HexEditorPiece));
+    hex_editor_pieces_reset(pieces);
+
+    return pieces;
+}
+
+void hex_editor_pieces_free(HexEditorPieces* pieces) {
+    furi_assert(pieces);
+    free(pieces->added);
+    free(pieces->list);
+    free(pieces);
+}
+
+uint32_t hex_editor_pieces_size(HexEditorPieces* pieces) {
+    return pieces->size;
+}
+
+bool hex_editor_pieces_is_dirty(HexEditorPieces* pieces) {
+    return pieces->added_size > 0;
+}
+
+size_t hex_editor_pieces_count(HexEditorPieces* pieces) {
+    return pieces->count;
+}
+
+/* index of the piece containing offset */
+static size_t hex_editor_pieces_find(HexEditorPieces* pieces, uint32_t offset) {
+    size_t low = 0;
+    size_t high = pieces->count;
+
+    while(high - low > 1) {
+        size_t mid = (low + high) / 2;
+        if(pieces->list[mid].offset <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+size_t
+    hex_editor_pieces_read(HexEditorPieces* pieces, uint32_t offset, uint8_t* data, size_t size) {
+    furi_assert(pieces);
+    if(offset >= pieces->size) return 0;
+
+    size = MIN(size, pieces->size - offset);
+    size_t done = 0;
+
+    for(size_t index = hex_editor_pieces_find(pieces, offset); done < size; index++) {
+        const HexEditorPiece* piece = &pieces->list[index];
+        uint32_t in_piece = offset - piece->offset;
+        size_t chunk = MIN(size - done, piece->length - in_piece);
+
+        if(piece->edited) {
+            memcpy(data + done, pieces->added + piece->source + in_piece, chunk);
+        } else {
+            size_t read = hex_editor_cache_read(pieces->cache, offset, data + done, chunk);
+            if(read != chunk) return done + read;
+        }
+        done += chunk;
+        offset += chunk;
+    }
+
+    return done;
+}
+
+bool hex_editor_pieces_write(
+    HexEditorPieces* pieces,
+    uint32_t offset,
+    const uint8_t* data,
+    size_t size) {
+    furi_assert(pieces);
+    if(!size || offset >= pieces->size || size > pieces->size - offset) return false;
+
+    size_t first = hex_editor_pieces_find(pieces, offset);
+    HexEditorPiece* piece = &pieces->list[first];
+
+    /* editing bytes that were already edited, patch the add buffer in place */
+    if(piece->edited && offset + size <= piece->offset + piece->length) {
+        memcpy(pieces->added + piece->source + (offset - piece->offset), data, size);
+        return true;
+    }
+
+    size_t last = hex_editor_pieces_find(pieces, offset + size - 1);
+
+    if(pieces->added_size + size > pieces->added_capacity) {
+        pieces->added_capacity = pieces->added_size + size + HEX_EDITOR_ADDED_STEP;
+        pieces->added = realloc(pieces->added, pieces->added_capacity);
+    }
+    uint32_t source = pieces->added_size;
+    memcpy(pieces->added + source, data, size);
+    pieces->added_size += size;
+
+    /* pieces first..last are replaced by what is left of them around the edit */
+    HexEditorPiece left = pieces->list[first];
+    left.length = offset - left.offset;
+
+    HexEditorPiece right = pieces->list[last];
+    uint32_t cut = offset + size - right.offset;
+    right.offset += cut;
+    right.length -= cut;
+    if(right.edited) right.source += cut;
+
+    /* typing forward appends to the piece of the previous edit, which either ends right
+       before the edit or is split by it */
+    HexEditorPiece* previous = NULL;
+    if(left.length) {
+        previous = &left;
+    } else if(first > 0) {
+        previous = &pieces->list[first - 1];
+    }
+    bool extend = previous && previous->edited &&
+                  previous->source + previous->length == source;
+
+    HexEditorPiece replacement[3];
+    size_t replacement_count = 0;
+
+    if(extend) {
+        previous->length += size;
+    }
+    if(left.length) {
+        replacement[replacement_count++] = left;
+    }
+    if(!extend) {
+        replacement[replacement_count++] =
+            (HexEditorPiece){.offset = offset, .length = size, .source = source, .edited = true};
+    }
+    if(right.length) {
+        replacement[replacement_count++] = right;
+    }
+
+    size_t removed = last - first + 1;
+    size_t count = pieces->count - removed + replacement_count;
+    if(count > pieces->capacity) {
+        pieces->capacity = count + HEX_EDITOR_PIECES_STEP;
+        pieces->list = realloc(pieces->list, pieces->capacity * sizeof(HexEditorPiece));
+    }
+    memmove(
+        &pieces->list[first + replacement_count],
+        &pieces->list[last + 1],
+        (pieces->count - last - 1) * sizeof(HexEditorPiece));
+    memcpy(&pieces->list[first], replacement, replacement_count * sizeof(HexEditorPiece));
+    pieces->count = count;
+
+    return true;
+}
+
+bool hex_editor_pieces_save(HexEditorPieces* pieces, Stream* stream) {
+    furi_assert(pieces);
+    furi_assert(stream);
+
+    for(size_t index = 0; index < pieces->count; index++) {
+        const HexEditorPiece* piece = &pieces->list[index];
+        if(!piece->edited) continue;
+
+        if(!stream_seek(stream, piece->offset, StreamOffsetFromStart)) return false;
+        if(stream_write(stream, pieces->added + piece->source, piece->length) != piece->length) {
+            return false;
+        }
+    }
+
+    hex_editor_cache_invalidate(pieces->cache);
+    hex_editor_pieces_reset(pieces);
+
+    return true;
+}
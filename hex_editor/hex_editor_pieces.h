@@ -0,0 +1,34 @@
+#pragma once
+
+#include "hex_editor_cache.h"
+
+/* Piece table over the cached file. Edits overwrite bytes, so the file never changes size:
+   the table starts as one piece spanning the original file and every edit splits it and
+   points the edited range at an append-only buffer. Saving writes only the edited pieces,
+   in file order, in a single pass. */
+
+typedef struct HexEditorPieces HexEditorPieces;
+
+HexEditorPieces* hex_editor_pieces_alloc(HexEditorCache* cache);
+
+void hex_editor_pieces_free(HexEditorPieces* pieces);
+
+uint32_t hex_editor_pieces_size(HexEditorPieces* pieces);
+
+/** Copy the edited view of the file, returns the number of bytes read */
+size_t
+    hex_editor_pieces_read(HexEditorPieces* pieces, uint32_t offset, uint8_t* data, size_t size);
+
+/** Overwrite size bytes at offset, the range has to lie within the file */
+bool hex_editor_pieces_write(
+    HexEditorPieces* pieces,
+    uint32_t offset,
+    const uint8_t* data,
+    size_t size);
+
+bool hex_editor_pieces_is_dirty(HexEditorPieces* pieces);
+
+size_t hex_editor_pieces_count(HexEditorPieces* pieces);
+
+/** Write the edited pieces back to the stream and reset the table to the saved file */
+bool hex_editor_pieces_save(HexEditorPieces* pieces, Stream* stream);
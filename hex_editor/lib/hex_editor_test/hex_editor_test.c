@@ -0,0 +1,242 @@
+// Host test of the hex editor storage path: opens a multi-megabyte file through the page cache
+// and piece table, times scrolling and random jumps against plain stream reads, applies random
+// edits and checks every read against an in-memory mirror, then saves and compares the file.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hex_editor_cache.h"
+#include "hex_editor_pieces.h"
+
+#define DEFAULT_PATH "/tmp/hex_editor_test.bin"
+#define DEFAULT_SIZE_MB (4)
+#define DEFAULT_OPS (100000)
+#define DEFAULT_EDITS (2000)
+#define VERIFY_READS (20000)
+
+// Same geometry as the app's view
+#define ROW_BYTES (4)
+#define SCREEN_BYTES (20)
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t random_offset(uint32_t size) {
+    return ((uint32_t)rand() << 16 ^ (uint32_t)rand()) % size;
+}
+
+static bool create_file(const char* path, uint8_t* mirror, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if(!file) return false;
+
+    for(size_t i = 0; i < size; i++) mirror[i] = rand();
+    bool ok = fwrite(mirror, 1, size, file) == size;
+    fclose(file);
+    return ok;
+}
+
+static void stream_reset_stats(Stream* stream) {
+    stream->seeks = stream->reads = stream->writes = 0;
+    stream->read_bytes = stream->written_bytes = 0;
+}
+
+// Next screen position: scrolling moves one row, jumping goes anywhere in the file
+static uint32_t next_top(uint32_t top, uint32_t size, bool jump) {
+    if(jump) return random_offset(size - SCREEN_BYTES) & ~(ROW_BYTES - 1);
+    top += ROW_BYTES;
+    return top + SCREEN_BYTES > size ? 0 : top;
+}
+
+static bool bench_view(
+    const char* name,
+    Stream* stream,
+    HexEditorPieces* pieces,
+    const uint8_t* mirror,
+    uint32_t size,
+    size_t ops,
+    bool jump) {
+    uint8_t screen[SCREEN_BYTES];
+    uint32_t top = 0;
+    bool ok = true;
+
+    // Direct: what the view costs when every redraw goes to the stream
+    srand(2);
+    stream_reset_stats(stream);
+    double start = get_time();
+    for(size_t op = 0; op < ops; op++) {
+        top = next_top(top, size, jump);
+        stream_seek(stream, top, StreamOffsetFromStart);
+        stream_read(stream, screen, SCREEN_BYTES);
+    }
+    double direct = get_time() - start;
+    size_t direct_reads = stream->reads;
+
+    srand(2);
+    top = 0;
+    stream_reset_stats(stream);
+    start = get_time();
+    for(size_t op = 0; op < ops; op++) {
+        top = next_top(top, size, jump);
+        if(hex_editor_pieces_read(pieces, top, screen, SCREEN_BYTES) != SCREEN_BYTES ||
+           memcmp(screen, mirror + top, SCREEN_BYTES)) {
+            ok = false;
+        }
+    }
+    double cached = get_time() - start;
+
+    printf(
+        "%-7s direct %7.0f ns/op %5.2f reads/op | cached %7.0f ns/op %5.2f reads/op\n",
+        name,
+        direct * 1e9 / ops,
+        (double)direct_reads / ops,
+        cached * 1e9 / ops,
+        (double)stream->reads / ops);
+
+    return ok;
+}
+
+static bool verify_reads(HexEditorPieces* pieces, const uint8_t* mirror, uint32_t size) {
+    uint8_t data[64];
+
+    for(size_t i = 0; i < VERIFY_READS; i++) {
+        uint32_t offset = random_offset(size);
+        size_t length = 1 + rand() % sizeof(data);
+        size_t expected = MIN(length, size - offset);
+
+        if(hex_editor_pieces_read(pieces, offset, data, length) != expected ||
+           memcmp(data, mirror + offset, expected)) {
+            fprintf(stderr, "read mismatch at 0x%08X+%zu\n", offset, length);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void apply_edits(HexEditorPieces* pieces, uint8_t* mirror, uint32_t size, size_t edits) {
+    for(size_t edit = 0; edit < edits; edit++) {
+        uint32_t offset = random_offset(size);
+        // Mostly single bytes, some typed runs that should share one piece, some re-edits
+        size_t run = (rand() % 4 == 0) ? 1 + rand() % 16 : 1;
+
+        for(size_t i = 0; i < run && offset + i < size; i++) {
+            uint8_t value = rand();
+            hex_editor_pieces_write(pieces, offset + i, &value, 1);
+            mirror[offset + i] = value;
+        }
+        if(rand() % 8 == 0) {
+            uint8_t value = rand();
+            hex_editor_pieces_write(pieces, offset, &value, 1);
+            mirror[offset] = value;
+        }
+    }
+}
+
+static bool compare_file(const char* path, const uint8_t* mirror, size_t size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return false;
+
+    uint8_t* data = malloc(size + 1);
+    bool ok = fread(data, 1, size + 1, file) == size && !memcmp(data, mirror, size);
+    free(data);
+    fclose(file);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const char* path = DEFAULT_PATH;
+    size_t size_mb = DEFAULT_SIZE_MB;
+    size_t ops = DEFAULT_OPS;
+    size_t edits = DEFAULT_EDITS;
+    int opt;
+
+    while((opt = getopt(argc, argv, "f:s:j:e:h")) != -1) {
+        if(opt == 'f') {
+            path = optarg;
+        } else if(opt == 's') {
+            size_mb = strtoul(optarg, NULL, 0);
+        } else if(opt == 'j') {
+            ops = strtoul(optarg, NULL, 0);
+        } else if(opt == 'e') {
+            edits = strtoul(optarg, NULL, 0);
+        } else {
+            printf("Usage: %s [-f file] [-s MiB] [-j views] [-e edits]\n", argv[0]);
+            printf("  the file is overwritten with random data\n");
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    uint32_t size = size_mb * 1024 * 1024;
+    if(size < SCREEN_BYTES || ops == 0) {
+        fprintf(stderr, "File too small\n");
+        return 1;
+    }
+
+    uint8_t* mirror = malloc(size);
+    srand(1);
+    if(!create_file(path, mirror, size)) {
+        fprintf(stderr, "Unable to create %s\n", path);
+        return 1;
+    }
+
+    Stream* stream = host_stream_open(path);
+    HexEditorCache* cache = hex_editor_cache_alloc(stream);
+    HexEditorPieces* pieces = hex_editor_pieces_alloc(cache);
+    bool ok = true;
+
+    printf(
+        "%zu MiB file, %u x %u byte pages, %zu views\n",
+        size_mb,
+        HEX_EDITOR_PAGE_COUNT,
+        HEX_EDITOR_PAGE_SIZE,
+        ops);
+    ok &= bench_view("scroll", stream, pieces, mirror, size, ops, false);
+    ok &= bench_view("jump", stream, pieces, mirror, size, ops, true);
+
+    uint32_t hits, misses;
+    hex_editor_cache_stats(cache, &hits, &misses);
+    printf("cache: %u hits, %u misses\n", hits, misses);
+
+    srand(3);
+    double start = get_time();
+    apply_edits(pieces, mirror, size, edits);
+    double edit_time = get_time() - start;
+    printf(
+        "edits: %zu in %.1f ms, %zu pieces\n",
+        edits,
+        edit_time * 1e3,
+        hex_editor_pieces_count(pieces));
+    ok &= verify_reads(pieces, mirror, size);
+
+    stream_reset_stats(stream);
+    start = get_time();
+    ok &= hex_editor_pieces_save(pieces, stream);
+    fflush(stream->file);
+    double save_time = get_time() - start;
+    printf(
+        "save:  %.2f ms, %zu writes, %zu bytes written\n",
+        save_time * 1e3,
+        stream->writes,
+        stream->written_bytes);
+
+    ok &= !hex_editor_pieces_is_dirty(pieces) && hex_editor_pieces_count(pieces) == 1;
+    ok &= verify_reads(pieces, mirror, size);
+    ok &= compare_file(path, mirror, size);
+
+    hex_editor_pieces_free(pieces);
+    hex_editor_cache_free(cache);
+    host_stream_close(stream);
+    free(mirror);
+    unlink(path);
+
+    if(!ok) {
+        fprintf(stderr, "FAILED\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "furi_host.h"
+
+Stream* host_stream_open(const char* path) {
+    FILE* file = fopen(path, "r+b");
+    if(!file) return NULL;
+
+    Stream* stream = calloc(1, sizeof(Stream));
+    stream->file = file;
+    return stream;
+}
+
+void host_stream_close(Stream* stream) {
+    fclose(stream->file);
+    free(stream);
+}
+
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type) {
+    static const int whence[] = {
+        [StreamOffsetFromCurrent] = SEEK_CUR,
+        [StreamOffsetFromStart] = SEEK_SET,
+        [StreamOffsetFromEnd] = SEEK_END,
+    };
+    stream->seeks++;
+    return fseek(stream->file, offset, whence[offset_type]) == 0;
+}
+
+size_t stream_tell(Stream* stream) {
+    return ftell(stream->file);
+}
+
+size_t stream_size(Stream* stream) {
+    long position = ftell(stream->file);
+    fseek(stream->file, 0, SEEK_END);
+    long size = ftell(stream->file);
+    fseek(stream->file, position, SEEK_SET);
+    return size;
+}
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size) {
+    size_t read = fread(data, 1, size, stream->file);
+    stream->reads++;
+    stream->read_bytes += read;
+    return read;
+}
+
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size) {
+    size_t written = fwrite(data, 1, size, stream->file);
+    stream->writes++;
+    stream->written_bytes += written;
+    return written;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Just enough of the firmware API for the page cache and piece table to build on a host.
+// furi.h and toolbox/stream/stream.h are generated by the Makefile as a one-line include of
+// this, the Stream is backed by a stdio FILE and counts the calls that reach it.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) assert(x)
+#define furi_check(x) assert(x)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+typedef enum {
+    StreamOffsetFromCurrent,
+    StreamOffsetFromStart,
+    StreamOffsetFromEnd,
+} StreamOffset;
+
+typedef struct {
+    FILE* file;
+    size_t seeks;
+    size_t reads;
+    size_t writes;
+    size_t read_bytes;
+    size_t written_bytes;
+} Stream;
+
+Stream* host_stream_open(const char* path);
+void host_stream_close(Stream* stream);
+
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type);
+size_t stream_tell(Stream* stream);
+size_t stream_size(Stream* stream);
+size_t stream_read(Stream* stream, uint8_t* data, size_t size);
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size);
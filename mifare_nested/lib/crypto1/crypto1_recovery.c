@@ -0,0 +1,514 @@
+#pragma GCC optimize("O3")
+#pragma GCC optimize("-funroll-all-loops")
+
+#include "crypto1_recovery.h"
+#include "crypto1.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Chunked lfsr_recovery32 (crapto1) based on Mfkey32 by noproto. Instead of keeping two 2^21
+// state tables it enumerates all odd/even semi states once per round and keeps only the ones
+// whose feedback contribution MSB falls into current chunk.
+
+#define CONST_M1_1 (LF_POLY_EVEN << 1 | 1)
+#define CONST_M2_1 (LF_POLY_ODD << 1)
+#define CONST_M1_2 (LF_POLY_ODD)
+#define CONST_M2_2 (LF_POLY_EVEN << 1 | 1)
+
+#define MSB_BUCKET_SIZE (768)
+#define STATES_BUFFER_SIZE (1024)
+#define TEMP_STATES_SIZE (2 * MSB_BUCKET_SIZE)
+#define SEMI_STATES_PER_BLOCK ((1 << 20) / CRYPTO1_RECOVERY_BLOCKS_PER_ROUND)
+
+typedef struct {
+    uint32_t odd;
+    uint32_t even;
+} RecoveryState;
+
+typedef struct {
+    uint32_t tail;
+    uint32_t states[MSB_BUCKET_SIZE];
+} MsbBucket;
+
+typedef struct {
+    uint32_t uid_xor_nt0;
+    uint32_t uid_xor_nt1;
+    uint32_t ks0;
+    uint32_t ks1;
+    uint64_t* keys;
+    uint32_t keys_size;
+    uint32_t keys_found;
+} NestedParams;
+
+typedef struct {
+    uint32_t* states_buffer;
+    MsbBucket* odd_msbs;
+    MsbBucket* even_msbs;
+    uint32_t* temp_states_odd;
+    uint32_t* temp_states_even;
+    uint32_t chunk_size;
+    NestedParams params;
+    Crypto1RecoveryCallback callback;
+    void* context;
+    uint32_t total;
+} RecoveryContext;
+
+static const uint8_t lookup1[256] = {
+    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16,
+    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24, 8, 8,  24, 24, 8,  24, 8,  8,
+    8, 24, 8,  8,  24, 24, 24, 24, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    0, 0,  16, 16, 0,  16, 0,  0,  0, 16, 0,  0,  16, 16, 16, 16, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24, 0, 0,  16, 16, 0,  16, 0,  0,
+    0, 16, 0,  0,  16, 16, 16, 16, 8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24,
+    8, 8,  24, 24, 8,  24, 8,  8,  8, 24, 8,  8,  24, 24, 24, 24};
+static const uint8_t lookup2[256] = {
+    0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4,
+    4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6,
+    2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2,
+    2, 2, 6, 2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4,
+    0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2,
+    2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4,
+    4, 4, 0, 0, 4, 4, 0, 4, 0, 0, 0, 4, 0, 0, 4, 4, 4, 4, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2,
+    2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2,
+    2, 6, 2, 2, 6, 6, 6, 6, 2, 2, 6, 6, 2, 6, 2, 2, 2, 6, 2, 2, 6, 6, 6, 6};
+
+static inline uint32_t filter(uint32_t x) {
+    uint32_t f;
+    f = lookup1[x & 0xff] | lookup2[(x >> 8) & 0xff];
+    f |= 0x0d938 >> (x >> 16 & 0xf) & 1;
+    return (0xEC57E80A >> f) & 1;
+}
+
+static inline uint32_t parity32(uint32_t x) {
+    return __builtin_parity(x);
+}
+
+static inline void update_contribution(uint32_t* item, uint32_t m1, uint32_t m2, uint32_t in) {
+    uint32_t p = *item >> 25;
+    p = p << 1 | parity32(*item & m1);
+    p = p << 1 | parity32(*item & m2);
+    *item = (p << 24 | (*item & 0xffffff)) ^ in;
+}
+
+static void crypto1_get_lfsr(RecoveryState* state, uint64_t* lfsr) {
+    *lfsr = 0;
+    for(int i = 23; i >= 0; --i) {
+        *lfsr = *lfsr << 1 | ((state->odd >> (i ^ 3)) & 1);
+        *lfsr = *lfsr << 1 | ((state->even >> (i ^ 3)) & 1);
+    }
+}
+
+static uint32_t crypt_word(RecoveryState* s, uint32_t in) {
+    uint32_t ret = 0;
+    for(int i = 0; i < 32; i++) {
+        ret |= filter(s->odd) << (24 ^ i);
+        uint32_t feedin = LF_POLY_EVEN & s->even;
+        feedin ^= LF_POLY_ODD & s->odd;
+        feedin ^= !!BEBIT(in, i);
+        s->even = s->even << 1 | parity32(feedin);
+        uint32_t t = s->odd;
+        s->odd = s->even;
+        s->even = t;
+    }
+    return ret;
+}
+
+static void rollback_word(RecoveryState* s, uint32_t in) {
+    for(int i = 31; i >= 0; i--) {
+        s->odd &= 0xffffff;
+        uint32_t t = s->odd;
+        s->odd = s->even;
+        s->even = t;
+        uint32_t feedin = s->even & 1;
+        feedin ^= LF_POLY_EVEN & (s->even >>= 1);
+        feedin ^= LF_POLY_ODD & s->odd;
+        feedin ^= !!BEBIT(in, i);
+        s->even |= parity32(feedin) << 23;
+    }
+}
+
+// State after the first keystream word: roll back to the key and check both nonces with it
+static void check_state(RecoveryState* t, NestedParams* p) {
+    if(!(t->odd | t->even)) return;
+
+    rollback_word(t, p->uid_xor_nt0);
+    RecoveryState key_state = *t;
+
+    if(crypt_word(t, p->uid_xor_nt0) != p->ks0) return;
+
+    *t = key_state;
+    if(crypt_word(t, p->uid_xor_nt1) != p->ks1) return;
+
+    uint64_t key;
+    crypto1_get_lfsr(&key_state, &key);
+
+    for(uint32_t i = 0; i < p->keys_found && i < p->keys_size; i++) {
+        if(p->keys[i] == key) return;
+    }
+
+    if(p->keys_found < p->keys_size) {
+        p->keys[p->keys_found] = key;
+    }
+    p->keys_found++;
+}
+
+static inline int extend_table_simple(uint32_t* data, int tail, uint32_t bit) {
+    for(int s = 0; s <= tail; s++) {
+        data[s] <<= 1;
+        if(filter(data[s]) ^ filter(data[s] | 1)) {
+            data[s] |= filter(data[s]) ^ bit;
+        } else if(filter(data[s]) == bit) {
+            data[++tail] = data[++s];
+            data[s] = data[s - 1] | 1;
+        } else {
+            data[s--] = data[tail--];
+        }
+    }
+    return tail;
+}
+
+static int extend_table(
+    uint32_t* data,
+    int tbl,
+    int end,
+    uint32_t bit,
+    uint32_t m1,
+    uint32_t m2,
+    uint32_t in) {
+    in <<= 24;
+    for(data[tbl] <<= 1; tbl <= end; data[++tbl] <<= 1) {
+        if(filter(data[tbl]) ^ filter(data[tbl] | 1)) {
+            data[tbl] |= filter(data[tbl]) ^ bit;
+            update_contribution(&data[tbl], m1, m2, in);
+        } else if(filter(data[tbl]) == bit) {
+            data[++end] = data[tbl + 1];
+            data[tbl + 1] = data[tbl] | 1;
+            update_contribution(&data[tbl], m1, m2, in);
+            tbl++;
+            update_contribution(&data[tbl], m1, m2, in);
+        } else {
+            data[tbl--] = data[end--];
+        }
+    }
+    return end;
+}
+
+// Extends semi state by 12 keystream bits, last 8 of them also produce contribution MSB
+static int state_loop(uint32_t* states, uint32_t xks, uint32_t m1, uint32_t m2, uint32_t in) {
+    int tail = 0;
+
+    for(uint32_t round = 1; round <= 4; round++) {
+        tail = extend_table_simple(states, tail, (xks >> round) & 1);
+    }
+
+    for(uint32_t round = 5; round <= 12; round++) {
+        in >>= 2;
+        tail = extend_table(states, 0, tail, (xks >> round) & 1, m1, m2, in & 3);
+    }
+
+    return tail;
+}
+
+// First index in [start, stop] with the same contribution MSB as data[stop]
+static int binsearch(uint32_t* data, int start, int stop) {
+    uint32_t val = data[stop] & 0xff000000;
+    while(start != stop) {
+        int mid = start + ((stop - start) >> 1);
+        if(data[mid] >= val) {
+            stop = mid;
+        } else {
+            start = mid + 1;
+        }
+    }
+    return start;
+}
+
+static void quicksort(uint32_t* array, int low, int high) {
+    while(low < high) {
+        uint32_t pivot = array[low + (high - low) / 2];
+        int i = low, j = high;
+        while(i <= j) {
+            while(array[i] < pivot) i++;
+            while(array[j] > pivot) j--;
+            if(i <= j) {
+                uint32_t temp = array[i];
+                array[i++] = array[j];
+                array[j--] = temp;
+            }
+        }
+        // Recurse into smaller part to keep stack usage logarithmic
+        if(j - low < high - i) {
+            quicksort(array, low, j);
+            low = i;
+        } else {
+            quicksort(array, i, high);
+            high = j;
+        }
+    }
+}
+
+static void recover(
+    RecoveryContext* ctx,
+    uint32_t* odd,
+    int o_head,
+    int o_tail,
+    uint32_t oks,
+    uint32_t* even,
+    int e_head,
+    int e_tail,
+    uint32_t eks,
+    int rem,
+    uint32_t in,
+    bool first_run) {
+    if(rem == -1) {
+        for(int e = e_head; e <= e_tail; ++e) {
+            even[e] = (even[e] << 1) ^ parity32(even[e] & LF_POLY_EVEN) ^ !!(in & 4);
+            for(int o = o_head; o <= o_tail; ++o) {
+                RecoveryState state = {
+                    .odd = even[e] ^ parity32(odd[o] & LF_POLY_ODD),
+                    .even = odd[o],
+                };
+                check_state(&state, &ctx->params);
+            }
+        }
+        return;
+    }
+
+    if(!first_run) {
+        for(int i = 0; (i < 4) && (rem-- != 0); i++) {
+            oks >>= 1;
+            eks >>= 1;
+            in >>= 2;
+            // Extension may double the table, space above tail is free as groups are handled
+            // from the end. Won't happen with sane bucket sizes, but never write past the end
+            if(o_head + 2 * (o_tail - o_head + 1) >= TEMP_STATES_SIZE ||
+               e_head + 2 * (e_tail - e_head + 1) >= TEMP_STATES_SIZE) {
+                return;
+            }
+            o_tail = extend_table(odd, o_head, o_tail, oks & 1, CONST_M1_1, CONST_M2_1, 0);
+            if(o_head > o_tail) return;
+            e_tail = extend_table(even, e_head, e_tail, eks & 1, CONST_M1_2, CONST_M2_2, in & 3);
+            if(e_head > e_tail) return;
+        }
+    }
+
+    quicksort(odd, o_head, o_tail);
+    quicksort(even, e_head, e_tail);
+
+    while(o_tail >= o_head && e_tail >= e_head) {
+        if(((odd[o_tail] ^ even[e_tail]) >> 24) == 0) {
+            int o = o_tail;
+            int e = e_tail;
+            o_tail = binsearch(odd, o_head, o);
+            e_tail = binsearch(even, e_head, e);
+            recover(ctx, odd, o_tail--, o, oks, even, e_tail--, e, eks, rem, in, false);
+        } else if(odd[o_tail] > even[e_tail]) {
+            o_tail = binsearch(odd, o_head, o_tail) - 1;
+        } else {
+            e_tail = binsearch(even, e_head, e_tail) - 1;
+        }
+    }
+}
+
+static bool msb_bucket_add(MsbBucket* bucket, uint32_t state) {
+    for(uint32_t i = 0; i < bucket->tail; i++) {
+        if(bucket->states[i] == state) return true;
+    }
+
+    if(bucket->tail >= MSB_BUCKET_SIZE) return false;
+
+    bucket->states[bucket->tail++] = state;
+    return true;
+}
+
+// False if a bucket is full, dropping the state would silently lose candidates
+static bool msb_buckets_fill(
+    RecoveryContext* ctx,
+    MsbBucket* msbs,
+    uint32_t msb_head,
+    uint32_t semi_state,
+    uint32_t xks,
+    uint32_t m1,
+    uint32_t m2,
+    uint32_t in) {
+    ctx->states_buffer[0] = semi_state;
+    int tail = state_loop(ctx->states_buffer, xks, m1, m2, in);
+
+    for(int i = tail; i >= 0; i--) {
+        uint32_t msb = (ctx->states_buffer[i] >> 24) - msb_head;
+        if(msb < ctx->chunk_size && !msb_bucket_add(&msbs[msb], ctx->states_buffer[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static Crypto1RecoveryResult
+    recovery_round(RecoveryContext* ctx, uint32_t oks, uint32_t eks, uint32_t in, uint32_t round) {
+    uint32_t msb_head = ctx->chunk_size * round;
+    uint32_t progress = round * CRYPTO1_RECOVERY_BLOCKS_PER_ROUND;
+
+    for(uint32_t i = 0; i < ctx->chunk_size; i++) {
+        ctx->odd_msbs[i].tail = 0;
+        ctx->even_msbs[i].tail = 0;
+    }
+
+    for(int32_t semi_state = 1 << 20; semi_state >= 0; semi_state--) {
+        if(semi_state % SEMI_STATES_PER_BLOCK == 0 && semi_state != (1 << 20)) {
+            progress++;
+            if(ctx->callback && !ctx->callback(progress, ctx->total, ctx->context)) {
+                return Crypto1RecoveryCancelled;
+            }
+        }
+
+        if(filter(semi_state) == (oks & 1) &&
+           !msb_buckets_fill(
+               ctx, ctx->odd_msbs, msb_head, semi_state, oks, CONST_M1_1, CONST_M2_1, 0)) {
+            return Crypto1RecoveryOverflow;
+        }
+
+        if(filter(semi_state) == (eks & 1) &&
+           !msb_buckets_fill(
+               ctx, ctx->even_msbs, msb_head, semi_state, eks, CONST_M1_2, CONST_M2_2, in)) {
+            return Crypto1RecoveryOverflow;
+        }
+    }
+
+    for(uint32_t i = 0; i < ctx->chunk_size; i++) {
+        if(ctx->callback && !ctx->callback(progress, ctx->total, ctx->context)) {
+            return Crypto1RecoveryCancelled;
+        }
+
+        if(!ctx->odd_msbs[i].tail || !ctx->even_msbs[i].tail) continue;
+
+        memcpy(
+            ctx->temp_states_odd,
+            ctx->odd_msbs[i].states,
+            ctx->odd_msbs[i].tail * sizeof(uint32_t));
+        memcpy(
+            ctx->temp_states_even,
+            ctx->even_msbs[i].states,
+            ctx->even_msbs[i].tail * sizeof(uint32_t));
+
+        recover(
+            ctx,
+            ctx->temp_states_odd,
+            0,
+            ctx->odd_msbs[i].tail - 1,
+            oks >> 12,
+            ctx->temp_states_even,
+            0,
+            ctx->even_msbs[i].tail - 1,
+            eks >> 12,
+            3,
+            in >> 16,
+            true);
+    }
+
+    return Crypto1RecoveryKeysFound;
+}
+
+static uint32_t crypto1_recovery_normalize_chunk_size(uint32_t chunk_size) {
+    // Chunk size has to divide 256 evenly
+    uint32_t normalized = CRYPTO1_RECOVERY_MAX_CHUNK_SIZE;
+    while(normalized > chunk_size && normalized > CRYPTO1_RECOVERY_MIN_CHUNK_SIZE) {
+        normalized >>= 1;
+    }
+    return normalized;
+}
+
+size_t crypto1_recovery_get_memory_size(uint32_t chunk_size) {
+    chunk_size = crypto1_recovery_normalize_chunk_size(chunk_size);
+
+    return sizeof(uint32_t) * STATES_BUFFER_SIZE + 2 * chunk_size * sizeof(MsbBucket) +
+           2 * sizeof(uint32_t) * TEMP_STATES_SIZE;
+}
+
+uint32_t crypto1_recovery_get_chunk_size(size_t free_memory) {
+    for(uint32_t chunk_size = CRYPTO1_RECOVERY_MAX_CHUNK_SIZE;
+        chunk_size >= CRYPTO1_RECOVERY_MIN_CHUNK_SIZE;
+        chunk_size >>= 1) {
+        if(crypto1_recovery_get_memory_size(chunk_size) <= free_memory) return chunk_size;
+    }
+
+    return 0;
+}
+
+Crypto1RecoveryResult crypto1_nested_recover_keys(
+    uint32_t uid,
+    const uint32_t nt[2],
+    const uint32_t ks[2],
+    uint32_t chunk_size,
+    Crypto1RecoveryCallback callback,
+    void* context,
+    uint64_t* keys,
+    uint32_t keys_size,
+    uint32_t* keys_found) {
+    RecoveryContext ctx = {};
+    Crypto1RecoveryResult result = Crypto1RecoveryNoMemory;
+
+    ctx.chunk_size = crypto1_recovery_normalize_chunk_size(chunk_size);
+    ctx.callback = callback;
+    ctx.context = context;
+    ctx.params.uid_xor_nt0 = uid ^ nt[0];
+    ctx.params.uid_xor_nt1 = uid ^ nt[1];
+    ctx.params.ks0 = ks[0];
+    ctx.params.ks1 = ks[1];
+    ctx.params.keys = keys;
+    ctx.params.keys_size = keys_size;
+    ctx.params.keys_found = 0;
+
+    uint32_t rounds = 256 / ctx.chunk_size;
+    ctx.total = rounds * CRYPTO1_RECOVERY_BLOCKS_PER_ROUND;
+
+    do {
+        ctx.states_buffer = malloc(sizeof(uint32_t) * STATES_BUFFER_SIZE);
+        if(!ctx.states_buffer) break;
+        ctx.odd_msbs = malloc(ctx.chunk_size * sizeof(MsbBucket));
+        if(!ctx.odd_msbs) break;
+        ctx.even_msbs = malloc(ctx.chunk_size * sizeof(MsbBucket));
+        if(!ctx.even_msbs) break;
+        ctx.temp_states_odd = malloc(sizeof(uint32_t) * TEMP_STATES_SIZE);
+        if(!ctx.temp_states_odd) break;
+        ctx.temp_states_even = malloc(sizeof(uint32_t) * TEMP_STATES_SIZE);
+        if(!ctx.temp_states_even) break;
+
+        // Split keystream into odd and even bits
+        uint32_t oks = 0, eks = 0;
+        for(int i = 31; i >= 0; i -= 2) {
+            oks = oks << 1 | BEBIT(ks[0], i);
+        }
+        for(int i = 30; i >= 0; i -= 2) {
+            eks = eks << 1 | BEBIT(ks[0], i);
+        }
+
+        // Bits of uid ^ nt which are shifted into the even half, in order of use
+        uint32_t in = ctx.params.uid_xor_nt0;
+        in = ((in >> 16 & 0xff) | (in << 16) | (in & 0xff00)) << 1;
+
+        for(uint32_t round = 0; round < rounds; round++) {
+            result = recovery_round(&ctx, oks, eks, in, round);
+            if(result != Crypto1RecoveryKeysFound) break;
+        }
+    } while(false);
+
+    if(result == Crypto1RecoveryKeysFound && ctx.params.keys_found == 0) {
+        result = Crypto1RecoveryNoKeys;
+    }
+
+    *keys_found = MIN(ctx.params.keys_found, keys_size);
+
+    free(ctx.states_buffer);
+    free(ctx.odd_msbs);
+    free(ctx.even_msbs);
+    free(ctx.temp_states_odd);
+    free(ctx.temp_states_even);
+
+    return result;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Enumeration of 2^20 filter inputs is split in blocks, callback is called after every block
+#define CRYPTO1_RECOVERY_BLOCKS_PER_ROUND (32)
+
+// Chunk size is how many of 256 contribution MSB values are handled per round
+#define CRYPTO1_RECOVERY_MAX_CHUNK_SIZE (16)
+#define CRYPTO1_RECOVERY_MIN_CHUNK_SIZE (1)
+
+typedef enum {
+    Crypto1RecoveryKeysFound,
+    Crypto1RecoveryNoKeys,
+    Crypto1RecoveryCancelled,
+    Crypto1RecoveryNoMemory,
+    // MSB bucket got full and states were lost, keys found so far may miss the right one
+    Crypto1RecoveryOverflow,
+} Crypto1RecoveryResult;
+
+/**
+ * Progress callback, progress is in blocks of CRYPTO1_RECOVERY_BLOCKS_PER_ROUND per round
+ * Return false to cancel recovery
+ */
+typedef bool (*Crypto1RecoveryCallback)(uint32_t progress, uint32_t total, void* context);
+
+/**
+ * Amount of heap used by recovery with given chunk size
+ */
+size_t crypto1_recovery_get_memory_size(uint32_t chunk_size);
+
+/**
+ * Biggest chunk size which fits into given amount of memory, 0 if even smallest doesn't fit
+ */
+uint32_t crypto1_recovery_get_chunk_size(size_t free_memory);
+
+/**
+ * Recovers candidate keys from two nested authentications with known tag nonces
+ *
+ * ks[i] is keystream which encrypted nt[i] (nt_enc ^ nt). First pair gives about 2^16 LFSR
+ * states, second pair filters them. Both keystreams start from the same key, so second one
+ * doesn't rule out all wrong keys, candidates still have to be checked on the tag.
+ * Work is done in 256 / chunk_size rounds, memory usage is bounded by
+ * crypto1_recovery_get_memory_size(chunk_size). At most keys_size unique keys are stored.
+ */
+Crypto1RecoveryResult crypto1_nested_recover_keys(
+    uint32_t uid,
+    const uint32_t nt[2],
+    const uint32_t ks[2],
+    uint32_t chunk_size,
+    Crypto1RecoveryCallback callback,
+    void* context,
+    uint64_t* keys,
+    uint32_t keys_size,
+    uint32_t* keys_found);
@@ -0,0 +1,144 @@
+#include "key_set.h"
+
+#include <furi.h>
+#include <string.h>
+
+#define KEY_SET_GROW_STEP (32)
+
+struct KeySet {
+    uint64_t* keys;
+    size_t count;
+    size_t capacity;
+};
+
+KeySet* key_set_alloc() {
+    KeySet* key_set = malloc(sizeof(KeySet));
+    key_set->keys = NULL;
+    key_set->count = 0;
+    key_set->capacity = 0;
+
+    return key_set;
+}
+
+void key_set_free(KeySet* key_set) {
+    furi_assert(key_set);
+
+    free(key_set->keys);
+    free(key_set);
+}
+
+void key_set_reset(KeySet* key_set) {
+    furi_assert(key_set);
+
+    key_set->count = 0;
+}
+
+// Index of first key which is not less than given one
+static size_t key_set_lower_bound(const KeySet* key_set, uint64_t key) {
+    size_t low = 0, high = key_set->count;
+
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+
+        if(key_set->keys[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+bool key_set_add(KeySet* key_set, uint64_t key) {
+    furi_assert(key_set);
+
+    size_t index = key_set_lower_bound(key_set, key);
+
+    if(index < key_set->count && key_set->keys[index] == key) {
+        return false;
+    }
+
+    if(key_set->count == key_set->capacity) {
+        key_set->capacity += KEY_SET_GROW_STEP;
+        key_set->keys = realloc(key_set->keys, key_set->capacity * sizeof(uint64_t));
+    }
+
+    memmove(
+        &key_set->keys[index + 1],
+        &key_set->keys[index],
+        (key_set->count - index) * sizeof(uint64_t));
+    key_set->keys[index] = key;
+    key_set->count++;
+
+    return true;
+}
+
+bool key_set_remove(KeySet* key_set, uint64_t key) {
+    furi_assert(key_set);
+
+    size_t index = key_set_lower_bound(key_set, key);
+
+    if(index == key_set->count || key_set->keys[index] != key) {
+        return false;
+    }
+
+    key_set->count--;
+    memmove(
+        &key_set->keys[index],
+        &key_set->keys[index + 1],
+        (key_set->count - index) * sizeof(uint64_t));
+
+    return true;
+}
+
+bool key_set_contains(const KeySet* key_set, uint64_t key) {
+    furi_assert(key_set);
+
+    size_t index = key_set_lower_bound(key_set, key);
+
+    return index < key_set->count && key_set->keys[index] == key;
+}
+
+size_t key_set_count(const KeySet* key_set) {
+    furi_assert(key_set);
+
+    return key_set->count;
+}
+
+uint64_t key_set_get(const KeySet* key_set, size_t index) {
+    furi_assert(key_set);
+    furi_check(index < key_set->count);
+
+    return key_set->keys[index];
+}
+
+static bool key_set_hex_nibble(char c, uint8_t* nibble) {
+    if(c >= '0' && c <= '9') {
+        *nibble = c - '0';
+    } else if(c >= 'A' && c <= 'F') {
+        *nibble = c - 'A' + 10;
+    } else if(c >= 'a' && c <= 'f') {
+        *nibble = c - 'a' + 10;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool key_set_parse_key(const char* line, uint64_t* key) {
+    uint64_t value = 0;
+    uint8_t nibble;
+
+    for(uint8_t i = 0; i < 12; i++) {
+        if(!key_set_hex_nibble(line[i], &nibble)) return false;
+        value = value << 4 | nibble;
+    }
+
+    if(line[12] != '\0' && line[12] != '\r' && line[12] != '\n') return false;
+
+    *key = value;
+
+    return true;
+}
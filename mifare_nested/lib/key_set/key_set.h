@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Set of 48 bit keys (or any uint64 values), kept as sorted array.
+ * Lookups are binary searches, so it can be used instead of comparing key strings
+ */
+typedef struct KeySet KeySet;
+
+KeySet* key_set_alloc();
+
+void key_set_free(KeySet* key_set);
+
+void key_set_reset(KeySet* key_set);
+
+/**
+ * Returns false if key is already in set
+ */
+bool key_set_add(KeySet* key_set, uint64_t key);
+
+bool key_set_remove(KeySet* key_set, uint64_t key);
+
+bool key_set_contains(const KeySet* key_set, uint64_t key);
+
+size_t key_set_count(const KeySet* key_set);
+
+/**
+ * Keys are returned in ascending order
+ */
+uint64_t key_set_get(const KeySet* key_set, size_t index);
+
+/**
+ * Parses dictionary line, 12 hex chars with optional line ending. Comments are rejected
+ */
+bool key_set_parse_key(const char* line, uint64_t* key);
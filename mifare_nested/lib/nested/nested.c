@@ -136,40 +136,92 @@ bool mifare_classic_authex(
     return true;
 }
 
-static int valid_nonce(uint32_t Nt, uint32_t NtEnc, uint32_t Ks1, const uint8_t* parity) {
-    return ((oddparity8((Nt >> 24) & 0xFF) ==
-             ((parity[0]) ^ oddparity8((NtEnc >> 24) & 0xFF) ^ FURI_BIT(Ks1, 16))) &&
-            (oddparity8((Nt >> 16) & 0xFF) ==
-             ((parity[1]) ^ oddparity8((NtEnc >> 16) & 0xFF) ^ FURI_BIT(Ks1, 8))) &&
-            (oddparity8((Nt >> 8) & 0xFF) ==
-             ((parity[2]) ^ oddparity8((NtEnc >> 8) & 0xFF) ^ FURI_BIT(Ks1, 0)))) ?
-               1 :
-               0;
+#define PRNG_PERIOD (65535)
+#define PRNG_GIANT_STEP (256)
+
+// Every 256th state of 16 bit PRNG LFSR, (state << 16 | step number), sorted by state
+static uint32_t prng_giant_steps[PRNG_GIANT_STEP];
+static bool prng_giant_steps_ready = false;
+
+static inline uint16_t prng_step(uint16_t x) {
+    return x >> 1 | (x ^ x >> 2 ^ x >> 3 ^ x >> 5) << 15;
 }
 
-void nonce_distance(uint32_t* msb, uint32_t* lsb) {
-    uint16_t x = 1, pos;
-    uint8_t calc_ok = 0;
+static void prng_giant_steps_init() {
+    uint16_t x = 1;
 
-    for(uint16_t i = 1; i; ++i) {
-        pos = (x & 0xff) << 8 | x >> 8;
+    for(uint32_t i = 0; i < PRNG_PERIOD; i++) {
+        if(i % PRNG_GIANT_STEP == 0) {
+            prng_giant_steps[i / PRNG_GIANT_STEP] = (uint32_t)x << 16 | i / PRNG_GIANT_STEP;
+        }
+
+        x = prng_step(x);
+    }
 
-        if((pos == *msb) & !(calc_ok >> 0 & 0x01)) {
-            *msb = i;
-            calc_ok |= 0x01;
+    // Insertion sort, only done once
+    for(uint32_t i = 1; i < PRNG_GIANT_STEP; i++) {
+        uint32_t value = prng_giant_steps[i];
+        uint32_t j = i;
+
+        for(; j > 0 && prng_giant_steps[j - 1] > value; j--) {
+            prng_giant_steps[j] = prng_giant_steps[j - 1];
         }
 
-        if((pos == *lsb) & !(calc_ok >> 1 & 0x01)) {
-            *lsb = i;
-            calc_ok |= 0x02;
+        prng_giant_steps[j] = value;
+    }
+
+    prng_giant_steps_ready = true;
+}
+
+static int32_t prng_giant_step_find(uint16_t x) {
+    uint32_t low = 0, high = PRNG_GIANT_STEP;
+
+    while(low < high) {
+        uint32_t mid = (low + high) / 2;
+
+        if((prng_giant_steps[mid] >> 16) < x) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
+    }
+
+    if(low < PRNG_GIANT_STEP && (prng_giant_steps[low] >> 16) == x) {
+        return prng_giant_steps[low] & 0xff;
+    }
+
+    return -1;
+}
+
+// Position (1..65535) of 16 bit nonce half in PRNG sequence, 0 if it isn't part of it.
+// Baby-step/giant-step: walk at most 256 steps forward until known state is hit
+static uint32_t prng_position(uint16_t value) {
+    if(!prng_giant_steps_ready) prng_giant_steps_init();
+
+    uint16_t x = value << 8 | value >> 8;
+
+    if(!x) return 0;
 
-        if(calc_ok == 0x03) {
-            return;
+    for(uint32_t steps = 0; steps < PRNG_GIANT_STEP; steps++) {
+        int32_t giant = prng_giant_step_find(x);
+
+        if(giant >= 0) {
+            return (giant * PRNG_GIANT_STEP + PRNG_PERIOD - steps) % PRNG_PERIOD + 1;
         }
 
-        x = x >> 1 | (x ^ x >> 2 ^ x >> 3 ^ x >> 5) << 15;
+        x = prng_step(x);
     }
+
+    return 0;
+}
+
+void nonce_distance(uint32_t* msb, uint32_t* lsb) {
+    // Keeps values that aren't part of the sequence, like loop did
+    uint32_t position = prng_position(*msb);
+    if(position) *msb = position;
+
+    position = prng_position(*lsb);
+    if(position) *lsb = position;
 }
 
 bool validate_prng_nonce(uint32_t nonce) {
@@ -179,6 +231,31 @@ bool validate_prng_nonce(uint32_t nonce) {
     return ((65535 - msb + lsb) % 65535) == 16;
 }
 
+uint32_t nested_prng_distance(uint32_t nt1, uint32_t nt2, uint32_t min, uint32_t max) {
+    uint32_t i = min;
+
+    // First 16 steps still depend on upper half of nt1, it's shifted out after that
+    for(; i < max && i < 16; i++) {
+        if(prng_successor(nt1, i) == nt2) return i;
+    }
+
+    if(i >= max || !validate_prng_nonce(nt2)) return max;
+
+    // Lower half holds the newest 16 PRNG bits
+    uint32_t from = prng_position(nt1 & 0xffff);
+    uint32_t to = prng_position(nt2 & 0xffff);
+
+    if(!from || !to) return max;
+
+    uint32_t distance = (to + PRNG_PERIOD - from) % PRNG_PERIOD;
+
+    if(distance < i) {
+        distance += ((i - distance + PRNG_PERIOD - 1) / PRNG_PERIOD) * PRNG_PERIOD;
+    }
+
+    return distance < max ? distance : max;
+}
+
 MifareNestedNonceType nested_check_nonce_type(FuriHalNfcTxRxContext* tx_rx, uint8_t blockNo) {
     uint32_t nonces[5] = {};
     uint8_t sameNonces = 0;
@@ -337,12 +414,7 @@ uint32_t nested_calibrate_distance(
         }
 
         // NXP Mifare is typical around 840, but for some unlicensed/compatible mifare tag this can be 160
-        uint32_t nttmp = prng_successor(nt1, 100);
-
-        for(i = 101; i < max_prng_value; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = nested_prng_distance(nt1, nt2, 101, max_prng_value);
 
         if(i != max_prng_value) {
             if(rtr != 0) {
@@ -409,12 +481,7 @@ struct distance_info nested_calibrate_distance_info(
         mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
         // NXP Mifare is typical around 840, but for some unlicensed/compatible mifare tag this can be 160
-        uint32_t nttmp = prng_successor(nt1, 1);
-
-        for(i = 2; i < 65565; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = nested_prng_distance(nt1, nt2, 2, 65565);
 
         if(i != 65565) {
             if(rtr != 0) {
@@ -513,7 +580,7 @@ struct nonce_info nested_attack(
                 nttest = prng_successor(nttest, 1);
                 ks1 = nt2 ^ nttest;
 
-                if(valid_nonce(nttest, nt2, ks1, par_array)) {
+                if(nested_valid_nonce(nttest, nt2, ks1, par_array)) {
                     if(ncount > 0) { // we are only interested in disambiguous nonces, try again
                         FURI_LOG_D(TAG, "Nonce#%lu: dismissed (ambiguous), ntdist=%lu", i + 1, j);
                         r.target_nt[i] = 0;
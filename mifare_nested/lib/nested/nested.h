@@ -3,6 +3,7 @@
 #include <lib/nfc/protocols/nfc_util.h>
 #include <lib/nfc/protocols/mifare_classic.h>
 #include <lib/nfc/protocols/crypto1.h>
+#include "nested_nonces.h"
 
 #include <storage/storage.h>
 #include <stream/stream.h>
@@ -73,6 +74,12 @@ struct nonce_info_hard nested_hard_nonce_attack(
     uint32_t* first_byte_sum,
     Stream* file_stream);
 
+/**
+ * Smallest PRNG distance in [min, max) from nt1 to nt2, max if nt2 can't be reached.
+ * Same result as stepping prng_successor one by one, but uses lookup table
+ */
+uint32_t nested_prng_distance(uint32_t nt1, uint32_t nt2, uint32_t min, uint32_t max);
+
 uint32_t nested_calibrate_distance(
     FuriHalNfcTxRxContext* tx_rx,
     uint8_t blockNo,
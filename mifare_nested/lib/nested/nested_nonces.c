@@ -0,0 +1,95 @@
+#include "nested_nonces.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "../../lib/parity/parity.h"
+#include "../../lib/crypto1/crypto1.h"
+
+bool nested_nonces_parse_line(const char* line, NestedNonceRecord* record) {
+    if(strncmp(line, "Nested: Key", strlen("Nested: Key")) != 0) return false;
+
+    const char* token = line;
+    uint8_t i = 0;
+
+    for(i = 0; i <= 18; i++) {
+        if(i != 0) {
+            token = strchr(token, ' ');
+            if(!token) break;
+            token++;
+        }
+
+        switch(i) {
+        case 2:
+            record->key_type = token[0] == 'B';
+            break;
+        case 4:
+            record->cuid = strtoul(token, NULL, 16);
+            break;
+        case 6:
+        case 12:
+            record->target_nt[i / 12] = strtoul(token, NULL, 16);
+            break;
+        case 8:
+        case 14:
+            record->target_ks[i / 14] = strtoul(token, NULL, 16);
+            break;
+        case 10:
+        case 16:
+            for(uint8_t j = 0; j < 4; j++) {
+                if(token[j] != '0' && token[j] != '1') return false;
+                record->parity[i / 16][j] = token[j] - '0';
+            }
+            break;
+        case 18:
+            record->sector = strtoul(token, NULL, 10);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return i > 18 && record->sector < 40;
+}
+
+bool nested_nonces_parse_delay(const char* line, uint32_t* delay, uint32_t* distance) {
+    if(strncmp(line, "Nested: Delay ", strlen("Nested: Delay ")) != 0) return false;
+
+    *delay = strtoul(line + strlen("Nested: Delay "), NULL, 10);
+    const char* distance_str = strstr(line, "distance ");
+    *distance = distance_str ? strtoul(distance_str + strlen("distance "), NULL, 10) : 0;
+
+    return true;
+}
+
+bool nested_valid_nonce(uint32_t nt, uint32_t nt_enc, uint32_t ks, const uint8_t* parity) {
+    return (oddparity8((nt >> 24) & 0xFF) ==
+            ((parity[0]) ^ oddparity8((nt_enc >> 24) & 0xFF) ^ FURI_BIT(ks, 16))) &&
+           (oddparity8((nt >> 16) & 0xFF) ==
+            ((parity[1]) ^ oddparity8((nt_enc >> 16) & 0xFF) ^ FURI_BIT(ks, 8))) &&
+           (oddparity8((nt >> 8) & 0xFF) ==
+            ((parity[2]) ^ oddparity8((nt_enc >> 8) & 0xFF) ^ FURI_BIT(ks, 0)));
+}
+
+bool nested_predict_nonce(
+    uint32_t nt1,
+    uint32_t nt_enc,
+    const uint8_t* parity,
+    uint32_t distance,
+    uint32_t* nt,
+    uint32_t* ks) {
+    // Same window and parity check as nested_attack used when nonce was collected
+    uint32_t ncount = 0;
+    uint32_t nttest = prng_successor(nt1, distance - 3);
+
+    for(uint32_t j = distance - 2; j < distance + 3; j++) {
+        nttest = prng_successor(nttest, 1);
+
+        if(nested_valid_nonce(nttest, nt_enc, nt_enc ^ nttest, parity)) {
+            *nt = nttest;
+            *ks = nt_enc ^ nttest;
+            ncount++;
+        }
+    }
+
+    return ncount == 1;
+}
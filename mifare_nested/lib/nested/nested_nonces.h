@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// One "Nested: Key ..." line of .nonces file
+typedef struct {
+    uint8_t key_type;
+    uint8_t sector;
+    uint32_t cuid;
+    uint32_t target_nt[2];
+    uint32_t target_ks[2];
+    uint8_t parity[2][4];
+} NestedNonceRecord;
+
+/**
+ * Parses "Nested: Key A cuid 0x... nt0 0x... ks0 0x... par0 0101 nt1 ... sec 1" line
+ */
+bool nested_nonces_parse_line(const char* line, NestedNonceRecord* record);
+
+/**
+ * Parses "Nested: Delay 100, distance 300" line, which delay mode files end with
+ */
+bool nested_nonces_parse_delay(const char* line, uint32_t* delay, uint32_t* distance);
+
+bool nested_valid_nonce(uint32_t nt, uint32_t nt_enc, uint32_t ks, const uint8_t* parity);
+
+/**
+ * Delay mode files keep nonce before the delay and encrypted nonce, finds the only PRNG value
+ * around distance which matches parity. False if there is none or more than one
+ */
+bool nested_predict_nonce(
+    uint32_t nt1,
+    uint32_t nt_enc,
+    const uint8_t* parity,
+    uint32_t distance,
+    uint32_t* nt,
+    uint32_t* ks);
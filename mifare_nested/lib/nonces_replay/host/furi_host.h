@@ -0,0 +1,31 @@
+#pragma once
+
+// Just enough of the firmware API for lib/crypto1 and lib/nested/nested_nonces.c to build on a
+// host. Every firmware header they include is generated by the Makefile as a one-line include
+// of this.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define furi_assert(x) assert(x)
+
+#define FURI_BIT(x, n) (((x) >> (n)) & 1)
+#define FURI_SWAP(x, y)     \
+    do {                    \
+        typeof(x) tmp = x;  \
+        x = y;              \
+        y = tmp;            \
+    } while(0)
+
+// lib/nfc/protocols/crypto1.h
+typedef struct {
+    uint32_t odd;
+    uint32_t even;
+} Crypto1;
@@ -0,0 +1,325 @@
+// Host replay of .nonces files through the same parser, delay mode prediction and key recovery
+// the app runs in mifare_nested_worker_recover_keys. Prints candidates in .keys format and how
+// long every nonce took. Without a file it generates static and delay mode nonces for random
+// keys, replays them and checks every key is among the candidates.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lib/crypto1/crypto1.h"
+#include "lib/crypto1/crypto1_recovery.h"
+#include "lib/nested/nested_nonces.h"
+#include "lib/parity/parity.h"
+
+#define MAX_CANDIDATES (64)
+#define LINE_SIZE (256)
+#define SELF_TEST_NONCES (2)
+#define SELF_TEST_DISTANCE (340)
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+typedef struct {
+    uint32_t nonces;
+    uint32_t skipped;
+    uint32_t unpredicted;
+    uint32_t overflows;
+    uint32_t keys;
+} ReplayStats;
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t random32(void) {
+    return (uint32_t)rand() << 16 ^ (uint32_t)rand();
+}
+
+static const char* result_name(Crypto1RecoveryResult result) {
+    switch(result) {
+    case Crypto1RecoveryKeysFound:
+        return "keys found";
+    case Crypto1RecoveryNoKeys:
+        return "no keys";
+    case Crypto1RecoveryCancelled:
+        return "cancelled";
+    case Crypto1RecoveryNoMemory:
+        return "no memory";
+    case Crypto1RecoveryOverflow:
+        return "bucket overflow";
+    default:
+        return "?";
+    }
+}
+
+// Same passes as mifare_nested_worker_recover_keys: find delay line, then recover every nonce
+// of a sector and key until one gives candidates
+static void replay(FILE* nonces, FILE* keys_out, uint32_t chunk_size, ReplayStats* stats) {
+    char line[LINE_SIZE];
+    uint32_t delay = 0, distance = 0;
+    bool recovered[2][40] = {};
+    uint64_t keys[MAX_CANDIDATES];
+
+    memset(stats, 0, sizeof(ReplayStats));
+    while(fgets(line, sizeof(line), nonces)) {
+        nested_nonces_parse_delay(line, &delay, &distance);
+    }
+    if(delay) fprintf(
+            stderr,
+            "delay %lu us, distance %lu\n",
+            (unsigned long)delay,
+            (unsigned long)distance);
+
+    rewind(nonces);
+    while(fgets(line, sizeof(line), nonces)) {
+        NestedNonceRecord record = {};
+        if(!strncmp(line, "HardNested", strlen("HardNested"))) stats->skipped++;
+        if(!nested_nonces_parse_line(line, &record)) continue;
+        stats->nonces++;
+
+        char name[16];
+        snprintf(
+            name, sizeof(name), "%c sector %02u", !record.key_type ? 'A' : 'B', record.sector);
+        if(recovered[record.key_type][record.sector]) continue;
+
+        if(delay) {
+            bool predicted = true;
+            for(uint8_t i = 0; i < 2; i++) {
+                predicted &= nested_predict_nonce(
+                    record.target_nt[i],
+                    record.target_ks[i],
+                    record.parity[i],
+                    distance,
+                    &record.target_nt[i],
+                    &record.target_ks[i]);
+            }
+            if(!predicted) {
+                fprintf(stderr, "%s: can't predict nonce\n", name);
+                stats->unpredicted++;
+                continue;
+            }
+        }
+
+        uint32_t keys_found = 0;
+        double start = get_time();
+        Crypto1RecoveryResult result = crypto1_nested_recover_keys(
+            record.cuid,
+            record.target_nt,
+            record.target_ks,
+            chunk_size,
+            NULL,
+            NULL,
+            keys,
+            MAX_CANDIDATES,
+            &keys_found);
+        fprintf(
+            stderr,
+            "%s: %s, %lu candidates, %.2f s\n",
+            name,
+            result_name(result),
+            (unsigned long)keys_found,
+            get_time() - start);
+
+        for(uint32_t i = 0; i < keys_found; i++) {
+            fprintf(keys_out, "Key %s:", name);
+            for(int8_t byte = 5; byte >= 0; byte--) {
+                fprintf(keys_out, " %02X", (uint8_t)(keys[i] >> (byte * 8)));
+            }
+            fprintf(keys_out, "\n");
+        }
+
+        if(result == Crypto1RecoveryOverflow) stats->overflows++;
+        if(keys_found && result != Crypto1RecoveryOverflow) {
+            recovered[record.key_type][record.sector] = true;
+        }
+        stats->keys += keys_found;
+    }
+    if(stats->skipped) {
+        fprintf(stderr, "%lu hard nested nonces skipped\n", (unsigned long)stats->skipped);
+    }
+}
+
+// Encrypted nonce of nested authentication with key and parity bits the way nested_attack
+// stores them: decrypted parity bit != parity of the byte
+static uint32_t
+    generate_auth(uint64_t key, uint32_t cuid, uint32_t nt, uint32_t* ks, uint8_t parity[4]) {
+    Crypto1 crypto;
+    crypto1_init(&crypto, key);
+    *ks = crypto1_word(&crypto, cuid ^ nt, 0);
+
+    uint32_t nt_enc = nt ^ *ks;
+    uint8_t next_bit = crypto1_filter(crypto.odd);
+    for(uint8_t i = 0; i < 4; i++) {
+        uint8_t shift = 24 - i * 8;
+        uint8_t ks_bit = i < 3 ? FURI_BIT(*ks, 16 - i * 8) : next_bit;
+        parity[i] = oddparity8(nt >> shift) ^ oddparity8(nt_enc >> shift) ^ ks_bit;
+    }
+    return nt_enc;
+}
+
+// Writes nonces for random keys, in delay mode nt is only known as distance from previous one
+static void generate(FILE* out, bool delay_mode, uint64_t* keys, uint32_t count) {
+    fprintf(out, "Filetype: Flipper Nested Nonce Manifest File\nVersion: 2\n");
+
+    for(uint32_t n = 0; n < count; n++) {
+        uint32_t cuid = random32();
+        keys[n] = (uint64_t)random32() << 16 ^ random32();
+        keys[n] &= 0xFFFFFFFFFFFF;
+
+        fprintf(out, "Nested: Key %c cuid 0x%08lx", n % 2 ? 'B' : 'A', (unsigned long)cuid);
+        for(uint8_t i = 0; i < 2; i++) {
+            uint32_t nt, ks, saved_nt, saved_ks;
+            uint8_t parity[4];
+            while(true) {
+                uint32_t nt1 = random32();
+                nt = delay_mode ? prng_successor(nt1, SELF_TEST_DISTANCE) : random32();
+                uint32_t nt_enc = generate_auth(keys[n], cuid, nt, &ks, parity);
+                saved_nt = delay_mode ? nt1 : nt;
+                saved_ks = delay_mode ? nt_enc : ks;
+
+                // Collection drops nonces which parity doesn't pin down
+                uint32_t predicted_nt, predicted_ks;
+                if(!delay_mode || nested_predict_nonce(
+                                      nt1,
+                                      nt_enc,
+                                      parity,
+                                      SELF_TEST_DISTANCE,
+                                      &predicted_nt,
+                                      &predicted_ks)) {
+                    CHECK(!delay_mode || (predicted_nt == nt && predicted_ks == ks));
+                    break;
+                }
+            }
+            fprintf(
+                out,
+                " nt%u 0x%08lx ks%u 0x%08lx par%u ",
+                i,
+                (unsigned long)saved_nt,
+                i,
+                (unsigned long)saved_ks,
+                i);
+            for(uint8_t j = 0; j < 4; j++) {
+                fprintf(out, "%u", parity[j]);
+            }
+        }
+        fprintf(out, " sec %lu\n", (unsigned long)n);
+    }
+
+    if(delay_mode) fprintf(out, "Nested: Delay 1000, distance %u", SELF_TEST_DISTANCE);
+}
+
+static void self_test(bool delay_mode, uint32_t chunk_size, const char* write_dir) {
+    uint64_t keys[SELF_TEST_NONCES];
+    char* nonces_text = NULL;
+    char* keys_text = NULL;
+    size_t nonces_size = 0, keys_size = 0;
+    ReplayStats stats;
+
+    fprintf(stderr, "%s nonces:\n", delay_mode ? "Delay mode" : "Static");
+    FILE* nonces = open_memstream(&nonces_text, &nonces_size);
+    generate(nonces, delay_mode, keys, SELF_TEST_NONCES);
+    fclose(nonces);
+
+    // Delay applies to the whole file, so each mode gets its own
+    if(write_dir) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s.nonces", write_dir, delay_mode ? "delay" : "static");
+        FILE* file = fopen(path, "w");
+        if(file) {
+            fputs(nonces_text, file);
+            fclose(file);
+        }
+    }
+
+    nonces = fmemopen(nonces_text, nonces_size, "r");
+    FILE* keys_out = open_memstream(&keys_text, &keys_size);
+    replay(nonces, keys_out, chunk_size, &stats);
+    fclose(nonces);
+    fclose(keys_out);
+
+    CHECK(stats.nonces == SELF_TEST_NONCES);
+    CHECK(stats.unpredicted == 0);
+    CHECK(stats.overflows == 0);
+    for(uint32_t n = 0; n < SELF_TEST_NONCES; n++) {
+        char key_line[64];
+        int len = snprintf(
+            key_line,
+            sizeof(key_line),
+            "Key %c sector %02lu:",
+            n % 2 ? 'B' : 'A',
+            (unsigned long)n);
+        for(int8_t byte = 5; byte >= 0; byte--) {
+            len += snprintf(
+                key_line + len, sizeof(key_line) - len, " %02X", (uint8_t)(keys[n] >> (byte * 8)));
+        }
+        CHECK(strstr(keys_text, key_line) != NULL);
+    }
+
+    free(nonces_text);
+    free(keys_text);
+}
+
+int main(int argc, char** argv) {
+    uint32_t chunk_size = CRYPTO1_RECOVERY_MAX_CHUNK_SIZE;
+    const char* write_dir = NULL;
+    int opt;
+
+    while((opt = getopt(argc, argv, "c:w:h")) != -1) {
+        if(opt == 'c') {
+            chunk_size = strtoul(optarg, NULL, 0);
+        } else if(opt == 'w') {
+            write_dir = optarg;
+        } else {
+            printf(
+                "Usage: %s [-c chunk size] [-w dir for generated nonces] [file.nonces]\n",
+                argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    fprintf(
+        stderr,
+        "chunk size %lu, %zu bytes\n",
+        (unsigned long)chunk_size,
+        crypto1_recovery_get_memory_size(chunk_size));
+
+    if(optind < argc) {
+        FILE* nonces = fopen(argv[optind], "r");
+        if(!nonces) {
+            fprintf(stderr, "Can't open %s\n", argv[optind]);
+            return 1;
+        }
+        ReplayStats stats;
+        replay(nonces, stdout, chunk_size, &stats);
+        fclose(nonces);
+        fprintf(
+            stderr,
+            "%lu nonces, %lu candidates, %lu not predicted, %lu overflows\n",
+            (unsigned long)stats.nonces,
+            (unsigned long)stats.keys,
+            (unsigned long)stats.unpredicted,
+            (unsigned long)stats.overflows);
+        return stats.overflows ? 1 : 0;
+    }
+
+    srand(1);
+    self_test(false, chunk_size, write_dir);
+    self_test(true, chunk_size, write_dir);
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
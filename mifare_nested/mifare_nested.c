@@ -71,6 +71,23 @@ CheckKeysState* check_keys_alloc() {
     return state;
 }
 
+KeyRecoveryState* key_recovery_alloc() {
+    KeyRecoveryState* state = malloc(sizeof(KeyRecoveryState));
+    state->view = view_alloc();
+    view_allocate_model(state->view, ViewModelTypeLocking, sizeof(KeyRecoveryViewModel));
+    with_view_model(
+        state->view,
+        KeyRecoveryViewModel * model,
+        {
+            model->header = furi_string_alloc();
+            furi_string_set(model->header, "Recovering keys");
+            model->lost_tag = false;
+        },
+        false);
+
+    return state;
+}
+
 static void nested_draw_callback(Canvas* canvas, void* model) {
     NestedAttackViewModel* m = model;
 
@@ -194,6 +211,53 @@ static void check_keys_draw_callback(Canvas* canvas, void* model) {
     elements_button_center(canvas, "Stop");
 }
 
+static void key_recovery_draw_callback(Canvas* canvas, void* model) {
+    KeyRecoveryViewModel* m = model;
+
+    if(m->lost_tag) {
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(canvas, 64, 4, AlignCenter, AlignTop, "Lost the tag!");
+        canvas_set_font(canvas, FontSecondary);
+        elements_multiline_text_aligned(
+            canvas, 64, 23, AlignCenter, AlignTop, "Apply tag once to read\nits UID");
+    } else {
+        char draw_str[32] = {};
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str_aligned(
+            canvas, 64, 2, AlignCenter, AlignTop, furi_string_get_cstr(m->header));
+        canvas_set_font(canvas, FontSecondary);
+
+        float progress = m->progress_total == 0 ?
+                             0 :
+                             (float)(m->progress) / (float)(m->progress_total);
+
+        if(progress > 1.0) {
+            progress = 1.0;
+        }
+
+        elements_progress_bar(canvas, 5, 15, 120, progress);
+        snprintf(
+            draw_str,
+            sizeof(draw_str),
+            "%lu/%lu: sector %u, key %c",
+            MIN(m->nonces_processed + 1, m->nonces_total),
+            m->nonces_total,
+            m->sector,
+            !m->key_type ? 'A' : 'B');
+        canvas_draw_str_aligned(canvas, 1, 28, AlignLeft, AlignTop, draw_str);
+        snprintf(
+            draw_str,
+            sizeof(draw_str),
+            "ETA %02lu:%02lu, keys found: %lu",
+            m->eta / 60,
+            m->eta % 60,
+            m->keys_found);
+        canvas_draw_str_aligned(canvas, 1, 40, AlignLeft, AlignTop, draw_str);
+    }
+
+    elements_button_center(canvas, "Stop");
+}
+
 static bool nested_input_callback(InputEvent* event, void* context) {
     MifareNested* mifare_nested = context;
 
@@ -290,9 +354,19 @@ MifareNested* mifare_nested_alloc() {
     view_dispatcher_add_view(
         mifare_nested->view_dispatcher, MifareNestedViewCheckKeys, keys_state->view);
 
+    // Key recovery state
+    KeyRecoveryState* recovery_state = key_recovery_alloc();
+    view_set_context(recovery_state->view, mifare_nested);
+    mifare_nested->recovery_state = recovery_state;
+    view_dispatcher_add_view(
+        mifare_nested->view_dispatcher, MifareNestedViewKeyRecovery, recovery_state->view);
+
     KeyInfo_t* key_info = malloc(sizeof(KeyInfo_t));
     mifare_nested->keys = key_info;
 
+    RecoveryInfo_t* recovery_info = malloc(sizeof(RecoveryInfo_t));
+    mifare_nested->recovery = recovery_info;
+
     MifareNestedSettings* settings = malloc(sizeof(MifareNestedSettings));
     settings->only_hardnested = false;
     mifare_nested->settings = settings;
@@ -303,6 +377,9 @@ MifareNested* mifare_nested_alloc() {
     view_set_draw_callback(keys_state->view, check_keys_draw_callback);
     view_set_input_callback(keys_state->view, nested_input_callback);
 
+    view_set_draw_callback(recovery_state->view, key_recovery_draw_callback);
+    view_set_input_callback(recovery_state->view, nested_input_callback);
+
     mifare_nested->collecting_type = MifareNestedWorkerStateReady;
     mifare_nested->run = NestedRunIdle;
 
@@ -345,12 +422,23 @@ void mifare_nested_free(MifareNested* mifare_nested) {
     // Check keys
     view_dispatcher_remove_view(mifare_nested->view_dispatcher, MifareNestedViewCheckKeys);
 
+    // Key recovery
+    view_dispatcher_remove_view(mifare_nested->view_dispatcher, MifareNestedViewKeyRecovery);
+    with_view_model(
+        mifare_nested->recovery_state->view,
+        KeyRecoveryViewModel * model,
+        { furi_string_free(model->header); },
+        false);
+    view_free(mifare_nested->recovery_state->view);
+    free(mifare_nested->recovery_state);
+
     // Nonces states
     free(mifare_nested->nonces);
     free(mifare_nested->nested_state);
 
     // Keys
     free(mifare_nested->keys);
+    free(mifare_nested->recovery);
 
     // Settings
     free(mifare_nested->settings);
@@ -60,6 +60,10 @@ typedef struct {
     void* context;
 } CheckKeysState;
 
+typedef struct {
+    View* view;
+} KeyRecoveryState;
+
 typedef enum {
     EventTypeTick,
     EventTypeKey,
@@ -96,9 +100,11 @@ struct MifareNested {
 
     NonceList_t* nonces;
     KeyInfo_t* keys;
+    RecoveryInfo_t* recovery;
 
     NestedState* nested_state;
     CheckKeysState* keys_state;
+    KeyRecoveryState* recovery_state;
     SaveNoncesResult_t* save_state;
 
     MifareNestedWorkerState collecting_type;
@@ -115,6 +121,7 @@ typedef enum {
     MifareNestedViewVariableList,
     MifareNestedViewCollecting,
     MifareNestedViewCheckKeys,
+    MifareNestedViewKeyRecovery,
 } MifareNestedView;
 
 typedef struct {
@@ -138,6 +145,19 @@ typedef struct {
     bool processing_keys;
 } CheckKeysViewModel;
 
+typedef struct {
+    FuriString* header;
+    uint32_t nonces_total;
+    uint32_t nonces_processed;
+    uint32_t keys_found;
+    uint32_t progress;
+    uint32_t progress_total;
+    uint32_t eta;
+    uint8_t sector;
+    uint8_t key_type;
+    bool lost_tag;
+} KeyRecoveryViewModel;
+
 static const NotificationSequence mifare_nested_sequence_blink_start_blue = {
     &message_blink_start_10,
     &message_blink_set_color_blue,
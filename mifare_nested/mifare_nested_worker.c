@@ -2,6 +2,8 @@
 
 #include "lib/nested/nested.h"
 #include "lib/parity/parity.h"
+#include "lib/crypto1/crypto1_recovery.h"
+#include "lib/key_set/key_set.h"
 #include <lib/nfc/protocols/nfc_util.h>
 
 #include <storage/storage.h>
@@ -83,6 +85,8 @@ int32_t mifare_nested_worker_task(void* context) {
         mifare_nested_worker_collect_nonces_hard(mifare_nested_worker);
     } else if(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
         mifare_nested_worker_check_keys(mifare_nested_worker);
+    } else if(mifare_nested_worker->state == MifareNestedWorkerStateRecovering) {
+        mifare_nested_worker_recover_keys(mifare_nested_worker);
     }
 
     mifare_nested_worker_change_state(mifare_nested_worker, MifareNestedWorkerStateReady);
@@ -315,12 +319,7 @@ uint32_t mifare_nested_worker_predict_delay(
         mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
         // Searching for delay, where PRNG will be near 800
-        uint32_t nttmp = prng_successor(nt1, 100);
-
-        for(i = 101; i < 65565; i++) {
-            nttmp = prng_successor(nttmp, 1);
-            if(nttmp == nt2) break;
-        }
+        i = nested_prng_distance(nt1, nt2, 101, 65565);
 
         if(!rtr) {
             zero_prng_value = i;
@@ -380,12 +379,7 @@ uint32_t mifare_nested_worker_predict_delay(
             mifare_classic_authex(crypto, tx_rx, cuid, blockNo, keyType, ui64Key, true, &nt2);
 
             // Searching for delay, where PRNG will be near 800
-            uint32_t nttmp = prng_successor(nt1, 0);
-
-            for(i = 1; i < 65565; i++) {
-                nttmp = prng_successor(nttmp, 1);
-                if(nttmp == nt2) break;
-            }
+            i = nested_prng_distance(nt1, nt2, 1, 65565);
 
             if(!(i > previous - 50 && i < previous + 50) && rtz) {
                 repeat++;
@@ -1429,61 +1423,81 @@ void mifare_nested_worker_collect_nonces(MifareNestedWorker* mifare_nested_worke
     nfc_deactivate();
 }
 
-bool* mifare_nested_worker_check_keys_exists(
+void mifare_nested_worker_remove_existing_keys(
     Storage* storage,
-    char* path,
-    uint64_t* keys,
-    uint32_t key_count,
+    const char* path,
+    KeySet* keys,
     MifareNestedWorker* mifare_nested_worker) {
-    bool* old_keys = malloc(sizeof(bool) * key_count);
     Stream* file_stream = file_stream_alloc(storage);
-    file_stream_open(file_stream, path, FSAM_READ, FSOM_OPEN_ALWAYS);
-    FuriString* key_strings[key_count];
-
-    for(uint32_t i = 0; i < key_count; i++) {
-        old_keys[i] = false;
-        key_strings[i] = furi_string_alloc_printf("%012llX\n", keys[i]);
-    }
+    FuriString* next_line = furi_string_alloc();
+    uint64_t key;
 
-    while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
-        FuriString* next_line = furi_string_alloc();
+    if(file_stream_open(file_stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        while(mifare_nested_worker->state == MifareNestedWorkerStateValidating &&
+              key_set_count(keys)) {
+            if(!stream_read_line(file_stream, next_line)) {
+                break;
+            }
 
-        if(!stream_read_line(file_stream, next_line)) {
-            break;
+            if(key_set_parse_key(furi_string_get_cstr(next_line), &key)) {
+                key_set_remove(keys, key);
+            }
         }
+    }
 
-        for(uint32_t i = 0; i < key_count; i++) {
-            if(keys[i] == (uint64_t)-1) continue;
+    furi_string_free(next_line);
+    file_stream_close(file_stream);
+    stream_free(file_stream);
+}
 
-            if(furi_string_cmp(next_line, key_strings[i]) == 0) {
-                old_keys[i] = true;
-            }
-        }
+void mifare_nested_worker_write_keys(Storage* storage, KeySet* keys) {
+    Stream* file_stream = file_stream_alloc(storage);
+    FuriString* key_strings = furi_string_alloc();
 
-        furi_string_free(next_line);
+    for(size_t i = 0; i < key_set_count(keys); i++) {
+        furi_string_cat_printf(key_strings, "%012llX\n", key_set_get(keys, i));
     }
 
-    for(uint32_t i = 0; i < key_count; i++) {
-        furi_string_free(key_strings[i]);
+    if(file_stream_open(
+           file_stream,
+           EXT_PATH("nfc/assets/mf_classic_dict_user.nfc"),
+           FSAM_READ_WRITE,
+           FSOM_OPEN_APPEND)) {
+        stream_write_string(file_stream, key_strings);
     }
 
+    furi_string_free(key_strings);
     file_stream_close(file_stream);
-    free(file_stream);
-
-    return old_keys;
+    stream_free(file_stream);
 }
 
-void mifare_nested_worker_write_key(Storage* storage, FuriString* key) {
-    Stream* file_stream = file_stream_alloc(storage);
-    file_stream_open(
-        file_stream,
-        EXT_PATH("nfc/assets/mf_classic_dict_user.nfc"),
-        FSAM_READ_WRITE,
-        FSOM_OPEN_APPEND);
+bool mifare_nested_worker_parse_found_key(
+    FuriString* line,
+    uint8_t* key_type,
+    uint8_t* sector,
+    uint64_t* key) {
+    // Key X sector XX: XX XX XX XX XX XX
+    // 0000000000111111111122222222223333
+    // 0123456789012345678901234567890123
+    if(!furi_string_start_with_str(line, "Key") || furi_string_size(line) < 34) return false;
 
-    stream_write_string(file_stream, key);
+    const char* str = furi_string_get_cstr(line);
+    uint8_t key_bytes[6];
 
-    file_stream_close(file_stream);
+    if(str[13] < '0' || str[13] > '9' || str[14] < '0' || str[14] > '9') return false;
+
+    *key_type = str[4] == 'B';
+    *sector = (str[13] - '0') * 10 + (str[14] - '0');
+
+    if(*sector >= 40) return false;
+
+    for(uint8_t i = 0; i < 6; i++) {
+        if(!hex_char_to_uint8(str[17 + i * 3], str[18 + i * 3], &key_bytes[i])) return false;
+    }
+
+    *key = nfc_util_bytes2num(key_bytes, 6);
+
+    return true;
 }
 
 void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
@@ -1499,35 +1513,20 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
     FuriHalNfcTxRxContext tx_rx = {};
     uint32_t key_count = 0;
     uint32_t sector_key_count = 0;
-    uint64_t keys[80];
-    bool found_keys[2][40];
-    bool unique_keys[2][40];
-    uint32_t sector_count = 0;
+    bool found_keys[2][40] = {};
+    bool unique_keys[2][40] = {};
+    uint8_t key_type;
+    uint8_t sector;
+    uint64_t key;
 
     if(type == MfClassicType4k) {
-        sector_count = 40;
         FURI_LOG_I(TAG, "Found Mifare Classic 4K tag");
     } else if(type == MfClassicType1k) {
-        sector_count = 16;
         FURI_LOG_I(TAG, "Found Mifare Classic 1K tag");
     } else { // if(type == MfClassicTypeMini)
-        sector_count = 5;
         FURI_LOG_I(TAG, "Found Mifare Classic Mini tag");
     }
 
-    uint32_t keys_count = sector_count * 2;
-
-    for(uint8_t key = 0; key < 2; key++) {
-        for(uint8_t i = 0; i < sector_count; i++) {
-            found_keys[key][i] = false;
-            unique_keys[key][i] = false;
-        }
-    }
-
-    for(uint8_t i = 0; i < keys_count; i++) {
-        keys[i] = -1;
-    }
-
     mifare_nested_worker_get_found_keys_file_path(&data, path);
 
     if(!file_stream_open(file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
@@ -1556,16 +1555,17 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
         return;
     };
 
+    // Candidates for the same sector repeat a lot (several tries, delay mode),
+    // each one is checked on tag only once
+    KeySet* checked_keys = key_set_alloc();
+    KeySet* valid_keys = key_set_alloc();
+
     while(true) {
         if(!stream_read_line(file_stream, next_line)) {
             break;
         }
 
-        if(furi_string_start_with_str(next_line, "Key")) {
-            uint8_t key_type = furi_string_get_char(next_line, 4) == 'B';
-            uint8_t sector = atoi((char[]){furi_string_get_char(next_line, 13)}) * 10 +
-                             atoi((char[]){furi_string_get_char(next_line, 14)});
-
+        if(mifare_nested_worker_parse_found_key(next_line, &key_type, &sector, &key)) {
             if(!unique_keys[key_type][sector]) {
                 unique_keys[key_type][sector] = true;
                 sector_key_count++;
@@ -1585,74 +1585,53 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
             break;
         }
 
-        if(furi_string_start_with_str(next_line, "Key")) {
-            // Key X sector XX: XX XX XX XX XX XX
-            // 0000000000111111111122222222223333
-            // 0123456789012345678901234567890123
-            uint8_t keyChar[6];
-            uint8_t count = 0;
-
-            uint8_t key_type = furi_string_get_char(next_line, 4) == 'B';
-            uint8_t sector = atoi((char[]){furi_string_get_char(next_line, 13)}) * 10 +
-                             atoi((char[]){furi_string_get_char(next_line, 14)});
-
-            for(uint8_t i = 17; i < 33; i += 3) {
-                hex_char_to_uint8(
-                    furi_string_get_char(next_line, i),
-                    furi_string_get_char(next_line, i + 1),
-                    &keyChar[count]);
-                count++;
-            }
-
-            uint64_t key = nfc_util_bytes2num(keyChar, 6);
-
-            key_info->checked_keys++;
-
-            if(found_keys[key_type][sector]) {
-                mifare_nested_worker->callback(
-                    MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
-
-                continue;
-            }
-
-            while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
-                result = nested_check_key(
-                    &tx_rx, mifare_nested_worker_get_block_by_sector(sector), key_type, key);
+        if(!mifare_nested_worker_parse_found_key(next_line, &key_type, &sector, &key)) {
+            continue;
+        }
 
-                if(result == NestedCheckKeyNoTag) {
-                    mifare_nested_worker->callback(
-                        MifareNestedWorkerEventNoTagDetected, mifare_nested_worker->context);
+        key_info->checked_keys++;
 
-                    furi_delay_ms(250);
-                } else {
-                    break;
-                }
-            }
+        if(found_keys[key_type][sector] ||
+           !key_set_add(
+               checked_keys, key | (uint64_t)sector << 48 | (uint64_t)key_type << 56)) {
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
 
-            if(result == NestedCheckKeyValid) {
-                FURI_LOG_I(
-                    TAG, "Found valid %c key for sector %u: %012llX", key_type, sector, key);
-                bool exists = false;
+            continue;
+        }
 
-                for(uint8_t i = 0; i < keys_count; i++) {
-                    if(keys[i] == key) {
-                        exists = true;
-                    }
-                }
+        while(mifare_nested_worker->state == MifareNestedWorkerStateValidating) {
+            result = nested_check_key(
+                &tx_rx, mifare_nested_worker_get_block_by_sector(sector), key_type, key);
 
-                if(!exists) {
-                    keys[key_info->found_keys] = key;
-                }
+            if(result == NestedCheckKeyNoTag) {
+                mifare_nested_worker->callback(
+                    MifareNestedWorkerEventNoTagDetected, mifare_nested_worker->context);
 
-                key_info->found_keys++;
-                found_keys[key_type][sector] = true;
+                furi_delay_ms(250);
+            } else {
+                break;
             }
+        }
 
-            mifare_nested_worker->callback(
-                MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
+        if(result == NestedCheckKeyValid) {
+            FURI_LOG_I(
+                TAG,
+                "Found valid %c key for sector %u: %012llX",
+                !key_type ? 'A' : 'B',
+                sector,
+                key);
+
+            key_set_add(valid_keys, key);
+            key_info->found_keys++;
+            found_keys[key_type][sector] = true;
         }
+
+        mifare_nested_worker->callback(
+            MifareNestedWorkerEventKeyChecked, mifare_nested_worker->context);
     }
 
+    key_set_free(checked_keys);
     furi_string_free(next_line);
     file_stream_close(file_stream);
     free(file_stream);
@@ -1660,45 +1639,24 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
     mifare_nested_worker->callback(
         MifareNestedWorkerEventProcessingKeys, mifare_nested_worker->context);
 
-    bool* old_keys = mifare_nested_worker_check_keys_exists(
-        storage,
-        EXT_PATH("nfc/assets/mf_classic_dict_user.nfc"),
-        keys,
-        keys_count,
-        mifare_nested_worker);
+    // Each dictionary is read once, known keys are dropped from the set
+    mifare_nested_worker_remove_existing_keys(
+        storage, EXT_PATH("nfc/assets/mf_classic_dict_user.nfc"), valid_keys, mifare_nested_worker);
+    mifare_nested_worker_remove_existing_keys(
+        storage, EXT_PATH("nfc/assets/mf_classic_dict.nfc"), valid_keys, mifare_nested_worker);
 
-    for(uint8_t i = 0; i < keys_count; i++) {
-        if(old_keys[i]) {
-            keys[i] = -1;
-        }
-    }
-
-    old_keys = mifare_nested_worker_check_keys_exists(
-        storage,
-        EXT_PATH("nfc/assets/mf_classic_dict.nfc"),
-        keys,
-        keys_count,
-        mifare_nested_worker);
+    if(key_set_count(valid_keys)) {
+        mifare_nested_worker_write_keys(storage, valid_keys);
 
-    for(uint8_t i = 0; i < keys_count; i++) {
-        if(old_keys[i]) {
-            keys[i] = -1;
+        for(size_t i = 0; i < key_set_count(valid_keys); i++) {
+            FURI_LOG_I(TAG, "Added new key: %012llX", key_set_get(valid_keys, i));
         }
-    }
-
-    for(uint8_t i = 0; i < keys_count; i++) {
-        if(keys[i] == (uint64_t)-1) continue;
-
-        FuriString* key_string = furi_string_alloc_printf("%012llX\n", keys[i]);
 
-        mifare_nested_worker_write_key(storage, key_string);
-        FURI_LOG_I(TAG, "Added new key: %s", furi_string_get_cstr(key_string));
-
-        key_info->added_keys++;
-
-        furi_string_free(key_string);
+        key_info->added_keys += key_set_count(valid_keys);
     }
 
+    key_set_free(valid_keys);
+
     if(!storage_simply_remove(storage, furi_string_get_cstr(path))) {
         FURI_LOG_E(TAG, "Failed to remove .keys file");
     }
@@ -1710,4 +1668,251 @@ void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker) {
         MifareNestedWorkerEventKeysFound, mifare_nested_worker->context);
 
     return;
-}
\ No newline at end of file
+}
+
+typedef struct {
+    MifareNestedWorker* worker;
+    uint32_t started;
+} RecoveryProgressContext;
+
+static bool mifare_nested_worker_recovery_callback(uint32_t progress, uint32_t total, void* context) {
+    RecoveryProgressContext* progress_context = context;
+    MifareNestedWorker* mifare_nested_worker = progress_context->worker;
+    RecoveryInfo_t* info = mifare_nested_worker->context->recovery;
+
+    if(progress != info->progress) {
+        uint32_t elapsed = furi_hal_rtc_get_timestamp() - progress_context->started;
+
+        info->progress = progress;
+        info->progress_total = total;
+        info->eta = progress ? (uint64_t)elapsed * (total - progress) / progress : 0;
+
+        mifare_nested_worker->callback(
+            MifareNestedWorkerEventRecoveryProgress, mifare_nested_worker->context);
+    }
+
+    return mifare_nested_worker->state == MifareNestedWorkerStateRecovering;
+}
+
+void mifare_nested_worker_recover_keys(MifareNestedWorker* mifare_nested_worker) {
+    RecoveryInfo_t* info = mifare_nested_worker->context->recovery;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* file_stream = file_stream_alloc(storage);
+    Stream* keys_stream = file_stream_alloc(storage);
+    FuriString* next_line = furi_string_alloc();
+    FuriString* path = furi_string_alloc();
+    FuriHalNfcDevData data = {};
+    uint32_t delay = 0;
+    uint32_t distance = 0;
+    uint32_t hardnested = 0;
+    bool recovered[2][40] = {};
+    uint64_t keys[NESTED_RECOVERY_MAX_CANDIDATES];
+
+    memset(info, 0, sizeof(RecoveryInfo_t));
+
+    // UID is only needed to find nonces file, tag can be removed after that
+    nested_get_data(&data);
+    while(mifare_nested_worker->state == MifareNestedWorkerStateRecovering && !data.uid_len) {
+        mifare_nested_worker->callback(
+            MifareNestedWorkerEventNoTagDetected, mifare_nested_worker->context);
+
+        furi_delay_ms(250);
+        nested_get_data(&data);
+    }
+
+    mifare_nested_worker_get_nonces_file_path(&data, path);
+
+    do {
+        if(mifare_nested_worker->state != MifareNestedWorkerStateRecovering) break;
+
+        if(!file_stream_open(
+               file_stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E(TAG, "Can't open %s", furi_string_get_cstr(path));
+
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventNeedCollection, mifare_nested_worker->context);
+            break;
+        }
+
+        while(stream_read_line(file_stream, next_line)) {
+            if(furi_string_start_with_str(next_line, "Nested: Key")) {
+                info->total_nonces++;
+            } else if(furi_string_start_with_str(next_line, "HardNested")) {
+                hardnested++;
+            } else {
+                nested_nonces_parse_delay(furi_string_get_cstr(next_line), &delay, &distance);
+            }
+        }
+
+        if(hardnested) {
+            FURI_LOG_W(TAG, "Skipping %lu hard nested nonces, use desktop app for them", hardnested);
+        }
+
+        if(!info->total_nonces) {
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventNoKeysRecovered, mifare_nested_worker->context);
+            break;
+        }
+
+        // Leave some heap for GUI and storage
+        size_t free_memory = memmgr_heap_get_max_free_block();
+        uint32_t chunk_size = crypto1_recovery_get_chunk_size(
+            free_memory > NESTED_RECOVERY_RESERVED_MEMORY ?
+                free_memory - NESTED_RECOVERY_RESERVED_MEMORY :
+                0);
+
+        if(!chunk_size) {
+            FURI_LOG_E(TAG, "Not enough memory for key recovery: %u", free_memory);
+
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventNoMemory, mifare_nested_worker->context);
+            break;
+        }
+
+        FURI_LOG_I(
+            TAG,
+            "Recovering keys from %lu nonces, chunk size %lu, delay %lu, distance %lu",
+            info->total_nonces,
+            chunk_size,
+            delay,
+            distance);
+
+        mifare_nested_worker_get_found_keys_file_path(&data, path);
+        file_stream_open(keys_stream, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+        stream_rewind(file_stream);
+
+        while(mifare_nested_worker->state == MifareNestedWorkerStateRecovering) {
+            NestedNonceRecord record = {};
+
+            if(!stream_read_line(file_stream, next_line)) {
+                break;
+            }
+
+            if(!nested_nonces_parse_line(furi_string_get_cstr(next_line), &record)) {
+                continue;
+            }
+
+            info->sector = record.sector;
+            info->key_type = record.key_type;
+            info->progress = 0;
+            info->eta = 0;
+
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventRecoveryProgress, mifare_nested_worker->context);
+
+            if(recovered[record.key_type][record.sector]) {
+                // Other try of the same sector already gave candidates
+                info->processed_nonces++;
+                continue;
+            }
+
+            if(delay) {
+                // Nonces were saved as is, PRNG value has to be predicted first
+                bool predicted = true;
+                for(uint8_t i = 0; i < 2; i++) {
+                    predicted &= nested_predict_nonce(
+                        record.target_nt[i],
+                        record.target_ks[i],
+                        record.parity[i],
+                        distance,
+                        &record.target_nt[i],
+                        &record.target_ks[i]);
+                }
+
+                if(!predicted) {
+                    FURI_LOG_W(
+                        TAG,
+                        "Can't predict nonce for sector %u, key_type: %u",
+                        record.sector,
+                        record.key_type);
+
+                    info->processed_nonces++;
+                    continue;
+                }
+            }
+
+            RecoveryProgressContext progress_context = {
+                .worker = mifare_nested_worker,
+                .started = furi_hal_rtc_get_timestamp(),
+            };
+            uint32_t keys_found = 0;
+
+            Crypto1RecoveryResult result = crypto1_nested_recover_keys(
+                record.cuid,
+                record.target_nt,
+                record.target_ks,
+                chunk_size,
+                mifare_nested_worker_recovery_callback,
+                &progress_context,
+                keys,
+                NESTED_RECOVERY_MAX_CANDIDATES,
+                &keys_found);
+
+            if(result == Crypto1RecoveryCancelled) {
+                break;
+            }
+
+            if(result == Crypto1RecoveryOverflow) {
+                FURI_LOG_E(
+                    TAG,
+                    "Buckets overflowed for sector %u, key_type: %u, candidates incomplete",
+                    record.sector,
+                    record.key_type);
+            }
+
+            FURI_LOG_I(
+                TAG,
+                "Sector %u, key_type: %u: %lu candidates in %lu seconds",
+                record.sector,
+                record.key_type,
+                keys_found,
+                furi_hal_rtc_get_timestamp() - progress_context.started);
+
+            for(uint32_t i = 0; i < keys_found; i++) {
+                FuriString* key_string = furi_string_alloc_printf(
+                    "Key %c sector %02u:", !record.key_type ? 'A' : 'B', record.sector);
+
+                for(int8_t byte = 5; byte >= 0; byte--) {
+                    furi_string_cat_printf(key_string, " %02X", (uint8_t)(keys[i] >> (byte * 8)));
+                }
+
+                furi_string_cat_printf(key_string, "\n");
+                stream_write_string(keys_stream, key_string);
+                furi_string_free(key_string);
+            }
+
+            // After overflow other tries of the sector may still give the right key
+            if(keys_found && result != Crypto1RecoveryOverflow) {
+                recovered[record.key_type][record.sector] = true;
+            }
+
+            info->found_keys += keys_found;
+            info->processed_nonces++;
+
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventRecoveryProgress, mifare_nested_worker->context);
+        }
+
+        file_stream_close(keys_stream);
+
+        if(mifare_nested_worker->state != MifareNestedWorkerStateRecovering) break;
+
+        if(info->found_keys) {
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventKeysRecovered, mifare_nested_worker->context);
+        } else {
+            storage_simply_remove(storage, furi_string_get_cstr(path));
+
+            mifare_nested_worker->callback(
+                MifareNestedWorkerEventNoKeysRecovered, mifare_nested_worker->context);
+        }
+    } while(false);
+
+    file_stream_close(file_stream);
+    stream_free(file_stream);
+    stream_free(keys_stream);
+    furi_string_free(next_line);
+    furi_string_free(path);
+    furi_record_close(RECORD_STORAGE);
+}
@@ -4,6 +4,10 @@
 
 #define NESTED_FOLDER EXT_PATH("nfc/.nested")
 
+// Candidate keys kept per nonce, usually there are only 1-3 of them
+#define NESTED_RECOVERY_MAX_CANDIDATES (64)
+#define NESTED_RECOVERY_RESERVED_MEMORY (8 * 1024)
+
 typedef struct MifareNestedWorker MifareNestedWorker;
 
 typedef enum {
@@ -14,6 +18,7 @@ typedef enum {
     MifareNestedWorkerStateCollectingStatic,
     MifareNestedWorkerStateCollectingHard,
     MifareNestedWorkerStateValidating,
+    MifareNestedWorkerStateRecovering,
 
     MifareNestedWorkerStateStop,
 } MifareNestedWorkerState;
@@ -37,7 +42,11 @@ typedef enum {
     MifareNestedWorkerEventProcessingKeys,
     MifareNestedWorkerEventNeedKeyRecovery,
     MifareNestedWorkerEventNeedCollection,
-    MifareNestedWorkerEventHardnestedStatesFound
+    MifareNestedWorkerEventHardnestedStatesFound,
+    MifareNestedWorkerEventRecoveryProgress,
+    MifareNestedWorkerEventKeysRecovered,
+    MifareNestedWorkerEventNoKeysRecovered,
+    MifareNestedWorkerEventNoMemory
 } MifareNestedWorkerEvent;
 
 typedef bool (*MifareNestedWorkerCallback)(MifareNestedWorkerEvent event, void* context);
@@ -91,6 +100,17 @@ typedef struct {
     bool tag_lost;
 } KeyInfo_t;
 
+typedef struct {
+    uint32_t total_nonces;
+    uint32_t processed_nonces;
+    uint32_t found_keys;
+    uint32_t progress;
+    uint32_t progress_total;
+    uint32_t eta;
+    uint8_t sector;
+    uint8_t key_type;
+} RecoveryInfo_t;
+
 typedef struct {
     uint32_t saved;
     uint32_t invalid;
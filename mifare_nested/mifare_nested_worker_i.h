@@ -26,3 +26,5 @@ void mifare_nested_worker_collect_nonces_static(MifareNestedWorker* mifare_neste
 void mifare_nested_worker_collect_nonces_hard(MifareNestedWorker* mifare_nested_worker);
 
 void mifare_nested_worker_check_keys(MifareNestedWorker* mifare_nested_worker);
+
+void mifare_nested_worker_recover_keys(MifareNestedWorker* mifare_nested_worker);
@@ -11,4 +11,5 @@ ADD_SCENE(mifare_nested, static_encrypted_nonce, StaticEncryptedNonce)
 ADD_SCENE(mifare_nested, need_key_recovery, NeedKeyRecovery)
 ADD_SCENE(mifare_nested, need_collection, NeedCollection)
 ADD_SCENE(mifare_nested, settings, Settings)
-ADD_SCENE(mifare_nested, no_nonces_collected, NoNoncesCollected)
\ No newline at end of file
+ADD_SCENE(mifare_nested, no_nonces_collected, NoNoncesCollected)
+ADD_SCENE(mifare_nested, key_recovery, KeyRecovery)
\ No newline at end of file
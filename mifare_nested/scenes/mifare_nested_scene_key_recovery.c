@@ -0,0 +1,97 @@
+#include "../mifare_nested_i.h"
+
+bool mifare_nested_key_recovery_worker_callback(MifareNestedWorkerEvent event, void* context) {
+    MifareNested* mifare_nested = context;
+    KeyRecoveryState* plugin_state = mifare_nested->recovery_state;
+
+    if(event == MifareNestedWorkerEventRecoveryProgress) {
+        RecoveryInfo_t* recovery_info = mifare_nested->recovery;
+
+        with_view_model(
+            plugin_state->view,
+            KeyRecoveryViewModel * model,
+            {
+                model->lost_tag = false;
+                model->nonces_total = recovery_info->total_nonces;
+                model->nonces_processed = recovery_info->processed_nonces;
+                model->keys_found = recovery_info->found_keys;
+                model->progress = recovery_info->progress;
+                model->progress_total = recovery_info->progress_total;
+                model->eta = recovery_info->eta;
+                model->sector = recovery_info->sector;
+                model->key_type = recovery_info->key_type;
+            },
+            true);
+
+        // Progress is reported often, there is nothing to do with it in scene
+        return true;
+    } else if(event == MifareNestedWorkerEventNoTagDetected) {
+        with_view_model(
+            plugin_state->view, KeyRecoveryViewModel * model, { model->lost_tag = true; }, true);
+    }
+
+    view_dispatcher_send_custom_event(mifare_nested->view_dispatcher, event);
+
+    return true;
+}
+
+void mifare_nested_scene_key_recovery_on_enter(void* context) {
+    MifareNested* mifare_nested = context;
+    KeyRecoveryState* plugin_state = mifare_nested->recovery_state;
+
+    with_view_model(
+        plugin_state->view,
+        KeyRecoveryViewModel * model,
+        {
+            model->lost_tag = false;
+            model->nonces_total = 0;
+            model->nonces_processed = 0;
+            model->keys_found = 0;
+            model->progress = 0;
+            model->progress_total = 0;
+            model->eta = 0;
+            model->sector = 0;
+            model->key_type = 0;
+        },
+        false);
+
+    mifare_nested_worker_start(
+        mifare_nested->worker,
+        MifareNestedWorkerStateRecovering,
+        &mifare_nested->nfc_dev->dev_data,
+        mifare_nested_key_recovery_worker_callback,
+        mifare_nested);
+
+    view_dispatcher_switch_to_view(mifare_nested->view_dispatcher, MifareNestedViewKeyRecovery);
+}
+
+bool mifare_nested_scene_key_recovery_on_event(void* context, SceneManagerEvent event) {
+    MifareNested* mifare_nested = context;
+
+    bool consumed = false;
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == MifareNestedWorkerEventKeysRecovered) {
+            // Recovered keys are only candidates, check them on the tag
+            scene_manager_next_scene(mifare_nested->scene_manager, MifareNestedSceneCheckKeys);
+            consumed = true;
+        } else if(
+            event.event == MifareNestedWorkerEventNoKeysRecovered ||
+            event.event == MifareNestedWorkerEventNoMemory) {
+            scene_manager_next_scene(mifare_nested->scene_manager, MifareNestedSceneFailed);
+            consumed = true;
+        } else if(event.event == MifareNestedWorkerEventNeedCollection) {
+            scene_manager_next_scene(
+                mifare_nested->scene_manager, MifareNestedSceneNeedCollection);
+            consumed = true;
+        } else if(event.event == MifareNestedWorkerEventNoTagDetected) {
+            consumed = true;
+        }
+    }
+
+    return consumed;
+}
+
+void mifare_nested_scene_key_recovery_on_exit(void* context) {
+    MifareNested* mifare_nested = context;
+    mifare_nested_worker_stop(mifare_nested->worker);
+}
@@ -30,6 +30,12 @@ void mifare_nested_scene_need_key_recovery_on_enter(void* context) {
         "Back",
         mifare_nested_scene_need_key_recovery_widget_callback,
         mifare_nested);
+    widget_add_button_element(
+        widget,
+        GuiButtonTypeRight,
+        "Recover",
+        mifare_nested_scene_need_key_recovery_widget_callback,
+        mifare_nested);
 
     // Setup and start worker
     view_dispatcher_switch_to_view(mifare_nested->view_dispatcher, MifareNestedViewWidget);
@@ -43,6 +49,9 @@ bool mifare_nested_scene_need_key_recovery_on_event(void* context, SceneManagerE
         if(event.event == GuiButtonTypeCenter || event.event == GuiButtonTypeLeft) {
             scene_manager_search_and_switch_to_previous_scene(mifare_nested->scene_manager, 0);
             consumed = true;
+        } else if(event.event == GuiButtonTypeRight) {
+            scene_manager_next_scene(mifare_nested->scene_manager, MifareNestedSceneKeyRecovery);
+            consumed = true;
         }
     } else if(event.type == SceneManagerEventTypeBack) {
         scene_manager_search_and_switch_to_previous_scene(mifare_nested->scene_manager, 0);
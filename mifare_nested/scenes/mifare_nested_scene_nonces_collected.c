@@ -19,16 +19,22 @@ void mifare_nested_scene_nonces_collected_on_enter(void* context) {
     widget_add_icon_element(widget, 52, 17, &I_DolphinSuccess);
     widget_add_string_element(widget, 0, 0, AlignLeft, AlignTop, FontPrimary, "Nonces collected");
     widget_add_string_element(
-        widget, 0, 12, AlignLeft, AlignTop, FontSecondary, "Now you can run");
-    widget_add_string_element(widget, 0, 22, AlignLeft, AlignTop, FontSecondary, "script on your");
-    widget_add_string_element(widget, 0, 32, AlignLeft, AlignTop, FontSecondary, "PC to recover");
-    widget_add_string_element(widget, 0, 42, AlignLeft, AlignTop, FontSecondary, "keys");
+        widget, 0, 12, AlignLeft, AlignTop, FontSecondary, "Now you can");
+    widget_add_string_element(widget, 0, 22, AlignLeft, AlignTop, FontSecondary, "recover keys");
+    widget_add_string_element(widget, 0, 32, AlignLeft, AlignTop, FontSecondary, "here or run");
+    widget_add_string_element(widget, 0, 42, AlignLeft, AlignTop, FontSecondary, "script on PC");
     widget_add_button_element(
         widget,
         GuiButtonTypeLeft,
         "Back",
         mifare_nested_scene_nonces_collected_widget_callback,
         mifare_nested);
+    widget_add_button_element(
+        widget,
+        GuiButtonTypeRight,
+        "Recover",
+        mifare_nested_scene_nonces_collected_widget_callback,
+        mifare_nested);
 
     // Setup and start worker
     view_dispatcher_switch_to_view(mifare_nested->view_dispatcher, MifareNestedViewWidget);
@@ -42,6 +48,9 @@ bool mifare_nested_scene_nonces_collected_on_event(void* context, SceneManagerEv
         if(event.event == GuiButtonTypeCenter || event.event == GuiButtonTypeLeft) {
             scene_manager_search_and_switch_to_previous_scene(mifare_nested->scene_manager, 0);
             consumed = true;
+        } else if(event.event == GuiButtonTypeRight) {
+            scene_manager_next_scene(mifare_nested->scene_manager, MifareNestedSceneKeyRecovery);
+            consumed = true;
         }
     } else if(event.type == SceneManagerEventTypeBack) {
         scene_manager_search_and_switch_to_previous_scene(mifare_nested->scene_manager, 0);
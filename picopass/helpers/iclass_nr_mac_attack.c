@@ -0,0 +1,317 @@
+#include "iclass_nr_mac_attack.h"
+#include "iclass_packed_dict.h"
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <lib/toolbox/args.h>
+#include <lib/flipper_format/flipper_format.h>
+#include <toolbox/keys_dict.h>
+#include <optimized_nr_mac.h>
+
+#define TAG "IclassNrMacAttack"
+
+#define ICLASS_NR_MAC_ATTACK_KEY_LEN (8)
+#define ICLASS_NR_MAC_ATTACK_KEY_BATCH (64)
+
+#define ICLASS_NR_MAC_FILE_EXTENSION ".mac"
+// csn_epurse.mac, both in hex
+#define ICLASS_NR_MAC_FILE_NAME_LEN (16 + 1 + 16 + 4)
+
+#define ICLASS_ELITE_DICT_FLIPPER_NAME APP_ASSETS_PATH("iclass_elite_dict.txt")
+#define ICLASS_STANDARD_DICT_FLIPPER_NAME APP_ASSETS_PATH("iclass_standard_dict.txt")
+#define ICLASS_ELITE_DICT_USER_NAME APP_DATA_PATH("assets/iclass_elite_dict_user.txt")
+
+typedef struct {
+    const char* name;
+    const char* path;
+    const char* packed_path;
+    bool elite;
+} IclassNrMacAttackDict;
+
+static const IclassNrMacAttackDict iclass_nr_mac_attack_dicts[] = {
+    {
+        .name = "Elite User Dictionary",
+        .path = ICLASS_ELITE_DICT_USER_NAME,
+        .packed_path = APP_DATA_PATH("assets/iclass_elite_dict_user.keys"),
+        .elite = true,
+    },
+    {
+        .name = "Standard System Dictionary",
+        .path = ICLASS_STANDARD_DICT_FLIPPER_NAME,
+        .packed_path = APP_DATA_PATH("assets/iclass_standard_dict.keys"),
+        .elite = false,
+    },
+    {
+        .name = "Elite System Dictionary",
+        .path = ICLASS_ELITE_DICT_FLIPPER_NAME,
+        .packed_path = APP_DATA_PATH("assets/iclass_elite_dict.keys"),
+        .elite = true,
+    },
+};
+
+struct IclassNrMacAttack {
+    FuriThread* thread;
+    IclassNrMacAttackCallback callback;
+    void* context;
+    volatile bool running;
+
+    LoclassNrMac captures[ICLASS_NR_MAC_ATTACK_MAX_CAPTURES];
+    IclassNrMacAttackResult results[ICLASS_NR_MAC_ATTACK_MAX_CAPTURES];
+    size_t capture_count;
+    size_t found_count;
+
+    const char* dict_name;
+    uint32_t total_keys;
+    uint32_t current_key;
+};
+
+static bool iclass_nr_mac_attack_parse_name(const char* name, uint8_t* csn, uint8_t* epurse) {
+    if(strlen(name) != ICLASS_NR_MAC_FILE_NAME_LEN) return false;
+    if(name[16] != '_') return false;
+    if(strcmp(name + 33, ICLASS_NR_MAC_FILE_EXTENSION) != 0) return false;
+
+    for(size_t i = 0; i < 8; i++) {
+        if(!args_char_to_hex(name[i * 2], name[i * 2 + 1], &csn[i])) return false;
+        if(!args_char_to_hex(name[17 + i * 2], name[17 + i * 2 + 1], &epurse[i])) return false;
+    }
+
+    return true;
+}
+
+static int32_t iclass_nr_mac_attack_worker(void* context) {
+    IclassNrMacAttack* instance = context;
+
+    uint8_t* keys = malloc(ICLASS_NR_MAC_ATTACK_KEY_BATCH * ICLASS_NR_MAC_ATTACK_KEY_LEN);
+    LoclassNrMac* active = malloc(sizeof(LoclassNrMac) * ICLASS_NR_MAC_ATTACK_MAX_CAPTURES);
+    size_t active_index[ICLASS_NR_MAC_ATTACK_MAX_CAPTURES];
+    LoclassNrMacMatch matches[ICLASS_NR_MAC_ATTACK_MAX_CAPTURES];
+
+    size_t active_count = 0;
+    for(size_t i = 0; i < instance->capture_count; i++) {
+        if(instance->results[i].found) continue;
+        active[active_count] = instance->captures[i];
+        active_index[active_count] = i;
+        active_count++;
+    }
+
+    for(size_t d = 0; d < COUNT_OF(iclass_nr_mac_attack_dicts); d++) {
+        if(!instance->running || active_count == 0) break;
+
+        const IclassNrMacAttackDict* dict_info = &iclass_nr_mac_attack_dicts[d];
+        IclassPackedDict* dict = iclass_packed_dict_alloc(dict_info->path, dict_info->packed_path);
+        if(!dict) {
+            FURI_LOG_W(TAG, "Skipping %s, failed to load %s", dict_info->name, dict_info->path);
+            continue;
+        }
+
+        instance->dict_name = dict_info->name;
+        instance->total_keys = iclass_packed_dict_get_total_keys(dict);
+        instance->current_key = 0;
+        instance->callback(IclassNrMacAttackEventProgress, instance->context);
+
+        while(instance->running && active_count) {
+            size_t key_count =
+                iclass_packed_dict_read_keys(dict, keys, ICLASS_NR_MAC_ATTACK_KEY_BATCH);
+            if(key_count == 0) break;
+
+            bool key_found = false;
+            size_t key_offset = 0;
+            while(active_count) {
+                size_t match_count = loclass_nr_mac_check_keys(
+                    active,
+                    active_count,
+                    keys + key_offset * ICLASS_NR_MAC_ATTACK_KEY_LEN,
+                    key_count - key_offset,
+                    dict_info->elite,
+                    matches,
+                    COUNT_OF(matches));
+
+                for(size_t i = 0; i < match_count; i++) {
+                    size_t index = active_index[matches[i].nr_mac];
+                    IclassNrMacAttackResult* result = &instance->results[index];
+                    if(result->found) continue;
+                    memcpy(
+                        result->key,
+                        keys + (key_offset + matches[i].key) * ICLASS_NR_MAC_ATTACK_KEY_LEN,
+                        ICLASS_NR_MAC_ATTACK_KEY_LEN);
+                    result->elite = dict_info->elite;
+                    result->found = true;
+                    instance->found_count++;
+                    key_found = true;
+                }
+
+                // Drop cracked captures so the next batches only check what is left
+                size_t left = 0;
+                for(size_t i = 0; i < active_count; i++) {
+                    if(instance->results[active_index[i]].found) continue;
+                    active[left] = active[i];
+                    active_index[left] = active_index[i];
+                    left++;
+                }
+                active_count = left;
+
+                // Check stops once matches are full, go on from the last matching key, every
+                // match there was a capture that has just been dropped
+                if(match_count < COUNT_OF(matches)) break;
+                key_offset += matches[match_count - 1].key;
+            }
+
+            instance->current_key += key_count;
+            instance->callback(
+                key_found ? IclassNrMacAttackEventKeyFound : IclassNrMacAttackEventProgress,
+                instance->context);
+        }
+
+        iclass_packed_dict_free(dict);
+    }
+
+    // Live reads try the user dictionary first, remember elite keys there
+    if(instance->found_count) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        storage_simply_mkdir(storage, APP_DATA_PATH("assets"));
+        furi_record_close(RECORD_STORAGE);
+
+        KeysDict* user_dict = keys_dict_alloc(
+            ICLASS_ELITE_DICT_USER_NAME, KeysDictModeOpenAlways, ICLASS_NR_MAC_ATTACK_KEY_LEN);
+        for(size_t i = 0; i < instance->capture_count; i++) {
+            IclassNrMacAttackResult* result = &instance->results[i];
+            if(!result->found || !result->elite) continue;
+            if(keys_dict_is_key_present(user_dict, result->key, ICLASS_NR_MAC_ATTACK_KEY_LEN)) {
+                continue;
+            }
+            keys_dict_add_key(user_dict, result->key, ICLASS_NR_MAC_ATTACK_KEY_LEN);
+        }
+        keys_dict_free(user_dict);
+    }
+
+    free(active);
+    free(keys);
+
+    instance->callback(IclassNrMacAttackEventDone, instance->context);
+
+    return 0;
+}
+
+IclassNrMacAttack* iclass_nr_mac_attack_alloc(IclassNrMacAttackCallback callback, void* context) {
+    furi_assert(callback);
+
+    IclassNrMacAttack* instance = malloc(sizeof(IclassNrMacAttack));
+    instance->thread =
+        furi_thread_alloc_ex(TAG, 4 * 1024, iclass_nr_mac_attack_worker, instance);
+    instance->callback = callback;
+    instance->context = context;
+    instance->dict_name = "";
+
+    return instance;
+}
+
+void iclass_nr_mac_attack_free(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    iclass_nr_mac_attack_stop(instance);
+    furi_thread_free(instance->thread);
+    free(instance);
+}
+
+size_t iclass_nr_mac_attack_load(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* dir = storage_file_alloc(storage);
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    FuriString* path = furi_string_alloc();
+    char name[ICLASS_NR_MAC_FILE_NAME_LEN + 2];
+    FileInfo info;
+
+    instance->capture_count = 0;
+    instance->found_count = 0;
+    memset(instance->results, 0, sizeof(instance->results));
+
+    if(storage_dir_open(dir, STORAGE_APP_DATA_PATH_PREFIX)) {
+        while(instance->capture_count < ICLASS_NR_MAC_ATTACK_MAX_CAPTURES &&
+              storage_dir_read(dir, &info, name, sizeof(name))) {
+            if(file_info_is_dir(&info)) continue;
+
+            uint8_t csn[8];
+            uint8_t epurse[8];
+            uint8_t nr_mac[8];
+            if(!iclass_nr_mac_attack_parse_name(name, csn, epurse)) continue;
+
+            furi_string_printf(path, "%s/%s", STORAGE_APP_DATA_PATH_PREFIX, name);
+            bool loaded = flipper_format_file_open_existing(file, furi_string_get_cstr(path)) &&
+                          flipper_format_read_hex(file, "NR-MAC", nr_mac, sizeof(nr_mac));
+            flipper_format_file_close(file);
+            if(!loaded) {
+                FURI_LOG_W(TAG, "Failed to load %s", name);
+                continue;
+            }
+
+            loclass_nr_mac_init(&instance->captures[instance->capture_count], csn, epurse, nr_mac);
+            memcpy(instance->results[instance->capture_count].csn, csn, sizeof(csn));
+            instance->capture_count++;
+        }
+    }
+    storage_dir_close(dir);
+
+    furi_string_free(path);
+    flipper_format_free(file);
+    storage_file_free(dir);
+    furi_record_close(RECORD_STORAGE);
+
+    FURI_LOG_I(TAG, "Loaded %zu NR-MAC captures", instance->capture_count);
+    return instance->capture_count;
+}
+
+void iclass_nr_mac_attack_start(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+    furi_assert(!instance->running);
+
+    instance->running = true;
+    furi_thread_start(instance->thread);
+}
+
+void iclass_nr_mac_attack_stop(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    if(!instance->running) return;
+    instance->running = false;
+    furi_thread_join(instance->thread);
+}
+
+const char* iclass_nr_mac_attack_get_dict_name(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    return instance->dict_name;
+}
+
+uint32_t iclass_nr_mac_attack_get_total_keys(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    return instance->total_keys;
+}
+
+uint32_t iclass_nr_mac_attack_get_current_key(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    return instance->current_key;
+}
+
+size_t iclass_nr_mac_attack_get_capture_count(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    return instance->capture_count;
+}
+
+size_t iclass_nr_mac_attack_get_found_count(IclassNrMacAttack* instance) {
+    furi_assert(instance);
+
+    return instance->found_count;
+}
+
+const IclassNrMacAttackResult*
+    iclass_nr_mac_attack_get_result(IclassNrMacAttack* instance, size_t index) {
+    furi_assert(instance);
+    furi_assert(index < instance->capture_count);
+
+    return &instance->results[index];
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ICLASS_NR_MAC_ATTACK_MAX_CAPTURES (16)
+
+/** Offline dictionary attack against NR-MAC pairs saved while emulating a partial card.
+ * Every saved pair is checked against the user elite, standard and elite dictionaries without
+ * a reader or card present. Elite keys that are found get added to the user dictionary.
+ */
+typedef struct IclassNrMacAttack IclassNrMacAttack;
+
+typedef enum {
+    IclassNrMacAttackEventProgress,
+    IclassNrMacAttackEventKeyFound,
+    IclassNrMacAttackEventDone,
+} IclassNrMacAttackEvent;
+
+typedef void (*IclassNrMacAttackCallback)(IclassNrMacAttackEvent event, void* context);
+
+typedef struct {
+    uint8_t csn[8];
+    uint8_t key[8];
+    bool elite;
+    bool found;
+} IclassNrMacAttackResult;
+
+IclassNrMacAttack* iclass_nr_mac_attack_alloc(IclassNrMacAttackCallback callback, void* context);
+
+void iclass_nr_mac_attack_free(IclassNrMacAttack* instance);
+
+/** Load saved NR-MAC pairs, returns number of captures loaded */
+size_t iclass_nr_mac_attack_load(IclassNrMacAttack* instance);
+
+void iclass_nr_mac_attack_start(IclassNrMacAttack* instance);
+
+void iclass_nr_mac_attack_stop(IclassNrMacAttack* instance);
+
+const char* iclass_nr_mac_attack_get_dict_name(IclassNrMacAttack* instance);
+
+uint32_t iclass_nr_mac_attack_get_total_keys(IclassNrMacAttack* instance);
+
+uint32_t iclass_nr_mac_attack_get_current_key(IclassNrMacAttack* instance);
+
+size_t iclass_nr_mac_attack_get_capture_count(IclassNrMacAttack* instance);
+
+size_t iclass_nr_mac_attack_get_found_count(IclassNrMacAttack* instance);
+
+const IclassNrMacAttackResult*
+    iclass_nr_mac_attack_get_result(IclassNrMacAttack* instance, size_t index);
@@ -0,0 +1,171 @@
+#include "iclass_packed_dict.h"
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <toolbox/keys_dict.h>
+#include <toolbox/path.h>
+
+#define TAG "IclassPackedDict"
+
+#define ICLASS_PACKED_DICT_MAGIC (0x4b504349) // "ICPK"
+#define ICLASS_PACKED_DICT_VERSION (2)
+#define ICLASS_PACKED_DICT_KEY_LEN (8)
+#define ICLASS_PACKED_DICT_PACK_BATCH (64)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t source_size;
+    uint32_t source_timestamp;
+    uint32_t total_keys;
+} IclassPackedDictHeader;
+
+struct IclassPackedDict {
+    Storage* storage;
+    File* file;
+    uint32_t total_keys;
+};
+
+static bool iclass_packed_dict_pack(
+    File* file,
+    const char* dict_path,
+    uint32_t source_size,
+    uint32_t source_timestamp) {
+    KeysDict* keys_dict =
+        keys_dict_alloc(dict_path, KeysDictModeOpenExisting, ICLASS_PACKED_DICT_KEY_LEN);
+    uint8_t* buffer = malloc(ICLASS_PACKED_DICT_PACK_BATCH * ICLASS_PACKED_DICT_KEY_LEN);
+    IclassPackedDictHeader header = {
+        .magic = ICLASS_PACKED_DICT_MAGIC,
+        .version = ICLASS_PACKED_DICT_VERSION,
+        .source_size = source_size,
+        .source_timestamp = source_timestamp,
+        .total_keys = 0,
+    };
+
+    bool packed = false;
+    do {
+        // Header is written last, an interrupted pack is never taken for a valid one
+        if(!storage_file_seek(file, sizeof(header), true)) break;
+
+        bool write_ok = true;
+        size_t count = 0;
+        while(write_ok) {
+            uint8_t* key = buffer + count * ICLASS_PACKED_DICT_KEY_LEN;
+            bool key_read = keys_dict_get_next_key(keys_dict, key, ICLASS_PACKED_DICT_KEY_LEN);
+            if(key_read) count++;
+            if(count == ICLASS_PACKED_DICT_PACK_BATCH || (!key_read && count)) {
+                size_t size = count * ICLASS_PACKED_DICT_KEY_LEN;
+                write_ok = storage_file_write(file, buffer, size) == size;
+                header.total_keys += count;
+                count = 0;
+            }
+            if(!key_read) break;
+        }
+        if(!write_ok) break;
+
+        if(!storage_file_seek(file, 0, true)) break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        packed = true;
+    } while(false);
+
+    free(buffer);
+    keys_dict_free(keys_dict);
+
+    return packed;
+}
+
+IclassPackedDict* iclass_packed_dict_alloc(const char* dict_path, const char* packed_path) {
+    IclassPackedDict* dict = malloc(sizeof(IclassPackedDict));
+    dict->storage = furi_record_open(RECORD_STORAGE);
+    dict->file = storage_file_alloc(dict->storage);
+    dict->total_keys = 0;
+
+    bool dict_loaded = false;
+    do {
+        FileInfo source_info;
+        if(storage_common_stat(dict->storage, dict_path, &source_info) != FSE_OK) break;
+        uint32_t source_size = source_info.size;
+        // Edits that keep the size, like replacing a key, only show in the modification time
+        uint32_t source_timestamp = 0;
+        storage_common_timestamp(dict->storage, dict_path, &source_timestamp);
+
+        IclassPackedDictHeader header = {};
+        if(storage_file_open(dict->file, packed_path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            bool header_ok =
+                storage_file_read(dict->file, &header, sizeof(header)) == sizeof(header) &&
+                header.magic == ICLASS_PACKED_DICT_MAGIC &&
+                header.version == ICLASS_PACKED_DICT_VERSION &&
+                header.source_size == source_size &&
+                header.source_timestamp == source_timestamp;
+            if(header_ok) {
+                dict->total_keys = header.total_keys;
+                dict_loaded = true;
+                break;
+            }
+        }
+        storage_file_close(dict->file);
+
+        FURI_LOG_I(TAG, "Packing %s", dict_path);
+        FuriString* packed_dir = furi_string_alloc();
+        path_extract_dirname(packed_path, packed_dir);
+        storage_simply_mkdir(dict->storage, furi_string_get_cstr(packed_dir));
+        furi_string_free(packed_dir);
+
+        if(!storage_file_open(dict->file, packed_path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+            FURI_LOG_E(TAG, "Failed to create %s", packed_path);
+            break;
+        }
+        if(!iclass_packed_dict_pack(dict->file, dict_path, source_size, source_timestamp)) {
+            FURI_LOG_E(TAG, "Failed to pack %s", dict_path);
+            storage_file_close(dict->file);
+            storage_common_remove(dict->storage, packed_path);
+            break;
+        }
+
+        // Read it back so the key count always comes from the file
+        if(!storage_file_seek(dict->file, 0, true)) break;
+        if(storage_file_read(dict->file, &header, sizeof(header)) != sizeof(header)) break;
+        dict->total_keys = header.total_keys;
+        dict_loaded = true;
+    } while(false);
+
+    if(!dict_loaded) {
+        storage_file_close(dict->file);
+        storage_file_free(dict->file);
+        furi_record_close(RECORD_STORAGE);
+        free(dict);
+        return NULL;
+    }
+
+    FURI_LOG_I(TAG, "Loaded packed dictionary with %lu keys", dict->total_keys);
+    return dict;
+}
+
+void iclass_packed_dict_free(IclassPackedDict* dict) {
+    furi_assert(dict);
+
+    storage_file_close(dict->file);
+    storage_file_free(dict->file);
+    furi_record_close(RECORD_STORAGE);
+    free(dict);
+}
+
+uint32_t iclass_packed_dict_get_total_keys(IclassPackedDict* dict) {
+    furi_assert(dict);
+
+    return dict->total_keys;
+}
+
+size_t iclass_packed_dict_read_keys(IclassPackedDict* dict, uint8_t* keys, size_t max_keys) {
+    furi_assert(dict);
+    furi_assert(keys);
+
+    size_t size = storage_file_read(dict->file, keys, max_keys * ICLASS_PACKED_DICT_KEY_LEN);
+    return size / ICLASS_PACKED_DICT_KEY_LEN;
+}
+
+bool iclass_packed_dict_rewind(IclassPackedDict* dict) {
+    furi_assert(dict);
+
+    return storage_file_seek(dict->file, sizeof(IclassPackedDictHeader), true);
+}
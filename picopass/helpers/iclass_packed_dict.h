@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Binary copy of a text key dictionary: 8 byte keys back to back after a small header.
+ * Built next to the app data on first use and rebuilt when the source dictionary changes size
+ * or modification time, so attacks can read keys in batches without parsing hex lines.
+ */
+typedef struct IclassPackedDict IclassPackedDict;
+
+IclassPackedDict* iclass_packed_dict_alloc(const char* dict_path, const char* packed_path);
+
+void iclass_packed_dict_free(IclassPackedDict* dict);
+
+uint32_t iclass_packed_dict_get_total_keys(IclassPackedDict* dict);
+
+/** Read up to max_keys keys, returns number of keys read, 0 at the end of dictionary */
+size_t iclass_packed_dict_read_keys(IclassPackedDict* dict, uint8_t* keys, size_t max_keys);
+
+bool iclass_packed_dict_rewind(IclassPackedDict* dict);
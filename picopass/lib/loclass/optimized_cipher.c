@@ -182,6 +182,16 @@ static inline void loclass_opt_output(const uint8_t* k, LoclassState_t* s, uint8
     }
 }
 
+static inline uint8_t loclass_opt_output_byte(const uint8_t* k, LoclassState_t* s) {
+    uint8_t bout = 0;
+#pragma GCC unroll 8
+    for(uint8_t i = 0; i < 8; i++) {
+        bout |= ((s->r & 0x4) >> 2) << i;
+        loclass_opt_successor(k, s, 0);
+    }
+    return bout;
+}
+
 static void loclass_opt_MAC(uint8_t* k, uint8_t* input, uint8_t* out) {
     LoclassState_t _init = {
         ((k[0] ^ 0x4c) + 0xEC) & 0xFF, // l
@@ -212,6 +222,24 @@ void loclass_opt_doReaderMAC(uint8_t* cc_nr_p, uint8_t* div_key_p, uint8_t mac[4
     memcpy(mac, dest, 4);
 }
 
+bool loclass_opt_checkReaderMAC(
+    const uint8_t* cc_nr_p,
+    const uint8_t* div_key_p,
+    const uint8_t mac[4]) {
+    LoclassState_t _init = {
+        ((div_key_p[0] ^ 0x4c) + 0xEC) & 0xFF, // l
+        ((div_key_p[0] ^ 0x4c) + 0x21) & 0xFF, // r
+        0x4c, // b
+        0xE012 // t
+    };
+    loclass_opt_suc(div_key_p, &_init, cc_nr_p, 12, false);
+    // Almost every candidate is rejected by the first byte, skip the rest of the output
+    for(uint8_t i = 0; i < 4; i++) {
+        if(loclass_opt_output_byte(div_key_p, &_init) != mac[i]) return false;
+    }
+    return true;
+}
+
 void loclass_opt_doReaderMAC_2(
     LoclassState_t _init,
     const uint8_t* nr,
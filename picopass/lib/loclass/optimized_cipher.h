@@ -58,6 +58,19 @@ typedef struct {
  **/
 void loclass_opt_doReaderMAC(uint8_t* cc_nr_p, uint8_t* div_key_p, uint8_t mac[4]);
 
+/**
+ * Same as loclass_opt_doReaderMAC, but compares the MAC byte by byte while it is generated
+ * and stops on the first mismatch. Meant for checking many candidate keys.
+ * @param cc_nr_p - CC (8 bytes) followed by NR (4 bytes)
+ * @param div_key_p - the key to use
+ * @param mac - the expected reader MAC
+ * @return true if the reader MAC matches
+ */
+bool loclass_opt_checkReaderMAC(
+    const uint8_t* cc_nr_p,
+    const uint8_t* div_key_p,
+    const uint8_t mac[4]);
+
 void loclass_opt_doReaderMAC_2(
     LoclassState_t _init,
     const uint8_t* nr,
@@ -0,0 +1,81 @@
+//-----------------------------------------------------------------------------
+// Offline check of dictionary keys against reader NR/MAC pairs captured
+// while emulating a card.
+//-----------------------------------------------------------------------------
+#include "optimized_nr_mac.h"
+
+#include <string.h>
+#include <mbedtls/des.h>
+#include "optimized_cipher.h"
+#include "optimized_cipherutils.h"
+#include "optimized_elite.h"
+#include "optimized_ikeys.h"
+
+void loclass_nr_mac_init(
+    LoclassNrMac* nr_mac,
+    const uint8_t* csn,
+    const uint8_t* cc,
+    const uint8_t* nr_mac_p) {
+    memcpy(nr_mac->csn, csn, 8);
+    memcpy(nr_mac->cc_nr, cc, 8);
+    memcpy(nr_mac->cc_nr + 8, nr_mac_p, 4);
+    memcpy(nr_mac->mac, nr_mac_p + 4, 4);
+    loclass_hash1(csn, nr_mac->key_index);
+}
+
+static void
+    loclass_nr_mac_div_key(mbedtls_des_context* ctx, const uint8_t* csn, uint8_t* div_key) {
+    uint8_t crypted_csn[8] = {0};
+    mbedtls_des_crypt_ecb(ctx, csn, crypted_csn);
+    loclass_hash0(loclass_x_bytes_to_num(crypted_csn, sizeof(crypted_csn)), div_key);
+}
+
+size_t loclass_nr_mac_check_keys(
+    const LoclassNrMac* nr_macs,
+    size_t nr_mac_count,
+    const uint8_t* keys,
+    size_t key_count,
+    bool elite,
+    LoclassNrMacMatch* matches,
+    size_t matches_size) {
+    mbedtls_des_context ctx;
+    uint8_t keytable[128];
+    uint8_t key_sel[8];
+    uint8_t key_sel_p[8];
+    uint8_t div_key[8];
+    size_t found = 0;
+
+    mbedtls_des_init(&ctx);
+
+    for(size_t k = 0; k < key_count && found < matches_size; k++) {
+        const uint8_t* key = keys + k * 8;
+
+        if(elite) {
+            // Key table is the expensive part of elite diversification and doesn't depend on CSN
+            loclass_hash2(key, keytable);
+        } else {
+            mbedtls_des_setkey_enc(&ctx, key);
+        }
+
+        for(size_t n = 0; n < nr_mac_count && found < matches_size; n++) {
+            const LoclassNrMac* nr_mac = &nr_macs[n];
+
+            if(elite) {
+                for(uint8_t i = 0; i < 8; i++) key_sel[i] = keytable[nr_mac->key_index[i]];
+                loclass_permutekey_rev(key_sel, key_sel_p);
+                mbedtls_des_setkey_enc(&ctx, key_sel_p);
+            }
+            loclass_nr_mac_div_key(&ctx, nr_mac->csn, div_key);
+
+            if(loclass_opt_checkReaderMAC(nr_mac->cc_nr, div_key, nr_mac->mac)) {
+                matches[found].key = k;
+                matches[found].nr_mac = n;
+                found++;
+            }
+        }
+    }
+
+    mbedtls_des_free(&ctx);
+
+    return found;
+}
@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+// Offline check of dictionary keys against reader NR/MAC pairs captured
+// while emulating a card. Every capture is a CSN, the card challenge (CC,
+// the e-purse) and the NR/MAC the reader answered with.
+//-----------------------------------------------------------------------------
+#ifndef OPTIMIZED_NR_MAC_H
+#define OPTIMIZED_NR_MAC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    uint8_t csn[8];
+    uint8_t cc_nr[12];
+    uint8_t mac[4];
+    uint8_t key_index[8]; // loclass_hash1(csn), only depends on the CSN
+} LoclassNrMac;
+
+typedef struct {
+    uint32_t key; // index of the key in the batch
+    uint32_t nr_mac; // index of the capture
+} LoclassNrMacMatch;
+
+/**
+ * Prepares a capture for loclass_nr_mac_check_keys
+ * @param nr_mac - capture to fill in
+ * @param csn - card serial number
+ * @param cc - card challenge (e-purse)
+ * @param nr_mac_p - NR (4 bytes) followed by MAC (4 bytes) as sent by the reader
+ */
+void loclass_nr_mac_init(
+    LoclassNrMac* nr_mac,
+    const uint8_t* csn,
+    const uint8_t* cc,
+    const uint8_t* nr_mac_p);
+
+/**
+ * Checks a batch of keys against all captures.
+ * Work that only depends on the key (elite key table, DES key schedule) is done once
+ * per key and shared by all captures.
+ * @param nr_macs - captures
+ * @param nr_mac_count - number of captures
+ * @param keys - key_count keys, 8 bytes each
+ * @param key_count - number of keys
+ * @param elite - use elite key diversification
+ * @param matches - where to store matches
+ * @param matches_size - capacity of matches
+ * @return number of matches stored
+ */
+size_t loclass_nr_mac_check_keys(
+    const LoclassNrMac* nr_macs,
+    size_t nr_mac_count,
+    const uint8_t* keys,
+    size_t key_count,
+    bool elite,
+    LoclassNrMacMatch* matches,
+    size_t matches_size);
+
+#endif // OPTIMIZED_NR_MAC_H
@@ -0,0 +1,236 @@
+// Host benchmark of the loclass core: keys per second for the reference per-key path used by
+// the poller and for the batched kernel used by the offline NR-MAC attack.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../loclass/optimized_cipher.h"
+#include "../loclass/optimized_nr_mac.h"
+
+#define DEFAULT_DICT_PATH "../../files/iclass_elite_dict.txt"
+#define DEFAULT_NR_MAC_COUNT (4)
+#define KEY_BATCH_SIZE (64)
+// Same as ICLASS_NR_MAC_ATTACK_MAX_CAPTURES, the attack sizes its matches by it
+#define MAX_MATCHES (16)
+#define SAME_BATCH_NR_MAC_COUNT (MAX_MATCHES + 4)
+#define NOT_FOUND ((size_t)-1)
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int hex_to_nibble(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static size_t load_dict(const char* path, uint8_t** keys) {
+    FILE* file = fopen(path, "r");
+    char line[128];
+    size_t count = 0;
+    size_t size = 0;
+
+    *keys = NULL;
+    if(!file) return 0;
+
+    while(fgets(line, sizeof(line), file)) {
+        uint8_t key[8];
+        bool valid = true;
+
+        if(line[0] == '#') continue;
+        for(size_t i = 0; i < sizeof(key) && valid; i++) {
+            int hi = hex_to_nibble(line[i * 2]);
+            int lo = hi < 0 ? -1 : hex_to_nibble(line[i * 2 + 1]);
+            valid = lo >= 0;
+            key[i] = (hi << 4) | lo;
+        }
+        if(!valid) continue;
+
+        if(count == size) {
+            size = size ? size * 2 : 256;
+            *keys = realloc(*keys, size * sizeof(key));
+        }
+        memcpy(*keys + count * sizeof(key), key, sizeof(key));
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+static void random_bytes(uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) data[i] = rand();
+}
+
+// Same loop as the NR-MAC attack worker: cracked captures are dropped, and when matches fill
+// up, the rest of the batch is checked again from the last matching key
+static size_t check_batched(
+    const LoclassNrMac* nr_macs,
+    size_t nr_mac_count,
+    const uint8_t* keys,
+    size_t key_count,
+    bool elite,
+    size_t* found_key) {
+    LoclassNrMac* active = malloc(nr_mac_count * sizeof(LoclassNrMac));
+    size_t* active_index = malloc(nr_mac_count * sizeof(size_t));
+    LoclassNrMacMatch matches[MAX_MATCHES];
+    size_t active_count = nr_mac_count;
+    size_t found_count = 0;
+
+    for(size_t n = 0; n < nr_mac_count; n++) {
+        active[n] = nr_macs[n];
+        active_index[n] = n;
+        found_key[n] = NOT_FOUND;
+    }
+
+    for(size_t k = 0; k < key_count && active_count; k += KEY_BATCH_SIZE) {
+        size_t count = key_count - k < KEY_BATCH_SIZE ? key_count - k : KEY_BATCH_SIZE;
+        size_t key_offset = 0;
+        while(active_count) {
+            size_t found = loclass_nr_mac_check_keys(
+                active,
+                active_count,
+                keys + (k + key_offset) * 8,
+                count - key_offset,
+                elite,
+                matches,
+                MAX_MATCHES);
+            for(size_t i = 0; i < found; i++) {
+                size_t n = active_index[matches[i].nr_mac];
+                if(found_key[n] != NOT_FOUND) continue;
+                found_key[n] = k + key_offset + matches[i].key;
+                found_count++;
+            }
+
+            size_t left = 0;
+            for(size_t i = 0; i < active_count; i++) {
+                if(found_key[active_index[i]] != NOT_FOUND) continue;
+                active[left] = active[i];
+                active_index[left] = active_index[i];
+                left++;
+            }
+            active_count = left;
+
+            if(found < MAX_MATCHES) break;
+            key_offset += matches[found - 1].key;
+        }
+    }
+
+    free(active_index);
+    free(active);
+    return found_count;
+}
+
+// First shared_count captures are made with the last dictionary key, so both passes scan the
+// whole dictionary, the rest are made with random keys and must not match
+static bool run_case(
+    const uint8_t* keys,
+    size_t key_count,
+    size_t nr_mac_count,
+    size_t shared_count,
+    bool elite) {
+    LoclassNrMac* nr_macs = calloc(nr_mac_count, sizeof(LoclassNrMac));
+    for(size_t n = 0; n < nr_mac_count; n++) {
+        uint8_t csn[8], cc[8], nr_mac[8], key[8], div_key[8], cc_nr[12];
+        random_bytes(csn, sizeof(csn));
+        random_bytes(cc, sizeof(cc));
+        random_bytes(nr_mac, 4);
+        if(n < shared_count) {
+            memcpy(key, keys + (key_count - 1) * 8, sizeof(key));
+        } else {
+            random_bytes(key, sizeof(key));
+        }
+        memcpy(cc_nr, cc, 8);
+        memcpy(cc_nr + 8, nr_mac, 4);
+        loclass_iclass_calc_div_key(csn, key, div_key, elite);
+        loclass_opt_doReaderMAC(cc_nr, div_key, nr_mac + 4);
+        loclass_nr_mac_init(&nr_macs[n], csn, cc, nr_mac);
+    }
+
+    // Reference: one key at a time, the same calls the poller makes
+    size_t reference_found = 0;
+    double start = get_time();
+    for(size_t k = 0; k < key_count; k++) {
+        for(size_t n = 0; n < nr_mac_count; n++) {
+            uint8_t div_key[8], mac[4];
+            loclass_iclass_calc_div_key(nr_macs[n].csn, keys + k * 8, div_key, elite);
+            loclass_opt_doReaderMAC(nr_macs[n].cc_nr, div_key, mac);
+            if(memcmp(mac, nr_macs[n].mac, sizeof(mac)) == 0) reference_found++;
+        }
+    }
+    double reference = get_time() - start;
+
+    size_t* found_key = malloc(nr_mac_count * sizeof(size_t));
+    start = get_time();
+    size_t batched_found =
+        check_batched(nr_macs, nr_mac_count, keys, key_count, elite, found_key);
+    double batched = get_time() - start;
+
+    bool shared_found = true;
+    for(size_t n = 0; n < shared_count; n++) {
+        if(found_key[n] != key_count - 1) shared_found = false;
+    }
+
+    double checks = (double)key_count * nr_mac_count;
+    printf(
+        "%zu %s keys x %zu captures, %zu with the last key\n",
+        key_count,
+        elite ? "elite" : "standard",
+        nr_mac_count,
+        shared_count);
+    printf("reference: %10.0f keys/s, %zu match\n", checks / reference, reference_found);
+    printf("batched:   %10.0f keys/s, %zu match\n", checks / batched, batched_found);
+
+    free(found_key);
+    free(nr_macs);
+
+    return shared_found && reference_found == batched_found;
+}
+
+int main(int argc, char** argv) {
+    const char* dict_path = DEFAULT_DICT_PATH;
+    size_t nr_mac_count = DEFAULT_NR_MAC_COUNT;
+    bool elite = true;
+    int opt;
+
+    while((opt = getopt(argc, argv, "d:n:sh")) != -1) {
+        if(opt == 'd') {
+            dict_path = optarg;
+        } else if(opt == 'n') {
+            nr_mac_count = strtoul(optarg, NULL, 0);
+        } else if(opt == 's') {
+            elite = false;
+        } else {
+            printf("Usage: %s [-d dict.txt] [-n captures] [-s]\n", argv[0]);
+            printf("  -s  standard key diversification instead of elite\n");
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    uint8_t* keys;
+    size_t key_count = load_dict(dict_path, &keys);
+    if(key_count == 0 || nr_mac_count == 0) {
+        fprintf(stderr, "No keys loaded from %s\n", dict_path);
+        return 1;
+    }
+
+    srand(1);
+    bool ok = run_case(keys, key_count, nr_mac_count, 1, elite);
+    // More captures crack on one key than matches can hold, none may be lost
+    ok &= run_case(keys, key_count, SAME_BATCH_NR_MAC_COUNT, SAME_BATCH_NR_MAC_COUNT, elite);
+
+    free(keys);
+
+    if(!ok) {
+        fprintf(stderr, "Batched kernel results don't match the reference\n");
+        return 1;
+    }
+
+    return 0;
+}
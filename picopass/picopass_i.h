@@ -24,6 +24,7 @@
 #include "scenes/picopass_scene.h"
 #include "views/dict_attack.h"
 #include "views/loclass.h"
+#include "helpers/iclass_nr_mac_attack.h"
 
 #include <storage/storage.h>
 #include <lib/toolbox/path.h>
@@ -55,6 +56,8 @@ enum PicopassCustomEvent {
     PicopassCustomEventLoclassGotMac,
     PicopassCustomEventLoclassGotStandardKey,
     PicopassCustomEventNrMacSaved,
+    PicopassCustomEventNrMacAttackUpdate,
+    PicopassCustomEventNrMacAttackDone,
 
     PicopassCustomEventPollerSuccess,
     PicopassCustomEventPollerFail,
@@ -108,6 +111,7 @@ struct Picopass {
     Widget* widget;
     DictAttack* dict_attack;
     Loclass* loclass;
+    IclassNrMacAttack* nr_mac_attack;
 
     PicopassDictAttackContext dict_attack_ctx;
     PicopassWriteKeyContext write_key_context;
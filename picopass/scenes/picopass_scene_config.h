@@ -20,4 +20,5 @@ ADD_SCENE(picopass, emulate, Emulate)
 ADD_SCENE(picopass, loclass, Loclass)
 ADD_SCENE(picopass, key_input, KeyInput)
 ADD_SCENE(picopass, nr_mac_saved, NrMacSaved)
+ADD_SCENE(picopass, nr_mac_attack, NrMacAttack)
 ADD_SCENE(picopass, more_info, MoreInfo)
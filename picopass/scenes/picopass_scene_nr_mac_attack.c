@@ -0,0 +1,106 @@
+#include "../picopass_i.h"
+#include <dolphin/dolphin.h>
+
+static void picopass_scene_nr_mac_attack_callback(IclassNrMacAttackEvent event, void* context) {
+    Picopass* picopass = context;
+
+    if(event == IclassNrMacAttackEventDone) {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventNrMacAttackDone);
+    } else {
+        view_dispatcher_send_custom_event(
+            picopass->view_dispatcher, PicopassCustomEventNrMacAttackUpdate);
+    }
+}
+
+static void picopass_scene_nr_mac_attack_update_progress(Picopass* picopass) {
+    IclassNrMacAttack* attack = picopass->nr_mac_attack;
+
+    picopass_text_store_set(
+        picopass,
+        "%s\nKeys: %lu/%lu\nFound: %zu/%zu",
+        iclass_nr_mac_attack_get_dict_name(attack),
+        iclass_nr_mac_attack_get_current_key(attack),
+        iclass_nr_mac_attack_get_total_keys(attack),
+        iclass_nr_mac_attack_get_found_count(attack),
+        iclass_nr_mac_attack_get_capture_count(attack));
+    popup_set_text(picopass->popup, picopass->text_store, 64, 36, AlignCenter, AlignCenter);
+}
+
+static void picopass_scene_nr_mac_attack_show_results(Picopass* picopass) {
+    IclassNrMacAttack* attack = picopass->nr_mac_attack;
+    FuriString* str = picopass->text_box_store;
+
+    furi_string_reset(str);
+    for(size_t i = 0; i < iclass_nr_mac_attack_get_capture_count(attack); i++) {
+        const IclassNrMacAttackResult* result = iclass_nr_mac_attack_get_result(attack, i);
+        furi_string_cat_str(str, "CSN: ");
+        for(size_t j = 0; j < sizeof(result->csn); j++) {
+            furi_string_cat_printf(str, "%02X", result->csn[j]);
+        }
+        furi_string_cat_str(str, "\n");
+        if(result->found) {
+            furi_string_cat_printf(str, "%s key: ", result->elite ? "Elite" : "Std");
+            for(size_t j = 0; j < sizeof(result->key); j++) {
+                furi_string_cat_printf(str, "%02X", result->key[j]);
+            }
+            furi_string_cat_str(str, "\n");
+        } else {
+            furi_string_cat_str(str, "Key not found\n");
+        }
+    }
+
+    text_box_set_font(picopass->text_box, TextBoxFontText);
+    text_box_set_text(picopass->text_box, furi_string_get_cstr(str));
+    view_dispatcher_switch_to_view(picopass->view_dispatcher, PicopassViewTextBox);
+}
+
+void picopass_scene_nr_mac_attack_on_enter(void* context) {
+    Picopass* picopass = context;
+
+    picopass->nr_mac_attack =
+        iclass_nr_mac_attack_alloc(picopass_scene_nr_mac_attack_callback, picopass);
+
+    Popup* popup = picopass->popup;
+    if(iclass_nr_mac_attack_load(picopass->nr_mac_attack)) {
+        popup_set_header(popup, "NR-MAC Attack", 64, 2, AlignCenter, AlignTop);
+        picopass_scene_nr_mac_attack_update_progress(picopass);
+        iclass_nr_mac_attack_start(picopass->nr_mac_attack);
+    } else {
+        popup_set_header(popup, "No NR-MAC\nsaved", 64, 24, AlignCenter, AlignCenter);
+        popup_set_text(
+            popup, "Emulate a partial\ncard to collect", 64, 48, AlignCenter, AlignCenter);
+    }
+    view_dispatcher_switch_to_view(picopass->view_dispatcher, PicopassViewPopup);
+}
+
+bool picopass_scene_nr_mac_attack_on_event(void* context, SceneManagerEvent event) {
+    Picopass* picopass = context;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == PicopassCustomEventNrMacAttackUpdate) {
+            picopass_scene_nr_mac_attack_update_progress(picopass);
+            consumed = true;
+        } else if(event.event == PicopassCustomEventNrMacAttackDone) {
+            if(iclass_nr_mac_attack_get_found_count(picopass->nr_mac_attack)) {
+                dolphin_deed(DolphinDeedNfcReadSuccess);
+            }
+            picopass_scene_nr_mac_attack_show_results(picopass);
+            consumed = true;
+        }
+    }
+    return consumed;
+}
+
+void picopass_scene_nr_mac_attack_on_exit(void* context) {
+    Picopass* picopass = context;
+
+    iclass_nr_mac_attack_free(picopass->nr_mac_attack);
+    picopass->nr_mac_attack = NULL;
+
+    // Clear views
+    popup_reset(picopass->popup);
+    text_box_reset(picopass->text_box);
+    furi_string_reset(picopass->text_box_store);
+}
@@ -3,6 +3,7 @@ enum SubmenuIndex {
     SubmenuIndexRead,
     SubmenuIndexSaved,
     SubmenuIndexLoclass,
+    SubmenuIndexNrMacAttack,
 };
 
 void picopass_scene_start_submenu_callback(void* context, uint32_t index) {
@@ -20,6 +21,12 @@ void picopass_scene_start_on_enter(void* context) {
 
     submenu_add_item(
         submenu, "Loclass", SubmenuIndexLoclass, picopass_scene_start_submenu_callback, picopass);
+    submenu_add_item(
+        submenu,
+        "NR-MAC Attack",
+        SubmenuIndexNrMacAttack,
+        picopass_scene_start_submenu_callback,
+        picopass);
 
     submenu_set_selected_item(
         submenu, scene_manager_get_scene_state(picopass->scene_manager, PicopassSceneStart));
@@ -49,6 +56,11 @@ bool picopass_scene_start_on_event(void* context, SceneManagerEvent event) {
                 picopass->scene_manager, PicopassSceneStart, PicopassSceneLoclass);
             scene_manager_next_scene(picopass->scene_manager, PicopassSceneLoclass);
             consumed = true;
+        } else if(event.event == SubmenuIndexNrMacAttack) {
+            scene_manager_set_scene_state(
+                picopass->scene_manager, PicopassSceneStart, SubmenuIndexNrMacAttack);
+            scene_manager_next_scene(picopass->scene_manager, PicopassSceneNrMacAttack);
+            consumed = true;
         }
     }
 
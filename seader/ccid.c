@@ -137,12 +137,6 @@ size_t seader_ccid_process(Seader* seader, uint8_t* cmd, size_t cmd_len) {
     CCID_Message message;
     message.consumed = 0;
 
-    char display[SEADER_UART_RX_BUF_SIZE * 2 + 1] = {0};
-    for(uint8_t i = 0; i < cmd_len; i++) {
-        snprintf(display + (i * 2), sizeof(display), "%02x", cmd[i]);
-    }
-    // FURI_LOG_D(TAG, "UART %d: %s", cmd_len, display);
-
     if(cmd_len == 2) {
         if(cmd[0] == CCID_MESSAGE_TYPE_RDR_to_PC_NotifySlotChange) {
             switch(cmd[1] & SLOT_0_MASK) {
@@ -220,11 +214,6 @@ size_t seader_ccid_process(Seader* seader, uint8_t* cmd, size_t cmd_len) {
         message.bError = ccid[8];
         message.payload = ccid + 10;
 
-        memset(display, 0, sizeof(display));
-        for(uint8_t i = 0; i < message.dwLength; i++) {
-            snprintf(display + (i * 2), sizeof(display), "%02x", message.payload[i]);
-        }
-
         if(cmd_len < 2 + 10 + message.dwLength + 1) {
             return message.consumed;
         }
@@ -9,10 +9,6 @@
 #include "seader_bridge.h"
 #include "seader_worker_i.h"
 
-#define SYNC (0x03)
-#define CTRL (0x06)
-#define NAK (0x15)
-
 #define BMICCSTATUS_MASK 0x03
 /*
  * Bit 0 = Slot 0 current state
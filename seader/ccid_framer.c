@@ -0,0 +1,92 @@
+#include "ccid_framer.h"
+
+#include <string.h>
+
+// CCID_MESSAGE_TYPE_RDR_to_PC_NotifySlotChange, sent bare without SYNC
+#define CCID_FRAMER_NOTIFY_SLOT_CHANGE (0x50)
+#define CCID_FRAMER_NOTIFY_SLOT_CHANGE_LEN (2)
+#define CCID_FRAMER_NAK_LEN (3)
+// SYNC + CTRL + bMessageType + dwLength
+#define CCID_FRAMER_LENGTH_END (7)
+
+_Static_assert(
+    (CCID_FRAMER_SIZE & (CCID_FRAMER_SIZE - 1)) == 0,
+    "CCID_FRAMER_SIZE must be a power of two");
+
+void ccid_framer_reset(CcidFramer* framer) {
+    framer->head = 0;
+    framer->tail = 0;
+    framer->dropped = 0;
+    framer->naks = 0;
+}
+
+uint8_t* ccid_framer_write_ptr(CcidFramer* framer, size_t* len) {
+    size_t offset = framer->head & (CCID_FRAMER_SIZE - 1);
+    size_t space = CCID_FRAMER_SIZE - (framer->head - framer->tail);
+    size_t to_end = CCID_FRAMER_SIZE - offset;
+
+    *len = space < to_end ? space : to_end;
+    return framer->buf + offset;
+}
+
+void ccid_framer_commit(CcidFramer* framer, size_t len) {
+    size_t offset = framer->head & (CCID_FRAMER_SIZE - 1);
+
+    memcpy(framer->buf + CCID_FRAMER_SIZE + offset, framer->buf + offset, len);
+    framer->head += len;
+}
+
+size_t ccid_framer_push(CcidFramer* framer, const uint8_t* data, size_t len) {
+    size_t pushed = 0;
+
+    while(pushed < len) {
+        size_t space;
+        uint8_t* dst = ccid_framer_write_ptr(framer, &space);
+        if(space == 0) break;
+        if(space > len - pushed) space = len - pushed;
+
+        memcpy(dst, data + pushed, space);
+        ccid_framer_commit(framer, space);
+        pushed += space;
+    }
+
+    return pushed;
+}
+
+size_t ccid_framer_next(CcidFramer* framer, uint8_t** frame) {
+    while(1) {
+        size_t available = framer->head - framer->tail;
+        uint8_t* data = framer->buf + (framer->tail & (CCID_FRAMER_SIZE - 1));
+        size_t len = 0;
+
+        if(available < 2) return 0;
+
+        if(data[0] == SYNC && data[1] == NAK) {
+            if(available < CCID_FRAMER_NAK_LEN) return 0;
+            framer->naks++;
+            framer->tail += CCID_FRAMER_NAK_LEN;
+            continue;
+        } else if(data[0] == SYNC && data[1] == CTRL) {
+            if(available < CCID_FRAMER_LENGTH_END) return 0;
+            uint32_t dwLength = data[3] | (data[4] << 8) | (data[5] << 16) |
+                                ((uint32_t)data[6] << 24);
+            if(dwLength <= CCID_FRAMER_SIZE - CCID_FRAMER_OVERHEAD) {
+                len = CCID_FRAMER_OVERHEAD + dwLength;
+            }
+        } else if(data[0] == CCID_FRAMER_NOTIFY_SLOT_CHANGE) {
+            len = CCID_FRAMER_NOTIFY_SLOT_CHANGE_LEN;
+        }
+
+        if(len == 0) {
+            // Not the start of a frame, resync on the next byte
+            framer->dropped++;
+            framer->tail++;
+            continue;
+        }
+        if(available < len) return 0;
+
+        *frame = data;
+        framer->tail += len;
+        return len;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SYNC (0x03)
+#define CTRL (0x06)
+#define NAK (0x15)
+
+// Power of two, largest frame the framer accepts
+#define CCID_FRAMER_SIZE (512)
+// SYNC + CTRL + CCID header + LRC
+#define CCID_FRAMER_OVERHEAD (2 + 10 + 1)
+
+/*
+ * Ring buffer that splits the SAM UART stream into CCID frames in place.
+ *
+ * Every byte is stored twice, at its ring offset and CCID_FRAMER_SIZE past it, so any frame is
+ * contiguous in memory no matter where it wraps. Frames are handed out as pointers into the
+ * ring and nothing is moved once received.
+ */
+typedef struct {
+    uint8_t buf[CCID_FRAMER_SIZE * 2];
+    size_t head;
+    size_t tail;
+    uint32_t dropped;
+    uint32_t naks;
+} CcidFramer;
+
+void ccid_framer_reset(CcidFramer* framer);
+
+/** Contiguous free space to receive into, commit with ccid_framer_commit */
+uint8_t* ccid_framer_write_ptr(CcidFramer* framer, size_t* len);
+
+void ccid_framer_commit(CcidFramer* framer, size_t len);
+
+/** Copy data into the ring, returns number of bytes that fit */
+size_t ccid_framer_push(CcidFramer* framer, const uint8_t* data, size_t len);
+
+/** Next complete frame (NotifySlotChange or SYNC CTRL message), 0 if more data is needed.
+ * NAKs and bytes that don't start a frame are skipped. The frame stays valid until the next
+ * write into the ring.
+ */
+size_t ccid_framer_next(CcidFramer* framer, uint8_t** frame);
@@ -24,10 +24,16 @@ extern "C" {
 #define	ASN1C_ENVIRONMENT_VERSION	923	/* Compile-time version */
 int get_asn1c_environment_version(void);	/* Run-time version */
 
-#define	CALLOC(nmemb, size)	calloc(nmemb, size)
-#define	MALLOC(size)		malloc(size)
-#define	REALLOC(oldptr, size)	realloc(oldptr, size)
-#define	FREEMEM(ptr)		free(ptr)
+/* Seader: structures live in the per-transaction arena, see seader_arena.h */
+void *seader_arena_malloc(size_t size);
+void *seader_arena_calloc(size_t nmemb, size_t size);
+void *seader_arena_realloc(void *ptr, size_t size);
+void seader_arena_free(void *ptr);
+
+#define	CALLOC(nmemb, size)	seader_arena_calloc(nmemb, size)
+#define	MALLOC(size)		seader_arena_malloc(size)
+#define	REALLOC(oldptr, size)	seader_arena_realloc(oldptr, size)
+#define	FREEMEM(ptr)		seader_arena_free(ptr)
 
 #define	asn_debug_indent	0
 #define ASN_DEBUG_INDENT_ADD(i) do{}while(0)
@@ -0,0 +1,204 @@
+// Host tests of the CCID framer: whole, fragmented, concatenated and corrupted SAM UART streams
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ccid_framer.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+// 0306 81 00000000 0000 0200 01 87, SlotStatus with no ICC present
+static const uint8_t slot_status[] =
+    {0x03, 0x06, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x87};
+static const uint8_t notify[] = {0x50, 0x03};
+static const uint8_t nak[] = {SYNC, NAK, 0x16};
+
+static size_t build_data_block(uint8_t* out, size_t payload_len, uint8_t seed) {
+    size_t len = 0;
+    out[len++] = SYNC;
+    out[len++] = CTRL;
+    out[len++] = 0x80;
+    out[len++] = payload_len & 0xff;
+    out[len++] = (payload_len >> 8) & 0xff;
+    out[len++] = 0;
+    out[len++] = 0;
+    out[len++] = 0; // slot
+    out[len++] = seed; // seq
+    out[len++] = 0;
+    out[len++] = 0;
+    out[len++] = 0;
+    for(size_t i = 0; i < payload_len; i++) {
+        out[len++] = (uint8_t)(seed + i * 7);
+    }
+    uint8_t lrc = 0;
+    for(size_t i = 0; i < len; i++) {
+        lrc ^= out[i];
+    }
+    out[len++] = lrc;
+    return len;
+}
+
+static size_t expect_frame(CcidFramer* framer, const uint8_t* expected, size_t expected_len) {
+    uint8_t* frame = NULL;
+    size_t len = ccid_framer_next(framer, &frame);
+    CHECK(len == expected_len);
+    if(len == expected_len) {
+        CHECK(memcmp(frame, expected, len) == 0);
+    }
+    return len;
+}
+
+static void expect_empty(CcidFramer* framer) {
+    uint8_t* frame = NULL;
+    CHECK(ccid_framer_next(framer, &frame) == 0);
+}
+
+static void test_single_frame(void) {
+    CcidFramer framer;
+    ccid_framer_reset(&framer);
+
+    CHECK(ccid_framer_push(&framer, slot_status, sizeof(slot_status)) == sizeof(slot_status));
+    expect_frame(&framer, slot_status, sizeof(slot_status));
+    expect_empty(&framer);
+    CHECK(framer.dropped == 0);
+}
+
+static void test_fragmented(void) {
+    CcidFramer framer;
+    uint8_t block[CCID_FRAMER_SIZE];
+    size_t block_len = build_data_block(block, 200, 0x11);
+    ccid_framer_reset(&framer);
+
+    // One byte at a time, nothing until the LRC arrives
+    for(size_t i = 0; i < block_len - 1; i++) {
+        ccid_framer_push(&framer, block + i, 1);
+        expect_empty(&framer);
+    }
+    ccid_framer_push(&framer, block + block_len - 1, 1);
+    expect_frame(&framer, block, block_len);
+    expect_empty(&framer);
+
+    // Split inside the length field
+    ccid_framer_push(&framer, block, 5);
+    expect_empty(&framer);
+    ccid_framer_push(&framer, block + 5, block_len - 5);
+    expect_frame(&framer, block, block_len);
+    expect_empty(&framer);
+}
+
+static void test_concatenated(void) {
+    CcidFramer framer;
+    uint8_t stream[CCID_FRAMER_SIZE];
+    uint8_t block[64];
+    size_t block_len = build_data_block(block, 20, 0x22);
+    size_t len = 0;
+    ccid_framer_reset(&framer);
+
+    memcpy(stream + len, notify, sizeof(notify));
+    len += sizeof(notify);
+    memcpy(stream + len, slot_status, sizeof(slot_status));
+    len += sizeof(slot_status);
+    memcpy(stream + len, nak, sizeof(nak));
+    len += sizeof(nak);
+    memcpy(stream + len, block, block_len);
+    len += block_len;
+    // Trailing partial frame
+    memcpy(stream + len, slot_status, 4);
+    len += 4;
+
+    ccid_framer_push(&framer, stream, len);
+    expect_frame(&framer, notify, sizeof(notify));
+    expect_frame(&framer, slot_status, sizeof(slot_status));
+    expect_frame(&framer, block, block_len);
+    expect_empty(&framer);
+    CHECK(framer.naks == 1);
+
+    ccid_framer_push(&framer, slot_status + 4, sizeof(slot_status) - 4);
+    expect_frame(&framer, slot_status, sizeof(slot_status));
+    expect_empty(&framer);
+    CHECK(framer.dropped == 0);
+}
+
+static void test_resync(void) {
+    CcidFramer framer;
+    const uint8_t garbage[] = {0x00, 0xff, 0x06, 0x03};
+    // SYNC CTRL with a length that can never fit
+    const uint8_t oversized[] = {SYNC, CTRL, 0x80, 0x00, 0x10, 0x00, 0x00};
+    ccid_framer_reset(&framer);
+
+    ccid_framer_push(&framer, garbage, sizeof(garbage));
+    ccid_framer_push(&framer, slot_status, sizeof(slot_status));
+    expect_frame(&framer, slot_status, sizeof(slot_status));
+    CHECK(framer.dropped == sizeof(garbage));
+
+    ccid_framer_push(&framer, oversized, sizeof(oversized));
+    ccid_framer_push(&framer, slot_status, sizeof(slot_status));
+    expect_frame(&framer, slot_status, sizeof(slot_status));
+    expect_empty(&framer);
+    CHECK(framer.dropped == sizeof(garbage) + sizeof(oversized));
+}
+
+static void test_wraparound(void) {
+    CcidFramer framer;
+    uint8_t block[CCID_FRAMER_SIZE];
+    ccid_framer_reset(&framer);
+
+    // Frame sizes that don't divide the ring, so frames straddle the end of it
+    for(size_t round = 0; round < 200; round++) {
+        size_t payload_len = (round * 37) % 300;
+        size_t block_len = build_data_block(block, payload_len, (uint8_t)round);
+        size_t split = (round * 13) % block_len;
+
+        ccid_framer_push(&framer, block, split);
+        if(split < block_len) {
+            uint8_t* frame;
+            CHECK(ccid_framer_next(&framer, &frame) == 0);
+        }
+        ccid_framer_push(&framer, block + split, block_len - split);
+        expect_frame(&framer, block, block_len);
+        expect_empty(&framer);
+    }
+    CHECK(framer.dropped == 0);
+}
+
+static void test_full_ring(void) {
+    CcidFramer framer;
+    uint8_t block[CCID_FRAMER_SIZE];
+    size_t block_len =
+        build_data_block(block, CCID_FRAMER_SIZE - CCID_FRAMER_OVERHEAD, 0x33);
+    ccid_framer_reset(&framer);
+
+    // Misalign the ring first
+    ccid_framer_push(&framer, slot_status, sizeof(slot_status));
+    expect_frame(&framer, slot_status, sizeof(slot_status));
+
+    CHECK(block_len == CCID_FRAMER_SIZE);
+    CHECK(ccid_framer_push(&framer, block, block_len) == block_len);
+    CHECK(ccid_framer_push(&framer, notify, sizeof(notify)) == 0);
+    expect_frame(&framer, block, block_len);
+    expect_empty(&framer);
+}
+
+int main(void) {
+    test_single_frame();
+    test_fragmented();
+    test_concatenated();
+    test_resync();
+    test_wraparound();
+    test_full_ring();
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
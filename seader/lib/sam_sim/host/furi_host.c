@@ -0,0 +1,468 @@
+#include "furi_host.h"
+
+#include <malloc.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include <asn_application.h>
+#include <der_encoder.h>
+
+bool host_verbose = false;
+HostMetrics host_metrics;
+bool host_metrics_paused = false;
+size_t host_heap_bytes = 0;
+size_t host_heap_peak = 0;
+
+static uint32_t host_custom_event = 0;
+static uint8_t host_flipper_format;
+
+uint64_t host_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void host_log(char level, const char* tag, const char* format, ...) {
+    if(!host_verbose) return;
+
+    va_list args;
+    va_start(args, format);
+    printf("[%c][%s] ", level, tag);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+/* Allocation and codec accounting, linked with -Wl,--wrap=<symbol> */
+
+void* __real_malloc(size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+asn_enc_rval_t __real_der_encode_to_buffer(
+    const asn_TYPE_descriptor_t* type_descriptor,
+    const void* struct_ptr,
+    void* buffer,
+    size_t buffer_size);
+asn_dec_rval_t __real_asn_decode(
+    const asn_codec_ctx_t* opt_codec_parameters,
+    enum asn_transfer_syntax syntax,
+    const asn_TYPE_descriptor_t* type_to_decode,
+    void** structure_ptr,
+    const void* buffer,
+    size_t size);
+
+// Heap in use is tracked for everything, paused or not, it's what the allocator sees
+static void host_heap_account(void* ptr, bool alloc) {
+    if(!ptr) return;
+    size_t size = malloc_usable_size(ptr);
+    if(alloc) {
+        host_heap_bytes += size;
+        if(host_heap_bytes > host_heap_peak) host_heap_peak = host_heap_bytes;
+    } else {
+        host_heap_bytes -= size;
+    }
+}
+
+void* __wrap_malloc(size_t size) {
+    // The firmware allocator hands out zeroed memory, sam_api.c's calloc() relies on it
+    void* ptr = __real_malloc(size);
+    if(ptr) memset(ptr, 0, size);
+    host_heap_account(ptr, true);
+    if(!host_metrics_paused) {
+        host_metrics.allocs++;
+        host_metrics.alloc_bytes += size;
+    }
+    return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    if(!host_metrics_paused) {
+        host_metrics.allocs += ptr ? 0 : 1;
+        host_metrics.alloc_bytes += size;
+    }
+    host_heap_account(ptr, false);
+    ptr = __real_realloc(ptr, size);
+    host_heap_account(ptr, true);
+    return ptr;
+}
+
+void __wrap_free(void* ptr) {
+    if(ptr && !host_metrics_paused) host_metrics.frees++;
+    host_heap_account(ptr, false);
+    __real_free(ptr);
+}
+
+asn_enc_rval_t __wrap_der_encode_to_buffer(
+    const asn_TYPE_descriptor_t* type_descriptor,
+    const void* struct_ptr,
+    void* buffer,
+    size_t buffer_size) {
+    uint64_t start = host_time_ns();
+    asn_enc_rval_t rval =
+        __real_der_encode_to_buffer(type_descriptor, struct_ptr, buffer, buffer_size);
+    if(!host_metrics_paused) {
+        host_metrics.encodes++;
+        host_metrics.encode_ns += host_time_ns() - start;
+    }
+    return rval;
+}
+
+asn_dec_rval_t __wrap_asn_decode(
+    const asn_codec_ctx_t* opt_codec_parameters,
+    enum asn_transfer_syntax syntax,
+    const asn_TYPE_descriptor_t* type_to_decode,
+    void** structure_ptr,
+    const void* buffer,
+    size_t size) {
+    uint64_t start = host_time_ns();
+    asn_dec_rval_t rval = __real_asn_decode(
+        opt_codec_parameters, syntax, type_to_decode, structure_ptr, buffer, size);
+    if(!host_metrics_paused) {
+        host_metrics.decodes++;
+        host_metrics.decode_ns += host_time_ns() - start;
+    }
+    return rval;
+}
+
+/* Threads, nothing runs concurrently: the harness pumps the app and the SAM in turn */
+
+struct FuriThread {
+    HostThreadFlagsCallback flags_callback;
+    void* flags_context;
+};
+
+void furi_delay_ms(uint32_t milliseconds) {
+    UNUSED(milliseconds);
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    UNUSED(name);
+    UNUSED(stack_size);
+    UNUSED(callback);
+    UNUSED(context);
+    return calloc(1, sizeof(FuriThread));
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    UNUSED(thread);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    UNUSED(thread);
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    if(thread_id && thread_id->flags_callback) {
+        thread_id->flags_callback(flags, thread_id->flags_context);
+    }
+    return flags;
+}
+
+void furi_thread_set_current_priority(FuriThreadPriority priority) {
+    UNUSED(priority);
+}
+
+void host_thread_set_flags_callback(
+    FuriThread* thread,
+    HostThreadFlagsCallback callback,
+    void* context) {
+    thread->flags_callback = callback;
+    thread->flags_context = context;
+}
+
+struct FuriMutex {
+    bool locked;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    UNUSED(type);
+    return calloc(1, sizeof(FuriMutex));
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    UNUSED(timeout);
+    if(mutex->locked) return FuriStatusError;
+    mutex->locked = true;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    mutex->locked = false;
+    return FuriStatusOk;
+}
+
+struct FuriMessageQueue {
+    uint8_t* buf;
+    uint32_t msg_count;
+    uint32_t msg_size;
+    uint32_t head;
+    uint32_t count;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* instance = calloc(1, sizeof(FuriMessageQueue));
+    instance->buf = calloc(msg_count, msg_size);
+    instance->msg_count = msg_count;
+    instance->msg_size = msg_size;
+    return instance;
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    free(instance->buf);
+    free(instance);
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg, uint32_t timeout) {
+    UNUSED(timeout);
+    if(instance->count == instance->msg_count) return FuriStatusError;
+    uint32_t index = (instance->head + instance->count) % instance->msg_count;
+    memcpy(instance->buf + index * instance->msg_size, msg, instance->msg_size);
+    instance->count++;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg, uint32_t timeout) {
+    UNUSED(timeout);
+    if(instance->count == 0) return FuriStatusError;
+    memcpy(msg, instance->buf + instance->head * instance->msg_size, instance->msg_size);
+    instance->head = (instance->head + 1) % instance->msg_count;
+    instance->count--;
+    return FuriStatusOk;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance) {
+    return instance->count;
+}
+
+uint32_t furi_message_queue_get_space(FuriMessageQueue* instance) {
+    return instance->msg_count - instance->count;
+}
+
+/* Strings */
+
+struct FuriString {
+    char buf[256];
+};
+
+FuriString* furi_string_alloc(void) {
+    return calloc(1, sizeof(FuriString));
+}
+
+void furi_string_free(FuriString* string) {
+    free(string);
+}
+
+bool furi_string_empty(const FuriString* string) {
+    return string->buf[0] == '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->buf;
+}
+
+int furi_string_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int ret = vsnprintf(string->buf, sizeof(string->buf), format, args);
+    va_end(args);
+    return ret;
+}
+
+int furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    size_t len = strlen(string->buf);
+    va_list args;
+    va_start(args, format);
+    int ret = vsnprintf(string->buf + len, sizeof(string->buf) - len, format, args);
+    va_end(args);
+    return ret;
+}
+
+/* Records, storage and GUI: accepted and dropped */
+
+void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event) {
+    UNUSED(view_dispatcher);
+    host_custom_event = event;
+}
+
+uint32_t host_take_custom_event(void) {
+    uint32_t event = host_custom_event;
+    host_custom_event = 0;
+    return event;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    UNUSED(path);
+    return true;
+}
+
+void dialog_message_show_storage_error(DialogsApp* context, const char* error_text) {
+    UNUSED(context);
+    FURI_LOG_E("Dialog", "%s", error_text);
+}
+
+void path_extract_dirname(const char* path, FuriString* dirname) {
+    const char* end = strrchr(path, '/');
+    size_t len = end ? (size_t)(end - path) : 0;
+    furi_string_printf(dirname, "%.*s", (int)len, path);
+}
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return (FlipperFormat*)&host_flipper_format;
+}
+
+void flipper_format_free(FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+}
+
+bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path) {
+    UNUSED(flipper_format);
+    FURI_LOG_D("FlipperFormat", "Write %s", path);
+    return true;
+}
+
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version) {
+    UNUSED(flipper_format);
+    UNUSED(filetype);
+    UNUSED(version);
+    return true;
+}
+
+bool flipper_format_write_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint8_t* data,
+    const uint16_t data_size) {
+    UNUSED(flipper_format);
+    UNUSED(key);
+    UNUSED(data);
+    UNUSED(data_size);
+    return true;
+}
+
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data) {
+    UNUSED(flipper_format);
+    UNUSED(key);
+    UNUSED(data);
+    return true;
+}
+
+/* NFC: only the virtual credential path is simulated, real pollers never run on a host */
+
+void nfc_device_set_data(NfcDevice* instance, NfcProtocol protocol, const void* protocol_data) {
+    UNUSED(instance);
+    UNUSED(protocol);
+    UNUSED(protocol_data);
+    abort();
+}
+
+const void* nfc_device_get_data(const NfcDevice* instance, NfcProtocol protocol) {
+    UNUSED(instance);
+    UNUSED(protocol);
+    abort();
+}
+
+const uint8_t* nfc_device_get_uid(const NfcDevice* instance, size_t* uid_len) {
+    UNUSED(instance);
+    UNUSED(uid_len);
+    abort();
+}
+
+const void* nfc_poller_get_data(const NfcPoller* instance) {
+    UNUSED(instance);
+    abort();
+}
+
+uint8_t iso14443_3a_get_sak(const Iso14443_3aData* data) {
+    return data->sak;
+}
+
+Iso14443_4aError iso14443_4a_poller_send_block(
+    Iso14443_4aPoller* instance,
+    const BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer) {
+    UNUSED(instance);
+    UNUSED(tx_buffer);
+    UNUSED(rx_buffer);
+    abort();
+}
+
+struct BitBuffer {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+};
+
+BitBuffer* bit_buffer_alloc(size_t capacity_bytes) {
+    BitBuffer* buf = malloc(sizeof(BitBuffer));
+    buf->data = malloc(capacity_bytes);
+    buf->size = 0;
+    buf->capacity = capacity_bytes;
+    return buf;
+}
+
+void bit_buffer_free(BitBuffer* buf) {
+    free(buf->data);
+    free(buf);
+}
+
+void bit_buffer_append_bytes(BitBuffer* buf, const uint8_t* data, size_t size_bytes) {
+    furi_check(buf->size + size_bytes <= buf->capacity);
+    memcpy(buf->data + buf->size, data, size_bytes);
+    buf->size += size_bytes;
+}
+
+const uint8_t* bit_buffer_get_data(const BitBuffer* buf) {
+    return buf->data;
+}
+
+size_t bit_buffer_get_size_bytes(const BitBuffer* buf) {
+    return buf->size;
+}
+
+void iso13239_crc_append(Iso13239CrcType type, BitBuffer* buf) {
+    uint16_t crc = type == Iso13239CrcTypePicopass ? 0xE012 : 0xFFFF;
+    for(size_t i = 0; i < buf->size; i++) {
+        crc ^= buf->data[i];
+        for(size_t j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+        }
+    }
+    if(type != Iso13239CrcTypePicopass) crc = ~crc;
+
+    uint8_t crc_bytes[2] = {crc & 0xff, crc >> 8};
+    bit_buffer_append_bytes(buf, crc_bytes, sizeof(crc_bytes));
+}
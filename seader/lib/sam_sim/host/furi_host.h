@@ -0,0 +1,259 @@
+#pragma once
+
+// Just enough of the firmware API for sam_api.c, ccid.c and seader_worker.c to build on a host.
+// Every firmware header they include is generated by the Makefile as a one-line include of this.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define furi_assert(x) assert(x)
+#define furi_check(x) assert(x)
+// Single threaded
+#define FURI_CRITICAL_ENTER() \
+    do {                      \
+    } while(0)
+#define FURI_CRITICAL_EXIT() \
+    do {                     \
+    } while(0)
+
+void host_log(char level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+#define FURI_LOG_E(tag, ...) host_log('E', tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) host_log('W', tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) host_log('I', tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) host_log('D', tag, __VA_ARGS__)
+#define FURI_LOG_T(tag, ...) host_log('T', tag, __VA_ARGS__)
+
+#define FuriWaitForever 0xFFFFFFFFU
+#define FuriFlagError 0x80000000U
+#define FuriFlagWaitAny 0x00000000U
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+} FuriStatus;
+
+typedef enum {
+    FuriThreadPriorityLowest = 1,
+    FuriThreadPriorityHighest = 31,
+} FuriThreadPriority;
+
+typedef enum {
+    FuriMutexTypeNormal,
+} FuriMutexType;
+
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriStreamBuffer FuriStreamBuffer;
+typedef struct FuriSemaphore FuriSemaphore;
+typedef struct FuriString FuriString;
+
+void furi_delay_ms(uint32_t milliseconds);
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+void furi_thread_set_current_priority(FuriThreadPriority priority);
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg, uint32_t timeout);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance);
+uint32_t furi_message_queue_get_space(FuriMessageQueue* instance);
+
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+bool furi_string_empty(const FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+int furi_string_printf(FuriString* string, const char* format, ...);
+int furi_string_cat_printf(FuriString* string, const char* format, ...);
+
+#define RECORD_STORAGE "storage"
+#define STORAGE_APP_DATA_PATH_PREFIX "/data"
+#define EXT_PATH(path) "/ext/" path
+#define ANY_PATH(path) "/any/" path
+
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+// Firmware types that only appear behind pointers
+typedef struct Storage Storage;
+typedef struct DialogsApp DialogsApp;
+typedef struct FlipperFormat FlipperFormat;
+typedef struct Gui Gui;
+typedef struct ViewDispatcher ViewDispatcher;
+typedef struct SceneManager SceneManager;
+typedef struct NotificationApp NotificationApp;
+typedef struct Submenu Submenu;
+typedef struct Popup Popup;
+typedef struct Loading Loading;
+typedef struct TextInput TextInput;
+typedef struct Widget Widget;
+typedef struct FuriHalSerialHandle FuriHalSerialHandle;
+typedef struct Nfc Nfc;
+typedef struct NfcPoller NfcPoller;
+typedef struct NfcDevice NfcDevice;
+typedef struct Iso14443_4aPoller Iso14443_4aPoller;
+typedef struct BitBuffer BitBuffer;
+
+typedef struct {
+    uint32_t type;
+    uint32_t event;
+} SceneManagerEvent;
+
+typedef struct {
+    const void* on_enter_handlers;
+    const void* on_event_handlers;
+    const void* on_exit_handlers;
+    uint32_t scene_num;
+} SceneManagerHandlers;
+
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event);
+
+bool storage_simply_mkdir(Storage* storage, const char* path);
+void dialog_message_show_storage_error(DialogsApp* context, const char* error_text);
+void path_extract_dirname(const char* path, FuriString* dirname);
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage);
+void flipper_format_free(FlipperFormat* flipper_format);
+bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path);
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version);
+bool flipper_format_write_hex(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint8_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data);
+
+// NFC
+typedef enum {
+    NfcCommandContinue,
+    NfcCommandReset,
+    NfcCommandStop,
+    NfcCommandSleep,
+} NfcCommand;
+
+typedef enum {
+    NfcProtocolIso14443_3a,
+    NfcProtocolIso14443_4a,
+} NfcProtocol;
+
+typedef struct {
+    NfcProtocol protocol;
+    void* instance;
+    void* event_data;
+} NfcGenericEvent;
+
+typedef struct {
+    uint8_t uid[10];
+    uint8_t uid_len;
+    uint8_t atqa[2];
+    uint8_t sak;
+} Iso14443_3aData;
+
+typedef enum {
+    Iso14443_4aErrorNone,
+    Iso14443_4aErrorTimeout,
+} Iso14443_4aError;
+
+typedef enum {
+    Iso14443_4aPollerEventTypeError,
+    Iso14443_4aPollerEventTypeReady,
+} Iso14443_4aPollerEventType;
+
+typedef struct {
+    Iso14443_4aPollerEventType type;
+} Iso14443_4aPollerEvent;
+
+void nfc_device_set_data(NfcDevice* instance, NfcProtocol protocol, const void* protocol_data);
+const void* nfc_device_get_data(const NfcDevice* instance, NfcProtocol protocol);
+const uint8_t* nfc_device_get_uid(const NfcDevice* instance, size_t* uid_len);
+const void* nfc_poller_get_data(const NfcPoller* instance);
+uint8_t iso14443_3a_get_sak(const Iso14443_3aData* data);
+Iso14443_4aError iso14443_4a_poller_send_block(
+    Iso14443_4aPoller* instance,
+    const BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer);
+
+BitBuffer* bit_buffer_alloc(size_t capacity_bytes);
+void bit_buffer_free(BitBuffer* buf);
+void bit_buffer_append_bytes(BitBuffer* buf, const uint8_t* data, size_t size_bytes);
+const uint8_t* bit_buffer_get_data(const BitBuffer* buf);
+size_t bit_buffer_get_size_bytes(const BitBuffer* buf);
+
+typedef enum {
+    Iso13239CrcTypeDefault,
+    Iso13239CrcTypePicopass,
+} Iso13239CrcType;
+
+void iso13239_crc_append(Iso13239CrcType type, BitBuffer* buf);
+
+// Harness side
+
+extern bool host_verbose;
+
+/** Called instead of waking a thread, used to hand the UART tx buffer to the simulated SAM */
+typedef void (*HostThreadFlagsCallback)(uint32_t flags, void* context);
+void host_thread_set_flags_callback(
+    FuriThread* thread,
+    HostThreadFlagsCallback callback,
+    void* context);
+
+/** Last event sent to the view dispatcher, 0 if none since the previous call */
+uint32_t host_take_custom_event(void);
+
+/** App side cost, the Makefile wraps malloc/free/realloc and the asn1c entry points */
+typedef struct {
+    uint32_t allocs;
+    uint32_t frees;
+    size_t alloc_bytes;
+    uint32_t encodes;
+    uint64_t encode_ns;
+    uint32_t decodes;
+    uint64_t decode_ns;
+} HostMetrics;
+
+extern HostMetrics host_metrics;
+// Set while the simulated SAM runs so its own allocations and codec calls aren't counted
+extern bool host_metrics_paused;
+// Bytes of heap in use, as malloc_usable_size() reports them, and the most ever in use
+extern size_t host_heap_bytes;
+extern size_t host_heap_peak;
+
+uint64_t host_time_ns(void);
@@ -0,0 +1,421 @@
+#include "sam_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Payload.h>
+#include <FrameProtocol.h>
+#include <PAC.h>
+#include <optimized_cipher.h>
+
+#define SAM_SIM_BUF_SIZE (512)
+#define SAM_SIM_SLOT (0)
+
+#define SYNC (0x03)
+#define CTRL (0x06)
+#define CCID_HEADER_LEN (10)
+
+#define CCID_PC_TO_RDR_ICC_POWER_ON (0x62)
+#define CCID_PC_TO_RDR_GET_SLOT_STATUS (0x65)
+#define CCID_PC_TO_RDR_XFR_BLOCK (0x6f)
+#define CCID_RDR_TO_PC_DATA_BLOCK (0x80)
+#define CCID_RDR_TO_PC_SLOT_STATUS (0x81)
+
+#define APDU_HEADER_LEN (5)
+#define ASN1_PREFIX (6)
+
+static const uint8_t sam_sim_atr[] =
+    {0x3b, 0x95, 0x96, 0x80, 0xb1, 0xfe, 0x55, 0x1f, 0xc7, 0x47, 0x72, 0x61, 0x63, 0x65, 0x13};
+// From a real SAM, see the comment above seader_parse_version
+static const uint8_t sam_sim_version[] = {
+    0x80, 0x02, 0x01, 0x29, 0x81, 0x06, 0x68, 0x3d, 0x05, 0x20, 0x26, 0xb6, 0x82, 0x01, 0x01};
+static const uint8_t sam_sim_serial[] = {0x04, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde};
+static const uint8_t sam_sim_iclass_key[] = {0xaf, 0xa7, 0x85, 0xa7, 0xda, 0xb3, 0x33, 0x78};
+static const uint8_t sam_sim_nr[] = {0x00, 0x00, 0x00, 0x00};
+static const uint8_t sam_sim_get_response_cmd[] = {0x00, 0xc0, 0x00, 0x00};
+
+typedef enum {
+    SamSimStepReadEpurse,
+    SamSimStepCheck,
+    SamSimStepReadSio1,
+    SamSimStepReadSio2,
+    SamSimStepFieldOff,
+    SamSimStepDone,
+} SamSimStep;
+
+struct SamSim {
+    bool get_response;
+    uint64_t credential;
+    uint8_t bit_length;
+
+    uint8_t out[SAM_SIM_BUF_SIZE * 2];
+    size_t out_len;
+    uint8_t pending[SAM_SIM_BUF_SIZE];
+    size_t pending_len;
+
+    SamSimStep step;
+    uint8_t csn[8];
+    uint8_t div_key[8];
+    uint8_t epurse[8];
+
+    const char* request_name;
+    SamSimStats stats;
+};
+
+SamSim* sam_sim_alloc(void) {
+    SamSim* sim = calloc(1, sizeof(SamSim));
+    sim->credential = 0x2409a4; // H10301, facility 18, card 1234
+    sim->bit_length = 26;
+    sim->request_name = "";
+    return sim;
+}
+
+void sam_sim_free(SamSim* sim) {
+    free(sim);
+}
+
+void sam_sim_set_get_response(SamSim* sim, bool enable) {
+    sim->get_response = enable;
+}
+
+void sam_sim_set_pacs(SamSim* sim, uint64_t credential, uint8_t bit_length) {
+    sim->credential = credential;
+    sim->bit_length = bit_length;
+}
+
+const char* sam_sim_get_request_name(SamSim* sim) {
+    return sim->request_name;
+}
+
+const SamSimStats* sam_sim_get_stats(SamSim* sim) {
+    return &sim->stats;
+}
+
+size_t sam_sim_transmit(SamSim* sim, uint8_t* data, size_t max_len) {
+    size_t len = sim->out_len < max_len ? sim->out_len : max_len;
+    memcpy(data, sim->out, len);
+    memmove(sim->out, sim->out + len, sim->out_len - len);
+    sim->out_len -= len;
+    return len;
+}
+
+static void sam_sim_send_ccid(
+    SamSim* sim,
+    uint8_t type,
+    uint8_t slot,
+    uint8_t seq,
+    uint8_t status,
+    const uint8_t* payload,
+    size_t len) {
+    if(sim->out_len + 2 + CCID_HEADER_LEN + len + 1 > sizeof(sim->out)) {
+        sim->stats.unexpected++;
+        return;
+    }
+
+    uint8_t* frame = sim->out + sim->out_len;
+    memset(frame, 0, 2 + CCID_HEADER_LEN);
+    frame[0] = SYNC;
+    frame[1] = CTRL;
+    frame[2 + 0] = type;
+    frame[2 + 1] = len & 0xff;
+    frame[2 + 2] = (len >> 8) & 0xff;
+    frame[2 + 5] = slot;
+    frame[2 + 6] = seq;
+    frame[2 + 7] = status;
+    memcpy(frame + 2 + CCID_HEADER_LEN, payload, len);
+
+    size_t frame_len = 2 + CCID_HEADER_LEN + len;
+    uint8_t lrc = 0;
+    for(size_t i = 0; i < frame_len; i++) {
+        lrc ^= frame[i];
+    }
+    frame[frame_len++] = lrc;
+    sim->out_len += frame_len;
+}
+
+// Response APDU: routing prefix, DER Payload, 9000 (or 61xx and GET RESPONSE)
+static size_t sam_sim_encode_payload(SamSim* sim, Payload_t* payload, uint8_t* apdu, size_t max) {
+    memset(apdu, 0, ASN1_PREFIX);
+    apdu[0] = 0x0a;
+    apdu[1] = 0x44;
+
+    asn_enc_rval_t er =
+        der_encode_to_buffer(&asn_DEF_Payload, payload, apdu + ASN1_PREFIX, max - ASN1_PREFIX - 2);
+    if(er.encoded < 0) {
+        printf("SAM: failed to encode %s\n", er.failed_type ? er.failed_type->name : "?");
+        sim->stats.unexpected++;
+        return 0;
+    }
+    return ASN1_PREFIX + er.encoded;
+}
+
+static void sam_sim_send_nfc(SamSim* sim, Payload_t* payload, const uint8_t* data, size_t len) {
+    static uint8_t protocol_bytes[] = {0x00, FrameProtocol_iclass};
+
+    payload->present = Payload_PR_nfcCommand;
+    if(data) {
+        NFCSend_t* nfc_send = &payload->choice.nfcCommand.choice.nfcSend;
+        payload->choice.nfcCommand.present = NFCCommand_PR_nfcSend;
+        nfc_send->data.buf = (uint8_t*)data;
+        nfc_send->data.size = len;
+        nfc_send->protocol.buf = protocol_bytes;
+        nfc_send->protocol.size = sizeof(protocol_bytes);
+        nfc_send->timeOut = 250;
+    } else {
+        payload->choice.nfcCommand.present = NFCCommand_PR_nfcOff;
+    }
+}
+
+static void sam_sim_append_crc(uint8_t* data, size_t len) {
+    uint16_t crc = 0xE012;
+    for(size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for(size_t j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+        }
+    }
+    data[len] = crc & 0xff;
+    data[len + 1] = crc >> 8;
+}
+
+// Next command of the iClass read script, built into payload
+static void sam_sim_next_step(SamSim* sim, Payload_t* payload, uint8_t* cmd) {
+    switch(sim->step) {
+    case SamSimStepReadEpurse:
+        cmd[0] = 0x88; // READCHECK_KD
+        cmd[1] = 0x02;
+        sam_sim_send_nfc(sim, payload, cmd, 2);
+        break;
+    case SamSimStepCheck: {
+        uint8_t cc_nr[12];
+        memcpy(cc_nr, sim->epurse, 8);
+        memcpy(cc_nr + 8, sam_sim_nr, 4);
+        cmd[0] = 0x05; // CHECK
+        memcpy(cmd + 1, sam_sim_nr, 4);
+        loclass_opt_doReaderMAC(cc_nr, sim->div_key, cmd + 5);
+        sam_sim_send_nfc(sim, payload, cmd, 9);
+        break;
+    }
+    case SamSimStepReadSio1:
+    case SamSimStepReadSio2:
+        cmd[0] = 0x06; // READ4
+        cmd[1] = sim->step == SamSimStepReadSio1 ? 0x0a : 0x0e;
+        sam_sim_append_crc(cmd + 1, 1);
+        sam_sim_send_nfc(sim, payload, cmd, 4);
+        break;
+    case SamSimStepFieldOff:
+        sam_sim_send_nfc(sim, payload, NULL, 0);
+        break;
+    case SamSimStepDone:
+        // Answer to cardDetected once the card has been read
+        payload->present = Payload_PR_response;
+        payload->choice.response.present = Response_PR_samResponse;
+        break;
+    }
+}
+
+static void sam_sim_nfc_rx(SamSim* sim, const uint8_t* data, size_t len) {
+    switch(sim->step) {
+    case SamSimStepReadEpurse:
+        if(len >= 8) memcpy(sim->epurse, data, 8);
+        break;
+    case SamSimStepCheck: {
+        uint8_t cc_nr[12];
+        uint8_t mac[4];
+        memcpy(cc_nr, sim->epurse, 8);
+        memcpy(cc_nr + 8, sam_sim_nr, 4);
+        loclass_opt_doTagMAC(cc_nr, sim->div_key, mac);
+        if(len < 4 || memcmp(mac, data, 4) != 0) sim->stats.tag_mac_errors++;
+        break;
+    }
+    default:
+        break;
+    }
+    if(sim->step < SamSimStepDone) sim->step++;
+}
+
+static size_t sam_sim_handle_payload(SamSim* sim, const uint8_t* der, size_t len, uint8_t* apdu) {
+    Payload_t* request = NULL;
+    Payload_t response = {0};
+    uint8_t cmd[16];
+    uint8_t pacs[16];
+    size_t apdu_len = 0;
+
+    asn_dec_rval_t rval = asn_decode(0, ATS_DER, &asn_DEF_Payload, (void**)&request, der, len);
+    if(rval.code != RC_OK) {
+        sim->request_name = "undecodable";
+        sim->stats.unexpected++;
+        ASN_STRUCT_FREE(asn_DEF_Payload, request);
+        return 0;
+    }
+
+    if(request->present == Payload_PR_samCommand) {
+        SamCommand_t* command = &request->choice.samCommand;
+        response.present = Payload_PR_response;
+        response.choice.response.present = Response_PR_samResponse;
+        SamResponse_t* sam_response = &response.choice.response.choice.samResponse;
+
+        switch(command->present) {
+        case SamCommand_PR_version:
+            sim->request_name = "samCommand.version";
+            sam_response->buf = (uint8_t*)sam_sim_version;
+            sam_response->size = sizeof(sam_sim_version);
+            break;
+        case SamCommand_PR_serialNumber:
+            sim->request_name = "samCommand.serialNumber";
+            sam_response->buf = (uint8_t*)sam_sim_serial;
+            sam_response->size = sizeof(sam_sim_serial);
+            break;
+        case SamCommand_PR_cardDetected: {
+            CardDetails_t* details = &command->choice.cardDetected.detectedCardDetails;
+            sim->request_name = "samCommand.cardDetected";
+            if(details->csn.size != sizeof(sim->csn) || details->protocol.size < 2 ||
+               details->protocol.buf[1] != FrameProtocol_iclass) {
+                sim->stats.unexpected++;
+                response.present = Payload_PR_errorResponse;
+                break;
+            }
+            memcpy(sim->csn, details->csn.buf, sizeof(sim->csn));
+            loclass_iclass_calc_div_key(sim->csn, sam_sim_iclass_key, sim->div_key, false);
+            sim->step = SamSimStepReadEpurse;
+            sam_sim_next_step(sim, &response, cmd);
+            break;
+        }
+        case SamCommand_PR_requestPacs: {
+            // PAC is a DER BIT STRING, credential bits left aligned
+            size_t bytes = (sim->bit_length + 7) / 8;
+            uint64_t value = sim->credential << (bytes * 8 - sim->bit_length);
+            sim->request_name = "samCommand.requestPacs";
+            pacs[0] = 0x03;
+            pacs[1] = bytes + 1;
+            pacs[2] = bytes * 8 - sim->bit_length;
+            for(size_t i = 0; i < bytes; i++) {
+                pacs[3 + i] = value >> (8 * (bytes - 1 - i));
+            }
+            sam_response->buf = pacs;
+            sam_response->size = 3 + bytes;
+            break;
+        }
+        default:
+            sim->request_name = "samCommand.other";
+            sim->stats.unexpected++;
+            response.present = Payload_PR_errorResponse;
+            break;
+        }
+    } else if(request->present == Payload_PR_response &&
+              request->choice.response.present == Response_PR_nfcResponse) {
+        NFCResponse_t* nfc_response = &request->choice.response.choice.nfcResponse;
+        if(nfc_response->present == NFCResponse_PR_nfcRx) {
+            NFCRx_t* nfc_rx = &nfc_response->choice.nfcRx;
+            sim->request_name = "response.nfcRx";
+            if(nfc_rx->data) {
+                sam_sim_nfc_rx(sim, nfc_rx->data->buf, nfc_rx->data->size);
+            } else {
+                sam_sim_nfc_rx(sim, NULL, 0);
+            }
+        } else {
+            sim->request_name = "response.nfcAck";
+            sim->step = SamSimStepDone;
+        }
+        sam_sim_next_step(sim, &response, cmd);
+    } else {
+        sim->request_name = "other";
+        sim->stats.unexpected++;
+        response.present = Payload_PR_errorResponse;
+    }
+
+    apdu_len = sam_sim_encode_payload(sim, &response, apdu, SAM_SIM_BUF_SIZE);
+    ASN_STRUCT_FREE(asn_DEF_Payload, request);
+    return apdu_len;
+}
+
+static void sam_sim_handle_apdu(
+    SamSim* sim,
+    uint8_t slot,
+    uint8_t seq,
+    const uint8_t* apdu,
+    size_t len) {
+    uint8_t response[SAM_SIM_BUF_SIZE];
+    size_t response_len = 0;
+
+    sim->stats.apdus++;
+    if(len >= APDU_HEADER_LEN &&
+       memcmp(apdu, sam_sim_get_response_cmd, sizeof(sam_sim_get_response_cmd)) == 0) {
+        sim->request_name = "GET RESPONSE";
+        memcpy(response, sim->pending, sim->pending_len);
+        response_len = sim->pending_len;
+        sim->pending_len = 0;
+    } else if(len > APDU_HEADER_LEN + ASN1_PREFIX && apdu[0] == 0xa0 && apdu[1] == 0xda) {
+        // Lc, then the app's routing prefix and the DER Payload
+        size_t lc = apdu[4];
+        if(APDU_HEADER_LEN + lc > len || lc <= ASN1_PREFIX) {
+            sim->stats.unexpected++;
+            return;
+        }
+        response_len = sam_sim_handle_payload(
+            sim, apdu + APDU_HEADER_LEN + ASN1_PREFIX, lc - ASN1_PREFIX, response);
+        if(sim->get_response && response_len > 0) {
+            memcpy(sim->pending, response, response_len);
+            sim->pending_len = response_len;
+            response[0] = 0x61;
+            response[1] = response_len;
+            sam_sim_send_ccid(sim, CCID_RDR_TO_PC_DATA_BLOCK, slot, seq, 0, response, 2);
+            return;
+        }
+    } else {
+        sim->request_name = "unknown APDU";
+        sim->stats.unexpected++;
+    }
+
+    response[response_len++] = 0x90;
+    response[response_len++] = 0x00;
+    sam_sim_send_ccid(sim, CCID_RDR_TO_PC_DATA_BLOCK, slot, seq, 0, response, response_len);
+}
+
+void sam_sim_receive(SamSim* sim, const uint8_t* frame, size_t len) {
+    sim->stats.frames++;
+    if(len < 2 + CCID_HEADER_LEN + 1 || frame[0] != SYNC || frame[1] != CTRL) {
+        sim->stats.unexpected++;
+        return;
+    }
+
+    uint8_t lrc = 0;
+    for(size_t i = 0; i < len; i++) {
+        lrc ^= frame[i];
+    }
+    if(lrc != 0) {
+        sim->stats.lrc_errors++;
+        return;
+    }
+
+    const uint8_t* ccid = frame + 2;
+    uint32_t length = ccid[1] | (ccid[2] << 8) | (ccid[3] << 16) | ((uint32_t)ccid[4] << 24);
+    uint8_t slot = ccid[5];
+    uint8_t seq = ccid[6];
+    if(2 + CCID_HEADER_LEN + length + 1 != len) {
+        sim->stats.unexpected++;
+        return;
+    }
+
+    switch(ccid[0]) {
+    case CCID_PC_TO_RDR_GET_SLOT_STATUS:
+        sim->request_name = "ccid.GetSlotStatus";
+        // bmICCStatus 0: present and active, 2: no ICC
+        sam_sim_send_ccid(
+            sim, CCID_RDR_TO_PC_SLOT_STATUS, slot, seq, slot == SAM_SIM_SLOT ? 0 : 2, NULL, 0);
+        break;
+    case CCID_PC_TO_RDR_ICC_POWER_ON:
+        sim->request_name = "ccid.IccPowerOn";
+        sam_sim_send_ccid(
+            sim, CCID_RDR_TO_PC_DATA_BLOCK, slot, seq, 0, sam_sim_atr, sizeof(sam_sim_atr));
+        break;
+    case CCID_PC_TO_RDR_XFR_BLOCK:
+        sam_sim_handle_apdu(sim, slot, seq, ccid + CCID_HEADER_LEN, length);
+        break;
+    default:
+        sim->request_name = "ccid.other";
+        sim->stats.unexpected++;
+        break;
+    }
+}
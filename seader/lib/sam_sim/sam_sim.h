@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Host stand-in for the SAM on the other end of the UART.
+ *
+ * It answers CCID slot status, power on and XfrBlock frames. The XfrBlock APDUs carry DER
+ * Payload messages, which it decodes with the same asn1c codecs as the app and answers with
+ * canned ones: version, serial number, an iClass read script of nfcSend commands followed by
+ * nfcOff, and a PACS response.
+ */
+typedef struct SamSim SamSim;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t apdus;
+    uint32_t lrc_errors;
+    uint32_t tag_mac_errors;
+    uint32_t unexpected;
+} SamSimStats;
+
+SamSim* sam_sim_alloc(void);
+
+void sam_sim_free(SamSim* sim);
+
+/** Answer with 61xx and serve the data on GET RESPONSE, like a SAM with a short buffer */
+void sam_sim_set_get_response(SamSim* sim, bool enable);
+
+/** Credential returned in the PACS response */
+void sam_sim_set_pacs(SamSim* sim, uint64_t credential, uint8_t bit_length);
+
+/** One complete CCID frame from the app, including SYNC CTRL and the LRC */
+void sam_sim_receive(SamSim* sim, const uint8_t* frame, size_t len);
+
+/** Bytes queued for the app, returns number of bytes copied */
+size_t sam_sim_transmit(SamSim* sim, uint8_t* data, size_t max_len);
+
+/** Name of the last request the app sent, for per-transaction reports */
+const char* sam_sim_get_request_name(SamSim* sim);
+
+const SamSimStats* sam_sim_get_stats(SamSim* sim);
@@ -0,0 +1,304 @@
+// Drives the real sam_api.c / ccid.c / seader_worker.c against the simulated SAM and reports the
+// app side cost of every SAM transaction: time, asn1c encode/decode calls and allocations.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "seader_worker_i.h"
+#include "seader_arena.h"
+#include "sam_sim.h"
+
+#define BENCH_MAX_ROWS (16)
+#define BENCH_DEFAULT_ITERATIONS (1000)
+#define BENCH_FINAL_ROW "(after last response)"
+
+typedef struct {
+    const char* name;
+    uint32_t count;
+    uint64_t ns;
+    HostMetrics metrics;
+} BenchRow;
+
+static Seader seader;
+static SeaderWorker* worker;
+static SeaderUartBridge* uart;
+static SamSim* sim;
+
+static BenchRow rows[BENCH_MAX_ROWS];
+static size_t row_count = 0;
+
+// App time is wall time minus time spent in the simulated SAM
+static uint64_t excluded_ns = 0;
+static uint64_t mark_ns = 0;
+static uint64_t mark_excluded_ns = 0;
+static HostMetrics mark_metrics;
+
+static uint32_t worker_event = 0;
+
+static BenchRow* bench_row(const char* name) {
+    for(size_t i = 0; i < row_count; i++) {
+        if(strcmp(rows[i].name, name) == 0) return &rows[i];
+    }
+    furi_check(row_count < BENCH_MAX_ROWS);
+    rows[row_count].name = name;
+    return &rows[row_count++];
+}
+
+static void bench_mark(void) {
+    mark_ns = host_time_ns();
+    mark_excluded_ns = excluded_ns;
+    mark_metrics = host_metrics;
+}
+
+// Everything the app did since the last mark is charged to the named transaction
+static void bench_account(const char* name, uint64_t now) {
+    BenchRow* row = bench_row(name);
+    row->count++;
+    row->ns += (now - mark_ns) - (excluded_ns - mark_excluded_ns);
+    row->metrics.allocs += host_metrics.allocs - mark_metrics.allocs;
+    row->metrics.frees += host_metrics.frees - mark_metrics.frees;
+    row->metrics.alloc_bytes += host_metrics.alloc_bytes - mark_metrics.alloc_bytes;
+    row->metrics.encodes += host_metrics.encodes - mark_metrics.encodes;
+    row->metrics.encode_ns += host_metrics.encode_ns - mark_metrics.encode_ns;
+    row->metrics.decodes += host_metrics.decodes - mark_metrics.decodes;
+    row->metrics.decode_ns += host_metrics.decode_ns - mark_metrics.decode_ns;
+}
+
+// UART tx thread wake-up: hand the frame to the SAM
+static void bench_uart_tx(uint32_t flags, void* context) {
+    UNUSED(context);
+    if(!(flags & WorkerEvtSamRx) || uart->tx_len == 0) return;
+
+    uint64_t start = host_time_ns();
+    host_metrics_paused = true;
+    sam_sim_receive(sim, uart->tx_buf, uart->tx_len);
+    host_metrics_paused = false;
+    uint64_t end = host_time_ns();
+    excluded_ns += end - start;
+
+    bench_account(sam_sim_get_request_name(sim), end);
+    bench_mark();
+}
+
+// protocol/picopass_poller.c needs the NFC HAL, only the virtual credential is read here
+uint8_t* picopass_poller_get_csn(PicopassPoller* instance) {
+    UNUSED(instance);
+    abort();
+}
+
+PicopassError picopass_poller_send_frame(
+    PicopassPoller* instance,
+    BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer,
+    uint32_t fwt_fc) {
+    UNUSED(instance);
+    UNUSED(tx_buffer);
+    UNUSED(rx_buffer);
+    UNUSED(fwt_fc);
+    abort();
+}
+
+static void bench_worker_callback(SeaderWorkerEvent event, void* context) {
+    UNUSED(context);
+    worker_event = event;
+}
+
+// UART rx worker and virtual credential loop, run until both sides are idle
+static void bench_pump(void) {
+    CcidFramer* framer = &uart->rx_framer;
+
+    while(1) {
+        size_t space;
+        uint8_t* dst = ccid_framer_write_ptr(framer, &space);
+        uint64_t start = host_time_ns();
+        host_metrics_paused = true;
+        size_t len = sam_sim_transmit(sim, dst, space);
+        host_metrics_paused = false;
+        excluded_ns += host_time_ns() - start;
+
+        if(len > 0) {
+            uint8_t* frame;
+            size_t frame_len;
+            ccid_framer_commit(framer, len);
+            while((frame_len = ccid_framer_next(framer, &frame)) > 0) {
+                seader_ccid_process(&seader, frame, frame_len);
+            }
+            continue;
+        }
+
+        // Same as seader_worker_virtual_credential
+        if(furi_message_queue_get_count(worker->messages) > 0) {
+            SeaderAPDU apdu = {};
+            furi_message_queue_get(worker->messages, &apdu, FuriWaitForever);
+            if(!seader_process_success_response_i(&seader, apdu.buf, apdu.len, true, NULL)) {
+                printf("Queued SAM message not processed\n");
+            }
+            continue;
+        }
+
+        break;
+    }
+}
+
+static bool bench_detect_sam(void) {
+    worker_event = 0;
+    memset(worker->sam_version, 0, sizeof(worker->sam_version));
+
+    bench_mark();
+    seader_ccid_check_for_sam(uart);
+    bench_pump();
+    bench_account(BENCH_FINAL_ROW, host_time_ns());
+
+    bool ok = worker_event == SeaderWorkerEventSamPresent && worker->sam_version[0] == 0x01 &&
+              worker->sam_version[1] == 0x29 && seader.samCommand == SamCommand_PR_NOTHING;
+    if(!ok) printf("SAM detection failed\n");
+    return ok;
+}
+
+static bool bench_read_credential(void) {
+    static const uint8_t csn[PICOPASS_UID_LEN] = {0x7a, 0x2c, 0x41, 0x00, 0xfb, 0xff, 0x12, 0xe0};
+    SeaderCredential* credential = seader.credential;
+
+    credential->type = SeaderCredentialTypeVirtual;
+    credential->credential = 0;
+    credential->bit_length = 0;
+    for(size_t i = 0; i < sizeof(credential->sio); i++) {
+        credential->sio[i] = i == 0 ? 0x30 : (uint8_t)i;
+    }
+    worker->stage = SeaderPollerEventTypeCardDetect;
+    host_take_custom_event();
+
+    bench_mark();
+    seader_worker_card_detect(&seader, 0, NULL, csn, sizeof(csn), NULL, 0);
+    bench_pump();
+    bench_account(BENCH_FINAL_ROW, host_time_ns());
+
+    bool ok = host_take_custom_event() == SeaderCustomEventPollerSuccess &&
+              worker->stage == SeaderPollerEventTypeComplete && credential->bit_length == 26 &&
+              credential->credential == 0x2409a4;
+    if(!ok) {
+        printf(
+            "Credential read failed: %zu bits %llx\n",
+            credential->bit_length,
+            (unsigned long long)credential->credential);
+    }
+    return ok;
+}
+
+static void bench_report(uint32_t iterations) {
+    printf(
+        "%-26s %7s %9s %13s %13s %7s %7s %7s\n",
+        "transaction",
+        "count",
+        "app us",
+        "encode n/us",
+        "decode n/us",
+        "allocs",
+        "frees",
+        "bytes");
+    for(size_t i = 0; i < row_count; i++) {
+        BenchRow* row = &rows[i];
+        double n = row->count;
+        printf(
+            "%-26s %7u %9.2f %5.1f/%7.2f %5.1f/%7.2f %7.1f %7.1f %7.0f\n",
+            row->name,
+            row->count / iterations,
+            row->ns / n / 1000,
+            row->metrics.encodes / n,
+            row->metrics.encode_ns / n / 1000,
+            row->metrics.decodes / n,
+            row->metrics.decode_ns / n / 1000,
+            row->metrics.allocs / n,
+            row->metrics.frees / n,
+            row->metrics.alloc_bytes / n);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+    int opt;
+
+    sim = sam_sim_alloc();
+    while((opt = getopt(argc, argv, "n:gv")) != -1) {
+        switch(opt) {
+        case 'n':
+            iterations = strtoul(optarg, NULL, 0);
+            break;
+        case 'g':
+            sam_sim_set_get_response(sim, true);
+            break;
+        case 'v':
+            host_verbose = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n iterations] [-g] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(iterations == 0) iterations = 1;
+
+    uart = calloc(1, sizeof(SeaderUartBridge));
+    uart->tx_thread = furi_thread_alloc_ex("SeaderUartTxWorker", 0, NULL, NULL);
+    host_thread_set_flags_callback(uart->tx_thread, bench_uart_tx, NULL);
+    ccid_framer_reset(&uart->rx_framer);
+
+    worker = seader_worker_alloc();
+    seader.worker = worker;
+    seader.uart = uart;
+    seader.credential = calloc(1, sizeof(SeaderCredential));
+    seader.credential->load_path = furi_string_alloc();
+    seader_worker_start(worker, SeaderWorkerStateCheckSam, uart, bench_worker_callback, &seader);
+
+    HostMetrics start_metrics = host_metrics;
+    size_t start_heap = host_heap_bytes;
+    host_heap_peak = host_heap_bytes;
+    uint64_t start = host_time_ns();
+    bool ok = true;
+    for(uint32_t i = 0; i < iterations && ok; i++) {
+        ok = bench_detect_sam() && bench_read_credential();
+    }
+    uint64_t elapsed = host_time_ns() - start - excluded_ns;
+
+    const SamSimStats* stats = sam_sim_get_stats(sim);
+    bench_report(iterations);
+    printf(
+        "\n%u iterations, %.1f us app time per detect + read, %.1f APDUs per iteration\n",
+        iterations,
+        elapsed / 1000.0 / iterations,
+        (double)stats->apdus / iterations);
+    printf(
+        "SAM saw %u frames, %u LRC errors, %u tag MAC errors, %u unexpected messages\n",
+        stats->frames,
+        stats->lrc_errors,
+        stats->tag_mac_errors,
+        stats->unexpected);
+
+    printf(
+        "Peak heap %zu bytes above the idle worker, %.1f allocations per iteration\n",
+        host_heap_peak - start_heap,
+        (double)(host_metrics.allocs - start_metrics.allocs) / iterations);
+
+    // The simulated SAM decodes requests with the same asn1c build, nested inside the app's
+    // transaction, so the arena peak is an upper bound for the app alone
+    SeaderArenaStats arena;
+    seader_arena_get_stats(&arena);
+    if(arena.size > 0) {
+        printf(
+            "Arena peak %zu of %zu bytes, %u of %u allocations fell back to the heap\n",
+            arena.peak,
+            arena.size,
+            arena.fallbacks,
+            arena.allocs);
+    }
+
+    uint32_t leaked = (host_metrics.allocs - start_metrics.allocs) -
+                      (host_metrics.frees - start_metrics.frees);
+    if(leaked) printf("%u allocations not freed\n", leaked);
+
+    ok = ok && stats->lrc_errors == 0 && stats->tag_mac_errors == 0 && stats->unexpected == 0;
+    printf("%s\n", ok ? "OK" : "FAILED");
+
+    sam_sim_free(sim);
+    return ok ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 
 #include "sam_api.h"
+#include "seader_arena.h"
 #include <toolbox/path.h>
 
 #define TAG "SAMAPI"
@@ -222,7 +223,7 @@ void seader_send_response(
     uint8_t from,
     uint8_t replyTo) {
     Payload_t* payload = 0;
-    payload = calloc(1, sizeof *payload);
+    payload = seader_arena_calloc(1, sizeof *payload);
     assert(payload);
 
     payload->present = Payload_PR_response;
@@ -230,7 +231,8 @@ void seader_send_response(
 
     seader_send_payload(seader_uart, payload, to, from, replyTo);
 
-    ASN_STRUCT_FREE(asn_DEF_Payload, payload);
+    // Shallow copy, the caller owns the response members
+    seader_arena_free(payload);
 }
 
 void seader_send_request_pacs(Seader* seader) {
@@ -238,13 +240,13 @@ void seader_send_request_pacs(Seader* seader) {
     SeaderUartBridge* seader_uart = seader_worker->uart;
 
     RequestPacs_t* requestPacs = 0;
-    requestPacs = calloc(1, sizeof *requestPacs);
+    requestPacs = seader_arena_calloc(1, sizeof *requestPacs);
     assert(requestPacs);
 
     requestPacs->contentElementTag = ContentElementTag_implicitFormatPhysicalAccessBits;
 
     SamCommand_t* samCommand = 0;
-    samCommand = calloc(1, sizeof *samCommand);
+    samCommand = seader_arena_calloc(1, sizeof *samCommand);
     assert(samCommand);
 
     samCommand->present = SamCommand_PR_requestPacs;
@@ -253,7 +255,7 @@ void seader_send_request_pacs(Seader* seader) {
     samCommand->choice.requestPacs = *requestPacs;
 
     Payload_t* payload = 0;
-    payload = calloc(1, sizeof *payload);
+    payload = seader_arena_calloc(1, sizeof *payload);
     assert(payload);
 
     payload->present = Payload_PR_samCommand;
@@ -271,14 +273,14 @@ void seader_worker_send_serial_number(Seader* seader) {
     SeaderUartBridge* seader_uart = seader_worker->uart;
 
     SamCommand_t* samCommand = 0;
-    samCommand = calloc(1, sizeof *samCommand);
+    samCommand = seader_arena_calloc(1, sizeof *samCommand);
     assert(samCommand);
 
     samCommand->present = SamCommand_PR_serialNumber;
     seader->samCommand = samCommand->present;
 
     Payload_t* payload = 0;
-    payload = calloc(1, sizeof *payload);
+    payload = seader_arena_calloc(1, sizeof *payload);
     assert(payload);
 
     payload->present = Payload_PR_samCommand;
@@ -295,14 +297,14 @@ void seader_worker_send_version(Seader* seader) {
 
     SeaderUartBridge* seader_uart = seader_worker->uart;
     SamCommand_t* samCommand = 0;
-    samCommand = calloc(1, sizeof *samCommand);
+    samCommand = seader_arena_calloc(1, sizeof *samCommand);
     assert(samCommand);
 
     samCommand->present = SamCommand_PR_version;
     seader->samCommand = samCommand->present;
 
     Payload_t* payload = 0;
-    payload = calloc(1, sizeof *payload);
+    payload = seader_arena_calloc(1, sizeof *payload);
     assert(payload);
 
     payload->present = Payload_PR_samCommand;
@@ -318,13 +320,13 @@ void seader_send_card_detected(Seader* seader, CardDetails_t* cardDetails) {
     SeaderWorker* seader_worker = seader->worker;
     SeaderUartBridge* seader_uart = seader_worker->uart;
     CardDetected_t* cardDetected = 0;
-    cardDetected = calloc(1, sizeof *cardDetected);
+    cardDetected = seader_arena_calloc(1, sizeof *cardDetected);
     assert(cardDetected);
 
     cardDetected->detectedCardDetails = *cardDetails;
 
     SamCommand_t* samCommand = 0;
-    samCommand = calloc(1, sizeof *samCommand);
+    samCommand = seader_arena_calloc(1, sizeof *samCommand);
     assert(samCommand);
 
     samCommand->present = SamCommand_PR_cardDetected;
@@ -332,7 +334,7 @@ void seader_send_card_detected(Seader* seader, CardDetails_t* cardDetails) {
     samCommand->choice.cardDetected = *cardDetected;
 
     Payload_t* payload = 0;
-    payload = calloc(1, sizeof *payload);
+    payload = seader_arena_calloc(1, sizeof *payload);
     assert(payload);
 
     payload->present = Payload_PR_samCommand;
@@ -340,15 +342,16 @@ void seader_send_card_detected(Seader* seader, CardDetails_t* cardDetails) {
 
     seader_send_payload(seader_uart, payload, 0x44, 0x0a, 0x44);
 
-    ASN_STRUCT_FREE(asn_DEF_Payload, payload);
-    ASN_STRUCT_FREE(asn_DEF_SamCommand, samCommand);
-    ASN_STRUCT_FREE(asn_DEF_CardDetected, cardDetected);
+    // Shallow copies, the caller owns the card details members
+    seader_arena_free(payload);
+    seader_arena_free(samCommand);
+    seader_arena_free(cardDetected);
 }
 
 bool seader_unpack_pacs(Seader* seader, uint8_t* buf, size_t size) {
     SeaderCredential* seader_credential = seader->credential;
     PAC_t* pac = 0;
-    pac = calloc(1, sizeof *pac);
+    pac = seader_arena_calloc(1, sizeof *pac);
     assert(pac);
     bool rtn = false;
 
@@ -400,16 +403,17 @@ bool seader_unpack_pacs(Seader* seader, uint8_t* buf, size_t size) {
 //    800201298106683d052026b6820101
 //300F800201298106683D052026B6820101
 bool seader_parse_version(SeaderWorker* seader_worker, uint8_t* buf, size_t size) {
-    SamVersion_t* version = 0;
-    version = calloc(1, sizeof *version);
-    assert(version);
-
     bool rtn = false;
     if(size > 30) {
         // Too large to handle now
         FURI_LOG_W(TAG, "Version of %d is to long to parse", size);
         return false;
     }
+
+    SamVersion_t* version = 0;
+    version = seader_arena_calloc(1, sizeof *version);
+    assert(version);
+
     // Add sequence prefix
     uint8_t seq[32] = {0x30};
     seq[1] = (uint8_t)size;
@@ -574,21 +578,21 @@ void seader_send_nfc_rx(SeaderUartBridge* seader_uart, uint8_t* buffer, size_t l
     RfStatus_t rfStatus = {.buf = status, .size = 2};
 
     NFCRx_t* nfcRx = 0;
-    nfcRx = calloc(1, sizeof *nfcRx);
+    nfcRx = seader_arena_calloc(1, sizeof *nfcRx);
     assert(nfcRx);
 
     nfcRx->rfStatus = rfStatus;
     nfcRx->data = &rxData;
 
     NFCResponse_t* nfcResponse = 0;
-    nfcResponse = calloc(1, sizeof *nfcResponse);
+    nfcResponse = seader_arena_calloc(1, sizeof *nfcResponse);
     assert(nfcResponse);
 
     nfcResponse->present = NFCResponse_PR_nfcRx;
     nfcResponse->choice.nfcRx = *nfcRx;
 
     Response_t* response = 0;
-    response = calloc(1, sizeof *response);
+    response = seader_arena_calloc(1, sizeof *response);
     assert(response);
 
     response->present = Response_PR_nfcResponse;
@@ -596,9 +600,10 @@ void seader_send_nfc_rx(SeaderUartBridge* seader_uart, uint8_t* buffer, size_t l
 
     seader_send_response(seader_uart, response, 0x14, 0x0a, 0x0);
 
-    ASN_STRUCT_FREE(asn_DEF_NFCRx, nfcRx);
-    ASN_STRUCT_FREE(asn_DEF_NFCResponse, nfcResponse);
-    ASN_STRUCT_FREE(asn_DEF_Response, response);
+    // Members point at the caller's buffer and the stack
+    seader_arena_free(nfcRx);
+    seader_arena_free(nfcResponse);
+    seader_arena_free(response);
 }
 
 void seader_capture_sio(BitBuffer* tx_buffer, BitBuffer* rx_buffer, SeaderCredential* credential) {
@@ -773,13 +778,13 @@ void seader_parse_nfc_off(SeaderUartBridge* seader_uart) {
     FURI_LOG_D(TAG, "Set Field Off");
 
     NFCResponse_t* nfcResponse = 0;
-    nfcResponse = calloc(1, sizeof *nfcResponse);
+    nfcResponse = seader_arena_calloc(1, sizeof *nfcResponse);
     assert(nfcResponse);
 
     nfcResponse->present = NFCResponse_PR_nfcAck;
 
     Response_t* response = 0;
-    response = calloc(1, sizeof *response);
+    response = seader_arena_calloc(1, sizeof *response);
     assert(response);
 
     response->present = Response_PR_nfcResponse;
@@ -787,7 +792,7 @@ void seader_parse_nfc_off(SeaderUartBridge* seader_uart) {
 
     seader_send_response(seader_uart, response, 0x44, 0x0a, 0);
 
-    ASN_STRUCT_FREE(asn_DEF_Response, response);
+    seader_arena_free(response);
     ASN_STRUCT_FREE(asn_DEF_NFCResponse, nfcResponse);
 }
 
@@ -846,7 +851,7 @@ bool seader_process_success_response_i(
     bool online,
     SeaderPollerContainer* spc) {
     Payload_t* payload = 0;
-    payload = calloc(1, sizeof *payload);
+    payload = seader_arena_calloc(1, sizeof *payload);
     assert(payload);
     bool processed = false;
 
@@ -897,7 +902,7 @@ NfcCommand seader_worker_card_detect(
     SeaderCredential* credential = seader->credential;
 
     CardDetails_t* cardDetails = 0;
-    cardDetails = calloc(1, sizeof *cardDetails);
+    cardDetails = seader_arena_calloc(1, sizeof *cardDetails);
     assert(cardDetails);
 
     OCTET_STRING_fromBuf(&cardDetails->csn, (const char*)uid, uid_len);
@@ -928,6 +933,9 @@ NfcCommand seader_worker_card_detect(
 
     seader_send_card_detected(seader, cardDetails);
 
+    // sak and atqa live on the stack
+    cardDetails->sak = NULL;
+    cardDetails->atqa = NULL;
     ASN_STRUCT_FREE(asn_DEF_CardDetails, cardDetails);
     return NfcCommandContinue;
 }
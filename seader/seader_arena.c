@@ -0,0 +1,118 @@
+#include "seader_arena.h"
+
+#include <furi.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Each block is preceded by its rounded up size, blocks start on an 8 byte boundary
+#define SEADER_ARENA_ALIGN (8)
+#define SEADER_ARENA_HEADER (SEADER_ARENA_ALIGN)
+#define SEADER_ARENA_ROUND(x) (((x) + SEADER_ARENA_ALIGN - 1) & ~(size_t)(SEADER_ARENA_ALIGN - 1))
+
+// Nothing is ever placed in the 1 byte stand-in when SEADER_ARENA_SIZE is 0
+static uint8_t arena[SEADER_ARENA_SIZE > 0 ? SEADER_ARENA_SIZE : 1]
+    __attribute__((aligned(SEADER_ARENA_ALIGN)));
+static size_t arena_used = 0;
+static uint32_t arena_live = 0;
+static SeaderArenaStats arena_stats = {.size = SEADER_ARENA_SIZE};
+
+static inline bool seader_arena_owns(const void* ptr) {
+    return SEADER_ARENA_SIZE > 0 && (const uint8_t*)ptr >= arena &&
+           (const uint8_t*)ptr < arena + sizeof(arena);
+}
+
+static inline size_t* seader_arena_header(void* ptr) {
+    return (size_t*)((uint8_t*)ptr - SEADER_ARENA_HEADER);
+}
+
+// The most recent block ends at arena_used and can be resized or released in place
+static inline bool seader_arena_is_last(void* ptr) {
+    return (uint8_t*)ptr + *seader_arena_header(ptr) == arena + arena_used;
+}
+
+// Called in a critical section, NULL if the block doesn't fit
+static uint8_t* seader_arena_bump(size_t size) {
+#if SEADER_ARENA_SIZE > 0
+    size_t block = SEADER_ARENA_ROUND(size);
+    if(size == 0 || arena_used + SEADER_ARENA_HEADER + block > SEADER_ARENA_SIZE) return NULL;
+
+    uint8_t* ptr = arena + arena_used + SEADER_ARENA_HEADER;
+    *seader_arena_header(ptr) = block;
+    arena_used += SEADER_ARENA_HEADER + block;
+    arena_live++;
+    if(arena_used > arena_stats.peak) arena_stats.peak = arena_used;
+    return ptr;
+#else
+    UNUSED(size);
+    return NULL;
+#endif
+}
+
+void* seader_arena_malloc(size_t size) {
+    FURI_CRITICAL_ENTER();
+    uint8_t* ptr = seader_arena_bump(size);
+    arena_stats.allocs++;
+    if(!ptr) arena_stats.fallbacks++;
+    FURI_CRITICAL_EXIT();
+
+    return ptr ? ptr : malloc(size);
+}
+
+void* seader_arena_calloc(size_t count, size_t size) {
+    void* ptr = seader_arena_malloc(count * size);
+    if(ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* seader_arena_realloc(void* ptr, size_t size) {
+    if(!seader_arena_owns(ptr)) return realloc(ptr, size);
+
+    size_t* header = seader_arena_header(ptr);
+    size_t old_block = *header;
+    size_t block = SEADER_ARENA_ROUND(size);
+    size_t offset = (uint8_t*)ptr - arena;
+    bool resized = false;
+
+    FURI_CRITICAL_ENTER();
+    if(seader_arena_is_last(ptr) && offset + block <= sizeof(arena)) {
+        *header = block;
+        arena_used = offset + block;
+        if(arena_used > arena_stats.peak) arena_stats.peak = arena_used;
+        resized = true;
+    } else if(block <= old_block) {
+        resized = true;
+    }
+    FURI_CRITICAL_EXIT();
+    if(resized) return ptr;
+
+    void* new_ptr = seader_arena_malloc(size);
+    if(new_ptr) {
+        memcpy(new_ptr, ptr, old_block);
+        seader_arena_free(ptr);
+    }
+    return new_ptr;
+}
+
+void seader_arena_free(void* ptr) {
+    if(!seader_arena_owns(ptr)) {
+        free(ptr);
+        return;
+    }
+
+    FURI_CRITICAL_ENTER();
+    furi_check(arena_live > 0);
+    arena_live--;
+    if(arena_live == 0) {
+        // End of the transaction, start over from the bottom
+        arena_used = 0;
+    } else if(seader_arena_is_last(ptr)) {
+        arena_used = (uint8_t*)ptr - arena - SEADER_ARENA_HEADER;
+    }
+    FURI_CRITICAL_EXIT();
+}
+
+void seader_arena_get_stats(SeaderArenaStats* stats) {
+    FURI_CRITICAL_ENTER();
+    *stats = arena_stats;
+    FURI_CRITICAL_EXIT();
+}
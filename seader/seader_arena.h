@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bytes of static RAM that serve asn1c structures, 0 sends everything to the heap
+#ifndef SEADER_ARENA_SIZE
+#define SEADER_ARENA_SIZE (2048)
+#endif
+
+/*
+ * Bump allocator behind the asn1c CALLOC/MALLOC/REALLOC/FREEMEM hooks and the message structs in
+ * sam_api.c.
+ *
+ * A SAM transaction allocates a few dozen small blocks and frees all of them before the next one
+ * starts. The arena counts live blocks and rewinds when the last one is freed, so a session
+ * never leaves holes in the Flipper heap. Requests that don't fit fall back to malloc and
+ * pointers outside the arena are passed to free, so mixing the two is safe.
+ */
+typedef struct {
+    size_t size;
+    size_t peak;
+    uint32_t allocs;
+    uint32_t fallbacks;
+} SeaderArenaStats;
+
+void* seader_arena_malloc(size_t size);
+
+void* seader_arena_calloc(size_t count, size_t size);
+
+void* seader_arena_realloc(void* ptr, size_t size);
+
+void seader_arena_free(void* ptr);
+
+void seader_arena_get_stats(SeaderArenaStats* stats);
@@ -9,6 +9,8 @@
 #include <furi.h>
 #include <furi_hal.h>
 
+#include "ccid_framer.h"
+
 #define SEADER_UART_RX_BUF_SIZE (256)
 
 typedef struct {
@@ -38,7 +40,7 @@ struct SeaderUartBridge {
 
     SeaderUartState st;
 
-    uint8_t rx_buf[SEADER_UART_RX_BUF_SIZE];
+    CcidFramer rx_framer;
     uint8_t tx_buf[SEADER_UART_RX_BUF_SIZE];
     size_t tx_len;
 };
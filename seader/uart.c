@@ -56,34 +56,16 @@ void seader_uart_set_baudrate(SeaderUartBridge* seader_uart, uint32_t baudrate)
     }
 }
 
-size_t seader_uart_process_buffer(Seader* seader, uint8_t* cmd, size_t cmd_len) {
+static void seader_uart_process_frames(Seader* seader) {
     SeaderUartBridge* seader_uart = seader->uart;
-    if(cmd_len < 2) {
-        return cmd_len;
-    }
-
-    size_t consumed = 0;
-    do {
-        consumed = seader_ccid_process(seader, cmd, cmd_len);
-
-        if(consumed > 0) {
-            memset(cmd, 0, consumed);
-            cmd_len -= consumed;
-            if(cmd_len > 0) {
-                memmove(cmd, cmd + consumed, cmd_len);
-            }
-            seader_uart->st.rx_cnt += consumed;
+    CcidFramer* framer = &seader_uart->rx_framer;
+    uint8_t* frame;
+    size_t frame_len;
 
-            /*
-            memset(display, 0, SEADER_UART_RX_BUF_SIZE);
-            for (uint8_t i = 0; i < cmd_len; i++) {
-                snprintf(display+(i*2), sizeof(display), "%02x", cmd[i]);
-            }
-            FURI_LOG_I(TAG, "cmd is now %d bytes: %s", cmd_len, display);
-            */
-        }
-    } while(consumed > 0 && cmd_len > 0);
-    return cmd_len;
+    while((frame_len = ccid_framer_next(framer, &frame)) > 0) {
+        seader_ccid_process(seader, frame, frame_len);
+        seader_uart->st.rx_cnt += frame_len;
+    }
 }
 
 int32_t seader_uart_worker(void* context) {
@@ -107,44 +89,31 @@ int32_t seader_uart_worker(void* context) {
 
     furi_thread_start(seader_uart->tx_thread);
 
-    uint8_t cmd[SEADER_UART_RX_BUF_SIZE];
-    size_t cmd_len = 0;
+    CcidFramer* framer = &seader_uart->rx_framer;
+    ccid_framer_reset(framer);
 
     while(1) {
         uint32_t events =
             furi_thread_flags_wait(WORKER_ALL_RX_EVENTS, FuriFlagWaitAny, FuriWaitForever);
         furi_check(!(events & FuriFlagError));
         if(events & WorkerEvtStop) {
-            memset(cmd, 0, cmd_len);
-            cmd_len = 0;
             break;
         }
         if(events & (WorkerEvtRxDone | WorkerEvtSamTxComplete)) {
-            size_t len = furi_stream_buffer_receive(
-                seader_uart->rx_stream, seader_uart->rx_buf, SEADER_UART_RX_BUF_SIZE, 0);
-            if(len > 0) {
-                furi_delay_ms(5); //WTF
-
-                /*
-                char display[SEADER_UART_RX_BUF_SIZE * 2 + 1] = {0};
-                for (uint8_t i = 0; i < len; i++) {
-                    snprintf(display+(i*2), sizeof(display), "%02x", seader_uart->rx_buf[i]);
-                }
-                FURI_LOG_I(TAG, "RECV %d bytes: %s", len, display);
-                */
-
-                if(cmd_len + len > SEADER_UART_RX_BUF_SIZE) {
-                    FURI_LOG_I(TAG, "OVERFLOW: %d + %d", cmd_len, len);
-                    memset(cmd, 0, cmd_len);
-                    cmd_len = 0;
-                }
-
-                memcpy(cmd + cmd_len, seader_uart->rx_buf, len);
-                cmd_len += len;
-                cmd_len = seader_uart_process_buffer(seader, cmd, cmd_len);
+            // Receive straight into the framer, a partial frame stays put until the rest arrives
+            while(1) {
+                size_t space;
+                uint8_t* dst = ccid_framer_write_ptr(framer, &space);
+                size_t len = furi_stream_buffer_receive(seader_uart->rx_stream, dst, space, 0);
+                if(len == 0) break;
+                ccid_framer_commit(framer, len);
+                seader_uart_process_frames(seader);
             }
         }
     }
+    if(framer->dropped || framer->naks) {
+        FURI_LOG_W(TAG, "Dropped %lu bytes, %lu NAKs", framer->dropped, framer->naks);
+    }
     seader_uart_serial_deinit(seader_uart);
 
     furi_thread_flags_set(furi_thread_get_id(seader_uart->tx_thread), WorkerEvtTxStop);
@@ -180,11 +149,6 @@ int32_t seader_uart_tx_thread(void* context) {
         if(events & WorkerEvtTxStop) break;
         if(events & WorkerEvtSamRx) {
             if(seader_uart->tx_len > 0) {
-                char display[SEADER_UART_RX_BUF_SIZE * 2 + 1] = {0};
-                for(uint8_t i = 0; i < seader_uart->tx_len; i++) {
-                    snprintf(display + (i * 2), sizeof(display), "%02x", seader_uart->tx_buf[i]);
-                }
-                // FURI_LOG_I(TAG, "SEND %d bytes: %s", seader_uart->tx_len, display);
                 seader_uart->st.tx_cnt += seader_uart->tx_len;
                 furi_hal_serial_tx(
                     seader_uart->serial_handle, seader_uart->tx_buf, seader_uart->tx_len);
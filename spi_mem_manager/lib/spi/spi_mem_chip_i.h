@@ -50,6 +50,7 @@ typedef enum {
     SPIMemChipCMDReadJEDECChipID = 0x9F,
     SPIMemChipCMDReadData = 0x03,
     SPIMemChipCMDChipErase = 0xC7,
+    SPIMemChipCMDSectorErase = 0x20,
     SPIMemChipCMDWriteEnable = 0x06,
     SPIMemChipCMDWriteDisable = 0x04,
     SPIMemChipCMDReadStatus = 0x05,
@@ -0,0 +1,88 @@
+#include "spi_mem_pipe.h"
+
+struct SPIMemPipe {
+    SPIMemPipeBlock blocks[SPI_MEM_PIPE_BLOCK_COUNT];
+    FuriMessageQueue* to_thread;
+    FuriMessageQueue* from_thread;
+    FuriThread* thread;
+    SPIMemPipeCallback callback;
+    void* context;
+    volatile bool stop;
+    volatile bool failed;
+};
+
+static int32_t spi_mem_pipe_thread(void* thread_context) {
+    SPIMemPipe* pipe = thread_context;
+    SPIMemPipeBlock* block;
+    while(!pipe->stop) {
+        if(furi_message_queue_get(pipe->to_thread, &block, SPI_MEM_PIPE_POLL_TIMEOUT) !=
+           FuriStatusOk)
+            continue;
+        if(!pipe->failed && !pipe->callback(pipe->context, block)) pipe->failed = true;
+        if(pipe->failed) block->size = 0;
+        furi_message_queue_put(pipe->from_thread, &block, FuriWaitForever);
+    }
+    return 0;
+}
+
+SPIMemPipe* spi_mem_pipe_alloc(
+    size_t block_size,
+    bool prime_thread,
+    SPIMemPipeCallback callback,
+    void* context) {
+    SPIMemPipe* pipe = malloc(sizeof(SPIMemPipe));
+    pipe->to_thread = furi_message_queue_alloc(SPI_MEM_PIPE_BLOCK_COUNT, sizeof(SPIMemPipeBlock*));
+    pipe->from_thread =
+        furi_message_queue_alloc(SPI_MEM_PIPE_BLOCK_COUNT, sizeof(SPIMemPipeBlock*));
+    pipe->callback = callback;
+    pipe->context = context;
+    pipe->stop = false;
+    pipe->failed = false;
+    for(size_t i = 0; i < SPI_MEM_PIPE_BLOCK_COUNT; i++) {
+        SPIMemPipeBlock* block = &pipe->blocks[i];
+        block->data = malloc(block_size);
+        block->offset = 0;
+        block->size = 0;
+        furi_message_queue_put(
+            prime_thread ? pipe->to_thread : pipe->from_thread, &block, FuriWaitForever);
+    }
+    pipe->thread = furi_thread_alloc_ex("SPIMemPipe", 2048, spi_mem_pipe_thread, pipe);
+    furi_thread_start(pipe->thread);
+    return pipe;
+}
+
+void spi_mem_pipe_free(SPIMemPipe* pipe) {
+    pipe->stop = true;
+    furi_thread_join(pipe->thread);
+    furi_thread_free(pipe->thread);
+    furi_message_queue_free(pipe->to_thread);
+    furi_message_queue_free(pipe->from_thread);
+    for(size_t i = 0; i < SPI_MEM_PIPE_BLOCK_COUNT; i++) {
+        free(pipe->blocks[i].data);
+    }
+    free(pipe);
+}
+
+SPIMemPipeBlock* spi_mem_pipe_take(SPIMemPipe* pipe, uint32_t timeout) {
+    SPIMemPipeBlock* block;
+    if(furi_message_queue_get(pipe->from_thread, &block, timeout) != FuriStatusOk) return NULL;
+    return block;
+}
+
+void spi_mem_pipe_give(SPIMemPipe* pipe, SPIMemPipeBlock* block) {
+    furi_message_queue_put(pipe->to_thread, &block, FuriWaitForever);
+}
+
+// Waits until pipe thread is done with every block given to it
+bool spi_mem_pipe_flush(SPIMemPipe* pipe, uint32_t timeout) {
+    uint32_t start = furi_get_tick();
+    while(furi_message_queue_get_count(pipe->from_thread) < SPI_MEM_PIPE_BLOCK_COUNT) {
+        if(furi_get_tick() - start > timeout) return false;
+        furi_delay_tick(1);
+    }
+    return !pipe->failed;
+}
+
+bool spi_mem_pipe_is_failed(SPIMemPipe* pipe) {
+    return pipe->failed;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <furi.h>
+
+// Blocks are passed between worker and pipe thread, so SPI transfer of one block
+// and SD card access of another one are running at the same time
+#define SPI_MEM_PIPE_BLOCK_COUNT 2
+#define SPI_MEM_PIPE_POLL_TIMEOUT 100
+#define SPI_MEM_PIPE_FLUSH_TIMEOUT 5000
+
+typedef struct SPIMemPipe SPIMemPipe;
+
+typedef struct {
+    uint8_t* data;
+    size_t offset;
+    size_t size;
+} SPIMemPipeBlock;
+
+// Runs in pipe thread for every block given to it, false stops the pipe
+typedef bool (*SPIMemPipeCallback)(void* context, SPIMemPipeBlock* block);
+
+// With prime_thread all blocks are given to pipe thread first (it produces data),
+// otherwise worker takes empty blocks first (worker produces data)
+SPIMemPipe* spi_mem_pipe_alloc(
+    size_t block_size,
+    bool prime_thread,
+    SPIMemPipeCallback callback,
+    void* context);
+void spi_mem_pipe_free(SPIMemPipe* pipe);
+SPIMemPipeBlock* spi_mem_pipe_take(SPIMemPipe* pipe, uint32_t timeout);
+void spi_mem_pipe_give(SPIMemPipe* pipe, SPIMemPipeBlock* block);
+bool spi_mem_pipe_flush(SPIMemPipe* pipe, uint32_t timeout);
+bool spi_mem_pipe_is_failed(SPIMemPipe* pipe);
@@ -0,0 +1,208 @@
+#include "spi_mem_chip_i.h"
+#include "spi_mem_sim.h"
+
+#define SPI_MEM_SIM_ADDRESS_SIZE 3
+#define SPI_MEM_SIM_SECTOR_SIZE 4096
+#define SPI_MEM_SIM_BLOCK_SIZE 65536
+
+#define SPI_MEM_SIM_CMD_FAST_READ 0x0B
+#define SPI_MEM_SIM_CMD_BLOCK_ERASE 0xD8
+#define SPI_MEM_SIM_CMD_CHIP_ERASE_ALT 0x60
+
+struct SPIMemSim {
+    const SPIMemChip* chip;
+    uint8_t* data;
+    bool write_enabled;
+    uint32_t busy_polls_left;
+    SPIMemSimStats stats;
+    SPIMemTransport transport;
+};
+
+static bool spi_mem_sim_trx(
+    void* context,
+    uint8_t cmd,
+    const uint8_t* address,
+    size_t address_size,
+    const uint8_t* tx,
+    size_t tx_size,
+    uint8_t* rx,
+    size_t rx_size);
+
+SPIMemSim* spi_mem_sim_alloc(const char* model_name) {
+    const SPIMemChip* chip;
+    for(chip = SPIMemChips; chip->model_name != NULL; chip++) {
+        if(!strcmp(chip->model_name, model_name)) break;
+    }
+    if(chip->model_name == NULL) return NULL;
+    SPIMemSim* sim = malloc(sizeof(SPIMemSim));
+    memset(sim, 0, sizeof(SPIMemSim));
+    sim->chip = chip;
+    sim->data = malloc(chip->size);
+    memset(sim->data, 0xFF, chip->size);
+    sim->transport.trx = spi_mem_sim_trx;
+    sim->transport.context = sim;
+    return sim;
+}
+
+void spi_mem_sim_free(SPIMemSim* sim) {
+    free(sim->data);
+    free(sim);
+}
+
+const SPIMemTransport* spi_mem_sim_get_transport(SPIMemSim* sim) {
+    return &sim->transport;
+}
+
+uint8_t* spi_mem_sim_get_data(SPIMemSim* sim) {
+    return sim->data;
+}
+
+size_t spi_mem_sim_get_size(SPIMemSim* sim) {
+    return sim->chip->size;
+}
+
+const SPIMemSimStats* spi_mem_sim_get_stats(SPIMemSim* sim) {
+    return &sim->stats;
+}
+
+void spi_mem_sim_reset_stats(SPIMemSim* sim) {
+    memset(&sim->stats, 0, sizeof(SPIMemSimStats));
+}
+
+static size_t spi_mem_sim_get_address(const uint8_t* address, size_t address_size) {
+    size_t addr = 0;
+    for(size_t i = 0; i < address_size; i++) {
+        addr = (addr << 8) | address[i];
+    }
+    return addr;
+}
+
+static void spi_mem_sim_read(SPIMemSim* sim, size_t addr, uint8_t* rx, size_t rx_size) {
+    // Read wraps around the end of the chip like real parts do
+    for(size_t i = 0; i < rx_size; i++) {
+        rx[i] = sim->data[(addr + i) % sim->chip->size];
+    }
+    sim->stats.bytes_read += rx_size;
+}
+
+static void
+    spi_mem_sim_program(SPIMemSim* sim, size_t addr, const uint8_t* tx, size_t tx_size) {
+    size_t page_size = sim->chip->page_size;
+    size_t page_start = addr - (addr % page_size);
+    // Only last page_size bytes are latched, address wraps inside the page
+    if(tx_size > page_size) {
+        tx += tx_size - page_size;
+        addr += tx_size - page_size;
+        tx_size = page_size;
+    }
+    for(size_t i = 0; i < tx_size; i++) {
+        size_t page_offset = (addr + i - page_start) % page_size;
+        // Programming can only clear bits
+        sim->data[page_start + page_offset] &= tx[i];
+    }
+    sim->stats.bytes_programmed += tx_size;
+    sim->stats.pages_programmed++;
+    sim->busy_polls_left = SPI_MEM_SIM_PAGE_PROGRAM_POLLS;
+}
+
+static void spi_mem_sim_erase(SPIMemSim* sim, size_t addr, size_t size) {
+    size_t start = addr - (addr % size);
+    memset(sim->data + start, 0xFF, size);
+}
+
+static bool spi_mem_sim_trx(
+    void* context,
+    uint8_t cmd,
+    const uint8_t* address,
+    size_t address_size,
+    const uint8_t* tx,
+    size_t tx_size,
+    uint8_t* rx,
+    size_t rx_size) {
+    SPIMemSim* sim = context;
+    size_t addr = 0;
+    if(address) addr = spi_mem_sim_get_address(address, address_size) % sim->chip->size;
+
+    if(cmd == SPIMemChipCMDReadStatus) {
+        uint8_t status = 0;
+        if(sim->busy_polls_left) {
+            status |= SPIMemChipStatusBitBusy;
+            sim->busy_polls_left--;
+            sim->stats.busy_polls++;
+        }
+        if(sim->write_enabled) status |= SPIMemChipStatusBitWriteEnabled;
+        // Status is sent repeatedly while chip select is held
+        if(rx) memset(rx, status, rx_size);
+        return true;
+    }
+
+    // Everything else except status read is ignored while chip is busy
+    if(sim->busy_polls_left) {
+        sim->stats.rejected_commands++;
+        if(rx) memset(rx, 0xFF, rx_size);
+        return true;
+    }
+
+    switch(cmd) {
+    case SPIMemChipCMDReadJEDECChipID:
+        if(rx) {
+            uint8_t id[3] = {sim->chip->vendor_id, sim->chip->type_id, sim->chip->capacity_id};
+            for(size_t i = 0; i < rx_size; i++) {
+                rx[i] = i < 3 ? id[i] : 0;
+            }
+        }
+        break;
+    case SPIMemChipCMDReadData:
+        if(rx && address_size == SPI_MEM_SIM_ADDRESS_SIZE) spi_mem_sim_read(sim, addr, rx, rx_size);
+        break;
+    case SPI_MEM_SIM_CMD_FAST_READ:
+        // First byte after address is dummy
+        if(rx && rx_size && address_size == SPI_MEM_SIM_ADDRESS_SIZE) {
+            rx[0] = 0xFF;
+            spi_mem_sim_read(sim, addr, rx + 1, rx_size - 1);
+        }
+        break;
+    case SPIMemChipCMDWriteEnable:
+        sim->write_enabled = true;
+        break;
+    case SPIMemChipCMDWriteDisable:
+        sim->write_enabled = false;
+        break;
+    case SPIMemChipCMDWriteData:
+    case SPIMemChipCMDSectorErase:
+    case SPI_MEM_SIM_CMD_BLOCK_ERASE:
+    case SPIMemChipCMDChipErase:
+    case SPI_MEM_SIM_CMD_CHIP_ERASE_ALT:
+        if(!sim->write_enabled) {
+            sim->stats.rejected_commands++;
+            break;
+        }
+        if(cmd == SPIMemChipCMDWriteData) {
+            if(address_size != SPI_MEM_SIM_ADDRESS_SIZE || !tx || !tx_size) break;
+            spi_mem_sim_program(sim, addr, tx, tx_size);
+        } else if(cmd == SPIMemChipCMDSectorErase) {
+            if(address_size != SPI_MEM_SIM_ADDRESS_SIZE) break;
+            spi_mem_sim_erase(sim, addr, MIN((size_t)SPI_MEM_SIM_SECTOR_SIZE, sim->chip->size));
+            sim->stats.sectors_erased++;
+            sim->busy_polls_left = SPI_MEM_SIM_SECTOR_ERASE_POLLS;
+        } else if(cmd == SPI_MEM_SIM_CMD_BLOCK_ERASE) {
+            if(address_size != SPI_MEM_SIM_ADDRESS_SIZE) break;
+            spi_mem_sim_erase(sim, addr, MIN((size_t)SPI_MEM_SIM_BLOCK_SIZE, sim->chip->size));
+            sim->stats.blocks_erased++;
+            sim->busy_polls_left = SPI_MEM_SIM_BLOCK_ERASE_POLLS;
+        } else {
+            spi_mem_sim_erase(sim, 0, sim->chip->size);
+            sim->stats.chips_erased++;
+            sim->busy_polls_left = SPI_MEM_SIM_CHIP_ERASE_POLLS;
+        }
+        // Chip resets write enable latch after every program/erase
+        sim->write_enabled = false;
+        break;
+    case SPIMemChipCMDReleasePowerDown:
+        break;
+    default:
+        if(rx) memset(rx, 0xFF, rx_size);
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "spi_mem_transport.h"
+
+// Simulated JEDEC NOR flash, chip geometry is taken from SPIMemChips by model name.
+// Lets read/verify/write pipelines run without hardware, memory of the whole chip is
+// allocated on heap, so it's meant for host builds and small chips on device
+
+// Busy time is counted in status register reads
+#define SPI_MEM_SIM_PAGE_PROGRAM_POLLS (2)
+#define SPI_MEM_SIM_SECTOR_ERASE_POLLS (8)
+#define SPI_MEM_SIM_BLOCK_ERASE_POLLS (16)
+#define SPI_MEM_SIM_CHIP_ERASE_POLLS (64)
+
+typedef struct SPIMemSim SPIMemSim;
+
+typedef struct {
+    size_t bytes_read;
+    size_t bytes_programmed;
+    uint32_t pages_programmed;
+    uint32_t sectors_erased;
+    uint32_t blocks_erased;
+    uint32_t chips_erased;
+    uint32_t busy_polls;
+    uint32_t rejected_commands; // commands ignored because chip was busy or not write enabled
+} SPIMemSimStats;
+
+/**
+ * Allocates simulated chip, contents are erased (0xFF)
+ * @return NULL if model_name is not in chip DB
+ */
+SPIMemSim* spi_mem_sim_alloc(const char* model_name);
+
+void spi_mem_sim_free(SPIMemSim* sim);
+
+/** Transport for spi_mem_tools_set_transport, valid until sim is freed */
+const SPIMemTransport* spi_mem_sim_get_transport(SPIMemSim* sim);
+
+uint8_t* spi_mem_sim_get_data(SPIMemSim* sim);
+size_t spi_mem_sim_get_size(SPIMemSim* sim);
+const SPIMemSimStats* spi_mem_sim_get_stats(SPIMemSim* sim);
+void spi_mem_sim_reset_stats(SPIMemSim* sim);
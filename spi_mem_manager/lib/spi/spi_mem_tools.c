@@ -1,5 +1,3 @@
-#include <furi_hal.h>
-#include <furi_hal_spi_config.h>
 #include "spi_mem_chip_i.h"
 #include "spi_mem_tools.h"
 
@@ -11,52 +9,34 @@ static uint8_t spi_mem_tools_addr_to_byte_arr(uint32_t addr, uint8_t* cmd) {
     return len;
 }
 
+static const SPIMemTransport* spi_mem_tools_transport = &spi_mem_transport_external;
+
+void spi_mem_tools_set_transport(const SPIMemTransport* transport) {
+    spi_mem_tools_transport = transport ? transport : &spi_mem_transport_external;
+}
+
 static bool spi_mem_tools_trx(
     SPIMemChipCMD cmd,
     uint8_t* tx_buf,
     size_t tx_size,
     uint8_t* rx_buf,
     size_t rx_size) {
-    bool success = false;
-    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
-    do {
-        if(!furi_hal_spi_bus_tx(
-               &furi_hal_spi_bus_handle_external, (uint8_t*)&cmd, 1, SPI_MEM_SPI_TIMEOUT))
-            break;
-        if(tx_buf) {
-            if(!furi_hal_spi_bus_tx(
-                   &furi_hal_spi_bus_handle_external, tx_buf, tx_size, SPI_MEM_SPI_TIMEOUT))
-                break;
-        }
-        if(rx_buf) {
-            if(!furi_hal_spi_bus_rx(
-                   &furi_hal_spi_bus_handle_external, rx_buf, rx_size, SPI_MEM_SPI_TIMEOUT))
-                break;
-        }
-        success = true;
-    } while(0);
-    furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
-    return success;
+    return spi_mem_tools_transport->trx(
+        spi_mem_tools_transport->context, cmd, tx_buf, tx_size, NULL, 0, rx_buf, rx_size);
 }
 
 static bool spi_mem_tools_write_buffer(uint8_t* data, size_t size, size_t offset) {
-    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
-    uint8_t cmd = (uint8_t)SPIMemChipCMDWriteData;
     uint8_t address[4];
     uint8_t address_size = spi_mem_tools_addr_to_byte_arr(offset, address);
-    bool success = false;
-    do {
-        if(!furi_hal_spi_bus_tx(&furi_hal_spi_bus_handle_external, &cmd, 1, SPI_MEM_SPI_TIMEOUT))
-            break;
-        if(!furi_hal_spi_bus_tx(
-               &furi_hal_spi_bus_handle_external, address, address_size, SPI_MEM_SPI_TIMEOUT))
-            break;
-        if(!furi_hal_spi_bus_tx(&furi_hal_spi_bus_handle_external, data, size, SPI_MEM_SPI_TIMEOUT))
-            break;
-        success = true;
-    } while(0);
-    furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
-    return success;
+    return spi_mem_tools_transport->trx(
+        spi_mem_tools_transport->context,
+        SPIMemChipCMDWriteData,
+        address,
+        address_size,
+        data,
+        size,
+        NULL,
+        0);
 }
 
 bool spi_mem_tools_read_chip_info(SPIMemChip* chip) {
@@ -74,8 +54,8 @@ bool spi_mem_tools_read_chip_info(SPIMemChip* chip) {
 
 bool spi_mem_tools_check_chip_info(SPIMemChip* chip) {
     SPIMemChip new_chip_info;
-    spi_mem_tools_read_chip_info(&new_chip_info);
     do {
+        if(!spi_mem_tools_read_chip_info(&new_chip_info)) break;
         if(chip->vendor_id != new_chip_info.vendor_id) break;
         if(chip->type_id != new_chip_info.type_id) break;
         if(chip->capacity_id != new_chip_info.capacity_id) break;
@@ -85,21 +65,16 @@ bool spi_mem_tools_check_chip_info(SPIMemChip* chip) {
 }
 
 bool spi_mem_tools_read_block(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
+    uint8_t cmd[4];
     if(!spi_mem_tools_check_chip_info(chip)) return false;
-    for(size_t i = 0; i < block_size; i += SPI_MEM_MAX_BLOCK_SIZE) {
-        uint8_t cmd[4];
-        if((offset + SPI_MEM_MAX_BLOCK_SIZE) > chip->size) return false;
-        if(!spi_mem_tools_trx(
-               SPIMemChipCMDReadData,
-               cmd,
-               spi_mem_tools_addr_to_byte_arr(offset, cmd),
-               data,
-               SPI_MEM_MAX_BLOCK_SIZE))
-            return false;
-        offset += SPI_MEM_MAX_BLOCK_SIZE;
-        data += SPI_MEM_MAX_BLOCK_SIZE;
-    }
-    return true;
+    if((offset + block_size) > chip->size) return false;
+    // Read command keeps going over page boundaries, so whole block is one transfer
+    return spi_mem_tools_trx(
+        SPIMemChipCMDReadData,
+        cmd,
+        spi_mem_tools_addr_to_byte_arr(offset, cmd),
+        data,
+        block_size);
 }
 
 size_t spi_mem_tools_get_file_max_block_size(SPIMemChip* chip) {
@@ -140,6 +115,24 @@ bool spi_mem_tools_erase_chip(SPIMemChip* chip) {
     return true;
 }
 
+bool spi_mem_tools_erase_sector(SPIMemChip* chip, size_t offset) {
+    uint8_t cmd[4];
+    do {
+        if(!spi_mem_tools_check_chip_info(chip)) break;
+        if((offset + SPI_MEM_SECTOR_SIZE) > chip->size) break;
+        if(!spi_mem_tools_set_write_enabled(chip, true)) break;
+        if(!spi_mem_tools_trx(
+               SPIMemChipCMDSectorErase,
+               cmd,
+               spi_mem_tools_addr_to_byte_arr(offset, cmd),
+               NULL,
+               0))
+            break;
+        return true;
+    } while(0);
+    return false;
+}
+
 bool spi_mem_tools_write_bytes(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
     do {
         if(!spi_mem_tools_check_chip_info(chip)) break;
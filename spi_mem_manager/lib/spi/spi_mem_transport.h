@@ -0,0 +1,22 @@
+#pragma once
+
+#include <furi.h>
+
+// Bus used by spi_mem_tools, external SPI by default. Any other backend
+// (like spi_mem_sim) can be plugged in with spi_mem_tools_set_transport
+typedef struct {
+    // One chip select cycle: command byte, address bytes, data to chip, data from chip.
+    // address, tx and rx are optional
+    bool (*trx)(
+        void* context,
+        uint8_t cmd,
+        const uint8_t* address,
+        size_t address_size,
+        const uint8_t* tx,
+        size_t tx_size,
+        uint8_t* rx,
+        size_t rx_size);
+    void* context;
+} SPIMemTransport;
+
+extern const SPIMemTransport spi_mem_transport_external;
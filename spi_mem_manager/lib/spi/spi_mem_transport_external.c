@@ -0,0 +1,48 @@
+#include <furi_hal.h>
+#include <furi_hal_spi_config.h>
+#include "spi_mem_transport.h"
+#include "spi_mem_tools.h"
+
+static bool spi_mem_transport_external_trx(
+    void* context,
+    uint8_t cmd,
+    const uint8_t* address,
+    size_t address_size,
+    const uint8_t* tx,
+    size_t tx_size,
+    uint8_t* rx,
+    size_t rx_size) {
+    UNUSED(context);
+    bool success = false;
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
+    do {
+        if(!furi_hal_spi_bus_tx(&furi_hal_spi_bus_handle_external, &cmd, 1, SPI_MEM_SPI_TIMEOUT))
+            break;
+        if(address) {
+            if(!furi_hal_spi_bus_tx(
+                   &furi_hal_spi_bus_handle_external,
+                   (uint8_t*)address,
+                   address_size,
+                   SPI_MEM_SPI_TIMEOUT))
+                break;
+        }
+        if(tx) {
+            if(!furi_hal_spi_bus_tx(
+                   &furi_hal_spi_bus_handle_external, (uint8_t*)tx, tx_size, SPI_MEM_SPI_TIMEOUT))
+                break;
+        }
+        if(rx) {
+            if(!furi_hal_spi_bus_rx(
+                   &furi_hal_spi_bus_handle_external, rx, rx_size, SPI_MEM_SPI_TIMEOUT))
+                break;
+        }
+        success = true;
+    } while(0);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
+    return success;
+}
+
+const SPIMemTransport spi_mem_transport_external = {
+    .trx = spi_mem_transport_external_trx,
+    .context = NULL,
+};
@@ -52,3 +52,8 @@ void spi_mem_worker_write_start(
     SPIMemWorker* worker,
     SPIMemWorkerCallback callback,
     void* context);
+void spi_mem_worker_smart_write_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context);
@@ -8,7 +8,8 @@ typedef enum {
     SPIMemWorkerModeRead,
     SPIMemWorkerModeVerify,
     SPIMemWorkerModeErase,
-    SPIMemWorkerModeWrite
+    SPIMemWorkerModeWrite,
+    SPIMemWorkerModeSmartWrite
 } SPIMemWorkerMode;
 
 struct SPIMemWorker {
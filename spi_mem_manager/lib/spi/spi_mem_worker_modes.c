@@ -1,6 +1,7 @@
 #include "spi_mem_worker_i.h"
 #include "spi_mem_chip.h"
 #include "spi_mem_tools.h"
+#include "spi_mem_pipe.h"
 #include "../../spi_mem_files.h"
 
 static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker);
@@ -8,6 +9,7 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker);
 static void spi_mem_worker_verify_process(SPIMemWorker* worker);
 static void spi_mem_worker_erase_process(SPIMemWorker* worker);
 static void spi_mem_worker_write_process(SPIMemWorker* worker);
+static void spi_mem_worker_smart_write_process(SPIMemWorker* worker);
 
 const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeIdle] = {.process = NULL},
@@ -15,7 +17,8 @@ const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeRead] = {.process = spi_mem_worker_read_process},
     [SPIMemWorkerModeVerify] = {.process = spi_mem_worker_verify_process},
     [SPIMemWorkerModeErase] = {.process = spi_mem_worker_erase_process},
-    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process}};
+    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process},
+    [SPIMemWorkerModeSmartWrite] = {.process = spi_mem_worker_smart_write_process}};
 
 static void spi_mem_worker_run_callback(SPIMemWorker* worker, SPIMemCustomEventWorker event) {
     if(worker->callback) {
@@ -25,12 +28,11 @@ static void spi_mem_worker_run_callback(SPIMemWorker* worker, SPIMemCustomEventW
 
 static bool spi_mem_worker_await_chip_busy(SPIMemWorker* worker) {
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
         if(spi_mem_worker_check_for_stop(worker)) return true;
         SPIMemChipStatus chip_status = spi_mem_tools_get_chip_status(worker->chip_info);
         if(chip_status == SPIMemChipStatusError) return false;
-        if(chip_status == SPIMemChipStatusBusy) continue;
-        return true;
+        if(chip_status == SPIMemChipStatusIdle) return true;
+        furi_delay_tick(1); // page program is done in about 1ms, don't wait longer than needed
     }
 }
 
@@ -42,6 +44,28 @@ static size_t spi_mem_worker_modes_get_total_size(SPIMemWorker* worker) {
     return total_size;
 }
 
+// File access, runs in pipe thread while worker is busy with SPI
+typedef struct {
+    SPIMemWorker* worker;
+    size_t offset;
+    size_t total_size;
+} SPIMemWorkerFileReader;
+
+static bool spi_mem_worker_file_write_callback(void* context, SPIMemPipeBlock* block) {
+    SPIMemWorker* worker = context;
+    return spi_mem_file_write_block(worker->cb_ctx, block->data, block->size);
+}
+
+static bool spi_mem_worker_file_read_callback(void* context, SPIMemPipeBlock* block) {
+    SPIMemWorkerFileReader* reader = context;
+    block->offset = reader->offset;
+    block->size = MIN((size_t)SPI_MEM_FILE_BUFFER_SIZE, reader->total_size - reader->offset);
+    if(!block->size) return true; // end of file
+    if(!spi_mem_file_read_block(reader->worker->cb_ctx, block->data, block->size)) return false;
+    reader->offset += block->size;
+    return true;
+}
+
 // ChipDetect
 static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
     SPIMemCustomEventWorker event;
@@ -59,28 +83,35 @@ static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
 
 // Read
 static bool spi_mem_worker_read(SPIMemWorker* worker, SPIMemCustomEventWorker* event) {
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
     size_t offset = 0;
     bool success = true;
+    SPIMemPipe* pipe = spi_mem_pipe_alloc(
+        SPI_MEM_FILE_BUFFER_SIZE, false, spi_mem_worker_file_write_callback, worker);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
-        if(offset >= chip_size) break;
-        if((offset + block_size) > chip_size) block_size = chip_size - offset;
-        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer, block_size)) {
-            *event = SPIMemCustomEventWorkerChipFail;
+        if(offset >= chip_size) {
+            success = spi_mem_pipe_flush(pipe, SPI_MEM_PIPE_FLUSH_TIMEOUT);
+            break;
+        }
+        SPIMemPipeBlock* block = spi_mem_pipe_take(pipe, SPI_MEM_PIPE_POLL_TIMEOUT);
+        if(!block) continue; // both blocks are still being written to SD
+        if(spi_mem_pipe_is_failed(pipe)) {
             success = false;
             break;
         }
-        if(!spi_mem_file_write_block(worker->cb_ctx, data_buffer, block_size)) {
+        block->offset = offset;
+        block->size = MIN((size_t)SPI_MEM_FILE_BUFFER_SIZE, chip_size - offset);
+        if(!spi_mem_tools_read_block(worker->chip_info, offset, block->data, block->size)) {
+            *event = SPIMemCustomEventWorkerChipFail;
             success = false;
             break;
         }
-        offset += block_size;
+        spi_mem_pipe_give(pipe, block);
+        offset += block->size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_pipe_free(pipe);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -99,33 +130,36 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker) {
 // Verify
 static bool
     spi_mem_worker_verify(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
-    uint8_t data_buffer_chip[SPI_MEM_FILE_BUFFER_SIZE];
-    uint8_t data_buffer_file[SPI_MEM_FILE_BUFFER_SIZE];
-    size_t offset = 0;
+    uint8_t* data_buffer_chip = malloc(SPI_MEM_FILE_BUFFER_SIZE);
+    SPIMemWorkerFileReader reader = {.worker = worker, .offset = 0, .total_size = total_size};
     bool success = true;
+    SPIMemPipe* pipe = spi_mem_pipe_alloc(
+        SPI_MEM_FILE_BUFFER_SIZE, true, spi_mem_worker_file_read_callback, &reader);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
-        if(offset >= total_size) break;
-        if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer_chip, block_size)) {
-            *event = SPIMemCustomEventWorkerChipFail;
+        SPIMemPipeBlock* block = spi_mem_pipe_take(pipe, SPI_MEM_PIPE_POLL_TIMEOUT);
+        if(!block) continue; // file block isn't read yet
+        if(spi_mem_pipe_is_failed(pipe)) {
             success = false;
             break;
         }
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer_file, block_size)) {
+        if(!block->size) break;
+        if(!spi_mem_tools_read_block(
+               worker->chip_info, block->offset, data_buffer_chip, block->size)) {
+            *event = SPIMemCustomEventWorkerChipFail;
             success = false;
             break;
         }
-        if(memcmp(data_buffer_chip, data_buffer_file, block_size) != 0) {
+        if(memcmp(data_buffer_chip, block->data, block->size) != 0) {
             *event = SPIMemCustomEventWorkerVerifyFail;
             success = false;
             break;
         }
-        offset += block_size;
+        spi_mem_pipe_give(pipe, block);
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_pipe_free(pipe);
+    free(data_buffer_chip);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -162,39 +196,41 @@ static bool spi_mem_worker_write_block_by_page(
     size_t block_size,
     size_t page_size) {
     for(size_t i = 0; i < block_size; i += page_size) {
+        size_t write_size = MIN(page_size, block_size - i);
         if(!spi_mem_worker_await_chip_busy(worker)) return false;
-        if(!spi_mem_tools_write_bytes(worker->chip_info, offset, data, page_size)) return false;
-        offset += page_size;
-        data += page_size;
+        if(!spi_mem_tools_write_bytes(worker->chip_info, offset, data, write_size)) return false;
+        offset += write_size;
+        data += write_size;
     }
     return true;
 }
 
 static bool
     spi_mem_worker_write(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
-    bool success = true;
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
-    size_t offset = 0;
+    SPIMemWorkerFileReader reader = {.worker = worker, .offset = 0, .total_size = total_size};
+    bool success = true;
+    SPIMemPipe* pipe = spi_mem_pipe_alloc(
+        SPI_MEM_FILE_BUFFER_SIZE, true, spi_mem_worker_file_read_callback, &reader);
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
-        if(offset >= total_size) break;
-        if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer, block_size)) {
+        SPIMemPipeBlock* block = spi_mem_pipe_take(pipe, SPI_MEM_PIPE_POLL_TIMEOUT);
+        if(!block) continue; // file block isn't read yet
+        if(spi_mem_pipe_is_failed(pipe)) {
             *event = SPIMemCustomEventWorkerFileFail;
             success = false;
             break;
         }
+        if(!block->size) break;
         if(!spi_mem_worker_write_block_by_page(
-               worker, offset, data_buffer, block_size, page_size)) {
+               worker, block->offset, block->data, block->size, page_size)) {
             success = false;
             break;
         }
-        offset += block_size;
+        spi_mem_pipe_give(pipe, block);
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_pipe_free(pipe);
     return success;
 }
 
@@ -212,3 +248,143 @@ static void spi_mem_worker_write_process(SPIMemWorker* worker) {
     spi_mem_file_close(worker->cb_ctx);
     spi_mem_worker_run_callback(worker, event);
 }
+
+// SmartWrite
+typedef enum {
+    SPIMemWorkerSectorSame,
+    SPIMemWorkerSectorProgram, // only 1 -> 0 bit changes, no erase needed
+    SPIMemWorkerSectorErase,
+} SPIMemWorkerSectorState;
+
+static SPIMemWorkerSectorState
+    spi_mem_worker_compare_sector(const uint8_t* chip_data, const uint8_t* file_data, size_t size) {
+    SPIMemWorkerSectorState state = SPIMemWorkerSectorSame;
+    for(size_t i = 0; i < size; i++) {
+        if(chip_data[i] == file_data[i]) continue;
+        if((chip_data[i] & file_data[i]) != file_data[i]) return SPIMemWorkerSectorErase;
+        state = SPIMemWorkerSectorProgram;
+    }
+    return state;
+}
+
+static bool spi_mem_worker_page_is_blank(const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if(data[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+// Programs only pages which differ from what is on chip now (all 0xFF after erase)
+static bool spi_mem_worker_program_sector(
+    SPIMemWorker* worker,
+    size_t offset,
+    uint8_t* chip_data,
+    uint8_t* file_data,
+    size_t size,
+    size_t page_size,
+    bool erased) {
+    for(size_t i = 0; i < size; i += page_size) {
+        size_t write_size = MIN(page_size, size - i);
+        if(erased ? spi_mem_worker_page_is_blank(&file_data[i], write_size) :
+                    memcmp(&chip_data[i], &file_data[i], write_size) == 0)
+            continue;
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_tools_write_bytes(worker->chip_info, offset + i, &file_data[i], write_size))
+            return false;
+    }
+    return spi_mem_worker_await_chip_busy(worker);
+}
+
+static bool spi_mem_worker_smart_write(
+    SPIMemWorker* worker,
+    size_t total_size,
+    SPIMemCustomEventWorker* event) {
+    uint8_t* chip_data = malloc(SPI_MEM_SECTOR_SIZE);
+    size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
+    size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
+    SPIMemWorkerFileReader reader = {.worker = worker, .offset = 0, .total_size = total_size};
+    bool success = true;
+    // File blocks are the same size as sectors, so every block is one sector
+    SPIMemPipe* pipe = spi_mem_pipe_alloc(
+        SPI_MEM_SECTOR_SIZE, true, spi_mem_worker_file_read_callback, &reader);
+    while(true) {
+        if(spi_mem_worker_check_for_stop(worker)) break;
+        SPIMemPipeBlock* block = spi_mem_pipe_take(pipe, SPI_MEM_PIPE_POLL_TIMEOUT);
+        if(!block) continue; // file block isn't read yet
+        if(spi_mem_pipe_is_failed(pipe)) {
+            *event = SPIMemCustomEventWorkerFileFail;
+            success = false;
+            break;
+        }
+        if(!block->size) break;
+        if(!spi_mem_tools_read_block(worker->chip_info, block->offset, chip_data, block->size)) {
+            success = false;
+            break;
+        }
+        SPIMemWorkerSectorState state =
+            spi_mem_worker_compare_sector(chip_data, block->data, block->size);
+        if(state != SPIMemWorkerSectorSame) {
+            bool erase = state == SPIMemWorkerSectorErase;
+            if(erase) {
+                // Tail of last sector isn't part of file, keep it as it was
+                if(block->size < SPI_MEM_SECTOR_SIZE) {
+                    size_t sector_size =
+                        MIN((size_t)SPI_MEM_SECTOR_SIZE, chip_size - block->offset);
+                    if(!spi_mem_tools_read_block(
+                           worker->chip_info, block->offset, chip_data, sector_size)) {
+                        success = false;
+                        break;
+                    }
+                    memcpy(
+                        &block->data[block->size],
+                        &chip_data[block->size],
+                        sector_size - block->size);
+                    block->size = sector_size;
+                }
+                if(!spi_mem_worker_await_chip_busy(worker)) {
+                    success = false;
+                    break;
+                }
+                if(!spi_mem_tools_erase_sector(worker->chip_info, block->offset)) {
+                    success = false;
+                    break;
+                }
+            }
+            if(!spi_mem_worker_program_sector(
+                   worker, block->offset, chip_data, block->data, block->size, page_size, erase)) {
+                success = false;
+                break;
+            }
+            // Only changed sectors are read back, the rest was just compared with file
+            if(!spi_mem_tools_read_block(
+                   worker->chip_info, block->offset, chip_data, block->size)) {
+                success = false;
+                break;
+            }
+            if(memcmp(chip_data, block->data, block->size) != 0) {
+                *event = SPIMemCustomEventWorkerVerifyFail;
+                success = false;
+                break;
+            }
+        }
+        spi_mem_pipe_give(pipe, block);
+        spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
+    }
+    spi_mem_pipe_free(pipe);
+    free(chip_data);
+    return success;
+}
+
+static void spi_mem_worker_smart_write_process(SPIMemWorker* worker) {
+    SPIMemCustomEventWorker event = SPIMemCustomEventWorkerChipFail;
+    size_t total_size =
+        spi_mem_worker_modes_get_total_size(worker); // need to be executed before opening file
+    do {
+        if(!spi_mem_file_open(worker->cb_ctx)) break;
+        if(!spi_mem_worker_await_chip_busy(worker)) break;
+        if(!spi_mem_worker_smart_write(worker, total_size, &event)) break;
+        event = SPIMemCustomEventWorkerDone;
+    } while(0);
+    spi_mem_file_close(worker->cb_ctx);
+    spi_mem_worker_run_callback(worker, event);
+}
@@ -0,0 +1,253 @@
+#include "furi_host.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+volatile uint32_t host_delay_ticks = 0;
+
+uint64_t host_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+uint32_t furi_get_tick(void) {
+    static uint64_t start = 0;
+    if(!start) start = host_time_ns();
+    return (host_time_ns() - start) / 1000000;
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    __atomic_add_fetch(&host_delay_ticks, ticks, __ATOMIC_RELAXED);
+    sched_yield();
+}
+
+static void host_deadline(struct timespec* ts, uint32_t timeout_ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout_ms / 1000;
+    ts->tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if(ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+// Waits on cond, false once timeout has passed
+static bool host_cond_wait(
+    pthread_cond_t* cond,
+    pthread_mutex_t* mutex,
+    const struct timespec* deadline,
+    uint32_t timeout) {
+    if(timeout == 0) return false;
+    if(timeout == FuriWaitForever) {
+        pthread_cond_wait(cond, mutex);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, mutex, deadline) == 0;
+}
+
+/* Threads */
+
+struct FuriThread {
+    pthread_t handle;
+    FuriThreadCallback callback;
+    void* context;
+    bool started;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t flags;
+};
+
+static __thread FuriThread* host_current_thread = NULL;
+
+FuriThread* furi_thread_alloc(void) {
+    FuriThread* thread = calloc(1, sizeof(FuriThread));
+    pthread_mutex_init(&thread->mutex, NULL);
+    pthread_cond_init(&thread->cond, NULL);
+    return thread;
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, name);
+    furi_thread_set_stack_size(thread, stack_size);
+    furi_thread_set_callback(thread, callback);
+    furi_thread_set_context(thread, context);
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    furi_check(!thread->started);
+    pthread_mutex_destroy(&thread->mutex);
+    pthread_cond_destroy(&thread->cond);
+    free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+static void* host_thread_body(void* arg) {
+    FuriThread* thread = arg;
+    host_current_thread = thread;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    furi_check(thread->callback);
+    thread->flags = 0;
+    thread->started = true;
+    furi_check(pthread_create(&thread->handle, NULL, host_thread_body, thread) == 0);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if(thread->started) pthread_join(thread->handle, NULL);
+    thread->started = false;
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    pthread_mutex_lock(&thread_id->mutex);
+    thread_id->flags |= flags;
+    uint32_t ret = thread_id->flags;
+    pthread_cond_broadcast(&thread_id->cond);
+    pthread_mutex_unlock(&thread_id->mutex);
+    return ret;
+}
+
+uint32_t furi_thread_flags_get(void) {
+    FuriThread* thread = host_current_thread;
+    if(!thread) return 0;
+    pthread_mutex_lock(&thread->mutex);
+    uint32_t flags = thread->flags;
+    pthread_mutex_unlock(&thread->mutex);
+    return flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    UNUSED(options); // only FuriFlagWaitAny is used
+    FuriThread* thread = host_current_thread;
+    furi_check(thread);
+
+    struct timespec deadline;
+    host_deadline(&deadline, timeout);
+    uint32_t ret = FuriFlagErrorTimeout;
+    pthread_mutex_lock(&thread->mutex);
+    while(true) {
+        if(thread->flags & flags) {
+            ret = thread->flags & flags;
+            thread->flags &= ~ret;
+            break;
+        }
+        if(!host_cond_wait(&thread->cond, &thread->mutex, &deadline, timeout)) {
+            if(thread->flags & flags) continue;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&thread->mutex);
+    return ret;
+}
+
+/* Message queues */
+
+struct FuriMessageQueue {
+    uint8_t* buf;
+    uint32_t msg_count;
+    uint32_t msg_size;
+    uint32_t head;
+    uint32_t count;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* instance = calloc(1, sizeof(FuriMessageQueue));
+    instance->buf = calloc(msg_count, msg_size);
+    instance->msg_count = msg_count;
+    instance->msg_size = msg_size;
+    pthread_mutex_init(&instance->mutex, NULL);
+    pthread_cond_init(&instance->cond, NULL);
+    return instance;
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    pthread_mutex_destroy(&instance->mutex);
+    pthread_cond_destroy(&instance->cond);
+    free(instance->buf);
+    free(instance);
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg, uint32_t timeout) {
+    struct timespec deadline;
+    host_deadline(&deadline, timeout);
+    FuriStatus status = FuriStatusOk;
+    pthread_mutex_lock(&instance->mutex);
+    while(instance->count == instance->msg_count) {
+        if(!host_cond_wait(&instance->cond, &instance->mutex, &deadline, timeout)) {
+            if(instance->count < instance->msg_count) continue;
+            status = FuriStatusErrorTimeout;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        uint32_t index = (instance->head + instance->count) % instance->msg_count;
+        memcpy(instance->buf + index * instance->msg_size, msg, instance->msg_size);
+        instance->count++;
+        pthread_cond_broadcast(&instance->cond);
+    }
+    pthread_mutex_unlock(&instance->mutex);
+    return status;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg, uint32_t timeout) {
+    struct timespec deadline;
+    host_deadline(&deadline, timeout);
+    FuriStatus status = FuriStatusOk;
+    pthread_mutex_lock(&instance->mutex);
+    while(instance->count == 0) {
+        if(!host_cond_wait(&instance->cond, &instance->mutex, &deadline, timeout)) {
+            if(instance->count) continue;
+            status = FuriStatusErrorTimeout;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        memcpy(msg, instance->buf + instance->head * instance->msg_size, instance->msg_size);
+        instance->head = (instance->head + 1) % instance->msg_count;
+        instance->count--;
+        pthread_cond_broadcast(&instance->cond);
+    }
+    pthread_mutex_unlock(&instance->mutex);
+    return status;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance) {
+    pthread_mutex_lock(&instance->mutex);
+    uint32_t count = instance->count;
+    pthread_mutex_unlock(&instance->mutex);
+    return count;
+}
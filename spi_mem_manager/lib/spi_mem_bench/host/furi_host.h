@@ -0,0 +1,110 @@
+#pragma once
+
+// Just enough of the firmware API for the spi_mem worker, pipe, tools and simulator to build on
+// a host. Threads and message queues are real (pthreads), the pipe overlaps file access with SPI
+// the same way it does on device. Every firmware header the sources include is generated by the
+// Makefile as a one-line include of this.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define furi_assert(x) assert(x)
+#define furi_check(x) assert(x)
+
+#define FuriWaitForever 0xFFFFFFFFU
+#define FuriFlagWaitAny 0x00000000U
+#define FuriFlagError 0x80000000U
+#define FuriFlagErrorTimeout 0xFFFFFFFEU
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriString FuriString;
+
+/** Milliseconds since start */
+uint32_t furi_get_tick(void);
+
+/** Doesn't sleep, only yields and counts, see host_delay_ticks */
+void furi_delay_tick(uint32_t ticks);
+
+FuriThread* furi_thread_alloc(void);
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_name(FuriThread* thread, const char* name);
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size);
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback);
+void furi_thread_set_context(FuriThread* thread, void* context);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_get(void);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg, uint32_t timeout);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance);
+
+// m-array.h, only what spi_mem_chip.h's found_chips needs
+#define HOST_ARRAY_CAPACITY 64
+#define M_POD_OPLIST
+#define ARRAY_DEF(name, type, oplist)                                      \
+    typedef struct {                                                       \
+        type items[HOST_ARRAY_CAPACITY];                                   \
+        size_t size;                                                       \
+    } name##_s;                                                            \
+    typedef name##_s name##_t[1];                                          \
+    static inline void name##_init(name##_t array) {                       \
+        array->size = 0;                                                   \
+    }                                                                      \
+    static inline void name##_clear(name##_t array) {                      \
+        array->size = 0;                                                   \
+    }                                                                      \
+    static inline void name##_reset(name##_t array) {                      \
+        array->size = 0;                                                   \
+    }                                                                      \
+    static inline void name##_push_back(name##_t array, type value) {      \
+        furi_check(array->size < HOST_ARRAY_CAPACITY);                     \
+        array->items[array->size++] = value;                               \
+    }                                                                      \
+    static inline size_t name##_size(const name##_t array) {               \
+        return array->size;                                                \
+    }                                                                      \
+    static inline type* name##_get(const name##_t array, size_t i) {       \
+        furi_check(i < array->size);                                       \
+        return (type*)&array->items[i];                                    \
+    }
+
+// Harness side
+
+/** Ticks the firmware code asked to wait, what polling costs on device */
+extern volatile uint32_t host_delay_ticks;
+
+uint64_t host_time_ns(void);
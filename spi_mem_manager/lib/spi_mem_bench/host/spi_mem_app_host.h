@@ -0,0 +1,18 @@
+#pragma once
+
+#include "furi_host.h"
+#include "spi_mem_app.h"
+
+// The app as the worker sees it: worker callback context and the dump file, which lives in
+// memory. sd_delay_us is added to every block read or written, like SD card access on device.
+struct SPIMemApp {
+    uint8_t* file;
+    size_t file_size;
+    size_t file_capacity;
+    size_t file_pos;
+    bool file_open;
+    uint32_t sd_delay_us;
+    uint32_t sd_blocks; // blocks read or written
+    volatile uint32_t blocks; // SPIMemCustomEventWorkerBlockReaded count
+    FuriMessageQueue* events; // every other worker event
+};
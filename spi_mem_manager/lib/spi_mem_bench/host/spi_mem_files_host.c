@@ -0,0 +1,46 @@
+#include "spi_mem_app_host.h"
+#include "spi_mem_files.h"
+
+#include <unistd.h>
+
+bool spi_mem_file_create_open(SPIMemApp* app) {
+    furi_check(!app->file_open);
+    app->file_size = 0;
+    app->file_pos = 0;
+    app->file_open = true;
+    return true;
+}
+
+bool spi_mem_file_open(SPIMemApp* app) {
+    furi_check(!app->file_open);
+    app->file_pos = 0;
+    app->file_open = true;
+    return true;
+}
+
+bool spi_mem_file_write_block(SPIMemApp* app, uint8_t* data, size_t size) {
+    if(app->sd_delay_us) usleep(app->sd_delay_us);
+    app->sd_blocks++;
+    if(app->file_pos + size > app->file_capacity) return false;
+    memcpy(app->file + app->file_pos, data, size);
+    app->file_pos += size;
+    app->file_size = MAX(app->file_size, app->file_pos);
+    return true;
+}
+
+bool spi_mem_file_read_block(SPIMemApp* app, uint8_t* data, size_t size) {
+    if(app->sd_delay_us) usleep(app->sd_delay_us);
+    app->sd_blocks++;
+    if(app->file_pos + size > app->file_size) return false;
+    memcpy(data, app->file + app->file_pos, size);
+    app->file_pos += size;
+    return true;
+}
+
+void spi_mem_file_close(SPIMemApp* app) {
+    app->file_open = false;
+}
+
+size_t spi_mem_file_get_size(SPIMemApp* app) {
+    return app->file_size;
+}
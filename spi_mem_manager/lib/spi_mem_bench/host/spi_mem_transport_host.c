@@ -0,0 +1,27 @@
+#include "spi_mem_transport.h"
+
+// There is no external SPI bus on a host, every chip there is a spi_mem_sim
+static bool spi_mem_transport_host_trx(
+    void* context,
+    uint8_t cmd,
+    const uint8_t* address,
+    size_t address_size,
+    const uint8_t* tx,
+    size_t tx_size,
+    uint8_t* rx,
+    size_t rx_size) {
+    UNUSED(context);
+    UNUSED(cmd);
+    UNUSED(address);
+    UNUSED(address_size);
+    UNUSED(tx);
+    UNUSED(tx_size);
+    UNUSED(rx);
+    UNUSED(rx_size);
+    return false;
+}
+
+const SPIMemTransport spi_mem_transport_external = {
+    .trx = spi_mem_transport_host_trx,
+    .context = NULL,
+};
@@ -0,0 +1,281 @@
+// Host benchmark of the spi_mem worker modes against the simulated NOR chip. Runs chip detect,
+// erase, write, verify, read and smart write through the real worker thread, pipe and tools on
+// top of spi_mem_sim, checks the chip and dump file contents after every mode and prints the
+// throughput and the SPI work each mode did.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "spi_mem_app_host.h"
+#include "spi_mem_chip_i.h"
+#include "spi_mem_sim.h"
+#include "spi_mem_tools.h"
+#include "spi_mem_worker_i.h"
+
+#define DEFAULT_CHIP "W25Q16"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+typedef void (*ModeStart)(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context);
+
+typedef struct {
+    SPIMemApp app;
+    SPIMemWorker* worker;
+    SPIMemSim* sim;
+    SPIMemChip chip_info;
+    found_chips_t found_chips;
+} Bench;
+
+static void bench_worker_callback(void* context, SPIMemCustomEventWorker event) {
+    SPIMemApp* app = context;
+    if(event == SPIMemCustomEventWorkerBlockReaded) {
+        app->blocks++;
+    } else {
+        furi_message_queue_put(app->events, &event, FuriWaitForever);
+    }
+}
+
+static SPIMemCustomEventWorker bench_wait(Bench* bench) {
+    SPIMemCustomEventWorker event;
+    furi_check(
+        furi_message_queue_get(bench->app.events, &event, FuriWaitForever) == FuriStatusOk);
+    // The last event comes from inside the mode, the worker goes idle right after it
+    while(__atomic_load_n(&bench->worker->mode_index, __ATOMIC_ACQUIRE) !=
+          SPIMemWorkerModeIdle) {
+        usleep(10);
+    }
+    return event;
+}
+
+static const char* bench_event_name(SPIMemCustomEventWorker event) {
+    switch(event) {
+    case SPIMemCustomEventWorkerChipIdentified:
+        return "identified";
+    case SPIMemCustomEventWorkerChipUnknown:
+        return "unknown";
+    case SPIMemCustomEventWorkerChipFail:
+        return "chip fail";
+    case SPIMemCustomEventWorkerFileFail:
+        return "file fail";
+    case SPIMemCustomEventWorkerDone:
+        return "done";
+    case SPIMemCustomEventWorkerVerifyFail:
+        return "verify fail";
+    default:
+        return "?";
+    }
+}
+
+// Runs one worker mode to its final event and prints what it cost
+static SPIMemCustomEventWorker bench_run(Bench* bench, const char* name, ModeStart start) {
+    spi_mem_sim_reset_stats(bench->sim);
+    bench->app.blocks = 0;
+    bench->app.sd_blocks = 0;
+    host_delay_ticks = 0;
+
+    uint64_t begin = host_time_ns();
+    start(&bench->chip_info, bench->worker, bench_worker_callback, &bench->app);
+    SPIMemCustomEventWorker event = bench_wait(bench);
+    double seconds = (host_time_ns() - begin) * 1e-9;
+
+    const SPIMemSimStats* stats = spi_mem_sim_get_stats(bench->sim);
+    size_t bytes = MAX(stats->bytes_read, stats->bytes_programmed);
+    printf(
+        "%-12s %-11s %8.1f ms %8.1f MB/s  read %7zu  programmed %7zu  pages %5lu"
+        "  erased %3lu/%lu/%lu  busy polls %6lu  waited %6lu ticks  blocks %lu\n",
+        name,
+        bench_event_name(event),
+        seconds * 1e3,
+        bytes / seconds / 1e6,
+        stats->bytes_read,
+        stats->bytes_programmed,
+        (unsigned long)stats->pages_programmed,
+        (unsigned long)stats->sectors_erased,
+        (unsigned long)stats->blocks_erased,
+        (unsigned long)stats->chips_erased,
+        (unsigned long)stats->busy_polls,
+        (unsigned long)host_delay_ticks,
+        (unsigned long)bench->app.blocks);
+    if(bench->app.sd_delay_us) {
+        // Pipe overlaps SPI with file access, so the mode shouldn't take much longer than this
+        printf(
+            "%-12s SD card busy %8.1f ms\n",
+            "",
+            bench->app.sd_blocks * bench->app.sd_delay_us / 1e3);
+    }
+    CHECK(stats->rejected_commands == 0);
+    return event;
+}
+
+static bool bench_chip_is(Bench* bench, const uint8_t* data, size_t size) {
+    return !memcmp(spi_mem_sim_get_data(bench->sim), data, size);
+}
+
+static bool bench_chip_is_blank(Bench* bench) {
+    uint8_t* data = spi_mem_sim_get_data(bench->sim);
+    for(size_t i = 0; i < spi_mem_sim_get_size(bench->sim); i++) {
+        if(data[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static void bench_detect(Bench* bench, const char* model) {
+    host_delay_ticks = 0;
+    spi_mem_worker_chip_detect_start(
+        &bench->chip_info, &bench->found_chips, bench->worker, bench_worker_callback, &bench->app);
+    CHECK(bench_wait(bench) == SPIMemCustomEventWorkerChipIdentified);
+
+    // Chips sharing the JEDEC id are all offered, the app lets the user pick one
+    const SPIMemChip* found = NULL;
+    for(size_t i = 0; i < found_chips_size(bench->found_chips); i++) {
+        const SPIMemChip* chip = *found_chips_get(bench->found_chips, i);
+        if(!strcmp(spi_mem_chip_get_model_name(chip), model)) found = chip;
+    }
+    CHECK(found != NULL);
+    if(found) spi_mem_chip_copy_chip_info(&bench->chip_info, found);
+    printf(
+        "%s %s, %zu bytes, %zu byte pages, %zu candidates with the same id\n",
+        spi_mem_chip_get_vendor_name(&bench->chip_info),
+        spi_mem_chip_get_model_name(&bench->chip_info),
+        spi_mem_chip_get_size(&bench->chip_info),
+        spi_mem_chip_get_page_size(&bench->chip_info),
+        found_chips_size(bench->found_chips));
+}
+
+static void bench_modes(Bench* bench) {
+    size_t size = spi_mem_chip_get_size(&bench->chip_info);
+    uint8_t* image = malloc(size);
+    uint8_t* chip = spi_mem_sim_get_data(bench->sim);
+    for(size_t i = 0; i < size; i++) {
+        image[i] = rand();
+    }
+
+    // Erase then write the image
+    memset(chip, 0, size);
+    CHECK(bench_run(bench, "erase", spi_mem_worker_erase_start) == SPIMemCustomEventWorkerDone);
+    CHECK(bench_chip_is_blank(bench));
+
+    memcpy(bench->app.file, image, size);
+    bench->app.file_size = size;
+    CHECK(bench_run(bench, "write", spi_mem_worker_write_start) == SPIMemCustomEventWorkerDone);
+    CHECK(bench_chip_is(bench, image, size));
+
+    // Verify passes, then catches one flipped bit
+    CHECK(bench_run(bench, "verify", spi_mem_worker_verify_start) == SPIMemCustomEventWorkerDone);
+    chip[size / 2] ^= 0x10;
+    CHECK(
+        bench_run(bench, "verify bad", spi_mem_worker_verify_start) ==
+        SPIMemCustomEventWorkerVerifyFail);
+    chip[size / 2] ^= 0x10;
+
+    // Read back into an empty file
+    memset(bench->app.file, 0, size);
+    bench->app.file_size = 0;
+    CHECK(bench_run(bench, "read", spi_mem_worker_read_start) == SPIMemCustomEventWorkerDone);
+    CHECK(bench->app.file_size == size);
+    CHECK(!memcmp(bench->app.file, image, size));
+
+    // Smart write with nothing changed touches nothing
+    CHECK(
+        bench_run(bench, "smart same", spi_mem_worker_smart_write_start) ==
+        SPIMemCustomEventWorkerDone);
+    CHECK(spi_mem_sim_get_stats(bench->sim)->bytes_programmed == 0);
+
+    // One sector only clears bits and is programmed in place, another needs an erase
+    size_t program_at = 3 * SPI_MEM_SECTOR_SIZE + 100;
+    size_t erase_at = 10 * SPI_MEM_SECTOR_SIZE + 200;
+    image[program_at] &= 0x0F;
+    if(image[program_at] == chip[program_at]) image[program_at] = 0;
+    image[erase_at] = ~chip[erase_at];
+    memcpy(bench->app.file, image, size);
+    CHECK(
+        bench_run(bench, "smart write", spi_mem_worker_smart_write_start) ==
+        SPIMemCustomEventWorkerDone);
+    CHECK(bench_chip_is(bench, image, size));
+    CHECK(spi_mem_sim_get_stats(bench->sim)->sectors_erased == 1);
+    CHECK(spi_mem_sim_get_stats(bench->sim)->chips_erased == 0);
+
+    // File shorter than chip: the rest of the last, partial sector survives its erase
+    size_t short_size = size - SPI_MEM_SECTOR_SIZE / 2;
+    size_t tail_at = short_size - 10;
+    image[tail_at] = ~chip[tail_at];
+    memcpy(bench->app.file, image, short_size);
+    bench->app.file_size = short_size;
+    CHECK(
+        bench_run(bench, "smart short", spi_mem_worker_smart_write_start) ==
+        SPIMemCustomEventWorkerDone);
+    CHECK(bench_chip_is(bench, image, size));
+    CHECK(spi_mem_sim_get_stats(bench->sim)->sectors_erased == 1);
+
+    free(image);
+}
+
+int main(int argc, char** argv) {
+    const char* model = DEFAULT_CHIP;
+    uint32_t sd_delay_us = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "c:d:h")) != -1) {
+        if(opt == 'c') {
+            model = optarg;
+        } else if(opt == 'd') {
+            sd_delay_us = strtoul(optarg, NULL, 0);
+        } else {
+            printf("Usage: %s [-c chip model] [-d SD delay per block, us]\n", argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    Bench bench = {0};
+    bench.sim = spi_mem_sim_alloc(model);
+    if(!bench.sim) {
+        fprintf(stderr, "No chip %s in SPIMemChips\n", model);
+        return 1;
+    }
+    if(spi_mem_sim_get_size(bench.sim) < 16 * SPI_MEM_SECTOR_SIZE) {
+        fprintf(stderr, "Need a chip of at least 16 sectors\n");
+        return 1;
+    }
+    spi_mem_tools_set_transport(spi_mem_sim_get_transport(bench.sim));
+
+    bench.app.file_capacity = spi_mem_sim_get_size(bench.sim);
+    bench.app.file = malloc(bench.app.file_capacity);
+    bench.app.sd_delay_us = sd_delay_us;
+    bench.app.events = furi_message_queue_alloc(8, sizeof(SPIMemCustomEventWorker));
+    found_chips_init(bench.found_chips);
+
+    bench.worker = spi_mem_worker_alloc();
+    spi_mem_worker_start_thread(bench.worker);
+
+    srand(1);
+    bench_detect(&bench, model);
+    if(!failures) bench_modes(&bench);
+
+    spi_mem_worker_stop_thread(bench.worker);
+    spi_mem_worker_free(bench.worker);
+    found_chips_clear(bench.found_chips);
+    furi_message_queue_free(bench.app.events);
+    free(bench.app.file);
+    spi_mem_tools_set_transport(NULL);
+    spi_mem_sim_free(bench.sim);
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 typedef enum {
     SPIMemSceneSavedFileMenuSubmenuIndexWrite,
+    SPIMemSceneSavedFileMenuSubmenuIndexSmartWrite,
     SPIMemSceneSavedFileMenuSubmenuIndexCompare,
     SPIMemSceneSavedFileMenuSubmenuIndexInfo,
     SPIMemSceneSavedFileMenuSubmenuIndexDelete,
@@ -20,6 +21,12 @@ void spi_mem_scene_saved_file_menu_on_enter(void* context) {
         SPIMemSceneSavedFileMenuSubmenuIndexWrite,
         spi_mem_scene_saved_file_menu_submenu_callback,
         app);
+    submenu_add_item(
+        app->submenu,
+        "Smart Write",
+        SPIMemSceneSavedFileMenuSubmenuIndexSmartWrite,
+        spi_mem_scene_saved_file_menu_submenu_callback,
+        app);
     submenu_add_item(
         app->submenu,
         "Compare",
@@ -53,6 +60,11 @@ bool spi_mem_scene_saved_file_menu_on_event(void* context, SceneManagerEvent eve
             scene_manager_next_scene(app->scene_manager, SPIMemSceneChipDetect);
             success = true;
         }
+        if(event.event == SPIMemSceneSavedFileMenuSubmenuIndexSmartWrite) {
+            app->mode = SPIMemModeSmartWrite;
+            scene_manager_next_scene(app->scene_manager, SPIMemSceneChipDetect);
+            success = true;
+        }
         if(event.event == SPIMemSceneSavedFileMenuSubmenuIndexCompare) {
             app->mode = SPIMemModeCompare;
             scene_manager_next_scene(app->scene_manager, SPIMemSceneChipDetect);
@@ -45,7 +45,8 @@ void spi_mem_scene_select_vendor_on_enter(void* context) {
 
 static void spi_mem_scene_select_vendor_set_previous_scene(SPIMemApp* app) {
     uint32_t scene = SPIMemSceneStart;
-    if(app->mode == SPIMemModeCompare || app->mode == SPIMemModeWrite)
+    if(app->mode == SPIMemModeCompare || app->mode == SPIMemModeWrite ||
+       app->mode == SPIMemModeSmartWrite)
         scene = SPIMemSceneSavedFileMenu;
     scene_manager_search_and_switch_to_previous_scene(app->scene_manager, scene);
 }
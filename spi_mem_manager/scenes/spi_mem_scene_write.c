@@ -24,7 +24,12 @@ void spi_mem_scene_write_on_enter(void* context) {
         app->view_progress, spi_mem_tools_get_file_max_block_size(app->chip_info));
     view_dispatcher_switch_to_view(app->view_dispatcher, SPIMemViewProgress);
     spi_mem_worker_start_thread(app->worker);
-    spi_mem_worker_write_start(app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    if(app->mode == SPIMemModeSmartWrite) {
+        spi_mem_worker_smart_write_start(
+            app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    } else {
+        spi_mem_worker_write_start(app->chip_info, app->worker, spi_mem_scene_write_callback, app);
+    }
 }
 
 bool spi_mem_scene_write_on_event(void* context, SceneManagerEvent event) {
@@ -41,7 +46,12 @@ bool spi_mem_scene_write_on_event(void* context, SceneManagerEvent event) {
         } else if(event.event == SPIMemCustomEventWorkerBlockReaded) {
             spi_mem_view_progress_inc_progress(app->view_progress);
         } else if(event.event == SPIMemCustomEventWorkerDone) {
-            scene_manager_next_scene(app->scene_manager, SPIMemSceneVerify);
+            // Smart write reads back every sector it changes, no need to verify whole chip
+            uint32_t scene = SPIMemSceneVerify;
+            if(app->mode == SPIMemModeSmartWrite) scene = SPIMemSceneSuccess;
+            scene_manager_next_scene(app->scene_manager, scene);
+        } else if(event.event == SPIMemCustomEventWorkerVerifyFail) {
+            scene_manager_next_scene(app->scene_manager, SPIMemSceneVerifyError);
         } else if(event.event == SPIMemCustomEventWorkerChipFail) {
             scene_manager_next_scene(app->scene_manager, SPIMemSceneChipError);
         } else if(event.event == SPIMemCustomEventWorkerFileFail) {
@@ -33,6 +33,7 @@
 typedef enum {
     SPIMemModeRead,
     SPIMemModeWrite,
+    SPIMemModeSmartWrite,
     SPIMemModeCompare,
     SPIMemModeErase,
     SPIMemModeDelete,
@@ -88,10 +88,12 @@ def generateCArr(arr, filename):
             print(" " + cur["size"] + ",", file=out, end="")
             print(" " + cur["pageSize"] + ",", file=out, end="")
             print(" " + cur["vendorEnum"] + ",", file=out, end="")
-            if cur == arr[-1]:
-                print(" " + cur["writeMode"] + "}};", file=out)
-            else:
-                print(" " + cur["writeMode"] + "},", file=out)
+            print(" " + cur["writeMode"] + "},", file=out)
+        # Lookups walk the array up to the NULL model name
+        print(
+            "    {0, 0, 0, NULL, 0, 0, SPIMemChipVendorUnknown, SPIMemChipWriteModeUnknown}};",
+            file=out,
+        )
 
 
 def main():
@@ -0,0 +1,283 @@
+// Host check of .swd scripts: compiles them with the app's compiler, reports errors with
+// their line, optionally disassembles the bytecode and compares the dispatch cost of the
+// bytecode against a model of the previous interpreter that re-tokenized every line and
+// searched the text for labels.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "swd_script.h"
+
+#define DEFAULT_STEPS (1000000)
+#define MAX_TOKENS (8)
+#define TOKEN_LENGTH (256)
+
+typedef struct {
+    const char* text;
+    size_t length;
+    size_t pos;
+    uint16_t line;
+    bool goto_active;
+    char goto_label[TOKEN_LENGTH];
+} TextInterp;
+
+static volatile uint32_t sink;
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static char* load_file(const char* path, size_t pad, size_t* length) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    size_t size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    // Padding goes in front so every goto has to walk past it in the text model
+    static const char padding[] = "# padding\n";
+    size_t pad_size = pad * (sizeof(padding) - 1);
+    char* text = malloc(pad_size + size + 1);
+    for(size_t i = 0; i < pad; i++) {
+        memcpy(text + i * (sizeof(padding) - 1), padding, sizeof(padding) - 1);
+    }
+    size_t read = fread(text + pad_size, 1, size, file);
+    fclose(file);
+
+    *length = pad_size + read;
+    text[*length] = '\0';
+    return text;
+}
+
+static void disassemble(const SwdScriptProgram* program) {
+    SwdScriptInsn insn;
+    uint32_t pc = 0;
+    uint32_t start = 0;
+
+    while(swd_script_fetch(program, &pc, &insn)) {
+        printf("  %04u  line %4u  %-16s", start, insn.line, swd_script_op_name(insn.op));
+        for(size_t arg = 0; arg < insn.argc; arg++) {
+            if(insn.op == SwdScriptOpGoto) {
+                printf(" @%04u", insn.argv[arg]);
+            } else if(
+                (insn.op == SwdScriptOpCall || insn.op == SwdScriptOpErrors) ||
+                (insn.op == SwdScriptOpMemDump && arg == 0) ||
+                (insn.op == SwdScriptOpMessage && arg > 0)) {
+                printf(" \"%s\"", swd_script_string(program, insn.argv[arg]));
+            } else {
+                printf(" 0x%08X", insn.argv[arg]);
+            }
+        }
+        printf("\n");
+        start = pc;
+    }
+}
+
+// One line split the way the old interpreter did it, quotes group spaces
+static size_t text_tokens(const char* line, const char* end, char tokens[][TOKEN_LENGTH]) {
+    size_t count = 0;
+
+    while(line < end && count < MAX_TOKENS) {
+        size_t length = 0;
+        bool quot = false;
+
+        while(line < end && *line == ' ') line++;
+        if(line == end) break;
+        while(line < end && (quot || *line != ' ')) {
+            char ch = *line++;
+            if(ch == '"') {
+                quot = !quot;
+            } else if(length + 1 < TOKEN_LENGTH) {
+                tokens[count][length++] = ch;
+            }
+        }
+        tokens[count++][length] = '\0';
+    }
+
+    return count;
+}
+
+// Model of the previous interpreter: every executed line is tokenized and its command looked
+// up by name, a goto restarts at the top of the file and skips lines until the label shows up.
+// Returns the line of the command that would have run.
+static uint16_t text_step(TextInterp* interp) {
+    char tokens[MAX_TOKENS][TOKEN_LENGTH];
+
+    while(true) {
+        if(interp->pos >= interp->length) {
+            interp->pos = 0;
+            interp->line = 0;
+        }
+
+        const char* line = interp->text + interp->pos;
+        const char* end = memchr(line, '\n', interp->length - interp->pos);
+        if(!end) end = interp->text + interp->length;
+        interp->pos = end - interp->text + 1;
+        interp->line++;
+        if(end > line && end[-1] == '\r') end--;
+
+        size_t count = text_tokens(line, end, tokens);
+        if(count == 0 || tokens[0][0] == '#') continue;
+
+        if(!strcmp(tokens[0], ".label")) {
+            if(interp->goto_active && count > 1 && !strcmp(tokens[1], interp->goto_label)) {
+                interp->goto_active = false;
+            }
+            continue;
+        }
+        if(interp->goto_active) continue;
+
+        for(size_t op = 0; op < SwdScriptOpCount; op++) {
+            if(!strcmp(tokens[0], swd_script_op_name(op))) {
+                sink += op;
+                break;
+            }
+        }
+
+        uint16_t executed = interp->line;
+        if(!strcmp(tokens[0], "goto")) {
+            strcpy(interp->goto_label, tokens[1]);
+            interp->goto_active = true;
+            interp->pos = 0;
+            interp->line = 0;
+        } else {
+            for(size_t arg = 1; arg < count; arg++) sink += strtoul(tokens[arg], NULL, 0);
+        }
+        return executed;
+    }
+}
+
+static uint16_t bytecode_step(const SwdScriptProgram* program, uint32_t* pc) {
+    SwdScriptInsn insn;
+
+    if(!swd_script_fetch(program, pc, &insn)) {
+        *pc = 0;
+        swd_script_fetch(program, pc, &insn);
+    }
+    if(insn.op == SwdScriptOpGoto) {
+        *pc = insn.argv[0];
+    } else {
+        for(size_t arg = 0; arg < insn.argc; arg++) sink += insn.argv[arg];
+    }
+    return insn.line;
+}
+
+static bool bench(const char* text, size_t length, const SwdScriptProgram* program, size_t steps) {
+    TextInterp interp = {.text = text, .length = length};
+    uint32_t text_trace = 0;
+    uint32_t bytecode_trace = 0;
+    uint32_t pc = 0;
+
+    double start = get_time();
+    for(size_t step = 0; step < steps; step++) {
+        text_trace = text_trace * 31 + text_step(&interp);
+    }
+    double text_time = get_time() - start;
+
+    start = get_time();
+    for(size_t step = 0; step < steps; step++) {
+        bytecode_trace = bytecode_trace * 31 + bytecode_step(program, &pc);
+    }
+    double bytecode_time = get_time() - start;
+
+    printf("  text:     %8.1f ns/step\n", text_time * 1e9 / steps);
+    printf(
+        "  bytecode: %8.1f ns/step, %s\n",
+        bytecode_time * 1e9 / steps,
+        text_trace == bytecode_trace ? "same trace" : "TRACE MISMATCH");
+
+    return text_trace == bytecode_trace;
+}
+
+/* lines the compiler has to reject instead of leaving them to the interpreter */
+static const char* const rejected[] = {
+    "beep 2\n",
+    "beep 0xFFFFFFFF\n",
+    "mem_dump out.bin 0 4 1 2\n",
+    "frobnicate\n",
+};
+
+static bool check_rejected(void) {
+    bool ok = true;
+
+    for(size_t line = 0; line < sizeof(rejected) / sizeof(rejected[0]); line++) {
+        SwdScriptProgram program;
+        SwdScriptError error;
+        if(swd_script_compile(&program, rejected[line], strlen(rejected[line]), &error)) {
+            fprintf(stderr, "accepted: %s", rejected[line]);
+            swd_script_free(&program);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    size_t steps = DEFAULT_STEPS;
+    size_t pad = 0;
+    bool dump = false;
+    int failed = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "dn:p:h")) != -1) {
+        if(opt == 'd') {
+            dump = true;
+        } else if(opt == 'n') {
+            steps = strtoul(optarg, NULL, 0);
+        } else if(opt == 'p') {
+            pad = strtoul(optarg, NULL, 0);
+        } else {
+            printf("Usage: %s [-d] [-n steps] [-p lines] script.swd...\n", argv[0]);
+            printf("  -d  disassemble the bytecode\n");
+            printf("  -n  commands to time per script, 0 to only compile\n");
+            printf("  -p  prepend comment lines, the text model has to skip them on goto\n");
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if(!check_rejected()) failed++;
+
+    for(int arg = optind; arg < argc; arg++) {
+        size_t length = 0;
+        char* text = load_file(argv[arg], pad, &length);
+        if(!text) {
+            fprintf(stderr, "%s: cannot read\n", argv[arg]);
+            failed++;
+            continue;
+        }
+
+        SwdScriptProgram program;
+        SwdScriptError error;
+        double start = get_time();
+        bool compiled = swd_script_compile(&program, text, length, &error);
+        double compile_time = get_time() - start;
+
+        if(!compiled) {
+            fprintf(stderr, "%s:%u: %s\n", argv[arg], error.line, error.message);
+            failed++;
+            free(text);
+            continue;
+        }
+
+        printf(
+            "%s: %zu bytes text, %zu bytes code, %zu bytes strings, compiled in %.1f us\n",
+            argv[arg],
+            length,
+            program.code_size * sizeof(uint32_t),
+            program.strings_size,
+            compile_time * 1e6);
+        if(dump) disassemble(&program);
+        if(steps && program.code_size && !bench(text, length, &program, steps)) failed++;
+
+        swd_script_free(&program);
+        free(text);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,31 @@
+#include "furi_host.h"
+
+#include <stdarg.h>
+
+bool host_verbose = false;
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    UNUSED(level);
+    if(!host_verbose) return;
+
+    va_list args;
+    va_start(args, format);
+    printf("[%s] ", tag);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+
+// The bench counts SWCLK cycles instead of waiting
+void furi_delay_us(uint32_t us) {
+    UNUSED(us);
+}
+
+const GpioPin gpio_ext_pc0 = {"PC0"};
+const GpioPin gpio_ext_pc1 = {"PC1"};
+const GpioPin gpio_ext_pc3 = {"PC3"};
+const GpioPin gpio_ext_pb2 = {"PB2"};
+const GpioPin gpio_ext_pb3 = {"PB3"};
+const GpioPin gpio_ext_pa4 = {"PA4"};
+const GpioPin gpio_ext_pa6 = {"PA6"};
+const GpioPin gpio_ext_pa7 = {"PA7"};
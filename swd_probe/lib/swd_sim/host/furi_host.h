@@ -0,0 +1,90 @@
+#pragma once
+
+// Just enough of the firmware API for swd.c to build on a host. Every firmware header that
+// swd_probe_app.h includes is generated by the Makefile as a one-line include of this.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) assert(x)
+#define furi_check(x) assert(x)
+
+typedef enum {
+    FuriLogLevelDefault = 0,
+    FuriLogLevelNone = 1,
+    FuriLogLevelError = 2,
+    FuriLogLevelWarn = 3,
+    FuriLogLevelInfo = 4,
+    FuriLogLevelDebug = 5,
+    FuriLogLevelTrace = 6,
+} FuriLogLevel;
+
+extern bool host_verbose;
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+void furi_delay_us(uint32_t us);
+
+/* GPIO, implemented by the SWD target model in swd_sim.c */
+
+typedef struct {
+    const char* name;
+} GpioPin;
+
+typedef enum {
+    GpioModeInput,
+    GpioModeOutputPushPull,
+    GpioModeOutputOpenDrain,
+    GpioModeAnalog,
+} GpioMode;
+
+typedef enum {
+    GpioPullNo,
+    GpioPullUp,
+    GpioPullDown,
+} GpioPull;
+
+typedef enum {
+    GpioSpeedLow,
+    GpioSpeedMedium,
+    GpioSpeedHigh,
+    GpioSpeedVeryHigh,
+} GpioSpeed;
+
+extern const GpioPin gpio_ext_pc0;
+extern const GpioPin gpio_ext_pc1;
+extern const GpioPin gpio_ext_pc3;
+extern const GpioPin gpio_ext_pb2;
+extern const GpioPin gpio_ext_pb3;
+extern const GpioPin gpio_ext_pa4;
+extern const GpioPin gpio_ext_pa6;
+extern const GpioPin gpio_ext_pa7;
+
+void furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed);
+void furi_hal_gpio_write(const GpioPin* gpio, bool state);
+bool furi_hal_gpio_read(const GpioPin* gpio);
+
+/* Opaque handles referenced by AppFSM and ScriptContext */
+
+typedef struct Storage Storage;
+typedef struct File File;
+typedef struct Gui Gui;
+typedef struct ViewPort ViewPort;
+typedef struct Canvas Canvas;
+typedef struct DialogsApp DialogsApp;
+typedef struct NotificationApp NotificationApp;
+typedef struct FuriTimer FuriTimer;
+typedef struct FuriMessageQueue FuriMessageQueue;
+typedef struct FuriMutex FuriMutex;
+
+typedef struct {
+    uint32_t sequence;
+    int key;
+    int type;
+} InputEvent;
@@ -0,0 +1,336 @@
+#include "swd_sim.h"
+
+#define SWD_SIM_LINE_RESET_BITS 50
+
+#define SWD_SIM_ACK_OK 0x01
+#define SWD_SIM_ACK_FAULT 0x04
+
+#define SWD_SIM_CSW_ADDRINC_SINGLE (1u << 4)
+#define SWD_SIM_CSW_ADDRINC_MASK (3u << 4)
+#define SWD_SIM_TAR_WRAP 0x400u
+
+#define SWD_SIM_CTRLSTAT_STICKYERR (1u << 5)
+#define SWD_SIM_CTRLSTAT_PWRUPREQ ((1u << 28) | (1u << 30))
+
+#define SWD_SIM_AP_CSW 0x00
+#define SWD_SIM_AP_TAR 0x04
+#define SWD_SIM_AP_DRW 0x0C
+#define SWD_SIM_AP_BASE 0xF8
+#define SWD_SIM_AP_IDR 0xFC
+#define SWD_SIM_AP_IDR_VALUE 0x24770011u
+
+typedef enum {
+    SwdSimStateIdle,
+    SwdSimStateRequest,
+    SwdSimStateAck,
+    SwdSimStateReadData,
+    SwdSimStateWriteTurnaround,
+    SwdSimStateWriteData,
+    SwdSimStateTurnaround,
+    SwdSimStateLockout,
+} SwdSimState;
+
+typedef struct {
+    const GpioPin* swclk;
+    const GpioPin* swdio;
+    bool clock;
+    bool host_output;
+    bool host_odr;
+    bool target_driving;
+    bool target_level;
+    uint32_t ones;
+
+    SwdSimState state;
+    uint8_t request;
+    uint8_t ack;
+    uint32_t bit;
+    uint64_t shift;
+
+    uint32_t ctrlstat;
+    uint32_t select;
+    uint32_t rdbuff;
+    uint32_t csw;
+    uint32_t tar;
+
+    uint32_t base;
+    uint32_t size;
+
+    SwdSimStats stats;
+} SwdSim;
+
+static SwdSim sim;
+
+uint32_t swd_sim_pattern(uint32_t address) {
+    return (address * 2654435761u) ^ 0x5A5AA5A5u;
+}
+
+void swd_sim_init(const GpioPin* swclk, const GpioPin* swdio, uint32_t base, uint32_t size) {
+    memset(&sim, 0, sizeof(sim));
+    sim.swclk = swclk;
+    sim.swdio = swdio;
+    sim.state = SwdSimStateLockout;
+    sim.base = base;
+    sim.size = size;
+}
+
+void swd_sim_deinit(void) {
+    memset(&sim, 0, sizeof(sim));
+}
+
+const SwdSimStats* swd_sim_get_stats(void) {
+    return &sim.stats;
+}
+
+void swd_sim_reset_stats(void) {
+    memset(&sim.stats, 0, sizeof(sim.stats));
+}
+
+static bool swd_sim_memory_read(uint32_t address, uint32_t* data) {
+    if(address < sim.base || address - sim.base >= sim.size) {
+        sim.ctrlstat |= SWD_SIM_CTRLSTAT_STICKYERR;
+        sim.stats.faults++;
+        return false;
+    }
+    *data = swd_sim_pattern(address & ~3u);
+    return true;
+}
+
+static void swd_sim_tar_increment(void) {
+    if((sim.csw & SWD_SIM_CSW_ADDRINC_MASK) == SWD_SIM_CSW_ADDRINC_SINGLE) {
+        sim.tar = (sim.tar & ~(SWD_SIM_TAR_WRAP - 1)) | ((sim.tar + 4) & (SWD_SIM_TAR_WRAP - 1));
+    }
+}
+
+static uint32_t swd_sim_ap_address(uint8_t a23) {
+    return (sim.select & 0xF0) | (a23 << 2);
+}
+
+// Reads return the previous AP read and start the next one, RDBUFF returns it without a new read
+static uint32_t swd_sim_read(bool ap, uint8_t a23) {
+    uint32_t data = 0;
+
+    if(!ap) {
+        switch(a23) {
+        case 0:
+            return SWD_SIM_DPIDR;
+        case 1:
+            // Power-up requests are acknowledged right away
+            return sim.ctrlstat | ((sim.ctrlstat & SWD_SIM_CTRLSTAT_PWRUPREQ) << 1);
+        case 3:
+            return sim.rdbuff;
+        default:
+            return 0;
+        }
+    }
+
+    uint32_t posted = sim.rdbuff;
+    if((sim.select >> 24) != 0) {
+        sim.rdbuff = 0;
+        return posted;
+    }
+
+    switch(swd_sim_ap_address(a23)) {
+    case SWD_SIM_AP_CSW:
+        sim.rdbuff = sim.csw;
+        break;
+    case SWD_SIM_AP_TAR:
+        sim.rdbuff = sim.tar;
+        break;
+    case SWD_SIM_AP_DRW:
+        if(swd_sim_memory_read(sim.tar, &data)) sim.rdbuff = data;
+        swd_sim_tar_increment();
+        break;
+    case SWD_SIM_AP_BASE:
+        sim.rdbuff = 0xE00FF003u;
+        break;
+    case SWD_SIM_AP_IDR:
+        sim.rdbuff = SWD_SIM_AP_IDR_VALUE;
+        break;
+    default:
+        sim.rdbuff = 0;
+        break;
+    }
+    return posted;
+}
+
+static void swd_sim_write(bool ap, uint8_t a23, uint32_t data) {
+    if(!ap) {
+        switch(a23) {
+        case 0:
+            // ABORT, STKERRCLR
+            if(data & (1u << 2)) sim.ctrlstat &= ~SWD_SIM_CTRLSTAT_STICKYERR;
+            break;
+        case 1:
+            sim.ctrlstat = (sim.ctrlstat & SWD_SIM_CTRLSTAT_STICKYERR) |
+                           (data & ~SWD_SIM_CTRLSTAT_STICKYERR);
+            break;
+        case 2:
+            sim.select = data;
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+
+    if((sim.select >> 24) != 0) return;
+
+    switch(swd_sim_ap_address(a23)) {
+    case SWD_SIM_AP_CSW:
+        sim.csw = data;
+        break;
+    case SWD_SIM_AP_TAR:
+        sim.tar = data;
+        break;
+    case SWD_SIM_AP_DRW:
+        // Memory is read only
+        swd_sim_tar_increment();
+        break;
+    default:
+        break;
+    }
+}
+
+static void swd_sim_request_done(void) {
+    uint8_t request = sim.request;
+    bool start = request & 0x01;
+    bool stop = request & 0x40;
+    bool park = request & 0x80;
+    bool parity = request & 0x20;
+
+    if(!start || stop || !park || parity != __builtin_parity(request & 0x1E)) {
+        // All ones is the start of a line reset, not an error
+        if(request != 0xFF) sim.stats.protocol_errors++;
+        sim.state = SwdSimStateLockout;
+        return;
+    }
+
+    bool ap = request & 0x02;
+    bool read = request & 0x04;
+    uint8_t a23 = (request >> 3) & 0x03;
+
+    sim.stats.transfers++;
+    sim.ack = SWD_SIM_ACK_OK;
+    if(ap && (sim.ctrlstat & SWD_SIM_CTRLSTAT_STICKYERR)) {
+        sim.ack = SWD_SIM_ACK_FAULT;
+    }
+    if(sim.ack == SWD_SIM_ACK_OK && read) {
+        uint32_t data = swd_sim_read(ap, a23);
+        sim.shift = data | ((uint64_t)__builtin_parity(data) << 32);
+    }
+    sim.bit = 0;
+    sim.state = SwdSimStateAck;
+}
+
+static void swd_sim_drive(bool level) {
+    sim.target_driving = true;
+    sim.target_level = level;
+}
+
+static void swd_sim_release(void) {
+    sim.target_driving = false;
+}
+
+// Open drain or input, the pull-up wins unless the probe pulls low
+static bool swd_sim_host_level(void) {
+    return !sim.host_output || sim.host_odr;
+}
+
+static void swd_sim_rising_edge(void) {
+    bool sample = swd_sim_host_level();
+
+    sim.stats.clocks++;
+
+    if(!sim.target_driving) {
+        sim.ones = sample ? sim.ones + 1 : 0;
+        if(sim.ones >= SWD_SIM_LINE_RESET_BITS) {
+            sim.state = SwdSimStateIdle;
+            return;
+        }
+    }
+
+    switch(sim.state) {
+    case SwdSimStateIdle:
+        if(sample) {
+            sim.request = 0x01;
+            sim.bit = 1;
+            sim.state = SwdSimStateRequest;
+        }
+        break;
+    case SwdSimStateRequest:
+        sim.request |= sample << sim.bit;
+        if(++sim.bit == 8) swd_sim_request_done();
+        break;
+    case SwdSimStateAck:
+        swd_sim_drive(sim.ack & (1 << sim.bit));
+        if(++sim.bit == 3) {
+            sim.bit = 0;
+            if(sim.ack != SWD_SIM_ACK_OK) {
+                sim.state = SwdSimStateTurnaround;
+            } else if(sim.request & 0x04) {
+                sim.state = SwdSimStateReadData;
+            } else {
+                sim.state = SwdSimStateWriteTurnaround;
+            }
+        }
+        break;
+    case SwdSimStateReadData:
+        swd_sim_drive((sim.shift >> sim.bit) & 1);
+        if(++sim.bit == 33) {
+            sim.bit = 0;
+            sim.state = SwdSimStateTurnaround;
+        }
+        break;
+    case SwdSimStateTurnaround:
+        // The edge after the target's last bit ends it and starts the turnaround cycle, the
+        // sample at the end of that cycle is ignored
+        swd_sim_release();
+        if(++sim.bit == 2) sim.state = SwdSimStateIdle;
+        break;
+    case SwdSimStateWriteTurnaround:
+        swd_sim_release();
+        if(++sim.bit == 2) {
+            sim.shift = 0;
+            sim.bit = 0;
+            sim.state = SwdSimStateWriteData;
+        }
+        break;
+    case SwdSimStateWriteData:
+        sim.shift |= (uint64_t)sample << sim.bit;
+        if(++sim.bit == 33) {
+            uint32_t data = (uint32_t)sim.shift;
+            if(((sim.shift >> 32) & 1) != (uint64_t)__builtin_parity(data)) {
+                sim.stats.protocol_errors++;
+            } else {
+                swd_sim_write(sim.request & 0x02, (sim.request >> 3) & 0x03, data);
+            }
+            sim.state = SwdSimStateIdle;
+        }
+        break;
+    case SwdSimStateLockout:
+        break;
+    }
+}
+
+void furi_hal_gpio_init(const GpioPin* gpio, GpioMode mode, GpioPull pull, GpioSpeed speed) {
+    UNUSED(pull);
+    UNUSED(speed);
+    sim.stats.gpio_inits++;
+    if(gpio == sim.swdio) sim.host_output = mode != GpioModeInput;
+}
+
+void furi_hal_gpio_write(const GpioPin* gpio, bool state) {
+    sim.stats.gpio_writes++;
+    if(gpio == sim.swclk) {
+        if(state && !sim.clock) swd_sim_rising_edge();
+        sim.clock = state;
+    } else if(gpio == sim.swdio) {
+        sim.host_odr = state;
+    }
+}
+
+bool furi_hal_gpio_read(const GpioPin* gpio) {
+    sim.stats.gpio_reads++;
+    if(gpio != sim.swdio) return true;
+    return sim.target_driving ? sim.target_level : swd_sim_host_level();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "furi_host.h"
+
+/*
+ * Bit level model of an ADIv5 SW-DP with one 32 bit MEM-AP in front of a block of memory.
+ *
+ * It sits behind furi_hal_gpio_*: SWDIO is sampled on every rising SWCLK edge while the probe
+ * drives it, and the target puts its next bit on the line on the rising edge while it drives.
+ * That matches the order swd.c bit-bangs in, the probe reads SWDIO after the falling edge.
+ *
+ * Line reset, request parity, posted AP reads, RDBUFF, TAR auto-increment with its 1 KiB wrap,
+ * CTRL/STAT power-up handshake and sticky errors on accesses outside the memory are modelled.
+ */
+
+#define SWD_SIM_DPIDR 0x2BA01477u
+
+typedef struct {
+    uint32_t clocks;
+    uint32_t gpio_inits;
+    uint32_t gpio_writes;
+    uint32_t gpio_reads;
+    uint32_t transfers;
+    uint32_t protocol_errors;
+    uint32_t faults;
+} SwdSimStats;
+
+/** Route SWCLK/SWDIO to the target, memory is filled with swd_sim_pattern() */
+void swd_sim_init(const GpioPin* swclk, const GpioPin* swdio, uint32_t base, uint32_t size);
+
+void swd_sim_deinit(void);
+
+/** Word the model holds at address */
+uint32_t swd_sim_pattern(uint32_t address);
+
+const SwdSimStats* swd_sim_get_stats(void);
+
+void swd_sim_reset_stats(void);
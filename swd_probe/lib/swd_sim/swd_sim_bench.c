@@ -0,0 +1,207 @@
+// Reads target memory through the real swd.c and the bit level target model, reports SWCLK
+// cycles, SWD transfers and GPIO reconfigurations per word for each way mem_dump can read.
+#include <unistd.h>
+
+#include "swd.h"
+#include "swd_sim.h"
+
+#define BENCH_BASE 0x08000000u
+#define BENCH_DEFAULT_LENGTH 0x4000u
+#define BENCH_DEFAULT_BLOCK 0x1000u
+#define BENCH_DEFAULT_OFFSET 0x100u
+#define BENCH_DEFAULT_KHZ 1000u
+
+typedef uint8_t (*BenchReader)(
+    AppFSM* const ctx,
+    uint8_t ap,
+    uint32_t address,
+    uint8_t* buf,
+    uint32_t len);
+
+// mem_dump with blocksize 4: CSW, TAR and two DRW reads for every word
+static uint8_t bench_read_words(
+    AppFSM* const ctx,
+    uint8_t ap,
+    uint32_t address,
+    uint8_t* buf,
+    uint32_t len) {
+    for(uint32_t pos = 0; pos < len; pos += 4) {
+        uint32_t data;
+        uint8_t ret = swd_read_memory(ctx, ap, address + pos, &data);
+        if(ret != 1) return ret;
+        memcpy(&buf[pos], &data, 4);
+    }
+    return 1;
+}
+
+// swd_read_memory_block before the TAR wrap handling: one TAR write per block and a posted
+// DRW read past the end instead of RDBUFF
+static uint8_t bench_read_block_unwrapped(
+    AppFSM* const ctx,
+    uint8_t ap,
+    uint32_t address,
+    uint8_t* buf,
+    uint32_t len) {
+    uint8_t ret = 0;
+    uint32_t data = 0;
+
+    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, 0x23000012);
+    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
+    ret |= swd_transfer(ctx, true, false, (MEMAP_DRW >> 2) & 3, &data);
+
+    for(size_t pos = 0; pos < len; pos += 4) {
+        ret |= swd_transfer(ctx, true, false, (MEMAP_DRW >> 2) & 3, &data);
+        memcpy(&buf[pos], &data, 4);
+        if(ret != 1) {
+            swd_abort(ctx);
+            return ret;
+        }
+    }
+    return ret;
+}
+
+static bool bench_connect(AppFSM* const ctx) {
+    uint32_t dpidr = 0;
+    uint32_t ctrlstat = CSYSPWRUPREQ | CDBGPWRUPREQ;
+
+    swd_line_reset(ctx);
+    if(swd_transfer(ctx, false, false, REG_IDCODE, &dpidr) != 1 || dpidr != SWD_SIM_DPIDR) {
+        printf("DPIDR read failed: %08X\n", dpidr);
+        return false;
+    }
+    return swd_write_dpbank(ctx, REG_CTRLSTAT, REG_CTRLSTAT_BANK, &ctrlstat) == 1;
+}
+
+static bool bench_run(
+    AppFSM* const ctx,
+    const char* name,
+    BenchReader reader,
+    uint32_t address,
+    uint32_t length,
+    uint32_t block,
+    uint32_t khz) {
+    uint8_t* buf = calloc(1, length + block);
+    uint32_t failed_blocks = 0;
+    uint32_t bad_words = 0;
+
+    swd_sim_reset_stats();
+    for(uint32_t pos = 0; pos < length; pos += block) {
+        if(reader(ctx, 0, address + pos, buf + pos, block) != 1) failed_blocks++;
+    }
+    SwdSimStats stats = *swd_sim_get_stats();
+
+    for(uint32_t pos = 0; pos < length; pos += 4) {
+        uint32_t data;
+        memcpy(&data, buf + pos, 4);
+        if(data != swd_sim_pattern(address + pos)) bad_words++;
+    }
+
+    // Sticky errors left behind show up on the next AP access
+    uint32_t ctrlstat = 0;
+    swd_read_dpbank(ctx, REG_CTRLSTAT, REG_CTRLSTAT_BANK, &ctrlstat);
+    bool sticky = ctrlstat & STICKYERR;
+    swd_abort(ctx);
+
+    double words = length / 4.0;
+    printf(
+        "%-20s %9.1f %9.2f %9.2f %9.2f %8.1f %6u %6lu %s\n",
+        name,
+        stats.clocks / words,
+        stats.transfers / words,
+        stats.gpio_inits / words,
+        (stats.gpio_writes + stats.gpio_reads) / words,
+        length / (stats.clocks / (khz * 1000.0)) / 1024,
+        bad_words,
+        (unsigned long)stats.faults,
+        failed_blocks || sticky ? "sticky error" : "");
+
+    free(buf);
+    return bad_words == 0 && stats.faults == 0 && !failed_blocks && !sticky;
+}
+
+int main(int argc, char** argv) {
+    uint32_t length = BENCH_DEFAULT_LENGTH;
+    uint32_t block = BENCH_DEFAULT_BLOCK;
+    uint32_t offset = BENCH_DEFAULT_OFFSET;
+    uint32_t khz = BENCH_DEFAULT_KHZ;
+    int opt;
+
+    while((opt = getopt(argc, argv, "l:b:o:k:v")) != -1) {
+        switch(opt) {
+        case 'l':
+            length = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            block = strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            offset = strtoul(optarg, NULL, 0);
+            break;
+        case 'k':
+            khz = strtoul(optarg, NULL, 0);
+            break;
+        case 'v':
+            host_verbose = true;
+            break;
+        default:
+            fprintf(
+                stderr,
+                "Usage: %s [-l length] [-b blocksize] [-o offset] [-k swclk kHz] [-v]\n",
+                argv[0]);
+            return 2;
+        }
+    }
+    // mem_dump limits
+    if(block < 4 || block > 0x1000 || (block & 3) || (length % block) || (offset & 3) ||
+       khz == 0) {
+        fprintf(stderr, "blocksize 4..4096 dividing the length, word aligned offset\n");
+        return 2;
+    }
+
+    // Memory ends right where the dump does, reading past it faults like a real target
+    AppFSM* app = calloc(1, sizeof(AppFSM));
+    app->mode_page = ModePageDPRegs;
+    app->io_num_swc = 0;
+    app->io_num_swd = 1;
+    app->swd_idle_bits = IDLE_BITS;
+    swd_sim_init(gpios[app->io_num_swc], gpios[app->io_num_swd], BENCH_BASE, offset + length);
+
+    if(!bench_connect(app)) {
+        printf("FAILED\n");
+        return 1;
+    }
+
+    uint32_t address = BENCH_BASE + offset;
+    printf(
+        "Dump of 0x%X bytes at 0x%08X in 0x%X byte blocks, KiB/s at %u kHz SWCLK\n",
+        length,
+        address,
+        block,
+        khz);
+    printf(
+        "%-20s %9s %9s %9s %9s %8s %6s %6s\n",
+        "reader",
+        "clk/word",
+        "xfer/word",
+        "init/word",
+        "gpio/word",
+        "KiB/s",
+        "bad",
+        "faults");
+
+    bench_run(app, "word at a time", bench_read_words, address, length, 4, khz);
+    bench_run(app, "block, no TAR wrap", bench_read_block_unwrapped, address, length, block, khz);
+    bool ok =
+        bench_run(app, "block, pipelined", swd_read_memory_block, address, length, block, khz);
+
+    const SwdSimStats* stats = swd_sim_get_stats();
+    if(stats->protocol_errors) {
+        printf("%lu SWD protocol errors\n", (unsigned long)stats->protocol_errors);
+        ok = false;
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+
+    swd_sim_deinit();
+    free(app);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,435 @@
+#include "swd.h"
+
+const GpioPin* gpios[SWD_GPIO_COUNT] = {
+    &gpio_ext_pc0,
+    &gpio_ext_pc1,
+    &gpio_ext_pc3,
+    &gpio_ext_pb2,
+    &gpio_ext_pb3,
+    &gpio_ext_pa4,
+    &gpio_ext_pa6,
+    &gpio_ext_pa7};
+
+void swd_configure_pins(AppFSM* const ctx, bool output) {
+    if(ctx->mode_page > ModePageFound && ctx->io_num_swc < 8 && ctx->io_num_swd < 8) {
+        /* SWDIO stays an open drain output and is released to the pull-up while the target
+           drives it, so turnarounds don't reconfigure the port twice per transfer */
+        uint8_t io_state = SWD_IO_STATE_VALID | (ctx->io_num_swc << 3) | ctx->io_num_swd;
+        if(ctx->io_state != io_state) {
+            furi_hal_gpio_init(
+                gpios[ctx->io_num_swc], GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+            furi_hal_gpio_init(
+                gpios[ctx->io_num_swd], GpioModeOutputOpenDrain, GpioPullUp, GpioSpeedVeryHigh);
+            ctx->io_state = io_state;
+        }
+        if(!output) {
+            furi_hal_gpio_write(gpios[ctx->io_num_swd], true);
+        }
+        return;
+    }
+
+    ctx->io_state = 0;
+
+    for(int io = 0; io < 8; io++) {
+        uint8_t bitmask = 1 << io;
+
+        /* if neither candidate for SWC nor SWD then skip */
+        if(!(ctx->io_swc & bitmask) && !(ctx->io_swd & bitmask)) {
+            furi_hal_gpio_init(gpios[io], GpioModeInput, GpioPullUp, GpioSpeedVeryHigh);
+            continue;
+        }
+
+        if(ctx->current_mask & bitmask) {
+            /* set for clock */
+            furi_hal_gpio_init(gpios[io], GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
+        } else {
+            /* set for data */
+            if(!output) {
+                furi_hal_gpio_init(gpios[io], GpioModeInput, GpioPullUp, GpioSpeedVeryHigh);
+            } else {
+                furi_hal_gpio_init(
+                    gpios[io], GpioModeOutputOpenDrain, GpioPullUp, GpioSpeedVeryHigh);
+            }
+        }
+    }
+}
+
+static void swd_set_clock(AppFSM* const ctx, const uint8_t level) {
+    if(ctx->mode_page > ModePageFound && ctx->io_num_swc < 8) {
+        furi_hal_gpio_write(gpios[ctx->io_num_swc], level);
+        return;
+    }
+
+    for(int io = 0; io < 8; io++) {
+        uint8_t bitmask = 1 << io;
+
+        /* if no candidate for SWC then skip */
+        if(!(ctx->io_swc & bitmask)) {
+            continue;
+        }
+
+        if(ctx->current_mask & bitmask) {
+            furi_hal_gpio_write(gpios[io], level);
+        }
+    }
+}
+
+void swd_set_data(AppFSM* const ctx, const uint8_t level) {
+    if(ctx->mode_page > ModePageFound && ctx->io_num_swd < 8) {
+        furi_hal_gpio_write(gpios[ctx->io_num_swd], level);
+        return;
+    }
+
+    for(int io = 0; io < 8; io++) {
+        uint8_t bitmask = 1 << io;
+
+        /* if no candidate for SWD then skip */
+        if(!(ctx->io_swd & bitmask)) {
+            continue;
+        }
+
+        if(!(ctx->current_mask & bitmask)) {
+            furi_hal_gpio_write(gpios[io], level);
+        }
+    }
+}
+
+static uint8_t swd_get_data(AppFSM* const ctx) {
+    if(ctx->mode_page > ModePageFound && ctx->io_num_swd < 8) {
+        return furi_hal_gpio_read(gpios[ctx->io_num_swd]);
+    }
+
+    uint8_t bits = 0;
+    for(int io = 0; io < 8; io++) {
+        uint8_t bitmask = 1 << io;
+
+        /* if no candidate for SWD then skip */
+        if(!(ctx->io_swd & bitmask)) {
+            continue;
+        }
+        bits |= furi_hal_gpio_read(gpios[io]) ? bitmask : 0;
+    }
+    return bits;
+}
+
+static void swd_clock_delay(AppFSM* const ctx) {
+    if(ctx->swd_clock_delay) {
+        furi_delay_us(ctx->swd_clock_delay);
+    }
+}
+
+static void swd_write_bit(AppFSM* const ctx, bool level) {
+    swd_set_clock(ctx, 0);
+    swd_set_data(ctx, level);
+    swd_clock_delay(ctx);
+    swd_set_clock(ctx, 1);
+    swd_clock_delay(ctx);
+    swd_set_clock(ctx, 0);
+}
+
+uint8_t swd_read_bit(AppFSM* const ctx) {
+    swd_set_clock(ctx, 1);
+    swd_clock_delay(ctx);
+    swd_set_clock(ctx, 0);
+    uint8_t bits = swd_get_data(ctx);
+    swd_clock_delay(ctx);
+    swd_set_clock(ctx, 1);
+
+    return bits;
+}
+
+/* send a byte or less LSB-first */
+void swd_write_byte(AppFSM* const ctx, const uint8_t data, size_t bits) {
+    for(size_t pos = 0; pos < bits; pos++) {
+        swd_write_bit(ctx, data & (1 << pos));
+    }
+}
+
+/* send a sequence of bytes LSB-first */
+void swd_write(AppFSM* const ctx, const uint8_t* data, size_t bits) {
+    size_t byte_pos = 0;
+    while(bits > 0) {
+        size_t remain = (bits > 8) ? 8 : bits;
+        swd_write_byte(ctx, data[byte_pos++], remain);
+        bits -= remain;
+    }
+}
+
+uint8_t swd_transfer(AppFSM* const ctx, bool ap, bool write, uint8_t a23, uint32_t* data) {
+    //notification_message(ctx->notification, &sequence_set_blue_255);
+    //notification_message(ctx->notification, &sequence_reset_red);
+
+    swd_set_data(ctx, false);
+    swd_configure_pins(ctx, true);
+
+    uint32_t idle = 0;
+    swd_write(ctx, (uint8_t*)&idle, ctx->swd_idle_bits);
+
+    uint8_t request[] = {0};
+
+    request[0] |= 0x01; /* start bit*/
+    request[0] |= ap ? 0x02 : 0; /* APnDP */
+    request[0] |= write ? 0 : 0x04; /* operation */
+    request[0] |= (a23 & 0x01) ? 0x08 : 0; /* A[2:3] */
+    request[0] |= (a23 & 0x02) ? 0x10 : 0; /* A[2:3] */
+    request[0] |= 0x80; /* park bit */
+    request[0] |= __builtin_parity(request[0]) ? 0x20 : 0; /* parity */
+
+    swd_write(ctx, request, sizeof(request) * 8);
+
+    /* turnaround cycle */
+    swd_configure_pins(ctx, false);
+
+    uint8_t ack = 0;
+
+    /* receive 3 ACK bits */
+    for(int pos = 0; pos < 3; pos++) {
+        ack >>= 1;
+        ack |= swd_read_bit(ctx) ? 0x04 : 0;
+    }
+
+    /* force ABORT/CTRL to always work */
+    if(!ap && a23 == 0) {
+        ack = 1;
+    }
+
+    if(ack != 0x01) {
+        //notification_message(ctx->notification, &sequence_reset_blue);
+        //notification_message(ctx->notification, &sequence_set_red_255);
+        return ack;
+    }
+
+    if(write) {
+        swd_write_bit(ctx, 0);
+        swd_configure_pins(ctx, true);
+
+        /* send 32 WDATA bits */
+        for(int pos = 0; pos < 32; pos++) {
+            swd_write_bit(ctx, *data & (1 << pos));
+        }
+
+        /* send parity bit */
+        swd_write_bit(ctx, __builtin_parity(*data));
+    } else {
+        *data = 0;
+        /* receive 32 RDATA bits */
+        for(int pos = 0; pos < 32; pos++) {
+            *data >>= 1;
+            *data |= swd_read_bit(ctx) ? 0x80000000 : 0;
+        }
+
+        /* receive parity bit */
+        bool parity = swd_read_bit(ctx);
+
+        if(parity != __builtin_parity(*data)) {
+            //notification_message(ctx->notification, &sequence_reset_blue);
+            //notification_message(ctx->notification, &sequence_set_red_255);
+            return 8;
+        }
+    }
+    swd_set_data(ctx, false);
+    swd_configure_pins(ctx, true);
+    //notification_message(ctx->notification, &sequence_reset_blue);
+
+    return ack;
+}
+
+/* A line reset is achieved by holding the data signal HIGH for at least 50 clock cycles, followed by at least two idle cycles. */
+void swd_line_reset(AppFSM* const ctx) {
+    //notification_message(ctx->notification, &sequence_set_red_255);
+    for(int bitcount = 0; bitcount < 50; bitcount += 8) {
+        swd_write_byte(ctx, 0xFF, 8);
+    }
+    swd_write_byte(ctx, 0, 8);
+    ctx->dp_regs.select_ok = false;
+    //notification_message(ctx->notification, &sequence_reset_red);
+}
+
+void swd_abort(AppFSM* const ctx) {
+    uint32_t dpidr;
+
+    /* first reset the line */
+    swd_line_reset(ctx);
+    swd_transfer(ctx, false, false, 0, &dpidr);
+    uint32_t abort = 0x0E;
+    swd_transfer(ctx, false, true, 0, &abort);
+}
+
+void swd_abort_simple(AppFSM* const ctx) {
+    uint32_t abort = 0x0E;
+    swd_transfer(ctx, false, true, 0, &abort);
+
+    uint32_t dpidr;
+    if(swd_transfer(ctx, false, false, 0, &dpidr) != 1) {
+        swd_abort(ctx);
+    }
+}
+
+uint8_t swd_select(AppFSM* const ctx, uint8_t ap_sel, uint8_t ap_bank, uint8_t dp_bank) {
+    uint32_t bank_reg = (ap_sel << 24) | ((ap_bank & 0x0F) << 4) | (dp_bank & 0x0F);
+
+    if(ctx->dp_regs.select_ok && bank_reg == ctx->dp_regs.select) {
+        return 1;
+    }
+
+    uint8_t ret = swd_transfer(ctx, false, true, REG_SELECT, &bank_reg);
+    if(ret != 1) {
+        ctx->dp_regs.select_ok = false;
+        DBG("failed: %d", ret);
+        return ret;
+    }
+
+    ctx->dp_regs.select = bank_reg;
+    ctx->dp_regs.select_ok = true;
+    return ret;
+}
+
+uint8_t swd_read_dpbank(AppFSM* const ctx, uint8_t dp_off, uint8_t dp_bank, uint32_t* data) {
+    uint8_t ret = 0;
+
+    /* select target bank */
+    if(dp_bank < 0x10) {
+        uint8_t ret = swd_select(ctx, 0, 0, dp_bank);
+        if(ret != 1) {
+            DBGS("swd_select failed");
+            return ret;
+        }
+    }
+
+    /* read data from it */
+    *data = 0;
+    ret = swd_transfer(ctx, false, false, dp_off, data);
+    if(ret != 1) {
+        DBG("failed: %d", ret);
+        return ret;
+    }
+    return ret;
+}
+
+uint8_t swd_write_dpbank(AppFSM* const ctx, uint8_t dp_off, uint8_t dp_bank, uint32_t* data) {
+    uint8_t ret = 0;
+
+    /* select target bank */
+    if(dp_bank < 0x10) {
+        ret = swd_select(ctx, 0, 0, dp_bank);
+        if(ret != 1) {
+            DBGS("swd_select failed");
+            return ret;
+        }
+    }
+
+    /* write it */
+    ret = swd_transfer(ctx, false, true, dp_off, data);
+    if(ret != 1) {
+        DBG("failed: %d", ret);
+        return ret;
+    }
+    return ret;
+}
+
+uint8_t swd_read_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t* data) {
+    /* select target bank */
+    uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
+    if(ret != 1) {
+        DBGS("swd_select failed");
+        return ret;
+    }
+    ret = swd_transfer(ctx, true, false, (ap_off >> 2) & 3, data);
+    *data = 0;
+    ret = swd_transfer(ctx, true, false, (ap_off >> 2) & 3, data);
+    if(ret != 1) {
+        DBG("failed: %d", ret);
+        return ret;
+    }
+    return ret;
+}
+
+uint8_t swd_write_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t data) {
+    uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
+    if(ret != 1) {
+        DBGS("swd_select failed");
+        return ret;
+    }
+    ret = swd_transfer(ctx, true, true, (ap_off >> 2) & 3, &data);
+    if(ret != 1) {
+        DBG("failed: %d", ret);
+        return ret;
+    }
+    return ret;
+}
+
+uint8_t swd_write_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t data) {
+    uint8_t ret = 0;
+    uint32_t csw = 0x23000002;
+
+    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
+    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
+    ret |= swd_write_ap(ctx, ap, MEMAP_DRW, data);
+    DBG("write 0x%08lX to 0x%08lX", data, address);
+
+    if(ret != 1) {
+        swd_abort(ctx);
+    }
+    return ret;
+}
+
+uint8_t swd_read_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t* data) {
+    uint8_t ret = 0;
+    uint32_t csw = 0x23000002;
+
+    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
+    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
+    ret |= swd_read_ap(ctx, ap, MEMAP_DRW, data);
+
+    if(ret != 1) {
+        DBG("read from 0x%08lX failed", address);
+        swd_abort(ctx);
+    } else {
+        DBG("read 0x%08lX from 0x%08lX", *data, address);
+    }
+    return ret;
+}
+
+uint8_t swd_read_memory_block(
+    AppFSM* const ctx,
+    uint8_t ap,
+    uint32_t address,
+    uint8_t* buf,
+    uint32_t len) {
+    uint32_t csw = 0x23000012;
+    uint32_t pos = 0;
+
+    uint8_t ret = swd_write_ap(ctx, ap, MEMAP_CSW, csw);
+
+    while(ret == 1 && pos < len) {
+        /* TAR only auto-increments within a 1 KiB block, reload it at every boundary */
+        uint32_t chunk = MEMAP_TAR_WRAP - ((address + pos) & (MEMAP_TAR_WRAP - 1));
+        if(chunk > len - pos) {
+            chunk = len - pos;
+        }
+        uint32_t words = (chunk + 3) / 4;
+        uint32_t data = 0;
+
+        ret = swd_write_ap(ctx, ap, MEMAP_TAR, address + pos);
+
+        /* posted reads, SELECT is still on bank 0 from the TAR write: every DRW read returns
+           the previous word and starts the next one, the last word is fetched from RDBUFF */
+        if(ret == 1) {
+            ret = swd_transfer(ctx, true, false, (MEMAP_DRW >> 2) & 3, &data);
+        }
+        for(uint32_t word = 0; ret == 1 && word < words; word++) {
+            bool last = (word + 1 == words);
+            ret = swd_transfer(ctx, !last, false, last ? REG_RDBUFF : (MEMAP_DRW >> 2) & 3, &data);
+
+            uint32_t copy = (len - pos < 4) ? len - pos : 4;
+            memcpy(&buf[pos], &data, copy);
+            pos += copy;
+        }
+    }
+
+    if(ret != 1) {
+        DBG("read from 0x%08lX failed", address + pos);
+        swd_abort(ctx);
+    }
+    return ret;
+}
@@ -0,0 +1,40 @@
+#ifndef __SWD_H__
+#define __SWD_H__
+
+#include "swd_probe_app.h"
+
+/* bit-banged SWD wire protocol and DP/AP/memory access on top of it */
+
+#define SWD_GPIO_COUNT 8
+/* AppFSM.io_state, set once the single SWC/SWD pin pair has been configured */
+#define SWD_IO_STATE_VALID 0x80
+
+extern const GpioPin* gpios[SWD_GPIO_COUNT];
+
+void swd_configure_pins(AppFSM* const ctx, bool output);
+void swd_set_data(AppFSM* const ctx, const uint8_t level);
+uint8_t swd_read_bit(AppFSM* const ctx);
+void swd_write_byte(AppFSM* const ctx, const uint8_t data, size_t bits);
+void swd_write(AppFSM* const ctx, const uint8_t* data, size_t bits);
+
+uint8_t swd_transfer(AppFSM* const ctx, bool ap, bool write, uint8_t a23, uint32_t* data);
+void swd_line_reset(AppFSM* const ctx);
+void swd_abort(AppFSM* const ctx);
+void swd_abort_simple(AppFSM* const ctx);
+uint8_t swd_select(AppFSM* const ctx, uint8_t ap_sel, uint8_t ap_bank, uint8_t dp_bank);
+
+uint8_t swd_read_dpbank(AppFSM* const ctx, uint8_t dp_off, uint8_t dp_bank, uint32_t* data);
+uint8_t swd_write_dpbank(AppFSM* const ctx, uint8_t dp_off, uint8_t dp_bank, uint32_t* data);
+uint8_t swd_read_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t* data);
+uint8_t swd_write_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t data);
+
+uint8_t swd_write_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t data);
+/* len bytes from address on, TAR auto-increment with posted reads */
+uint8_t swd_read_memory_block(
+    AppFSM* const ctx,
+    uint8_t ap,
+    uint32_t address,
+    uint8_t* buf,
+    uint32_t len);
+
+#endif
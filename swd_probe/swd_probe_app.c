@@ -4,6 +4,7 @@
 #include "swd_probe_icons.h"
 #include "jep106.h"
 #include "adi.h"
+#include "swd.h"
 
 #include <assets_icons.h>
 
@@ -11,19 +12,8 @@
 
 static void render_callback(Canvas* const canvas, void* cb_ctx);
 static bool swd_message_process(AppFSM* ctx);
-static uint8_t swd_transfer(AppFSM* const ctx, bool ap, bool write, uint8_t a23, uint32_t* data);
 static bool swd_execute_script(AppFSM* const ctx, const char* filename);
 
-static const GpioPin* gpios[] = {
-    &gpio_ext_pc0,
-    &gpio_ext_pc1,
-    &gpio_ext_pc3,
-    &gpio_ext_pb2,
-    &gpio_ext_pb3,
-    &gpio_ext_pa4,
-    &gpio_ext_pa6,
-    &gpio_ext_pa7};
-
 static const char* gpio_names[] = {"PC0", "PC1", "PC3", "PB2", "PB3", "PA4", "PA6", "PA7"};
 
 /* bit set: clock, else data */
@@ -71,6 +61,7 @@ const NotificationSequence seq_error = {
 };
 
 const NotificationSequence* seq_sounds[] = {&seq_c_minor, &seq_error};
+_Static_assert(COUNT_OF(seq_sounds) == SWD_SCRIPT_BEEP_SOUNDS, "beep sounds");
 
 static bool has_multiple_bits(uint8_t x) {
     return (x & (x - 1)) != 0;
@@ -92,426 +83,6 @@ static const char* gpio_name(uint8_t mask) {
     return gpio_names[io];
 }
 
-static void swd_configure_pins(AppFSM* const ctx, bool output) {
-    if(ctx->mode_page > ModePageFound && ctx->io_num_swc < 8 && ctx->io_num_swd < 8) {
-        furi_hal_gpio_init(
-            gpios[ctx->io_num_swc], GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-        if(!output) {
-            furi_hal_gpio_init(
-                gpios[ctx->io_num_swd], GpioModeInput, GpioPullUp, GpioSpeedVeryHigh);
-        } else {
-            furi_hal_gpio_init(
-                gpios[ctx->io_num_swd], GpioModeOutputOpenDrain, GpioPullUp, GpioSpeedVeryHigh);
-        }
-        return;
-    }
-
-    for(int io = 0; io < 8; io++) {
-        uint8_t bitmask = 1 << io;
-
-        /* if neither candidate for SWC nor SWD then skip */
-        if(!(ctx->io_swc & bitmask) && !(ctx->io_swd & bitmask)) {
-            furi_hal_gpio_init(gpios[io], GpioModeInput, GpioPullUp, GpioSpeedVeryHigh);
-            continue;
-        }
-
-        if(ctx->current_mask & bitmask) {
-            /* set for clock */
-            furi_hal_gpio_init(gpios[io], GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
-        } else {
-            /* set for data */
-            if(!output) {
-                furi_hal_gpio_init(gpios[io], GpioModeInput, GpioPullUp, GpioSpeedVeryHigh);
-            } else {
-                furi_hal_gpio_init(
-                    gpios[io], GpioModeOutputOpenDrain, GpioPullUp, GpioSpeedVeryHigh);
-            }
-        }
-    }
-}
-
-static void swd_set_clock(AppFSM* const ctx, const uint8_t level) {
-    if(ctx->mode_page > ModePageFound && ctx->io_num_swc < 8) {
-        furi_hal_gpio_write(gpios[ctx->io_num_swc], level);
-        return;
-    }
-
-    for(int io = 0; io < 8; io++) {
-        uint8_t bitmask = 1 << io;
-
-        /* if no candidate for SWC then skip */
-        if(!(ctx->io_swc & bitmask)) {
-            continue;
-        }
-
-        if(ctx->current_mask & bitmask) {
-            furi_hal_gpio_write(gpios[io], level);
-        }
-    }
-}
-
-static void swd_set_data(AppFSM* const ctx, const uint8_t level) {
-    if(ctx->mode_page > ModePageFound && ctx->io_num_swd < 8) {
-        furi_hal_gpio_write(gpios[ctx->io_num_swd], level);
-        return;
-    }
-
-    for(int io = 0; io < 8; io++) {
-        uint8_t bitmask = 1 << io;
-
-        /* if no candidate for SWD then skip */
-        if(!(ctx->io_swd & bitmask)) {
-            continue;
-        }
-
-        if(!(ctx->current_mask & bitmask)) {
-            furi_hal_gpio_write(gpios[io], level);
-        }
-    }
-}
-
-static uint8_t swd_get_data(AppFSM* const ctx) {
-    if(ctx->mode_page > ModePageFound && ctx->io_num_swd < 8) {
-        return furi_hal_gpio_read(gpios[ctx->io_num_swd]);
-    }
-
-    uint8_t bits = 0;
-    for(int io = 0; io < 8; io++) {
-        uint8_t bitmask = 1 << io;
-
-        /* if no candidate for SWD then skip */
-        if(!(ctx->io_swd & bitmask)) {
-            continue;
-        }
-        bits |= furi_hal_gpio_read(gpios[io]) ? bitmask : 0;
-    }
-    return bits;
-}
-
-static void swd_clock_delay(AppFSM* const ctx) {
-    if(ctx->swd_clock_delay) {
-        furi_delay_us(ctx->swd_clock_delay);
-    }
-}
-
-static void swd_write_bit(AppFSM* const ctx, bool level) {
-    swd_set_clock(ctx, 0);
-    swd_set_data(ctx, level);
-    swd_clock_delay(ctx);
-    swd_set_clock(ctx, 1);
-    swd_clock_delay(ctx);
-    swd_set_clock(ctx, 0);
-}
-
-static uint8_t swd_read_bit(AppFSM* const ctx) {
-    swd_set_clock(ctx, 1);
-    swd_clock_delay(ctx);
-    swd_set_clock(ctx, 0);
-    uint8_t bits = swd_get_data(ctx);
-    swd_clock_delay(ctx);
-    swd_set_clock(ctx, 1);
-
-    return bits;
-}
-
-/* send a byte or less LSB-first */
-static void swd_write_byte(AppFSM* const ctx, const uint8_t data, size_t bits) {
-    for(size_t pos = 0; pos < bits; pos++) {
-        swd_write_bit(ctx, data & (1 << pos));
-    }
-}
-
-/* send a sequence of bytes LSB-first */
-static void swd_write(AppFSM* const ctx, const uint8_t* data, size_t bits) {
-    size_t byte_pos = 0;
-    while(bits > 0) {
-        size_t remain = (bits > 8) ? 8 : bits;
-        swd_write_byte(ctx, data[byte_pos++], remain);
-        bits -= remain;
-    }
-}
-
-static uint8_t swd_transfer(AppFSM* const ctx, bool ap, bool write, uint8_t a23, uint32_t* data) {
-    //notification_message(ctx->notification, &sequence_set_blue_255);
-    //notification_message(ctx->notification, &sequence_reset_red);
-
-    swd_set_data(ctx, false);
-    swd_configure_pins(ctx, true);
-
-    uint32_t idle = 0;
-    swd_write(ctx, (uint8_t*)&idle, ctx->swd_idle_bits);
-
-    uint8_t request[] = {0};
-
-    request[0] |= 0x01; /* start bit*/
-    request[0] |= ap ? 0x02 : 0; /* APnDP */
-    request[0] |= write ? 0 : 0x04; /* operation */
-    request[0] |= (a23 & 0x01) ? 0x08 : 0; /* A[2:3] */
-    request[0] |= (a23 & 0x02) ? 0x10 : 0; /* A[2:3] */
-    request[0] |= 0x80; /* park bit */
-    request[0] |= __builtin_parity(request[0]) ? 0x20 : 0; /* parity */
-
-    swd_write(ctx, request, sizeof(request) * 8);
-
-    /* turnaround cycle */
-    swd_configure_pins(ctx, false);
-
-    uint8_t ack = 0;
-
-    /* receive 3 ACK bits */
-    for(int pos = 0; pos < 3; pos++) {
-        ack >>= 1;
-        ack |= swd_read_bit(ctx) ? 0x04 : 0;
-    }
-
-    /* force ABORT/CTRL to always work */
-    if(!ap && a23 == 0) {
-        ack = 1;
-    }
-
-    if(ack != 0x01) {
-        //notification_message(ctx->notification, &sequence_reset_blue);
-        //notification_message(ctx->notification, &sequence_set_red_255);
-        return ack;
-    }
-
-    if(write) {
-        swd_write_bit(ctx, 0);
-        swd_configure_pins(ctx, true);
-
-        /* send 32 WDATA bits */
-        for(int pos = 0; pos < 32; pos++) {
-            swd_write_bit(ctx, *data & (1 << pos));
-        }
-
-        /* send parity bit */
-        swd_write_bit(ctx, __builtin_parity(*data));
-    } else {
-        *data = 0;
-        /* receive 32 RDATA bits */
-        for(int pos = 0; pos < 32; pos++) {
-            *data >>= 1;
-            *data |= swd_read_bit(ctx) ? 0x80000000 : 0;
-        }
-
-        /* receive parity bit */
-        bool parity = swd_read_bit(ctx);
-
-        if(parity != __builtin_parity(*data)) {
-            //notification_message(ctx->notification, &sequence_reset_blue);
-            //notification_message(ctx->notification, &sequence_set_red_255);
-            return 8;
-        }
-    }
-    swd_set_data(ctx, false);
-    swd_configure_pins(ctx, true);
-    //notification_message(ctx->notification, &sequence_reset_blue);
-
-    return ack;
-}
-
-/* A line reset is achieved by holding the data signal HIGH for at least 50 clock cycles, followed by at least two idle cycles. */
-static void swd_line_reset(AppFSM* const ctx) {
-    //notification_message(ctx->notification, &sequence_set_red_255);
-    for(int bitcount = 0; bitcount < 50; bitcount += 8) {
-        swd_write_byte(ctx, 0xFF, 8);
-    }
-    swd_write_byte(ctx, 0, 8);
-    ctx->dp_regs.select_ok = false;
-    //notification_message(ctx->notification, &sequence_reset_red);
-}
-
-static void swd_abort(AppFSM* const ctx) {
-    uint32_t dpidr;
-
-    /* first reset the line */
-    swd_line_reset(ctx);
-    swd_transfer(ctx, false, false, 0, &dpidr);
-    uint32_t abort = 0x0E;
-    swd_transfer(ctx, false, true, 0, &abort);
-}
-
-static void swd_abort_simple(AppFSM* const ctx) {
-    uint32_t abort = 0x0E;
-    swd_transfer(ctx, false, true, 0, &abort);
-
-    uint32_t dpidr;
-    if(swd_transfer(ctx, false, false, 0, &dpidr) != 1) {
-        swd_abort(ctx);
-    }
-}
-
-static uint8_t swd_select(AppFSM* const ctx, uint8_t ap_sel, uint8_t ap_bank, uint8_t dp_bank) {
-    uint32_t bank_reg = (ap_sel << 24) | ((ap_bank & 0x0F) << 4) | (dp_bank & 0x0F);
-
-    if(ctx->dp_regs.select_ok && bank_reg == ctx->dp_regs.select) {
-        return 1;
-    }
-
-    uint8_t ret = swd_transfer(ctx, false, true, REG_SELECT, &bank_reg);
-    if(ret != 1) {
-        ctx->dp_regs.select_ok = false;
-        DBG("failed: %d", ret);
-        return ret;
-    }
-
-    ctx->dp_regs.select = bank_reg;
-    ctx->dp_regs.select_ok = true;
-    return ret;
-}
-
-static uint8_t
-    swd_read_dpbank(AppFSM* const ctx, uint8_t dp_off, uint8_t dp_bank, uint32_t* data) {
-    uint8_t ret = 0;
-
-    /* select target bank */
-    if(dp_bank < 0x10) {
-        uint8_t ret = swd_select(ctx, 0, 0, dp_bank);
-        if(ret != 1) {
-            DBGS("swd_select failed");
-            return ret;
-        }
-    }
-
-    /* read data from it */
-    *data = 0;
-    ret = swd_transfer(ctx, false, false, dp_off, data);
-    if(ret != 1) {
-        DBG("failed: %d", ret);
-        return ret;
-    }
-    return ret;
-}
-
-static uint8_t
-    swd_write_dpbank(AppFSM* const ctx, uint8_t dp_off, uint8_t dp_bank, uint32_t* data) {
-    uint8_t ret = 0;
-
-    /* select target bank */
-    if(dp_bank < 0x10) {
-        ret = swd_select(ctx, 0, 0, dp_bank);
-        if(ret != 1) {
-            DBGS("swd_select failed");
-            return ret;
-        }
-    }
-
-    /* write it */
-    ret = swd_transfer(ctx, false, true, dp_off, data);
-    if(ret != 1) {
-        DBG("failed: %d", ret);
-        return ret;
-    }
-    return ret;
-}
-
-static uint8_t swd_read_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t* data) {
-    /* select target bank */
-    uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
-    if(ret != 1) {
-        DBGS("swd_select failed");
-        return ret;
-    }
-    ret = swd_transfer(ctx, true, false, (ap_off >> 2) & 3, data);
-    *data = 0;
-    ret = swd_transfer(ctx, true, false, (ap_off >> 2) & 3, data);
-    if(ret != 1) {
-        DBG("failed: %d", ret);
-        return ret;
-    }
-    return ret;
-}
-
-static uint8_t swd_read_ap_single(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t* data) {
-    uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
-    if(ret != 1) {
-        DBGS("swd_select failed");
-        return ret;
-    }
-    *data = 0;
-    ret = swd_transfer(ctx, true, false, (ap_off >> 2) & 3, data);
-    if(ret != 1) {
-        DBG("failed: %d", ret);
-        return ret;
-    }
-    return ret;
-}
-
-static uint8_t swd_write_ap(AppFSM* const ctx, uint8_t ap, uint8_t ap_off, uint32_t data) {
-    uint8_t ret = swd_select(ctx, ap, (ap_off >> 4) & 0x0F, 0);
-    if(ret != 1) {
-        DBGS("swd_select failed");
-        return ret;
-    }
-    ret = swd_transfer(ctx, true, true, (ap_off >> 2) & 3, &data);
-    if(ret != 1) {
-        DBG("failed: %d", ret);
-        return ret;
-    }
-    return ret;
-}
-
-static uint8_t swd_write_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t data) {
-    uint8_t ret = 0;
-    uint32_t csw = 0x23000002;
-
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
-    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
-    ret |= swd_write_ap(ctx, ap, MEMAP_DRW, data);
-    DBG("write 0x%08lX to 0x%08lX", data, address);
-
-    if(ret != 1) {
-        swd_abort(ctx);
-    }
-    return ret;
-}
-
-uint8_t swd_read_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t* data) {
-    uint8_t ret = 0;
-    uint32_t csw = 0x23000002;
-
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
-    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
-    ret |= swd_read_ap(ctx, ap, MEMAP_DRW, data);
-
-    if(ret != 1) {
-        DBG("read from 0x%08lX failed", address);
-        swd_abort(ctx);
-    } else {
-        DBG("read 0x%08lX from 0x%08lX", *data, address);
-    }
-    return ret;
-}
-
-static uint8_t swd_read_memory_block(
-    AppFSM* const ctx,
-    uint8_t ap,
-    uint32_t address,
-    uint8_t* buf,
-    uint32_t len) {
-    uint8_t ret = 0;
-    uint32_t data = 0;
-    uint32_t csw = 0x23000012;
-
-    ret |= swd_write_ap(ctx, ap, MEMAP_CSW, csw);
-    ret |= swd_write_ap(ctx, ap, MEMAP_TAR, address);
-    ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
-
-    for(size_t pos = 0; pos < len; pos += 4) {
-        data = 0xDEADBEEF;
-        ret |= swd_read_ap_single(ctx, ap, MEMAP_DRW, &data);
-        DBG("read %lX", data);
-
-        memcpy(&buf[pos], &data, 4);
-
-        if(ret != 1) {
-            swd_abort(ctx);
-            return ret;
-        }
-    }
-    return ret;
-}
-
 static uint32_t swd_detect(AppFSM* const ctx) {
     swd_set_data(ctx, false);
     swd_configure_pins(ctx, true);
@@ -684,8 +255,11 @@ static void swd_script_log(ScriptContext* ctx, FuriLogLevel level, const char* f
     bool commandline = false;
     ScriptContext* cur = ctx;
     FuriString* buffer = furi_string_alloc();
+    FuriString* text = furi_string_alloc();
     va_list argp;
     va_start(argp, format);
+    furi_string_vprintf(text, format, argp);
+    va_end(argp);
 
     do {
         if(cur == ctx->app->commandline) {
@@ -709,7 +283,7 @@ static void swd_script_log(ScriptContext* ctx, FuriLogLevel level, const char* f
         }
 
         furi_string_cat_str(buffer, prefix);
-        furi_string_cat_printf(buffer, format, argp);
+        furi_string_cat(buffer, text);
         furi_string_cat_str(buffer, "\n");
 
         if(!usb_uart_tx_data(
@@ -717,175 +291,12 @@ static void swd_script_log(ScriptContext* ctx, FuriLogLevel level, const char* f
             DBGS("Sending via USB failed");
         }
     } else {
-        LOG(furi_string_get_cstr(buffer));
+        LOG("%s", furi_string_get_cstr(text));
     }
-    va_end(argp);
+    furi_string_free(text);
     furi_string_free(buffer);
 }
 
-/* read characters until newline was read */
-static bool swd_script_seek_newline(ScriptContext* ctx) {
-    while(true) {
-        uint8_t ch = 0;
-
-        if(ctx->script_file) {
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                return false;
-            }
-        } else {
-            ch = ctx->line_data[ctx->line_pos];
-            if(ch == 0) {
-                return false;
-            }
-            ctx->line_pos++;
-        }
-        if(ch == '\n') {
-            return true;
-        }
-    }
-}
-
-/* read whitespaces until the next character is read. 
-   returns false if EOF or newline was read */
-static bool swd_script_skip_whitespace(ScriptContext* ctx) {
-    while(true) {
-        uint8_t ch = 0;
-        uint64_t start_pos = 0;
-
-        if(ctx->script_file) {
-            start_pos = storage_file_tell(ctx->script_file);
-
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                return false;
-            }
-        } else {
-            start_pos = ctx->line_pos;
-            ch = ctx->line_data[ctx->line_pos];
-
-            if(ch == 0) {
-                return false;
-            }
-            ctx->line_pos++;
-        }
-        if(ch == '\n') {
-            return false;
-        }
-        if(ch != ' ') {
-            if(ctx->script_file) {
-                storage_file_seek(ctx->script_file, start_pos, true);
-            } else {
-                ctx->line_pos = start_pos;
-            }
-            return true;
-        }
-    }
-}
-
-static bool swd_script_get_string(ScriptContext* ctx, char* str, size_t max_length) {
-    bool quot = false;
-    size_t pos = 0;
-
-    str[pos] = '\000';
-
-    while(true) {
-        char ch = 0;
-        uint64_t start_pos = 0;
-
-        if(ctx->script_file) {
-            start_pos = storage_file_tell(ctx->script_file);
-
-            if(storage_file_read(ctx->script_file, &ch, 1) != 1) {
-                DBGS("end reached");
-                return false;
-            }
-        } else {
-            start_pos = ctx->line_pos;
-            ch = ctx->line_data[ctx->line_pos];
-
-            if(ch == 0) {
-                DBGS("end reached");
-                return false;
-            }
-            ctx->line_pos++;
-        }
-
-        if(ch == '"') {
-            quot = !quot;
-            continue;
-        }
-        if(!quot) {
-            if(ch == ' ') {
-                break;
-            }
-            if(ch == '\r' || ch == '\n') {
-                if(ctx->script_file) {
-                    storage_file_seek(ctx->script_file, start_pos, true);
-                } else {
-                    ctx->line_pos = start_pos;
-                }
-                break;
-            }
-        }
-        if(pos + 2 > max_length) {
-            DBGS("too long");
-            return false;
-        }
-        str[pos++] = ch;
-        str[pos] = '\000';
-    }
-    DBG("got '%s'", str);
-
-    return true;
-}
-
-static bool swd_script_get_number(ScriptContext* ctx, uint32_t* number) {
-    char str[16];
-
-    if(!swd_script_get_string(ctx, str, sizeof(str))) {
-        DBGS("could not get string");
-        return false;
-    }
-    DBG("got '%s'", str);
-
-    size_t pos = 0;
-    *number = 0;
-
-    /* hex number? */
-    if(!strncmp(str, "0x", 2)) {
-        pos += 2;
-        while(str[pos]) {
-            uint8_t ch = str[pos++];
-            uint8_t ch_num = ch - '0';
-            uint8_t ch_hex = (ch & ~0x20) - 'A';
-
-            *number <<= 4;
-
-            if(ch_num <= 10) {
-                *number += ch_num;
-            } else if(ch_hex <= 5) {
-                *number += 10 + ch_hex;
-            } else {
-                return false;
-            }
-        }
-    } else {
-        while(str[pos]) {
-            uint8_t ch = str[pos++];
-            uint8_t ch_num = ch - '0';
-
-            *number *= 10;
-
-            if(ch_num < 10) {
-                *number += ch_num;
-            } else {
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
 static void swd_script_gui_refresh(ScriptContext* ctx) {
     if(furi_message_queue_get_count(ctx->app->event_queue) > 0) {
         swd_message_process(ctx->app);
@@ -898,76 +309,30 @@ static void swd_script_gui_refresh(ScriptContext* ctx) {
 
 /************************** script functions **************************/
 
-static bool swd_scriptfunc_comment(ScriptContext* ctx) {
-    DBGS("comment");
+static bool swd_scriptfunc_goto(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    DBG("goto %lu", insn->argv[0]);
 
-    swd_script_seek_newline(ctx);
-
-    return true;
-}
-
-static bool swd_scriptfunc_label(ScriptContext* ctx) {
-    char label[256];
-    DBGS("label");
-
-    swd_script_skip_whitespace(ctx);
-    if(!swd_script_get_string(ctx, label, sizeof(label))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse label");
-        return false;
-    }
-
-    if(!strcmp(label, ctx->goto_label)) {
-        ctx->goto_active = false;
-        DBG("matches '%s'", ctx->goto_label);
-    }
-
-    swd_script_seek_newline(ctx);
-
-    return true;
-}
-
-static bool swd_scriptfunc_goto(ScriptContext* ctx) {
-    DBGS("goto");
-
-    swd_script_skip_whitespace(ctx);
-
-    if(!swd_script_get_string(ctx, ctx->goto_label, sizeof(ctx->goto_label))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse target label");
-        return false;
-    }
-
-    /* start from beginning and rerun starting from label */
-    ctx->goto_active = true;
-    ctx->restart = true;
-
-    swd_script_seek_newline(ctx);
+    /* labels were resolved by the compiler, jump straight to the target */
+    ctx->pc = insn->argv[0];
 
     return true;
 }
 
 #include <toolbox/path.h>
 
-static bool swd_scriptfunc_call(ScriptContext* ctx) {
+static bool swd_scriptfunc_call(ScriptContext* ctx, const SwdScriptInsn* insn) {
     DBGS("call");
 
-    swd_script_skip_whitespace(ctx);
-
     /* fetch previous file directory */
     FuriString* filepath = furi_string_alloc();
     path_extract_dirname(ctx->filename, filepath);
     // strncpy(filename, ctx->filename, sizeof(filename));
 
-    char filename[MAX_FILE_LENGTH] = {};
     bool success = false;
     do {
         /* append filename */
-        if(!swd_script_get_string(ctx, filename, sizeof(filename))) {
-            swd_script_log(ctx, FuriLogLevelError, "failed to parse filename");
-            break;
-        }
-        furi_string_cat_printf(filepath, "/%s", filename);
+        furi_string_cat_printf(filepath, "/%s", swd_script_string(ctx->program, insn->argv[0]));
 
-        swd_script_seek_newline(ctx);
         /* append extension */
         furi_string_cat_str(filepath, ".swd");
 
@@ -986,80 +351,49 @@ static bool swd_scriptfunc_call(ScriptContext* ctx) {
     return success;
 }
 
-static bool swd_scriptfunc_status(ScriptContext* ctx) {
-    uint32_t status = 1;
+static bool swd_scriptfunc_status(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t status = (insn->argc > 0) ? insn->argv[0] : 1;
     DBGS("status");
 
-    swd_script_skip_whitespace(ctx);
-    swd_script_get_number(ctx, &status);
-
     ctx->status_ignore = (status == 0);
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_errors(ScriptContext* ctx) {
-    char type[32];
+static bool swd_scriptfunc_errors(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    const char* type = swd_script_string(ctx->program, insn->argv[0]);
     DBGS("errors");
 
-    swd_script_skip_whitespace(ctx);
-
-    if(!swd_script_get_string(ctx, type, sizeof(type))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse");
-        return false;
-    }
-
     if(!strcmp(type, "ignore")) {
         ctx->errors_ignore = true;
     }
     if(!strcmp(type, "fail")) {
         ctx->errors_ignore = false;
     }
-    swd_script_seek_newline(ctx);
 
     return true;
 }
 
-static bool swd_scriptfunc_beep(ScriptContext* ctx) {
-    uint32_t sound = 0;
+static bool swd_scriptfunc_beep(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t sound = (insn->argc > 0) ? insn->argv[0] : 0;
     DBGS("beep");
 
-    swd_script_skip_whitespace(ctx);
-    swd_script_get_number(ctx, &sound);
-
-    notification_message_block(ctx->app->notification, seq_sounds[sound]);
-
-    swd_script_seek_newline(ctx);
-
-    return true;
-}
-
-static bool swd_scriptfunc_message(ScriptContext* ctx) {
-    uint32_t wait_time = 0;
-    char message[256];
-    char type[256];
-    bool success = true;
-    bool show_dialog = false;
-
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &wait_time)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse wait_time");
-        return false;
-    }
-
-    if(!swd_script_get_string(ctx, message, sizeof(message))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse message");
+    if(sound >= COUNT_OF(seq_sounds)) {
         return false;
     }
+    notification_message_block(ctx->app->notification, seq_sounds[sound]);
+
+    return true;
+}
 
-    if(swd_script_get_string(ctx, type, sizeof(type))) {
-        if(!strcmp(type, "dialog")) {
+static bool swd_scriptfunc_message(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t wait_time = insn->argv[0];
+    const char* message = swd_script_string(ctx->program, insn->argv[1]);
+    bool success = true;
+    bool show_dialog = false;
+
+    if(insn->argc > 2) {
+        if(!strcmp(swd_script_string(ctx->program, insn->argv[2]), "dialog")) {
             show_dialog = true;
         }
     }
@@ -1079,23 +413,11 @@ static bool swd_scriptfunc_message(ScriptContext* ctx) {
         }
     }
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_swd_idle_bits(ScriptContext* ctx) {
-    uint32_t swd_idle_bits = 0;
-
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &swd_idle_bits)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse");
-        return false;
-    }
+static bool swd_scriptfunc_swd_idle_bits(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t swd_idle_bits = insn->argv[0];
 
     if(swd_idle_bits <= 32) {
         ctx->app->swd_idle_bits = swd_idle_bits;
@@ -1103,23 +425,11 @@ static bool swd_scriptfunc_swd_idle_bits(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelError, "value must be between 1 and 32");
     }
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_swd_clock_delay(ScriptContext* ctx) {
-    uint32_t swd_clock_delay = 0;
-
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &swd_clock_delay)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse");
-        return false;
-    }
+static bool swd_scriptfunc_swd_clock_delay(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t swd_clock_delay = insn->argv[0];
 
     if(swd_clock_delay <= 1000000) {
         ctx->app->swd_clock_delay = swd_clock_delay;
@@ -1127,23 +437,11 @@ static bool swd_scriptfunc_swd_clock_delay(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelError, "value must be between 1 and 1000000");
     }
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_maxtries(ScriptContext* ctx) {
-    uint32_t max_tries = 0;
-
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &max_tries)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse");
-        return false;
-    }
+static bool swd_scriptfunc_maxtries(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t max_tries = insn->argv[0];
 
     if(max_tries >= 1 && max_tries <= 1024) {
         ctx->max_tries = max_tries;
@@ -1151,23 +449,11 @@ static bool swd_scriptfunc_maxtries(ScriptContext* ctx) {
         DBGS("value must be between 1 and 1024");
     }
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_blocksize(ScriptContext* ctx) {
-    uint32_t block_size = 0;
-
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &block_size)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse");
-        return false;
-    }
+static bool swd_scriptfunc_blocksize(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t block_size = insn->argv[0];
 
     if(block_size >= 4 && block_size <= 0x1000) {
         ctx->block_size = block_size;
@@ -1175,23 +461,11 @@ static bool swd_scriptfunc_blocksize(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelError, "value must be between 4 and 4096");
     }
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_apselect(ScriptContext* ctx) {
-    uint32_t ap = 0;
-
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &ap)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse AP");
-        return false;
-    }
+static bool swd_scriptfunc_apselect(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t ap = insn->argv[0];
 
     if(!swd_apscan_test(ctx->app, ap)) {
         swd_script_log(ctx, FuriLogLevelError, "no selected AP");
@@ -1200,12 +474,11 @@ static bool swd_scriptfunc_apselect(ScriptContext* ctx) {
 
     ctx->selected_ap = ap;
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_apscan(ScriptContext* ctx) {
+static bool swd_scriptfunc_apscan(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     DBGS("Scanning APs");
     for(uint32_t ap = 0; ap < 255; ap++) {
         snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Scan AP %lu", ap);
@@ -1214,52 +487,100 @@ static bool swd_scriptfunc_apscan(ScriptContext* ctx) {
             DBG("  AP%lu detected", ap);
         }
     }
-    swd_script_seek_newline(ctx);
 
     return true;
 }
 
-static bool swd_scriptfunc_abort(ScriptContext* ctx) {
+static bool swd_scriptfunc_abort(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     DBGS("Aborting");
     swd_abort(ctx->app);
-    swd_script_seek_newline(ctx);
 
     return true;
 }
 
-static bool swd_scriptfunc_mem_dump(ScriptContext* ctx) {
-    char filename[MAX_FILE_LENGTH];
-    uint32_t address = 0;
-    uint32_t length = 0;
-    uint32_t flags = 0;
-    bool success = true;
+/* mem_dump hands filled blocks to a writer thread and reads the next one meanwhile */
+#define DUMP_BUFFERS 2
 
-    /* get file */
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
+typedef struct {
+    File* file;
+    FuriThread* thread;
+    /* blocks to write, NULL stops the thread */
+    FuriMessageQueue* filled;
+    /* blocks free to read into */
+    FuriMessageQueue* empty;
+    uint8_t* buffers[DUMP_BUFFERS];
+    uint32_t block_size;
+    bool write_error;
+} DumpWriter;
 
-    if(!swd_script_get_string(ctx, filename, sizeof(filename))) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse filename");
-        return false;
-    }
-    /* get address */
-    if(!swd_script_get_number(ctx, &address)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse address");
-        return false;
+static int32_t swd_dump_writer_thread(void* context) {
+    DumpWriter* writer = context;
+    uint8_t* buffer = NULL;
+
+    while(furi_message_queue_get(writer->filled, &buffer, FuriWaitForever) == FuriStatusOk &&
+          buffer) {
+        if(storage_file_write(writer->file, buffer, writer->block_size) != writer->block_size) {
+            writer->write_error = true;
+        }
+        furi_message_queue_put(writer->empty, &buffer, FuriWaitForever);
     }
+    return 0;
+}
 
-    /* get length */
-    if(!swd_script_get_number(ctx, &length)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse length");
-        return false;
+static DumpWriter* swd_dump_writer_alloc(File* file, uint32_t block_size) {
+    DumpWriter* writer = malloc(sizeof(DumpWriter));
+
+    writer->file = file;
+    writer->block_size = block_size;
+    writer->write_error = false;
+    writer->filled = furi_message_queue_alloc(DUMP_BUFFERS + 1, sizeof(uint8_t*));
+    writer->empty = furi_message_queue_alloc(DUMP_BUFFERS, sizeof(uint8_t*));
+    for(size_t pos = 0; pos < DUMP_BUFFERS; pos++) {
+        /* single word reads of blocks smaller than a word store a whole word */
+        writer->buffers[pos] = malloc((block_size + 3) & ~3UL);
+        furi_message_queue_put(writer->empty, &writer->buffers[pos], FuriWaitForever);
     }
+    writer->thread = furi_thread_alloc_ex("SwdDumpWriter", 1024, swd_dump_writer_thread, writer);
+    furi_thread_start(writer->thread);
+
+    return writer;
+}
+
+static uint8_t* swd_dump_writer_get(DumpWriter* writer) {
+    uint8_t* buffer = NULL;
+    furi_message_queue_get(writer->empty, &buffer, FuriWaitForever);
+    return buffer;
+}
+
+static void swd_dump_writer_put(DumpWriter* writer, uint8_t* buffer) {
+    furi_message_queue_put(writer->filled, &buffer, FuriWaitForever);
+}
+
+/* waits for pending writes, returns false if any of them failed */
+static bool swd_dump_writer_free(DumpWriter* writer) {
+    uint8_t* stop = NULL;
+    furi_message_queue_put(writer->filled, &stop, FuriWaitForever);
+    furi_thread_join(writer->thread);
+    furi_thread_free(writer->thread);
 
-    /* get flags */
-    if(swd_script_get_number(ctx, &flags)) {
-        DBGS("found extra flags");
+    bool ok = !writer->write_error;
+    for(size_t pos = 0; pos < DUMP_BUFFERS; pos++) {
+        free(writer->buffers[pos]);
     }
+    furi_message_queue_free(writer->filled);
+    furi_message_queue_free(writer->empty);
+    free(writer);
+
+    return ok;
+}
+
+static bool swd_scriptfunc_mem_dump(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    const char* filename = swd_script_string(ctx->program, insn->argv[0]);
+    uint32_t address = insn->argv[1];
+    uint32_t length = insn->argv[2];
+    uint32_t flags = (insn->argc > 3) ? insn->argv[3] : 0;
+    bool success = true;
 
     LOG("would dump %08lX, len %08lX into %s", address, length, filename);
 
@@ -1280,11 +601,13 @@ static bool swd_scriptfunc_mem_dump(ScriptContext* ctx) {
         ctx->block_size = 0x1000;
     }
 
-    uint8_t* buffer = malloc(ctx->block_size);
+    DumpWriter* writer = swd_dump_writer_alloc(dump, ctx->block_size);
 
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
 
     for(uint32_t pos = 0; pos < length; pos += ctx->block_size) {
+        uint8_t* buffer = swd_dump_writer_get(writer);
+
         if((pos & 0xFF) == 0) {
             int pct = pos * 100 / length;
             snprintf(
@@ -1335,9 +658,10 @@ static bool swd_scriptfunc_mem_dump(ScriptContext* ctx) {
             /* flags == 1: "continue reading even if it fails" */
             /* flags == 2: "its okay if cannot dump fully" */
             if(flags & 1) {
-                /* set all content to a known value as indication */
-                for(size_t fill_pos = 0; fill_pos < ctx->block_size; fill_pos += 4) {
-                    *((uint32_t*)&buffer[fill_pos]) = 0xDEADFACE;
+                /* set all content to a known value as indication, 0xDEADFACE little endian */
+                static const uint8_t fill[4] = {0xCE, 0xFA, 0xAD, 0xDE};
+                for(size_t fill_pos = 0; fill_pos < ctx->block_size; fill_pos++) {
+                    buffer[fill_pos] = fill[fill_pos & 3];
                 }
             } else if(flags & 2) {
                 success = (pos > 0);
@@ -1348,41 +672,27 @@ static bool swd_scriptfunc_mem_dump(ScriptContext* ctx) {
                 break;
             }
         }
-        storage_file_write(dump, buffer, ctx->block_size);
+        swd_dump_writer_put(writer, buffer);
     }
 
     furi_mutex_release(ctx->app->swd_mutex);
 
+    if(!swd_dump_writer_free(writer)) {
+        snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "Failed to write file");
+        swd_script_gui_refresh(ctx);
+        success = false;
+    }
     storage_file_close(dump);
-    swd_script_seek_newline(ctx);
-    free(buffer);
+    storage_file_free(dump);
 
     return success;
 }
 
-static bool swd_scriptfunc_mem_write(ScriptContext* ctx) {
-    uint32_t address = 0;
-    uint32_t data = 0;
+static bool swd_scriptfunc_mem_write(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t address = insn->argv[0];
+    uint32_t data = insn->argv[1];
     bool success = true;
 
-    /* get file */
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get address */
-    if(!swd_script_get_number(ctx, &address)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse address");
-        return false;
-    }
-
-    /* get data */
-    if(!swd_script_get_number(ctx, &data)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse data");
-        return false;
-    }
-
     DBG("write %08lX to %08lX", data, address);
 
     bool access_ok = false;
@@ -1417,27 +727,13 @@ static bool swd_scriptfunc_mem_write(ScriptContext* ctx) {
         success = false;
     }
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_mem_read(ScriptContext* ctx) {
-    uint32_t address = 0;
+static bool swd_scriptfunc_mem_read(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t address = insn->argv[0];
     bool success = true;
 
-    /* get file */
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get address */
-    if(!swd_script_get_number(ctx, &address)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse address");
-        return false;
-    }
-
     DBG("read from %08lX", address);
 
     uint32_t data = 0;
@@ -1471,40 +767,15 @@ static bool swd_scriptfunc_mem_read(ScriptContext* ctx) {
         success = false;
     }
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_mem_ldmst(ScriptContext* ctx) {
-    uint32_t address = 0;
-    uint32_t data = 0;
-    uint32_t mask = 0;
+static bool swd_scriptfunc_mem_ldmst(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t address = insn->argv[0];
+    uint32_t data = insn->argv[1];
+    uint32_t mask = insn->argv[2];
     bool success = true;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get address */
-    if(!swd_script_get_number(ctx, &address)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse address");
-        return false;
-    }
-
-    /* get data */
-    if(!swd_script_get_number(ctx, &data)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse data");
-        return false;
-    }
-
-    /* get mask */
-    if(!swd_script_get_number(ctx, &mask)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse mask");
-        return false;
-    }
-
     LOG("write %08lX to %08lX, mask %08lX", data, address, mask);
 
     bool access_ok = false;
@@ -1540,39 +811,15 @@ static bool swd_scriptfunc_mem_ldmst(ScriptContext* ctx) {
         success = false;
     }
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_dp_write(ScriptContext* ctx) {
-    uint32_t dp_bank = 0;
-    uint32_t dp_off = 0;
-    uint32_t data = 0;
+static bool swd_scriptfunc_dp_write(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t data = insn->argv[0];
+    uint32_t dp_off = insn->argv[1];
+    uint32_t dp_bank = (insn->argc > 2) ? insn->argv[2] : 0xFF;
     bool success = true;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get data */
-    if(!swd_script_get_number(ctx, &data)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse data");
-        return false;
-    }
-
-    /* get dp_off */
-    if(!swd_script_get_number(ctx, &dp_off)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse DP offset");
-        return false;
-    }
-
-    /* get dp_bank */
-    if(!swd_script_get_number(ctx, &dp_bank)) {
-        dp_bank = 0xFF;
-    }
-
     swd_script_log(
         ctx, FuriLogLevelDefault, "write %08lX to reg %08lX / bank %08lX", data, dp_off, dp_bank);
 
@@ -1586,33 +833,15 @@ static bool swd_scriptfunc_dp_write(ScriptContext* ctx) {
 
     furi_mutex_release(ctx->app->swd_mutex);
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_dp_read(ScriptContext* ctx) {
-    uint32_t dp_bank = 0;
-    uint32_t dp_off = 0;
+static bool swd_scriptfunc_dp_read(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t dp_off = insn->argv[0];
+    uint32_t dp_bank = (insn->argc > 1) ? insn->argv[1] : 0xFF;
     uint32_t data = 0;
     bool success = true;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get dp_off */
-    if(!swd_script_get_number(ctx, &dp_off)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse DP offset");
-        return false;
-    }
-
-    /* get dp_bank */
-    if(!swd_script_get_number(ctx, &dp_bank)) {
-        dp_bank = 0xFF;
-    }
-
     swd_script_log(ctx, FuriLogLevelDefault, "read reg %02lX / bank %02lX", dp_off, dp_bank);
 
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
@@ -1626,33 +855,14 @@ static bool swd_scriptfunc_dp_read(ScriptContext* ctx) {
     }
     furi_mutex_release(ctx->app->swd_mutex);
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_ap_write(ScriptContext* ctx) {
-    uint32_t ap_reg = 0;
-    uint32_t data = 0;
+static bool swd_scriptfunc_ap_write(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t data = insn->argv[0];
+    uint32_t ap_reg = insn->argv[1];
     bool success = true;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get data */
-    if(!swd_script_get_number(ctx, &data)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse data");
-        return false;
-    }
-
-    /* get ap_reg */
-    if(!swd_script_get_number(ctx, &ap_reg)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse AP register");
-        return false;
-    }
-
     swd_script_log(
         ctx, FuriLogLevelDefault, "AP%d %08lX -> %02lX", ctx->selected_ap, data, ap_reg);
 
@@ -1665,27 +875,14 @@ static bool swd_scriptfunc_ap_write(ScriptContext* ctx) {
     }
     furi_mutex_release(ctx->app->swd_mutex);
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_ap_read(ScriptContext* ctx) {
-    uint32_t ap_reg = 0;
+static bool swd_scriptfunc_ap_read(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t ap_reg = insn->argv[0];
     uint32_t data = 0;
     bool success = true;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    /* get ap_reg */
-    if(!swd_script_get_number(ctx, &ap_reg)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse AP register");
-        return false;
-    }
-
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
 
     uint8_t ret = swd_read_ap(ctx->app, ctx->selected_ap, ap_reg, &data);
@@ -1698,12 +895,11 @@ static bool swd_scriptfunc_ap_read(ScriptContext* ctx) {
     }
     furi_mutex_release(ctx->app->swd_mutex);
 
-    swd_script_seek_newline(ctx);
-
     return success;
 }
 
-static bool swd_scriptfunc_core_halt(ScriptContext* ctx) {
+static bool swd_scriptfunc_core_halt(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     bool succ = false;
 
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
@@ -1725,12 +921,12 @@ static bool swd_scriptfunc_core_halt(ScriptContext* ctx) {
     }
 
     furi_mutex_release(ctx->app->swd_mutex);
-    swd_script_seek_newline(ctx);
 
     return succ;
 }
 
-static bool swd_scriptfunc_core_continue(ScriptContext* ctx) {
+static bool swd_scriptfunc_core_continue(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     bool succ = false;
     uint32_t data = 0;
 
@@ -1751,12 +947,11 @@ static bool swd_scriptfunc_core_continue(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelDefault, "Core continued");
     }
 
-    swd_script_seek_newline(ctx);
-
     return succ;
 }
 
-static bool swd_scriptfunc_core_step(ScriptContext* ctx) {
+static bool swd_scriptfunc_core_step(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     bool succ = false;
     uint32_t data = 0;
 
@@ -1782,8 +977,6 @@ static bool swd_scriptfunc_core_step(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelDefault, "Core stepped");
     }
 
-    swd_script_seek_newline(ctx);
-
     return succ;
 }
 
@@ -1803,7 +996,8 @@ static struct cpu_regs_type {
     {0x58, "FP S24"}, {0x59, "FP S25"}, {0x5A, "FP S26"}, {0x5B, "FP S27"}, {0x5C, "FP S28"},
     {0x5D, "FP S29"}, {0x5E, "FP S30"}, {0x5F, "FP S31"}};
 
-static bool swd_scriptfunc_core_regs(ScriptContext* ctx) {
+static bool swd_scriptfunc_core_regs(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     bool succ = false;
 
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
@@ -1841,26 +1035,14 @@ static bool swd_scriptfunc_core_regs(ScriptContext* ctx) {
     }
     furi_mutex_release(ctx->app->swd_mutex);
 
-    swd_script_seek_newline(ctx);
-
     return true;
 }
 
-static bool swd_scriptfunc_core_reg_get(ScriptContext* ctx) {
-    uint32_t core_reg = 0;
+static bool swd_scriptfunc_core_reg_get(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t core_reg = insn->argv[0];
     uint32_t core_data = 0;
     bool succ = false;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &core_reg)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse register");
-        return false;
-    }
-
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
     uint32_t reg_dhcsr = 0;
     uint32_t reg_cpacr = 0;
@@ -1892,34 +1074,14 @@ static bool swd_scriptfunc_core_reg_get(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelDefault, "0x%08X", core_data);
     }
 
-    swd_script_seek_newline(ctx);
-
     return succ;
 }
 
-static bool swd_scriptfunc_core_reg_set(ScriptContext* ctx) {
-    uint32_t core_reg = 0;
-    uint32_t core_data = 0;
+static bool swd_scriptfunc_core_reg_set(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    uint32_t core_reg = insn->argv[0];
+    uint32_t core_data = insn->argv[1];
     bool succ = false;
 
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-
-    if(!swd_script_get_number(ctx, &core_reg)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse register");
-        return false;
-    }
-    if(!swd_script_skip_whitespace(ctx)) {
-        swd_script_log(ctx, FuriLogLevelError, "missing whitespace");
-        return false;
-    }
-    if(!swd_script_get_number(ctx, &core_data)) {
-        swd_script_log(ctx, FuriLogLevelError, "failed to parse data");
-        return false;
-    }
-
     furi_mutex_acquire(ctx->app->swd_mutex, FuriWaitForever);
     uint32_t reg_dhcsr = 0;
     uint32_t reg_cpacr = 0;
@@ -1948,12 +1110,11 @@ static bool swd_scriptfunc_core_reg_set(ScriptContext* ctx) {
     }
     furi_mutex_release(ctx->app->swd_mutex);
 
-    swd_script_seek_newline(ctx);
-
     return succ;
 }
 
-static bool swd_scriptfunc_core_cpuid(ScriptContext* ctx) {
+static bool swd_scriptfunc_core_cpuid(ScriptContext* ctx, const SwdScriptInsn* insn) {
+    UNUSED(insn);
     bool succ = false;
     uint32_t reg_cpuid = 0;
 
@@ -1967,145 +1128,148 @@ static bool swd_scriptfunc_core_cpuid(ScriptContext* ctx) {
         swd_script_log(ctx, FuriLogLevelDefault, "0x%08X", reg_cpuid);
     }
 
-    swd_script_seek_newline(ctx);
-
     return succ;
 }
 
-static const ScriptFunctionInfo script_funcs[] = {
-    {"#", &swd_scriptfunc_comment},
-    {".label", &swd_scriptfunc_label},
-    {"goto", &swd_scriptfunc_goto},
-    {"call", &swd_scriptfunc_call},
-    {"status", &swd_scriptfunc_status},
-    {"errors", &swd_scriptfunc_errors},
-    {"message", &swd_scriptfunc_message},
-    {"beep", &swd_scriptfunc_beep},
-    {"max_tries", &swd_scriptfunc_maxtries},
-    {"swd_clock_delay", &swd_scriptfunc_swd_clock_delay},
-    {"swd_idle_bits", &swd_scriptfunc_swd_idle_bits},
-    {"block_size", &swd_scriptfunc_blocksize},
-    {"abort", &swd_scriptfunc_abort},
-    {"mem_dump", &swd_scriptfunc_mem_dump},
-    {"mem_ldmst", &swd_scriptfunc_mem_ldmst},
-    {"mem_write", &swd_scriptfunc_mem_write},
-    {"mem_read", &swd_scriptfunc_mem_read},
-    {"dp_write", &swd_scriptfunc_dp_write},
-    {"dp_read", &swd_scriptfunc_dp_read},
-    {"ap_scan", &swd_scriptfunc_apscan},
-    {"ap_select", &swd_scriptfunc_apselect},
-    {"ap_read", &swd_scriptfunc_ap_read},
-    {"ap_write", &swd_scriptfunc_ap_write},
-    {"core_halt", &swd_scriptfunc_core_halt},
-    {"core_step", &swd_scriptfunc_core_step},
-    {"core_continue", &swd_scriptfunc_core_continue},
-    {"core_regs", &swd_scriptfunc_core_regs},
-    {"core_reg_get", &swd_scriptfunc_core_reg_get},
-    {"core_reg_set", &swd_scriptfunc_core_reg_set},
-    {"core_cpuid", &swd_scriptfunc_core_cpuid}};
+static const ScriptFunction script_funcs[SwdScriptOpCount] = {
+    [SwdScriptOpGoto] = &swd_scriptfunc_goto,
+    [SwdScriptOpCall] = &swd_scriptfunc_call,
+    [SwdScriptOpStatus] = &swd_scriptfunc_status,
+    [SwdScriptOpErrors] = &swd_scriptfunc_errors,
+    [SwdScriptOpMessage] = &swd_scriptfunc_message,
+    [SwdScriptOpBeep] = &swd_scriptfunc_beep,
+    [SwdScriptOpMaxTries] = &swd_scriptfunc_maxtries,
+    [SwdScriptOpClockDelay] = &swd_scriptfunc_swd_clock_delay,
+    [SwdScriptOpIdleBits] = &swd_scriptfunc_swd_idle_bits,
+    [SwdScriptOpBlockSize] = &swd_scriptfunc_blocksize,
+    [SwdScriptOpAbort] = &swd_scriptfunc_abort,
+    [SwdScriptOpMemDump] = &swd_scriptfunc_mem_dump,
+    [SwdScriptOpMemLdmst] = &swd_scriptfunc_mem_ldmst,
+    [SwdScriptOpMemWrite] = &swd_scriptfunc_mem_write,
+    [SwdScriptOpMemRead] = &swd_scriptfunc_mem_read,
+    [SwdScriptOpDpWrite] = &swd_scriptfunc_dp_write,
+    [SwdScriptOpDpRead] = &swd_scriptfunc_dp_read,
+    [SwdScriptOpApScan] = &swd_scriptfunc_apscan,
+    [SwdScriptOpApSelect] = &swd_scriptfunc_apselect,
+    [SwdScriptOpApRead] = &swd_scriptfunc_ap_read,
+    [SwdScriptOpApWrite] = &swd_scriptfunc_ap_write,
+    [SwdScriptOpCoreHalt] = &swd_scriptfunc_core_halt,
+    [SwdScriptOpCoreStep] = &swd_scriptfunc_core_step,
+    [SwdScriptOpCoreContinue] = &swd_scriptfunc_core_continue,
+    [SwdScriptOpCoreRegs] = &swd_scriptfunc_core_regs,
+    [SwdScriptOpCoreRegGet] = &swd_scriptfunc_core_reg_get,
+    [SwdScriptOpCoreRegSet] = &swd_scriptfunc_core_reg_set,
+    [SwdScriptOpCoreCpuid] = &swd_scriptfunc_core_cpuid};
 
 /************************** script main code **************************/
 
-static bool swd_execute_script_line(ScriptContext* const ctx) {
-    char buffer[64];
-    uint64_t start_pos = 0;
+/* run a compiled script from its start, returns the source line that failed or 0 */
+static uint16_t swd_script_run(ScriptContext* const ctx, const SwdScriptProgram* program) {
+    SwdScriptInsn insn;
 
-    if(ctx->script_file) {
-        start_pos = storage_file_tell(ctx->script_file);
-        uint16_t ret = storage_file_read(ctx->script_file, buffer, 2);
-        storage_file_seek(ctx->script_file, start_pos, true);
+    ctx->program = program;
+    ctx->pc = 0;
 
-        if(ret < 2) {
-            return true;
+    while(swd_script_fetch(program, &ctx->pc, &insn)) {
+        if(ctx->abort) {
+            DBGS("aborting");
+            break;
         }
-    } else {
-        start_pos = ctx->line_pos;
-        strncpy(buffer, ctx->line_data, 2);
+        const char* name = swd_script_op_name(insn.op);
+
+        DBG("line %u: '%s'", insn.line, name);
 
-        if(buffer[0] == 0 || buffer[1] == 0) {
-            return true;
+        if(!ctx->status_ignore) {
+            snprintf(ctx->app->state_string, sizeof(ctx->app->state_string), "CMD: %s", name);
         }
-    }
+        swd_script_gui_refresh(ctx);
 
-    if(buffer[0] == '\n' || (buffer[0] == '\r' && buffer[1] == '\n')) {
-        swd_script_seek_newline(ctx);
-        return true;
+        if(!script_funcs[insn.op](ctx, &insn) && !ctx->errors_ignore) {
+            swd_script_log(ctx, FuriLogLevelError, "Command failed: %s", name);
+            snprintf(
+                ctx->app->state_string,
+                sizeof(ctx->app->state_string),
+                "Command failed: %s",
+                name);
+            return insn.line;
+        }
     }
 
-    for(size_t entry = 0; entry < COUNT(script_funcs); entry++) {
-        if(ctx->abort) {
-            DBGS("aborting");
-            break;
-        }
-        size_t expected = strlen(script_funcs[entry].prefix);
+    return 0;
+}
 
-        if(ctx->script_file) {
-            storage_file_seek(ctx->script_file, start_pos, true);
+static bool swd_execute_script_line(ScriptContext* const ctx) {
+    SwdScriptProgram program;
+    SwdScriptError error;
 
-            if(storage_file_read(ctx->script_file, buffer, expected) != expected) {
-                continue;
-            }
-        } else {
-            ctx->line_pos = start_pos;
+    if(!swd_script_compile(&program, ctx->line_data, strlen(ctx->line_data), &error)) {
+        swd_script_log(ctx, FuriLogLevelError, "%s", error.message);
+        return false;
+    }
 
-            if(strlen(ctx->line_data) < expected) {
-                continue;
-            }
-            strncpy(buffer, ctx->line_data, expected);
-            ctx->line_pos += expected;
-        }
+    bool success = (swd_script_run(ctx, &program) == 0);
+    swd_script_free(&program);
 
-        buffer[expected] = '\000';
-        if(strncmp(buffer, script_funcs[entry].prefix, expected)) {
-            continue;
-        }
-        bool success = true;
+    return success;
+}
 
-        if(ctx->goto_active) {
-            DBG("ignore: '%s'", script_funcs[entry].prefix);
+/* read the whole script and compile it, the text is only kept during compilation */
+static bool swd_script_load(ScriptContext* const ctx, SwdScriptProgram* program) {
+    File* file = storage_file_alloc(ctx->app->storage);
+    char* text = NULL;
+    bool success = false;
 
-            /* only execute label handlers */
-            if(buffer[0] == '.') {
-                success = script_funcs[entry].func(ctx);
-            } else {
-                swd_script_seek_newline(ctx);
-            }
-        } else {
-            DBG("command: '%s'", script_funcs[entry].prefix);
+    do {
+        if(!storage_file_open(file, ctx->filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E(TAG, "open, %s", storage_file_get_error_desc(file));
+            DBG("Failed to open '%s'", ctx->filename);
+            snprintf(
+                ctx->app->state_string, sizeof(ctx->app->state_string), "Failed to open file");
+            break;
+        }
 
-            if(!ctx->status_ignore) {
-                snprintf(
-                    ctx->app->state_string,
-                    sizeof(ctx->app->state_string),
-                    "CMD: %s",
-                    script_funcs[entry].prefix);
-            }
-            swd_script_gui_refresh(ctx);
+        size_t size = storage_file_size(file);
+        if(size > SCRIPT_MAX_SIZE) {
+            snprintf(
+                ctx->app->state_string, sizeof(ctx->app->state_string), "Script too large");
+            break;
+        }
 
-            /* function, execute */
-            success = script_funcs[entry].func(ctx);
+        text = malloc(size + 1);
+        if(storage_file_read(file, text, size) != size) {
+            snprintf(
+                ctx->app->state_string, sizeof(ctx->app->state_string), "Failed to read file");
+            break;
+        }
 
-            if(!success && !ctx->errors_ignore) {
-                swd_script_log(
-                    ctx, FuriLogLevelError, "Command failed: %s", script_funcs[entry].prefix);
-                snprintf(
-                    ctx->app->state_string,
-                    sizeof(ctx->app->state_string),
-                    "Command failed: %s",
-                    script_funcs[entry].prefix);
-                return false;
-            }
+        SwdScriptError error;
+        if(!swd_script_compile(program, text, size, &error)) {
+            snprintf(
+                ctx->app->state_string,
+                sizeof(ctx->app->state_string),
+                "Line %u: %s",
+                error.line,
+                error.message);
+            break;
         }
+        DBG("compiled %u bytes into %u words", size, program->code_size);
+
+        success = true;
+    } while(false);
 
-        return true;
+    if(!success) {
+        swd_script_log(ctx, FuriLogLevelError, "%s: %s", ctx->filename, ctx->app->state_string);
     }
-    swd_script_log(ctx, FuriLogLevelError, "unknown command '%s'", buffer);
 
-    return false;
+    free(text);
+    storage_file_free(file);
+
+    return success;
 }
 
 static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
     bool success = true;
+    SwdScriptProgram program;
 
     /* fetch current script and set as parent */
     ScriptContext* parent = ctx->script;
@@ -2124,14 +1288,18 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
         return false;
     }
 
-    /* first allocate a file object */
-    ctx->script->script_file = storage_file_alloc(ctx->storage);
+    if(!swd_script_load(ctx->script, &program)) {
+        char text_buf[128];
+
+        snprintf(text_buf, sizeof(text_buf), "Script error:\n%s", ctx->state_string);
+        DialogMessage* message = dialog_message_alloc();
+        dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
+        dialog_message_set_icon(message, &I_app, 3, 2);
+        dialog_message_set_text(message, text_buf, 3, 16, AlignLeft, AlignTop);
+        dialog_message_set_buttons(message, "Back", NULL, NULL);
+        dialog_message_show(ctx->dialogs, message);
+        dialog_message_free(message);
 
-    /* then get our script opened */
-    if(!storage_file_open(ctx->script->script_file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        FURI_LOG_E(TAG, "open, %s", storage_file_get_error_desc(ctx->script->script_file));
-        DBG("Failed to open '%s'", filename);
-        storage_file_free(ctx->script->script_file);
         parent = ctx->script->parent;
         free(ctx->script);
         ctx->script = parent;
@@ -2139,56 +1307,18 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
     }
 
     do {
-        success = true;
         ctx->script->restart = false;
 
-        storage_file_seek(ctx->script->script_file, 0, true);
-
-        uint32_t line = 1;
-        while(line < SCRIPT_MAX_LINES) {
-            if(ctx->script->abort) {
-                DBGS("Abort requested");
-                break;
-            }
-            if(storage_file_eof(ctx->script->script_file)) {
-                break;
-            }
-            DBG("line %lu", line);
-            if(!swd_execute_script_line(ctx->script)) {
-                success = false;
-                break;
-            }
-            if(ctx->script->restart) {
-                break;
-            }
-            line++;
-        }
-
-        if(ctx->script->restart) {
-            DBGS("Restarting");
-        } else {
-            DBGS("Finished");
-        }
-
-        if(line >= SCRIPT_MAX_LINES) {
-            success = true;
-            char text_buf[128];
-
-            snprintf(text_buf, sizeof(text_buf), "aborting after %d lines", SCRIPT_MAX_LINES);
-            DialogMessage* message = dialog_message_alloc();
-            dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
-            dialog_message_set_icon(message, &I_app, 3, 2);
-            dialog_message_set_text(message, text_buf, 3, 16, AlignLeft, AlignTop);
-            dialog_message_set_buttons(message, "Back", NULL, NULL);
-            dialog_message_free(message);
+        uint16_t failed_line = swd_script_run(ctx->script, &program);
+        success = (failed_line == 0);
 
-            ctx->script->restart = false;
-        }
+        DBGS("Finished");
 
         if(!success) {
             char text_buf[128];
 
-            snprintf(text_buf, sizeof(text_buf), "Line %lu failed:\n%s", line, ctx->state_string);
+            snprintf(
+                text_buf, sizeof(text_buf), "Line %u failed:\n%s", failed_line, ctx->state_string);
             DialogMessage* message = dialog_message_alloc();
             dialog_message_set_header(message, "SWD Probe", 16, 2, AlignLeft, AlignTop);
             dialog_message_set_icon(message, &I_app, 3, 2);
@@ -2201,8 +1331,7 @@ static bool swd_execute_script(AppFSM* const ctx, const char* filename) {
         }
     } while(ctx->script->restart);
 
-    storage_file_close(ctx->script->script_file);
-    storage_file_free(ctx->script->script_file);
+    swd_script_free(&program);
 
     parent = ctx->script->parent;
     free(ctx->script);
@@ -3079,7 +2208,6 @@ size_t data_received(void* ctx, uint8_t* data, size_t length) {
     AppFSM* app = (AppFSM*)ctx;
 
     strncpy(app->commandline->line_data, (const char*)data, length);
-    app->commandline->line_pos = 0;
 
     for(size_t pos = 0; pos < length; pos++) {
         uint8_t ch = app->commandline->line_data[pos];
@@ -20,6 +20,7 @@
 #include <notification/notification_messages.h>
 
 #include "usb_uart.h"
+#include "swd_script.h"
 
 #define TAG "SWD"
 
@@ -42,7 +43,8 @@
 #define CLOCK_DELAY 0
 
 #define MAX_FILE_LENGTH 128
-#define SCRIPT_MAX_LINES 1000
+/* scripts are read completely and compiled before they run */
+#define SCRIPT_MAX_SIZE (32 * 1024)
 
 typedef enum {
     ModePageScan = 0,
@@ -77,10 +79,13 @@ typedef enum {
 #define REG_EVENTSTAT_BANK 0x04
 
 #define REG_SELECT 0x02
+#define REG_RDBUFF 0x03
 
 #define MEMAP_CSW 0x00
 #define MEMAP_TAR 0x04
 #define MEMAP_DRW 0x0C
+/* TAR auto-increment is only guaranteed within this boundary */
+#define MEMAP_TAR_WRAP 0x400
 #define AP_IDR 0xFC
 #define AP_BASE 0xF8
 
@@ -184,6 +189,7 @@ typedef struct {
     uint8_t io_swd;
     uint8_t io_num_swc;
     uint8_t io_num_swd;
+    uint8_t io_state;
     int32_t detected_timeout;
     uint32_t swd_clock_delay;
     uint32_t swd_idle_bits;
@@ -216,10 +222,10 @@ struct sScriptContext {
 
     /* when used with string input */
     char line_data[128];
-    uint64_t line_pos;
 
-    /* when used with file input */
-    File* script_file;
+    /* compiled script and index of the next instruction word */
+    const SwdScriptProgram* program;
+    uint32_t pc;
 
     uint64_t position;
     uint32_t selected_ap;
@@ -230,14 +236,9 @@ struct sScriptContext {
     bool restart;
     bool errors_ignore;
     bool status_ignore;
-    bool goto_active;
-    char goto_label[64];
 };
 
-typedef struct {
-    const char* prefix;
-    bool (*func)(ScriptContext* ctx);
-} ScriptFunctionInfo;
+typedef bool (*ScriptFunction)(ScriptContext* ctx, const SwdScriptInsn* insn);
 
 uint8_t swd_read_memory(AppFSM* const ctx, uint8_t ap, uint32_t address, uint32_t* data);
 
@@ -0,0 +1,464 @@
+#include "swd_script.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SWD_SCRIPT_TOKEN_LENGTH 256
+
+typedef struct {
+    const char* name;
+    /* one character per argument: n number, s string, l label. arguments after ? are
+       optional and the handler supplies their defaults */
+    const char* args;
+} SwdScriptOpInfo;
+
+static const SwdScriptOpInfo swd_script_ops[SwdScriptOpCount] = {
+    [SwdScriptOpGoto] = {"goto", "l"},
+    [SwdScriptOpCall] = {"call", "s"},
+    [SwdScriptOpStatus] = {"status", "?n"},
+    [SwdScriptOpErrors] = {"errors", "s"},
+    [SwdScriptOpMessage] = {"message", "ns?s"},
+    [SwdScriptOpBeep] = {"beep", "?n"},
+    [SwdScriptOpMaxTries] = {"max_tries", "n"},
+    [SwdScriptOpClockDelay] = {"swd_clock_delay", "n"},
+    [SwdScriptOpIdleBits] = {"swd_idle_bits", "n"},
+    [SwdScriptOpBlockSize] = {"block_size", "n"},
+    [SwdScriptOpAbort] = {"abort", ""},
+    [SwdScriptOpMemDump] = {"mem_dump", "snn?n"},
+    [SwdScriptOpMemLdmst] = {"mem_ldmst", "nnn"},
+    [SwdScriptOpMemWrite] = {"mem_write", "nn"},
+    [SwdScriptOpMemRead] = {"mem_read", "n"},
+    [SwdScriptOpDpWrite] = {"dp_write", "nn?n"},
+    [SwdScriptOpDpRead] = {"dp_read", "n?n"},
+    [SwdScriptOpApScan] = {"ap_scan", ""},
+    [SwdScriptOpApSelect] = {"ap_select", "n"},
+    [SwdScriptOpApRead] = {"ap_read", "n"},
+    [SwdScriptOpApWrite] = {"ap_write", "nn"},
+    [SwdScriptOpCoreHalt] = {"core_halt", ""},
+    [SwdScriptOpCoreStep] = {"core_step", ""},
+    [SwdScriptOpCoreContinue] = {"core_continue", ""},
+    [SwdScriptOpCoreRegs] = {"core_regs", ""},
+    [SwdScriptOpCoreRegGet] = {"core_reg_get", "n"},
+    [SwdScriptOpCoreRegSet] = {"core_reg_set", "nn"},
+    [SwdScriptOpCoreCpuid] = {"core_cpuid", ""},
+};
+
+typedef struct {
+    uint32_t name;
+    uint32_t target;
+    uint16_t line;
+} SwdScriptLabel;
+
+typedef struct {
+    SwdScriptProgram* program;
+    SwdScriptError* error;
+    uint16_t line;
+
+    size_t code_alloc;
+    size_t strings_alloc;
+
+    /* label definitions and goto arguments waiting for them, names live in a scratch pool
+       that is dropped once everything is resolved */
+    SwdScriptLabel* labels;
+    size_t label_count;
+    size_t label_alloc;
+    SwdScriptLabel* fixups;
+    size_t fixup_count;
+    size_t fixup_alloc;
+    char* names;
+    size_t names_size;
+    size_t names_alloc;
+} SwdScriptCompiler;
+
+static bool swd_script_fail(SwdScriptCompiler* compiler, const char* format, ...) {
+    va_list argp;
+    va_start(argp, format);
+    compiler->error->line = compiler->line;
+    vsnprintf(compiler->error->message, sizeof(compiler->error->message), format, argp);
+    va_end(argp);
+
+    return false;
+}
+
+static bool swd_script_grow(
+    SwdScriptCompiler* compiler,
+    void** buffer,
+    size_t* alloc,
+    size_t needed,
+    size_t element) {
+    if(needed <= *alloc) {
+        return true;
+    }
+
+    size_t size = *alloc ? *alloc : 32;
+    while(size < needed) {
+        size *= 2;
+    }
+
+    void* grown = realloc(*buffer, size * element);
+    if(!grown) {
+        return swd_script_fail(compiler, "out of memory");
+    }
+    *buffer = grown;
+    *alloc = size;
+
+    return true;
+}
+
+static bool swd_script_emit(SwdScriptCompiler* compiler, uint32_t word) {
+    SwdScriptProgram* program = compiler->program;
+
+    if(!swd_script_grow(
+           compiler,
+           (void**)&program->code,
+           &compiler->code_alloc,
+           program->code_size + 1,
+           sizeof(uint32_t))) {
+        return false;
+    }
+    program->code[program->code_size++] = word;
+
+    return true;
+}
+
+static bool swd_script_add_string(
+    SwdScriptCompiler* compiler,
+    char** pool,
+    size_t* size,
+    size_t* alloc,
+    const char* str,
+    uint32_t* offset) {
+    size_t length = strlen(str) + 1;
+
+    if(!swd_script_grow(compiler, (void**)pool, alloc, *size + length, 1)) {
+        return false;
+    }
+    memcpy(*pool + *size, str, length);
+    *offset = *size;
+    *size += length;
+
+    return true;
+}
+
+static bool swd_script_add_label(
+    SwdScriptCompiler* compiler,
+    SwdScriptLabel** list,
+    size_t* count,
+    size_t* alloc,
+    const char* name,
+    uint32_t target) {
+    SwdScriptLabel label = {.target = target, .line = compiler->line};
+
+    if(!swd_script_grow(compiler, (void**)list, alloc, *count + 1, sizeof(label))) {
+        return false;
+    }
+    if(!swd_script_add_string(
+           compiler,
+           &compiler->names,
+           &compiler->names_size,
+           &compiler->names_alloc,
+           name,
+           &label.name)) {
+        return false;
+    }
+    (*list)[(*count)++] = label;
+
+    return true;
+}
+
+static bool swd_script_is_space(char ch) {
+    return ch == ' ' || ch == '\t';
+}
+
+/* same rules as the old text interpreter: space separated, double quotes group spaces */
+static bool swd_script_token(
+    SwdScriptCompiler* compiler,
+    const char** pos,
+    const char* end,
+    char* token,
+    bool* found) {
+    const char* cur = *pos;
+    bool quot = false;
+    size_t length = 0;
+
+    while(cur < end && swd_script_is_space(*cur)) {
+        cur++;
+    }
+    *found = cur < end;
+
+    while(cur < end && (quot || !swd_script_is_space(*cur))) {
+        char ch = *cur++;
+
+        if(ch == '"') {
+            quot = !quot;
+            continue;
+        }
+        if(length + 1 >= SWD_SCRIPT_TOKEN_LENGTH) {
+            return swd_script_fail(compiler, "argument too long");
+        }
+        token[length++] = ch;
+    }
+    token[length] = '\000';
+    *pos = cur;
+
+    if(quot) {
+        return swd_script_fail(compiler, "unterminated string");
+    }
+
+    return true;
+}
+
+static bool swd_script_parse_number(const char* str, uint32_t* number) {
+    uint32_t base = 10;
+    uint64_t value = 0;
+
+    if(str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        base = 16;
+        str += 2;
+    }
+    if(!*str) {
+        return false;
+    }
+
+    for(; *str; str++) {
+        char ch = *str | 0x20;
+        uint32_t digit = 0;
+
+        if(*str >= '0' && *str <= '9') {
+            digit = *str - '0';
+        } else if(base == 16 && ch >= 'a' && ch <= 'f') {
+            digit = ch - 'a' + 10;
+        } else {
+            return false;
+        }
+        value = value * base + digit;
+        if(value > UINT32_MAX) {
+            return false;
+        }
+    }
+    *number = value;
+
+    return true;
+}
+
+static bool
+    swd_script_compile_line(SwdScriptCompiler* compiler, const char* pos, const char* end) {
+    SwdScriptProgram* program = compiler->program;
+    char token[SWD_SCRIPT_TOKEN_LENGTH];
+    bool found = false;
+
+    while(pos < end && swd_script_is_space(*pos)) {
+        pos++;
+    }
+    if(pos == end || *pos == '#') {
+        return true;
+    }
+
+    if(!swd_script_token(compiler, &pos, end, token, &found)) {
+        return false;
+    }
+
+    if(!strcmp(token, ".label")) {
+        if(!swd_script_token(compiler, &pos, end, token, &found)) {
+            return false;
+        }
+        if(!found) {
+            return swd_script_fail(compiler, "missing label name");
+        }
+        for(size_t label = 0; label < compiler->label_count; label++) {
+            if(!strcmp(compiler->names + compiler->labels[label].name, token)) {
+                return swd_script_fail(compiler, "duplicate label '%s'", token);
+            }
+        }
+        if(!swd_script_add_label(
+               compiler,
+               &compiler->labels,
+               &compiler->label_count,
+               &compiler->label_alloc,
+               token,
+               program->code_size)) {
+            return false;
+        }
+    } else {
+        size_t op = 0;
+        while(op < SwdScriptOpCount && strcmp(swd_script_ops[op].name, token)) {
+            op++;
+        }
+        if(op == SwdScriptOpCount) {
+            return swd_script_fail(compiler, "unknown command '%s'", token);
+        }
+
+        size_t header = program->code_size;
+        if(!swd_script_emit(compiler, op | ((uint32_t)compiler->line << 16))) {
+            return false;
+        }
+
+        const char* args = swd_script_ops[op].args;
+        bool optional = false;
+        uint32_t argc = 0;
+        for(; *args; args++) {
+            if(*args == '?') {
+                optional = true;
+                continue;
+            }
+            if(argc == SWD_SCRIPT_MAX_ARGS) {
+                return swd_script_fail(
+                    compiler, "too many arguments for '%s'", swd_script_ops[op].name);
+            }
+            if(!swd_script_token(compiler, &pos, end, token, &found)) {
+                return false;
+            }
+            if(!found) {
+                if(optional) {
+                    break;
+                }
+                return swd_script_fail(
+                    compiler, "missing argument for '%s'", swd_script_ops[op].name);
+            }
+
+            uint32_t arg = 0;
+            switch(*args) {
+            case 'n':
+                if(!swd_script_parse_number(token, &arg)) {
+                    return swd_script_fail(compiler, "invalid number '%s'", token);
+                }
+                if(op == SwdScriptOpBeep && arg >= SWD_SCRIPT_BEEP_SOUNDS) {
+                    return swd_script_fail(compiler, "unknown sound '%s'", token);
+                }
+                break;
+            case 's':
+                if(!swd_script_add_string(
+                       compiler,
+                       &program->strings,
+                       &program->strings_size,
+                       &compiler->strings_alloc,
+                       token,
+                       &arg)) {
+                    return false;
+                }
+                break;
+            case 'l':
+                if(!swd_script_add_label(
+                       compiler,
+                       &compiler->fixups,
+                       &compiler->fixup_count,
+                       &compiler->fixup_alloc,
+                       token,
+                       program->code_size)) {
+                    return false;
+                }
+                break;
+            }
+            if(!swd_script_emit(compiler, arg)) {
+                return false;
+            }
+            argc++;
+        }
+        program->code[header] |= argc << 8;
+    }
+
+    if(!swd_script_token(compiler, &pos, end, token, &found)) {
+        return false;
+    }
+    if(found) {
+        return swd_script_fail(compiler, "unexpected '%s'", token);
+    }
+
+    return true;
+}
+
+static bool swd_script_resolve(SwdScriptCompiler* compiler) {
+    for(size_t fixup = 0; fixup < compiler->fixup_count; fixup++) {
+        const char* name = compiler->names + compiler->fixups[fixup].name;
+        size_t label = 0;
+
+        while(label < compiler->label_count &&
+              strcmp(compiler->names + compiler->labels[label].name, name)) {
+            label++;
+        }
+        if(label == compiler->label_count) {
+            compiler->line = compiler->fixups[fixup].line;
+            return swd_script_fail(compiler, "unknown label '%s'", name);
+        }
+        compiler->program->code[compiler->fixups[fixup].target] = compiler->labels[label].target;
+    }
+
+    return true;
+}
+
+bool swd_script_compile(
+    SwdScriptProgram* program,
+    const char* text,
+    size_t length,
+    SwdScriptError* error) {
+    SwdScriptCompiler compiler = {.program = program, .error = error};
+    const char* end = text + length;
+    bool success = true;
+
+    memset(program, 0, sizeof(*program));
+    memset(error, 0, sizeof(*error));
+
+    while(success && text < end) {
+        const char* eol = memchr(text, '\n', end - text);
+        const char* next = eol ? eol + 1 : end;
+
+        if(!eol) {
+            eol = end;
+        }
+        if(eol > text && eol[-1] == '\r') {
+            eol--;
+        }
+
+        if(++compiler.line > SWD_SCRIPT_MAX_LINES) {
+            success = swd_script_fail(&compiler, "more than %d lines", SWD_SCRIPT_MAX_LINES);
+            break;
+        }
+        success = swd_script_compile_line(&compiler, text, eol);
+        text = next;
+    }
+
+    if(success) {
+        success = swd_script_resolve(&compiler);
+    }
+
+    free(compiler.labels);
+    free(compiler.fixups);
+    free(compiler.names);
+
+    if(!success) {
+        swd_script_free(program);
+    }
+
+    return success;
+}
+
+void swd_script_free(SwdScriptProgram* program) {
+    free(program->code);
+    free(program->strings);
+    memset(program, 0, sizeof(*program));
+}
+
+bool swd_script_fetch(const SwdScriptProgram* program, uint32_t* pc, SwdScriptInsn* insn) {
+    if(*pc >= program->code_size) {
+        return false;
+    }
+
+    uint32_t word = program->code[*pc];
+    insn->op = (SwdScriptOp)(word & 0xFF);
+    insn->argc = (word >> 8) & 0xFF;
+    insn->line = word >> 16;
+    insn->argv = &program->code[*pc + 1];
+    *pc += 1 + insn->argc;
+
+    return true;
+}
+
+const char* swd_script_op_name(SwdScriptOp op) {
+    return op < SwdScriptOpCount ? swd_script_ops[op].name : "?";
+}
+
+const char* swd_script_string(const SwdScriptProgram* program, uint32_t arg) {
+    return program->strings + arg;
+}
@@ -0,0 +1,83 @@
+#ifndef __SWD_SCRIPT_H__
+#define __SWD_SCRIPT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* script compiler, turns .swd text into bytecode once so the interpreter neither re-parses
+   lines nor searches the text for labels while running. only depends on the C library. */
+
+#define SWD_SCRIPT_MAX_LINES 1000
+#define SWD_SCRIPT_MAX_ARGS 4
+/* number of sounds 'beep' can select, the app's sound table must match */
+#define SWD_SCRIPT_BEEP_SOUNDS 2
+
+typedef enum {
+    SwdScriptOpGoto,
+    SwdScriptOpCall,
+    SwdScriptOpStatus,
+    SwdScriptOpErrors,
+    SwdScriptOpMessage,
+    SwdScriptOpBeep,
+    SwdScriptOpMaxTries,
+    SwdScriptOpClockDelay,
+    SwdScriptOpIdleBits,
+    SwdScriptOpBlockSize,
+    SwdScriptOpAbort,
+    SwdScriptOpMemDump,
+    SwdScriptOpMemLdmst,
+    SwdScriptOpMemWrite,
+    SwdScriptOpMemRead,
+    SwdScriptOpDpWrite,
+    SwdScriptOpDpRead,
+    SwdScriptOpApScan,
+    SwdScriptOpApSelect,
+    SwdScriptOpApRead,
+    SwdScriptOpApWrite,
+    SwdScriptOpCoreHalt,
+    SwdScriptOpCoreStep,
+    SwdScriptOpCoreContinue,
+    SwdScriptOpCoreRegs,
+    SwdScriptOpCoreRegGet,
+    SwdScriptOpCoreRegSet,
+    SwdScriptOpCoreCpuid,
+    SwdScriptOpCount,
+} SwdScriptOp;
+
+/* each instruction is one header word (op | argc << 8 | line << 16) followed by argc
+   argument words. numbers are stored as is, strings as offsets into the string pool and
+   goto targets as the word index of the labelled instruction. */
+typedef struct {
+    uint32_t* code;
+    size_t code_size;
+    char* strings;
+    size_t strings_size;
+} SwdScriptProgram;
+
+typedef struct {
+    SwdScriptOp op;
+    uint16_t line;
+    uint8_t argc;
+    const uint32_t* argv;
+} SwdScriptInsn;
+
+typedef struct {
+    uint16_t line;
+    char message[64];
+} SwdScriptError;
+
+bool swd_script_compile(
+    SwdScriptProgram* program,
+    const char* text,
+    size_t length,
+    SwdScriptError* error);
+void swd_script_free(SwdScriptProgram* program);
+
+/* decode the instruction at *pc and advance *pc, false at the end of the program */
+bool swd_script_fetch(const SwdScriptProgram* program, uint32_t* pc, SwdScriptInsn* insn);
+
+const char* swd_script_op_name(SwdScriptOp op);
+const char* swd_script_string(const SwdScriptProgram* program, uint32_t arg);
+
+#endif
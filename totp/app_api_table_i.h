@@ -38,6 +38,10 @@ static constexpr auto app_api_table = sort(create_array_t<sym_entry>(
         totp_token_info_iterator_get_current_token,
         const TokenInfo*,
         (const TokenInfoIteratorContext*)),
+    API_METHOD(
+        totp_token_info_iterator_get_token_summary,
+        const TokenInfo*,
+        (TokenInfoIteratorContext*, size_t)),
     API_METHOD(
         totp_token_info_iterator_add_new_token,
         TotpIteratorUpdateTokenResult,
@@ -57,8 +57,13 @@ static void handle(PluginState* plugin_state, FuriString* args, Cli* cli) {
 
     (*formatter->header_formatter)();
     for(size_t i = 0; i < total_count; i++) {
-        totp_token_info_iterator_go_to(iterator_context, i);
-        const TokenInfo* token_info = totp_token_info_iterator_get_current_token(iterator_context);
+        const TokenInfo* token_info =
+            totp_token_info_iterator_get_token_summary(iterator_context, i);
+        if(token_info == NULL) {
+            totp_token_info_iterator_go_to(iterator_context, i);
+            token_info = totp_token_info_iterator_get_current_token(iterator_context);
+        }
+
         (*formatter->body_item_formatter)(i, token_info);
     }
 
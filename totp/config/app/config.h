@@ -43,3 +43,10 @@
 #ifndef TOTP_UI_NO_ADD_NEW_TOKEN
 #define TOTP_UI_ADD_NEW_TOKEN_ENABLED
 #endif
+
+// Amount of neighbour tokens (on each side of the current one) whose current and next
+// codes are pre-generated in background, so switching between tokens is instant.
+// Secrets stay encrypted in the cache, only generated codes are kept. 0 disables the cache
+#ifndef TOTP_CODE_CACHE_WINDOW_RADIUS
+#define TOTP_CODE_CACHE_WINDOW_RADIUS (1)
+#endif
@@ -0,0 +1,253 @@
+#include "token_info_index.h"
+
+#include <toolbox/stream/stream.h>
+#include <toolbox/stream/file_stream.h>
+#include "constants.h"
+#include "../../types/common.h"
+
+#define TOKEN_INFO_INDEX_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.idx"
+#define TOKEN_INFO_INDEX_MAGIC (0x58444954) // "TIDX"
+#define TOKEN_INFO_INDEX_VERSION (1)
+#define TOKEN_INFO_INDEX_NAME_LENGTH (39)
+#define TOKEN_INFO_INDEX_OFFSETS_GROW_STEP (16)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t config_file_size;
+} TokenInfoIndexHeader;
+
+typedef struct {
+    uint32_t offset;
+    TokenHashAlgo algo;
+    TokenDigitsCount digits;
+    TokenDuration duration;
+    TokenType type;
+    uint8_t name_length;
+    char name[TOKEN_INFO_INDEX_NAME_LENGTH];
+} TokenInfoIndexRecord;
+
+_Static_assert(sizeof(TokenInfoIndexRecord) == 48, "Unexpected token index record size");
+
+struct TokenInfoIndex {
+    Storage* storage;
+    Stream* stream;
+    uint32_t* offsets;
+    size_t count;
+    size_t capacity;
+    bool loaded;
+};
+
+static void token_info_index_close_stream(TokenInfoIndex* index) {
+    if(index->stream != NULL) {
+        file_stream_close(index->stream);
+        stream_free(index->stream);
+        index->stream = NULL;
+    }
+}
+
+static void token_info_index_reset(TokenInfoIndex* index) {
+    token_info_index_close_stream(index);
+    free(index->offsets);
+    index->offsets = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->loaded = false;
+}
+
+static bool token_info_index_open_stream(TokenInfoIndex* index, FS_OpenMode open_mode) {
+    index->stream = file_stream_alloc(index->storage);
+    if(!file_stream_open(
+           index->stream,
+           TOKEN_INFO_INDEX_FILE_PATH,
+           open_mode == FSOM_CREATE_ALWAYS ? FSAM_READ_WRITE : FSAM_READ,
+           open_mode)) {
+        token_info_index_close_stream(index);
+        return false;
+    }
+
+    return true;
+}
+
+static bool token_info_index_push_offset(TokenInfoIndex* index, uint32_t offset) {
+    if(index->count >= index->capacity) {
+        size_t new_capacity = index->capacity + TOKEN_INFO_INDEX_OFFSETS_GROW_STEP;
+        uint32_t* new_offsets = realloc(index->offsets, new_capacity * sizeof(uint32_t));
+        if(new_offsets == NULL) {
+            return false;
+        }
+
+        index->offsets = new_offsets;
+        index->capacity = new_capacity;
+    }
+
+    index->offsets[index->count] = offset;
+    index->count++;
+    return true;
+}
+
+TokenInfoIndex* totp_token_info_index_alloc(Storage* storage) {
+    TokenInfoIndex* index = malloc(sizeof(TokenInfoIndex));
+    furi_check(index != NULL);
+    index->storage = storage;
+    index->stream = NULL;
+    index->offsets = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->loaded = false;
+    return index;
+}
+
+void totp_token_info_index_free(TokenInfoIndex* index) {
+    if(index == NULL) return;
+    token_info_index_reset(index);
+    free(index);
+}
+
+bool totp_token_info_index_load(TokenInfoIndex* index, size_t config_file_size) {
+    token_info_index_reset(index);
+    if(!token_info_index_open_stream(index, FSOM_OPEN_EXISTING)) {
+        return false;
+    }
+
+    bool result = false;
+    do {
+        TokenInfoIndexHeader header;
+        if(stream_read(index->stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
+
+        size_t expected_size = sizeof(header) + header.count * sizeof(TokenInfoIndexRecord);
+        if(header.magic != TOKEN_INFO_INDEX_MAGIC || header.version != TOKEN_INFO_INDEX_VERSION ||
+           header.config_file_size != config_file_size ||
+           stream_size(index->stream) != expected_size) {
+            FURI_LOG_D(LOGGING_TAG, "Token index is stale");
+            break;
+        }
+
+        TokenInfoIndexRecord record;
+        size_t i = 0;
+        while(i < header.count &&
+              stream_read(index->stream, (uint8_t*)&record, sizeof(record)) == sizeof(record) &&
+              token_info_index_push_offset(index, record.offset)) {
+            i++;
+        }
+
+        result = i == header.count;
+    } while(false);
+
+    if(result) {
+        index->loaded = true;
+    } else {
+        token_info_index_reset(index);
+    }
+
+    return result;
+}
+
+void totp_token_info_index_invalidate(TokenInfoIndex* index) {
+    token_info_index_reset(index);
+    storage_common_remove(index->storage, TOKEN_INFO_INDEX_FILE_PATH);
+}
+
+bool totp_token_info_index_build_begin(TokenInfoIndex* index) {
+    token_info_index_reset(index);
+    if(!token_info_index_open_stream(index, FSOM_CREATE_ALWAYS)) {
+        return false;
+    }
+
+    // Header gets written once index is complete, invalid until then
+    TokenInfoIndexHeader header = {0};
+    if(stream_write(index->stream, (const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        token_info_index_reset(index);
+        return false;
+    }
+
+    return true;
+}
+
+bool totp_token_info_index_build_append(
+    TokenInfoIndex* index,
+    size_t offset,
+    const TokenInfo* token_info) {
+    if(index->stream == NULL) return false;
+
+    TokenInfoIndexRecord record = {0};
+    record.offset = offset;
+    record.algo = token_info->algo;
+    record.digits = token_info->digits;
+    record.duration = token_info->duration;
+    record.type = token_info->type;
+
+    size_t name_length = furi_string_size(token_info->name);
+    record.name_length = name_length > UINT8_MAX ? UINT8_MAX : name_length;
+    strncpy(record.name, furi_string_get_cstr(token_info->name), TOKEN_INFO_INDEX_NAME_LENGTH);
+
+    if(stream_write(index->stream, (const uint8_t*)&record, sizeof(record)) != sizeof(record) ||
+       !token_info_index_push_offset(index, record.offset)) {
+        token_info_index_reset(index);
+        return false;
+    }
+
+    return true;
+}
+
+bool totp_token_info_index_build_end(TokenInfoIndex* index, size_t config_file_size) {
+    if(index->stream == NULL) return false;
+
+    TokenInfoIndexHeader header = {
+        .magic = TOKEN_INFO_INDEX_MAGIC,
+        .version = TOKEN_INFO_INDEX_VERSION,
+        .count = index->count,
+        .config_file_size = config_file_size};
+
+    if(!stream_rewind(index->stream) ||
+       stream_write(index->stream, (const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        totp_token_info_index_invalidate(index);
+        return false;
+    }
+
+    index->loaded = true;
+    return true;
+}
+
+bool totp_token_info_index_is_loaded(const TokenInfoIndex* index) {
+    return index->loaded;
+}
+
+size_t totp_token_info_index_get_count(const TokenInfoIndex* index) {
+    return index->count;
+}
+
+size_t totp_token_info_index_get_offset(const TokenInfoIndex* index, size_t token_index) {
+    furi_check(index->loaded && token_index < index->count);
+    return index->offsets[token_index];
+}
+
+bool totp_token_info_index_read_summary(
+    TokenInfoIndex* index,
+    size_t token_index,
+    TokenInfo* token_info) {
+    if(!index->loaded || token_index >= index->count) return false;
+
+    TokenInfoIndexRecord record;
+    if(!stream_seek(
+           index->stream,
+           sizeof(TokenInfoIndexHeader) + token_index * sizeof(TokenInfoIndexRecord),
+           StreamOffsetFromStart) ||
+       stream_read(index->stream, (uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+        return false;
+    }
+
+    if(record.name_length >= TOKEN_INFO_INDEX_NAME_LENGTH) {
+        return false;
+    }
+
+    furi_string_set_strn(token_info->name, record.name, record.name_length);
+    token_info->algo = record.algo;
+    token_info->digits = record.digits;
+    token_info->duration = record.duration;
+    token_info->type = record.type;
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <storage/storage.h>
+#include "../../types/token_info.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TokenInfoIndex TokenInfoIndex;
+
+/**
+ * @brief Initializes a new token index.
+ *        Token index is a binary sidecar file next to the config file which keeps byte offset
+ *        and fixed-size summary (name, algo, digits, duration, type) of every token record,
+ *        so any token can be reached without scanning the text config file.
+ * @param storage storage reference
+ * @return Token index
+ */
+TokenInfoIndex* totp_token_info_index_alloc(Storage* storage);
+
+/**
+ * @brief Disposes token index and releases all the resources
+ * @param index token index
+ */
+void totp_token_info_index_free(TokenInfoIndex* index);
+
+/**
+ * @brief Loads token index from the sidecar file
+ * @param index token index
+ * @param config_file_size current config file size, used to detect stale index files
+ * @return \c true if index has been loaded and matches config file; \c false otherwise
+ */
+bool totp_token_info_index_load(TokenInfoIndex* index, size_t config_file_size);
+
+/**
+ * @brief Drops loaded index and removes the sidecar file. Must be called whenever token
+ *        records in the config file are changed
+ * @param index token index
+ */
+void totp_token_info_index_invalidate(TokenInfoIndex* index);
+
+/**
+ * @brief Starts building a new index, previous one gets invalidated
+ * @param index token index
+ * @return \c true if sidecar file has been created; \c false otherwise
+ */
+bool totp_token_info_index_build_begin(TokenInfoIndex* index);
+
+/**
+ * @brief Appends a token record to the index being built
+ * @param index token index
+ * @param offset offset of the token record start in the config file
+ * @param token_info token info to take summary from
+ * @return \c true if record has been appended; \c false otherwise
+ */
+bool totp_token_info_index_build_append(
+    TokenInfoIndex* index,
+    size_t offset,
+    const TokenInfo* token_info);
+
+/**
+ * @brief Finalizes index being built
+ * @param index token index
+ * @param config_file_size config file size index has been built for
+ * @return \c true if index has been saved and loaded; \c false otherwise
+ */
+bool totp_token_info_index_build_end(TokenInfoIndex* index, size_t config_file_size);
+
+/**
+ * @brief Checks whether index is loaded and can be used
+ * @param index token index
+ * @return \c true if index is loaded; \c false otherwise
+ */
+bool totp_token_info_index_is_loaded(const TokenInfoIndex* index);
+
+/**
+ * @brief Gets amount of tokens in the index
+ * @param index token index
+ * @return amount of tokens
+ */
+size_t totp_token_info_index_get_count(const TokenInfoIndex* index);
+
+/**
+ * @brief Gets config file offset of the token record with given index
+ * @param index token index
+ * @param token_index token index
+ * @return offset of the token record start in the config file
+ */
+size_t totp_token_info_index_get_offset(const TokenInfoIndex* index, size_t token_index);
+
+/**
+ * @brief Reads token summary (name, algo, digits, duration and type) from the index
+ * @param index token index
+ * @param token_index token index
+ * @param[out] token_info token info to fill; secret, automation features and counter are not touched
+ * @return \c true if complete summary has been read; \c false if index is not loaded
+ *         or token name didn't fit into the index record
+ */
+bool totp_token_info_index_read_summary(
+    TokenInfoIndex* index,
+    size_t token_index,
+    TokenInfo* token_info);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,6 +5,7 @@
 #include <toolbox/stream/file_stream.h>
 #include "../../types/common.h"
 #include "../../types/crypto_settings.h"
+#include "token_info_index.h"
 
 #define CONFIG_FILE_PART_FILE_PATH CONFIG_FILE_DIRECTORY_PATH "/totp.conf.part"
 #define STREAM_COPY_BUFFER_SIZE (128)
@@ -15,9 +16,13 @@ struct TokenInfoIteratorContext {
     size_t last_seek_offset;
     size_t last_seek_index;
     TokenInfo* current_token;
+    TokenInfo* summary_token;
+    TokenInfoIndex* index;
+    bool index_build_failed;
     FlipperFormat* config_file;
     CryptoSettings* crypto_settings;
     Storage* storage;
+    uint32_t list_version;
 };
 
 static bool
@@ -46,12 +51,50 @@ static bool
     return found;
 }
 
+static bool is_token_start(Stream* stream) {
+    char buffer[sizeof(TOTP_CONFIG_KEY_TOKEN_NAME) + 1];
+    size_t offset = stream_tell(stream);
+    bool result = stream_read(stream, (uint8_t*)&buffer[0], sizeof(buffer)) == sizeof(buffer) &&
+                  strncmp(buffer, "\n" TOTP_CONFIG_KEY_TOKEN_NAME ":", sizeof(buffer)) == 0;
+    return stream_seek(stream, offset, StreamOffsetFromStart) && result;
+}
+
+static void invalidate_token_index(TokenInfoIteratorContext* context) {
+    totp_token_info_index_invalidate(context->index);
+    context->index_build_failed = false;
+    context->list_version++;
+}
+
+static bool seek_to_token_using_index(size_t token_index, TokenInfoIteratorContext* context) {
+    if(!totp_token_info_index_is_loaded(context->index) ||
+       token_index >= totp_token_info_index_get_count(context->index)) {
+        return false;
+    }
+
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t offset = totp_token_info_index_get_offset(context->index, token_index);
+    if(!stream_seek(stream, offset, StreamOffsetFromStart) || !is_token_start(stream)) {
+        // Config file has been changed behind our back, index can't be trusted anymore
+        FURI_LOG_D(LOGGING_TAG, "Token index is out of sync with config file");
+        invalidate_token_index(context);
+        return false;
+    }
+
+    context->last_seek_offset = offset;
+    context->last_seek_index = token_index;
+    return true;
+}
+
 static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context) {
     furi_check(context != NULL && context->config_file != NULL);
     if(token_index >= context->total_count) {
         return false;
     }
 
+    if(seek_to_token_using_index(token_index, context)) {
+        return true;
+    }
+
     Stream* stream = flipper_format_get_raw_stream(context->config_file);
     long token_index_diff = (long)token_index - (long)context->last_seek_index;
     size_t token_index_diff_weight = (size_t)labs(token_index_diff);
@@ -97,6 +140,74 @@ static bool seek_to_token(size_t token_index, TokenInfoIteratorContext* context)
     return true;
 }
 
+static void read_token_summary(FlipperFormat* config_file, TokenInfo* token_info) {
+    token_info_set_defaults(token_info);
+    if(!flipper_format_read_string(config_file, TOTP_CONFIG_KEY_TOKEN_NAME, token_info->name)) {
+        return;
+    }
+
+    uint32_t temp_data32;
+    if(flipper_format_read_uint32(config_file, TOTP_CONFIG_KEY_TOKEN_ALGO, &temp_data32, 1)) {
+        token_info_set_algo_from_int(token_info, temp_data32);
+    }
+
+    if(flipper_format_read_uint32(config_file, TOTP_CONFIG_KEY_TOKEN_DIGITS, &temp_data32, 1)) {
+        token_info_set_digits_from_int(token_info, temp_data32);
+    }
+
+    if(flipper_format_read_uint32(config_file, TOTP_CONFIG_KEY_TOKEN_DURATION, &temp_data32, 1)) {
+        token_info_set_duration_from_int(token_info, temp_data32);
+    }
+
+    if(flipper_format_read_uint32(config_file, TOTP_CONFIG_KEY_TOKEN_TYPE, &temp_data32, 1)) {
+        token_info->type = temp_data32;
+    }
+}
+
+/**
+ * @brief Scans the whole config file once, counting tokens and building token index
+ * @param context token info iterator context
+ * @return amount of tokens found
+ */
+static size_t rebuild_token_index(TokenInfoIteratorContext* context) {
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t original_offset = stream_tell(stream);
+    bool index_ok = totp_token_info_index_build_begin(context->index);
+    size_t tokens_count = 0;
+
+    stream_rewind(stream);
+    while(flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
+        if(index_ok) {
+            size_t token_offset = stream_tell(stream);
+            read_token_summary(context->config_file, context->summary_token);
+            index_ok = totp_token_info_index_build_append(
+                           context->index, token_offset, context->summary_token) &&
+                       stream_seek(stream, token_offset + 1, StreamOffsetFromStart);
+            if(!index_ok) {
+                FURI_LOG_W(LOGGING_TAG, "Unable to build token index");
+                stream_seek(stream, token_offset + 1, StreamOffsetFromStart);
+            }
+        }
+
+        tokens_count++;
+    }
+
+    if(!index_ok || !totp_token_info_index_build_end(context->index, stream_size(stream))) {
+        totp_token_info_index_invalidate(context->index);
+        // Don't rescan on every navigation if index can't be saved, next write will retry
+        context->index_build_failed = true;
+    }
+
+    stream_seek(stream, original_offset, StreamOffsetFromStart);
+    return tokens_count;
+}
+
+static void ensure_token_index(TokenInfoIteratorContext* context) {
+    if(!totp_token_info_index_is_loaded(context->index) && !context->index_build_failed) {
+        context->total_count = rebuild_token_index(context);
+    }
+}
+
 static bool stream_insert_stream(Stream* dst, Stream* src) {
     uint8_t buffer[STREAM_COPY_BUFFER_SIZE];
     size_t buffer_read_size;
@@ -222,6 +333,8 @@ static bool
             break;
         }
 
+        invalidate_token_index(context);
+
         if(offset_end != offset_start && !stream_delete(stream, offset_end - offset_start)) {
             break;
         }
@@ -255,30 +368,38 @@ TokenInfoIteratorContext* totp_token_info_iterator_alloc(
     Storage* storage,
     FlipperFormat* config_file,
     CryptoSettings* crypto_settings) {
-    Stream* stream = flipper_format_get_raw_stream(config_file);
-    stream_rewind(stream);
-    size_t tokens_count = 0;
-    while(true) {
-        if(!flipper_format_seek_to_siblinig_token_start(stream, StreamDirectionForward)) {
-            break;
-        }
-
-        tokens_count++;
-    }
-
     TokenInfoIteratorContext* context = malloc(sizeof(TokenInfoIteratorContext));
     furi_check(context != NULL);
 
-    context->total_count = tokens_count;
+    context->current_index = 0;
+    context->last_seek_offset = 0;
+    context->last_seek_index = 0;
     context->current_token = token_info_alloc();
+    context->summary_token = token_info_alloc();
+    context->summary_token->token = NULL;
+    context->summary_token->token_length = 0;
+    context->index = totp_token_info_index_alloc(storage);
+    context->index_build_failed = false;
     context->config_file = config_file;
     context->crypto_settings = crypto_settings;
     context->storage = storage;
+    context->list_version = 0;
+
+    Stream* stream = flipper_format_get_raw_stream(config_file);
+    if(totp_token_info_index_load(context->index, stream_size(stream))) {
+        context->total_count = totp_token_info_index_get_count(context->index);
+    } else {
+        context->total_count = rebuild_token_index(context);
+    }
+
+    stream_rewind(stream);
     return context;
 }
 
 void totp_token_info_iterator_free(TokenInfoIteratorContext* context) {
     if(context == NULL) return;
+    totp_token_info_index_free(context->index);
+    token_info_free(context->summary_token);
     token_info_free(context->current_token);
     free(context);
 }
@@ -303,6 +424,8 @@ bool totp_token_info_iterator_remove_current_token_info(TokenInfoIteratorContext
         return false;
     }
 
+    invalidate_token_index(context);
+
     if(!stream_seek(stream, begin_offset, StreamOffsetFromStart) ||
        !stream_delete(stream, end_offset - begin_offset)) {
         return false;
@@ -368,6 +491,8 @@ bool totp_token_info_iterator_move_current_token_info(
             break;
         }
 
+        invalidate_token_index(context);
+
         if(!stream_delete(stream, moving_size)) {
             break;
         }
@@ -479,19 +604,21 @@ TotpIteratorUpdateTokenResult totp_token_info_iterator_add_new_token(
     return result;
 }
 
-bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t token_index) {
-    furi_check(context != NULL);
-    context->current_index = token_index;
-    if(!seek_to_token(context->current_index, context)) {
-        return false;
-    }
-
-    Stream* stream = flipper_format_get_raw_stream(context->config_file);
-    size_t original_offset = stream_tell(stream);
-
+/**
+ * @brief Reads token record starting at the current config file position
+ * @param context token info iterator context
+ * @param[out] tokenInfo token info to fill
+ * @param[out] token_update_needed set to \c true if token secret is stored unencrypted
+ *             and token record has to be re-saved
+ * @return \c true if token record has been read; \c false otherwise
+ */
+static bool read_token_info(
+    TokenInfoIteratorContext* context,
+    TokenInfo* tokenInfo,
+    bool* token_update_needed) {
+    *token_update_needed = false;
     if(!flipper_format_read_string(
-           context->config_file, TOTP_CONFIG_KEY_TOKEN_NAME, context->current_token->name)) {
-        stream_seek(stream, original_offset, StreamOffsetFromStart);
+           context->config_file, TOTP_CONFIG_KEY_TOKEN_NAME, tokenInfo->name)) {
         return false;
     }
 
@@ -500,8 +627,7 @@ bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t to
            context->config_file, TOTP_CONFIG_KEY_TOKEN_SECRET, &secret_bytes_count)) {
         secret_bytes_count = 0;
     }
-    TokenInfo* tokenInfo = context->current_token;
-    bool token_update_needed = false;
+
     if(tokenInfo->token != NULL) {
         free(tokenInfo->token);
         tokenInfo->token_length = 0;
@@ -522,7 +648,7 @@ bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t to
                     LOGGING_TAG,
                     "Token \"%s\" has plain secret",
                     furi_string_get_cstr(tokenInfo->name));
-                token_update_needed = true;
+                *token_update_needed = true;
             } else {
                 tokenInfo->token = NULL;
                 tokenInfo->token_length = 0;
@@ -597,15 +723,59 @@ bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t to
         tokenInfo->counter = 0;
     }
 
+    return true;
+}
+
+bool totp_token_info_iterator_go_to(TokenInfoIteratorContext* context, size_t token_index) {
+    furi_check(context != NULL);
+    ensure_token_index(context);
+    context->current_index = token_index;
+    if(!seek_to_token(context->current_index, context)) {
+        return false;
+    }
+
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t original_offset = stream_tell(stream);
+
+    bool token_update_needed;
+    bool result = read_token_info(context, context->current_token, &token_update_needed);
+
     stream_seek(stream, original_offset, StreamOffsetFromStart);
 
-    if(token_update_needed && !totp_token_info_iterator_save_current_token_info_changes(context)) {
+    if(!result ||
+       (token_update_needed && !totp_token_info_iterator_save_current_token_info_changes(context))) {
         return false;
     }
 
     return true;
 }
 
+TokenInfo*
+    totp_token_info_iterator_load_token(TokenInfoIteratorContext* context, size_t token_index) {
+    furi_check(context != NULL);
+    ensure_token_index(context);
+    if(!seek_to_token(token_index, context)) {
+        return NULL;
+    }
+
+    Stream* stream = flipper_format_get_raw_stream(context->config_file);
+    size_t original_offset = stream_tell(stream);
+
+    TokenInfo* token_info = token_info_alloc();
+    token_info->token = NULL;
+    token_info->token_length = 0;
+
+    // Plain secret gets encrypted in memory anyway, migration is up to iterator go_to
+    bool token_update_needed;
+    if(!read_token_info(context, token_info, &token_update_needed)) {
+        token_info_free(token_info);
+        token_info = NULL;
+    }
+
+    stream_seek(stream, original_offset, StreamOffsetFromStart);
+    return token_info;
+}
+
 const TokenInfo*
     totp_token_info_iterator_get_current_token(const TokenInfoIteratorContext* context) {
     return context->current_token;
@@ -615,14 +785,31 @@ size_t totp_token_info_iterator_get_current_token_index(const TokenInfoIteratorC
     return context->current_index;
 }
 
+const TokenInfo* totp_token_info_iterator_get_token_summary(
+    TokenInfoIteratorContext* context,
+    size_t token_index) {
+    ensure_token_index(context);
+    if(token_index >= context->total_count ||
+       !totp_token_info_index_read_summary(context->index, token_index, context->summary_token)) {
+        return NULL;
+    }
+
+    return context->summary_token;
+}
+
 size_t totp_token_info_iterator_get_total_count(const TokenInfoIteratorContext* context) {
     return context->total_count;
 }
 
+uint32_t totp_token_info_iterator_get_list_version(const TokenInfoIteratorContext* context) {
+    return context->list_version;
+}
+
 void totp_token_info_iterator_attach_to_config_file(
     TokenInfoIteratorContext* context,
     FlipperFormat* config_file) {
     context->config_file = config_file;
+    context->list_version++;
     Stream* stream = flipper_format_get_raw_stream(context->config_file);
     stream_seek(stream, context->last_seek_offset, StreamOffsetFromStart);
 }
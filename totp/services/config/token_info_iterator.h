@@ -118,6 +118,29 @@ const TokenInfo*
  */
 size_t totp_token_info_iterator_get_current_token_index(const TokenInfoIteratorContext* context);
 
+/**
+ * @brief Loads a standalone copy of the token info with given index. Current token is not changed
+ * @param context token info iterator context
+ * @param token_index token index
+ * @return loaded token info which has to be released with \c token_info_free by the caller;
+ *         \c NULL if token can't be loaded
+ */
+TokenInfo*
+    totp_token_info_iterator_load_token(TokenInfoIteratorContext* context, size_t token_index);
+
+/**
+ * @brief Gets token name and parameters from the token index without loading the whole token record.
+ *        Current token is not changed
+ * @param context token info iterator context
+ * @param token_index token index
+ * @return token summary (secret, automation features and counter are not set) which stays valid
+ *         until next call; \c NULL if summary is not available, \c totp_token_info_iterator_go_to
+ *         should be used instead
+ */
+const TokenInfo* totp_token_info_iterator_get_token_summary(
+    TokenInfoIteratorContext* context,
+    size_t token_index);
+
 /**
  * @brief Gets total amount of token infos found
  * @param context token info iterator context
@@ -125,6 +148,15 @@ size_t totp_token_info_iterator_get_current_token_index(const TokenInfoIteratorC
  */
 size_t totp_token_info_iterator_get_total_count(const TokenInfoIteratorContext* context);
 
+/**
+ * @brief Gets token list version. Version changes whenever tokens are added, updated, removed or
+ *        moved, or iterator is attached to another config file, so anything cached by token index
+ *        has to be dropped once version changes
+ * @param context token info iterator context
+ * @return token list version
+ */
+uint32_t totp_token_info_iterator_get_list_version(const TokenInfoIteratorContext* context);
+
 /**
  * @brief Attaches token info iterator to another config file
  * @param context token info iterator context
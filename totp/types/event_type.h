@@ -3,4 +3,10 @@
 
 typedef uint8_t EventType;
 
-enum EventTypes { EventTypeTick, EventTypeKey, EventForceCloseApp, EventForceRedraw };
+enum EventTypes {
+    EventTypeTick,
+    EventTypeKey,
+    EventForceCloseApp,
+    EventForceRedraw,
+    EventCodeCachePrefetch
+};
@@ -41,6 +41,7 @@ typedef struct {
     UiPrecalculatedDimensions ui_precalculated_dimensions;
     FontInfo* active_font;
     NotificationApp* notification_app;
+    bool code_cache_prefetch_pending;
 } SceneState;
 
 static const NotificationSequence*
@@ -107,14 +108,92 @@ static const NotificationSequence*
     return (NotificationSequence*)scene_state->notification_sequence_automation;
 }
 
+static void schedule_code_cache_prefetch(PluginState* const plugin_state) {
+    SceneState* scene_state = (SceneState*)plugin_state->current_scene_state;
+    if(scene_state->code_cache_prefetch_pending) {
+        return;
+    }
+
+    // Goes to the back of the queue, so already pending input and redraw are handled first.
+    // Prefetch is best effort, it is simply skipped if queue is full
+    PluginEvent event = {.type = EventCodeCachePrefetch};
+    scene_state->code_cache_prefetch_pending =
+        furi_message_queue_put(plugin_state->event_queue, &event, 0) == FuriStatusOk;
+}
+
+/**
+ * @brief Keeps codes of the current token and its neighbours pre-generated, so next Left\Right
+ *        press shows the code instantly. Loads at most one token per call and schedules itself
+ *        again, so reading the config file never holds input handling or rendering back for
+ *        longer than a single token read
+ * @param plugin_state application state
+ */
+static void prefetch_code_cache(PluginState* const plugin_state) {
+    SceneState* scene_state = (SceneState*)plugin_state->current_scene_state;
+    scene_state->code_cache_prefetch_pending = false;
+
+    TokenInfoIteratorContext* iterator_context =
+        totp_config_get_token_iterator_context(plugin_state);
+    size_t total_count = totp_token_info_iterator_get_total_count(iterator_context);
+    if(total_count == 0) {
+        return;
+    }
+
+    size_t token_index = totp_token_info_iterator_get_current_token_index(iterator_context);
+    size_t window[TOTP_CODE_CACHE_WINDOW_RADIUS * 2 + 1];
+    size_t window_size = 0;
+    for(int32_t offset = -TOTP_CODE_CACHE_WINDOW_RADIUS; offset <= TOTP_CODE_CACHE_WINDOW_RADIUS;
+        offset++) {
+        size_t index = (token_index + total_count + offset % (int32_t)total_count) % total_count;
+        bool duplicate = false;
+        for(size_t i = 0; i < window_size && !duplicate; i++) {
+            duplicate = window[i] == index;
+        }
+
+        if(!duplicate) {
+            window[window_size++] = index;
+        }
+    }
+
+    totp_generate_code_worker_set_cache_window(
+        scene_state->generate_code_worker_context,
+        totp_token_info_iterator_get_list_version(iterator_context),
+        &window[0],
+        window_size);
+
+    for(size_t i = 0; i < window_size; i++) {
+        if(totp_generate_code_worker_is_token_cached(
+               scene_state->generate_code_worker_context, window[i])) {
+            continue;
+        }
+
+        TokenInfo* token_info = totp_token_info_iterator_load_token(iterator_context, window[i]);
+        if(token_info != NULL) {
+            totp_generate_code_worker_cache_token(
+                scene_state->generate_code_worker_context,
+                totp_token_info_iterator_get_list_version(iterator_context),
+                window[i],
+                token_info);
+            schedule_code_cache_prefetch(plugin_state);
+            return;
+        }
+    }
+}
+
 static void update_totp_params(PluginState* const plugin_state, size_t token_index) {
     SceneState* scene_state = (SceneState*)plugin_state->current_scene_state;
     TokenInfoIteratorContext* iterator_context =
         totp_config_get_token_iterator_context(plugin_state);
-    if(totp_token_info_iterator_go_to(iterator_context, token_index)) {
-        totp_generate_code_worker_notify(
-            scene_state->generate_code_worker_context, TotpGenerateCodeWorkerEventForceUpdate);
+    if(!totp_token_info_iterator_go_to(iterator_context, token_index)) {
+        return;
     }
+
+    totp_generate_code_worker_set_current_token(
+        scene_state->generate_code_worker_context,
+        totp_token_info_iterator_get_list_version(iterator_context),
+        token_index);
+
+    schedule_code_cache_prefetch(plugin_state);
 }
 
 static void draw_totp_code(Canvas* const canvas, const PluginState* const plugin_state) {
@@ -198,6 +277,7 @@ void totp_scene_generate_token_activate(PluginState* plugin_state) {
     scene_state->notification_app = furi_record_open(RECORD_NOTIFICATION);
     scene_state->notification_sequence_automation[0] = NULL;
     scene_state->notification_sequence_new_token[0] = NULL;
+    scene_state->code_cache_prefetch_pending = false;
 
 #ifdef TOTP_BADBT_AUTOMATION_ENABLED
 
@@ -334,6 +414,11 @@ void totp_scene_generate_token_render(Canvas* const canvas, PluginState* plugin_
 bool totp_scene_generate_token_handle_event(
     const PluginEvent* const event,
     PluginState* plugin_state) {
+    if(event->type == EventCodeCachePrefetch) {
+        prefetch_code_cache(plugin_state);
+        return true;
+    }
+
     if(event->type != EventTypeKey) {
         return true;
     }
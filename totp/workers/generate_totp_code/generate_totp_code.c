@@ -4,16 +4,32 @@
 #include "../../services/crypto/crypto_facade.h"
 #include "../../services/totp/totp.h"
 #include "../../services/convert/convert.h"
+#include "../../config/app/config.h"
 #include <furi_hal_rtc.h>
 #include <memset_s.h>
 
 #define ONE_SEC_MS (1000)
+#define CODE_CACHE_SIZE (TOTP_CODE_CACHE_WINDOW_RADIUS * 2 + 1)
+#define NO_TOKEN_INDEX (SIZE_MAX)
+
+typedef struct {
+    TokenInfo* token_info; // Encrypted copy of the token, NULL if entry is free
+    size_t token_index;
+    uint32_t time_step;
+    bool has_codes;
+    char current_code[TokenDigitsCountMax + 1];
+    char next_code[TokenDigitsCountMax + 1];
+} TotpCodeCacheEntry;
 
 struct TotpGenerateCodeWorkerContext {
     char* code_buffer;
     FuriThread* thread;
     FuriMutex* code_buffer_sync;
     const TokenInfo* token_info;
+    size_t current_token_index;
+    FuriMutex* code_cache_sync;
+    uint32_t code_cache_list_version;
+    TotpCodeCacheEntry code_cache[CODE_CACHE_SIZE];
     float timezone_offset;
     const CryptoSettings* crypto_settings;
     TOTP_NEW_CODE_GENERATED_HANDLER on_new_code_generated_handler;
@@ -63,37 +79,166 @@ static TOTP_ALGO get_totp_algo_impl(TokenHashAlgo algo) {
     return NULL;
 }
 
-static void generate_totp_code(
-    TotpGenerateCodeWorkerContext* context,
+/**
+ * @brief Generates current and, for TOTP tokens, next code with a single secret decryption.
+ *        Decrypted secret is wiped right after codes are generated
+ * @param context worker context
+ * @param token_info token info to generate codes for
+ * @param current_ts timestamp to generate current code for
+ * @param[out] code buffer to generate current code to, can be \c NULL
+ * @param[out] next_code buffer to generate next code to, can be \c NULL
+ */
+static void generate_totp_codes(
+    const TotpGenerateCodeWorkerContext* context,
     const TokenInfo* token_info,
-    uint32_t current_ts) {
+    uint32_t current_ts,
+    char* code,
+    char* next_code) {
     if(token_info->token != NULL && token_info->token_length > 0) {
         size_t key_length;
         uint8_t* key = totp_crypto_decrypt(
             token_info->token, token_info->token_length, context->crypto_settings, &key_length);
 
-        uint64_t otp_code;
+        TOTP_ALGO algo = get_totp_algo_impl(token_info->algo);
         if(token_info->type == TokenTypeTOTP) {
-            otp_code = totp_at(
-                get_totp_algo_impl(token_info->algo),
-                key,
-                key_length,
-                current_ts,
-                context->timezone_offset,
-                token_info->duration);
+            if(code != NULL) {
+                uint64_t otp_code = totp_at(
+                    algo,
+                    key,
+                    key_length,
+                    current_ts,
+                    context->timezone_offset,
+                    token_info->duration);
+                int_token_to_str(otp_code, code, token_info->digits, token_info->algo);
+            }
+
+            if(next_code != NULL) {
+                uint64_t otp_code = totp_at(
+                    algo,
+                    key,
+                    key_length,
+                    current_ts + token_info->duration,
+                    context->timezone_offset,
+                    token_info->duration);
+                int_token_to_str(otp_code, next_code, token_info->digits, token_info->algo);
+            }
         } else if(token_info->type == TokenTypeHOTP) {
-            otp_code = hotp_at(
-                get_totp_algo_impl(token_info->algo), key, key_length, token_info->counter);
+            if(code != NULL) {
+                uint64_t otp_code = hotp_at(algo, key, key_length, token_info->counter);
+                int_token_to_str(otp_code, code, token_info->digits, token_info->algo);
+            }
         } else {
             furi_crash("Unknown token type");
         }
 
-        int_token_to_str(otp_code, context->code_buffer, token_info->digits, token_info->algo);
         memset_s(key, key_length, 0, key_length);
         free(key);
     } else {
-        int_token_to_str(0, context->code_buffer, token_info->digits, token_info->algo);
+        if(code != NULL) {
+            int_token_to_str(0, code, token_info->digits, token_info->algo);
+        }
+
+        if(next_code != NULL) {
+            int_token_to_str(0, next_code, token_info->digits, token_info->algo);
+        }
+    }
+}
+
+static void generate_totp_code(
+    TotpGenerateCodeWorkerContext* context,
+    const TokenInfo* token_info,
+    uint32_t current_ts) {
+    generate_totp_codes(context, token_info, current_ts, context->code_buffer, NULL);
+}
+
+static void code_cache_entry_free(TotpCodeCacheEntry* entry) {
+    memset_s(entry->current_code, sizeof(entry->current_code), 0, sizeof(entry->current_code));
+    memset_s(entry->next_code, sizeof(entry->next_code), 0, sizeof(entry->next_code));
+    token_info_free(entry->token_info);
+    entry->token_info = NULL;
+    entry->token_index = NO_TOKEN_INDEX;
+    entry->has_codes = false;
+}
+
+static TotpCodeCacheEntry*
+    code_cache_find(TotpGenerateCodeWorkerContext* context, size_t token_index) {
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE; i++) {
+        TotpCodeCacheEntry* entry = &context->code_cache[i];
+        if(entry->token_info != NULL && entry->token_index == token_index) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Wipes the whole cache if token list has changed since cache was filled, as cached
+ *        tokens are keyed by index and indexes can point to other tokens by now
+ * @param context worker context
+ * @param list_version current token list version
+ */
+static void
+    code_cache_check_list_version(TotpGenerateCodeWorkerContext* context, uint32_t list_version) {
+    if(context->code_cache_list_version == list_version) {
+        return;
+    }
+
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE; i++) {
+        code_cache_entry_free(&context->code_cache[i]);
+    }
+
+    context->code_cache_list_version = list_version;
+}
+
+/**
+ * @brief Brings cached codes up to date. Codes are only generated when time step rolls over,
+ *        in which case previous "next" code becomes current one and only new "next" code
+ *        has to be generated
+ * @param context worker context
+ * @param current_ts current timestamp
+ */
+static void code_cache_refresh(TotpGenerateCodeWorkerContext* context, uint32_t current_ts) {
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE; i++) {
+        TotpCodeCacheEntry* entry = &context->code_cache[i];
+        if(entry->token_info == NULL || entry->token_info->type != TokenTypeTOTP) {
+            continue;
+        }
+
+        uint32_t time_step = current_ts / entry->token_info->duration;
+        if(entry->has_codes && entry->time_step == time_step) {
+            continue;
+        }
+
+        if(entry->has_codes && entry->time_step + 1 == time_step) {
+            memcpy(entry->current_code, entry->next_code, sizeof(entry->current_code));
+            generate_totp_codes(context, entry->token_info, current_ts, NULL, entry->next_code);
+        } else {
+            generate_totp_codes(
+                context, entry->token_info, current_ts, entry->current_code, entry->next_code);
+        }
+
+        entry->time_step = time_step;
+        entry->has_codes = true;
+    }
+}
+
+/**
+ * @brief Copies cached code of the current token into code buffer
+ * @param context worker context
+ * @param current_ts current timestamp
+ * @return \c true if cached code is available; \c false otherwise
+ */
+static bool
+    code_cache_get_current_code(TotpGenerateCodeWorkerContext* context, uint32_t current_ts) {
+    const TotpCodeCacheEntry* entry = code_cache_find(context, context->current_token_index);
+    if(entry == NULL || !entry->has_codes || entry->token_info->type != TokenTypeTOTP ||
+       entry->time_step != current_ts / entry->token_info->duration) {
+        return false;
     }
+
+    memcpy(context->code_buffer, entry->current_code, sizeof(entry->current_code));
+    return true;
 }
 
 static int32_t totp_generate_worker_callback(void* context) {
@@ -103,7 +248,8 @@ static int32_t totp_generate_worker_callback(void* context) {
 
     while(true) {
         uint32_t flags = furi_thread_flags_wait(
-            TotpGenerateCodeWorkerEventStop | TotpGenerateCodeWorkerEventForceUpdate,
+            TotpGenerateCodeWorkerEventStop | TotpGenerateCodeWorkerEventForceUpdate |
+                TotpGenerateCodeWorkerEventCacheUpdate,
             FuriFlagWaitAny,
             ONE_SEC_MS);
 
@@ -117,6 +263,11 @@ static int32_t totp_generate_worker_callback(void* context) {
 
         if(flags & TotpGenerateCodeWorkerEventStop) break;
 
+        uint32_t now_ts = furi_hal_rtc_get_timestamp();
+        furi_mutex_acquire(t_context->code_cache_sync, FuriWaitForever);
+        code_cache_refresh(t_context, now_ts);
+        furi_mutex_release(t_context->code_cache_sync);
+
         const TokenInfo* token_info = t_context->token_info;
         if(token_info == NULL) {
             continue;
@@ -124,13 +275,23 @@ static int32_t totp_generate_worker_callback(void* context) {
 
         const bool is_time_based = token_info->type == TokenTypeTOTP;
 
-        uint32_t curr_ts = is_time_based ? furi_hal_rtc_get_timestamp() : 0;
+        uint32_t curr_ts = is_time_based ? now_ts : 0;
 
         bool time_left = false;
         if(flags & TotpGenerateCodeWorkerEventForceUpdate ||
            (is_time_based && (time_left = (curr_ts % token_info->duration) == 0))) {
             if(furi_mutex_acquire(t_context->code_buffer_sync, FuriWaitForever) == FuriStatusOk) {
-                generate_totp_code(t_context, token_info, curr_ts);
+                bool cached = false;
+                if(is_time_based) {
+                    furi_mutex_acquire(t_context->code_cache_sync, FuriWaitForever);
+                    cached = code_cache_get_current_code(t_context, curr_ts);
+                    furi_mutex_release(t_context->code_cache_sync);
+                }
+
+                if(!cached) {
+                    generate_totp_code(t_context, token_info, curr_ts);
+                }
+
                 if(is_time_based) {
                     curr_ts = furi_hal_rtc_get_timestamp();
                 }
@@ -164,6 +325,13 @@ TotpGenerateCodeWorkerContext* totp_generate_code_worker_start(
     furi_check(context != NULL);
     context->code_buffer = code_buffer;
     context->token_info = token_info;
+    context->current_token_index = NO_TOKEN_INDEX;
+    context->code_cache_sync = furi_mutex_alloc(FuriMutexTypeNormal);
+    context->code_cache_list_version = 0;
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE; i++) {
+        context->code_cache[i].token_info = NULL;
+        code_cache_entry_free(&context->code_cache[i]);
+    }
     context->code_buffer_sync = code_buffer_sync;
     context->timezone_offset = timezone_offset;
     context->crypto_settings = crypto_settings;
@@ -181,6 +349,10 @@ void totp_generate_code_worker_stop(TotpGenerateCodeWorkerContext* context) {
     furi_thread_flags_set(furi_thread_get_id(context->thread), TotpGenerateCodeWorkerEventStop);
     furi_thread_join(context->thread);
     furi_thread_free(context->thread);
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE; i++) {
+        code_cache_entry_free(&context->code_cache[i]);
+    }
+    furi_mutex_free(context->code_cache_sync);
     free(context);
 }
 
@@ -208,3 +380,82 @@ void totp_generate_code_worker_set_lifetime_changed_handler(
     context->on_code_lifetime_changed_handler = on_code_lifetime_changed_handler;
     context->on_code_lifetime_changed_handler_context = on_code_lifetime_changed_handler_context;
 }
+
+void totp_generate_code_worker_set_current_token(
+    TotpGenerateCodeWorkerContext* context,
+    uint32_t list_version,
+    size_t token_index) {
+    furi_check(context != NULL);
+    furi_check(furi_mutex_acquire(context->code_cache_sync, FuriWaitForever) == FuriStatusOk);
+    code_cache_check_list_version(context, list_version);
+    context->current_token_index = token_index;
+    furi_mutex_release(context->code_cache_sync);
+    totp_generate_code_worker_notify(context, TotpGenerateCodeWorkerEventForceUpdate);
+}
+
+void totp_generate_code_worker_set_cache_window(
+    TotpGenerateCodeWorkerContext* context,
+    uint32_t list_version,
+    const size_t* token_indexes,
+    size_t token_indexes_count) {
+    furi_check(context != NULL);
+    furi_check(furi_mutex_acquire(context->code_cache_sync, FuriWaitForever) == FuriStatusOk);
+    code_cache_check_list_version(context, list_version);
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE; i++) {
+        TotpCodeCacheEntry* entry = &context->code_cache[i];
+        if(entry->token_info == NULL) continue;
+
+        bool in_window = false;
+        for(size_t j = 0; j < token_indexes_count && !in_window; j++) {
+            in_window = token_indexes[j] == entry->token_index;
+        }
+
+        if(!in_window) {
+            code_cache_entry_free(entry);
+        }
+    }
+    furi_mutex_release(context->code_cache_sync);
+}
+
+bool totp_generate_code_worker_is_token_cached(
+    TotpGenerateCodeWorkerContext* context,
+    size_t token_index) {
+    furi_check(context != NULL);
+    furi_check(furi_mutex_acquire(context->code_cache_sync, FuriWaitForever) == FuriStatusOk);
+    bool result = code_cache_find(context, token_index) != NULL;
+    furi_mutex_release(context->code_cache_sync);
+    return result;
+}
+
+bool totp_generate_code_worker_cache_token(
+    TotpGenerateCodeWorkerContext* context,
+    uint32_t list_version,
+    size_t token_index,
+    TokenInfo* token_info) {
+    furi_check(context != NULL && token_info != NULL);
+    furi_check(furi_mutex_acquire(context->code_cache_sync, FuriWaitForever) == FuriStatusOk);
+    code_cache_check_list_version(context, list_version);
+    TotpCodeCacheEntry* entry = code_cache_find(context, token_index);
+    for(uint8_t i = 0; i < CODE_CACHE_SIZE && entry == NULL; i++) {
+        if(context->code_cache[i].token_info == NULL) {
+            entry = &context->code_cache[i];
+        }
+    }
+
+    bool result = false;
+    if(entry != NULL) {
+        code_cache_entry_free(entry);
+        entry->token_info = token_info;
+        entry->token_index = token_index;
+        result = true;
+    }
+    furi_mutex_release(context->code_cache_sync);
+
+    if(result) {
+        totp_generate_code_worker_notify(context, TotpGenerateCodeWorkerEventCacheUpdate);
+    } else {
+        token_info_free(token_info);
+    }
+
+    return result;
+}
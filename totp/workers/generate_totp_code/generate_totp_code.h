@@ -29,7 +29,12 @@ enum TotGenerateCodeWorkerEvents {
     /**
      * @brief Triggers OTP code generation
      */
-    TotpGenerateCodeWorkerEventForceUpdate = 0b10
+    TotpGenerateCodeWorkerEventForceUpdate = 0b10,
+
+    /**
+     * @brief Triggers generation of codes for newly cached tokens
+     */
+    TotpGenerateCodeWorkerEventCacheUpdate = 0b100
 };
 
 /**
@@ -84,3 +89,55 @@ void totp_generate_code_worker_set_lifetime_changed_handler(
     TotpGenerateCodeWorkerContext* context,
     TOTP_CODE_LIFETIME_CHANGED_HANDLER on_code_lifetime_changed_handler,
     void* on_code_lifetime_changed_handler_context);
+
+/**
+ * @brief Sets index of the token code is generated for and triggers code generation.
+ *        If codes of this token are cached, cached code is used instead of generating a new one
+ * @param context worker context
+ * @param list_version token list version \c token_index belongs to, whole cache is wiped
+ *        if it differs from the version cache has been filled for
+ * @param token_index current token index
+ */
+void totp_generate_code_worker_set_current_token(
+    TotpGenerateCodeWorkerContext* context,
+    uint32_t list_version,
+    size_t token_index);
+
+/**
+ * @brief Evicts all the cached tokens which are not in the given list. Cached codes are wiped
+ * @param context worker context
+ * @param list_version token list version \c token_indexes belong to
+ * @param token_indexes indexes of the tokens to keep in cache
+ * @param token_indexes_count amount of items in \c token_indexes
+ */
+void totp_generate_code_worker_set_cache_window(
+    TotpGenerateCodeWorkerContext* context,
+    uint32_t list_version,
+    const size_t* token_indexes,
+    size_t token_indexes_count);
+
+/**
+ * @brief Checks whether token with given index is cached
+ * @param context worker context
+ * @param token_index token index
+ * @return \c true if token is cached; \c false otherwise
+ */
+bool totp_generate_code_worker_is_token_cached(
+    TotpGenerateCodeWorkerContext* context,
+    size_t token_index);
+
+/**
+ * @brief Adds token to the code cache. Current and next codes of all the cached TOTP tokens are
+ *        generated in background and only regenerated when time step rolls over.
+ *        Token secret stays encrypted, it is only decrypted for the time codes are generated
+ * @param context worker context
+ * @param list_version token list version \c token_info has been loaded from
+ * @param token_index token index
+ * @param token_info token info to cache, worker takes ownership of it
+ * @return \c true if token has been cached; \c false if cache is full
+ */
+bool totp_generate_code_worker_cache_token(
+    TotpGenerateCodeWorkerContext* context,
+    uint32_t list_version,
+    size_t token_index,
+    TokenInfo* token_info);
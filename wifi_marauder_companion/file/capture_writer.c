@@ -0,0 +1,92 @@
+#include "capture_writer.h"
+
+#include <furi.h>
+
+struct CaptureWriter {
+    File* file;
+    size_t fill;
+    uint32_t last_write;
+    uint8_t buffer[CAPTURE_WRITER_BUFFER_SIZE];
+};
+
+CaptureWriter* capture_writer_alloc(File* file) {
+    furi_assert(file);
+
+    CaptureWriter* writer = malloc(sizeof(CaptureWriter));
+    writer->file = file;
+    capture_writer_reset(writer);
+
+    return writer;
+}
+
+void capture_writer_free(CaptureWriter* writer) {
+    furi_assert(writer);
+    free(writer);
+}
+
+void capture_writer_reset(CaptureWriter* writer) {
+    writer->fill = 0;
+    writer->last_write = furi_get_tick();
+}
+
+static bool capture_writer_write_out(CaptureWriter* writer, const uint8_t* data, size_t len) {
+    writer->last_write = furi_get_tick();
+    return storage_file_write(writer->file, data, len) == len;
+}
+
+// Write the whole sectors in the buffer and keep the tail
+static bool capture_writer_write_sectors(CaptureWriter* writer) {
+    size_t len = writer->fill - writer->fill % CAPTURE_WRITER_SECTOR_SIZE;
+    if(!len) return true;
+
+    bool ok = capture_writer_write_out(writer, writer->buffer, len);
+    memmove(writer->buffer, writer->buffer + len, writer->fill - len);
+    writer->fill -= len;
+    return ok;
+}
+
+bool capture_writer_write(CaptureWriter* writer, const uint8_t* data, size_t len) {
+    furi_assert(writer);
+    bool ok = true;
+
+    while(len) {
+        if(!writer->fill && len >= CAPTURE_WRITER_BUFFER_SIZE) {
+            // Nothing buffered, large pieces go straight to the file in whole sectors
+            size_t direct = len - len % CAPTURE_WRITER_SECTOR_SIZE;
+            ok &= capture_writer_write_out(writer, data, direct);
+            data += direct;
+            len -= direct;
+            continue;
+        }
+
+        size_t chunk = MIN(len, CAPTURE_WRITER_BUFFER_SIZE - writer->fill);
+        memcpy(writer->buffer + writer->fill, data, chunk);
+        writer->fill += chunk;
+        data += chunk;
+        len -= chunk;
+
+        if(writer->fill == CAPTURE_WRITER_BUFFER_SIZE) {
+            ok &= capture_writer_write_out(writer, writer->buffer, writer->fill);
+            writer->fill = 0;
+        }
+    }
+
+    // A slow capture shouldn't sit in RAM for long
+    if(furi_get_tick() - writer->last_write > furi_ms_to_ticks(CAPTURE_WRITER_FLUSH_MS)) {
+        ok &= capture_writer_write_sectors(writer);
+    }
+
+    return ok;
+}
+
+bool capture_writer_flush(CaptureWriter* writer) {
+    furi_assert(writer);
+    bool ok = true;
+
+    if(writer->fill) {
+        ok = capture_writer_write_out(writer, writer->buffer, writer->fill);
+        writer->fill = 0;
+    }
+
+    return ok;
+}
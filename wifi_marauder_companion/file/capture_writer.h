@@ -0,0 +1,28 @@
+#pragma once
+
+#include <storage/storage.h>
+
+// SD card sector, every write but the last one of a capture is a multiple of it
+#define CAPTURE_WRITER_SECTOR_SIZE (512)
+#define CAPTURE_WRITER_BUFFER_SIZE (8 * CAPTURE_WRITER_SECTOR_SIZE)
+// Whole sectors that waited this long are written out even if the buffer isn't full
+#define CAPTURE_WRITER_FLUSH_MS (2000)
+
+/*
+ * Collects the small pieces the UART worker receives and writes them to the capture file in
+ * whole buffers. The file starts out sector aligned and only whole sectors are written until
+ * capture_writer_flush, so the SD card never sees a partial sector rewritten.
+ */
+typedef struct CaptureWriter CaptureWriter;
+
+CaptureWriter* capture_writer_alloc(File* file);
+
+void capture_writer_free(CaptureWriter* writer);
+
+/** Start over for a freshly opened file, anything still buffered is dropped */
+void capture_writer_reset(CaptureWriter* writer);
+
+bool capture_writer_write(CaptureWriter* writer, const uint8_t* data, size_t len);
+
+/** Write everything buffered, call before closing the file */
+bool capture_writer_flush(CaptureWriter* writer);
@@ -0,0 +1,329 @@
+// Host benchmark of the console: streams scan output in UART-sized chunks and redraws after
+// every chunk, once through the line ring and console view and once through a model of the old
+// path (append to a 4 KiB string, halve it when full, copy it into the text box and lay out the
+// whole text again). Also checks the rows on screen and scrollback against an independent wrap.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wifi_marauder_lines.h"
+#include "wifi_marauder_console_view.h"
+
+#define DEFAULT_LINES (20000)
+#define DEFAULT_CHUNK (64)
+
+// What the app used: store size, text box width in pixels and visible lines
+#define TEXT_STORE_SIZE (4096)
+#define TEXT_BOX_WIDTH (120)
+#define TEXT_BOX_LINES (5)
+
+#define ROW_HEIGHT (10)
+#define SCREEN_ROWS (6)
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Scan output the board prints, CRLF line endings
+static char* build_output(size_t lines, size_t* len) {
+    char* text = malloc(lines * 96);
+    size_t pos = 0;
+
+    for(size_t i = 0; i < lines; i++) {
+        if(i % 50 == 0) {
+            pos += sprintf(text + pos, "Starting AP scan on channel %zu\r\n", 1 + i % 13);
+        } else {
+            pos += sprintf(
+                text + pos,
+                "%d Ch: %zu BSSID: %02zx:%02zx:4e:5f:60:71 ESSID: %.*s\r\n",
+                -40 - rand() % 50,
+                1 + i % 13,
+                i & 0xff,
+                (i >> 8) & 0xff,
+                rand() % 24,
+                "HomeNetwork_5G_Guest_Extended");
+        }
+    }
+    *len = pos;
+    return text;
+}
+
+// Old path: FuriString store halved when it fills up and text_box_set_text on every update.
+// The text box copies the text, then walks all of it measuring glyphs to insert line breaks,
+// counts lines and draws the last few.
+typedef struct {
+    char store[TEXT_STORE_SIZE + 1];
+    size_t store_len;
+    char text[TEXT_STORE_SIZE + 1];
+    char formatted[2 * TEXT_STORE_SIZE];
+    uint8_t glyph_width[256];
+    size_t lines;
+    size_t laid_out;
+    size_t glyphs;
+} TextBoxModel;
+
+static void text_box_model_init(TextBoxModel* model) {
+    memset(model, 0, sizeof(*model));
+    for(size_t c = 0; c < 256; c++) {
+        model->glyph_width[c] = (c == 'i' || c == 'l' || c == '.' || c == ':') ? 2 :
+                                (c == 'm' || c == 'w' || c == 'M' || c == 'W') ? 6 :
+                                                                                  5;
+    }
+}
+
+static void text_box_model_update(TextBoxModel* model, const char* chunk, size_t len) {
+    if(model->store_len + len >= TEXT_STORE_SIZE - 1) {
+        size_t keep = model->store_len / 2;
+        memmove(model->store, model->store + model->store_len - keep, keep);
+        model->store_len = keep;
+    }
+    memcpy(model->store + model->store_len, chunk, len);
+    model->store_len += len;
+    model->store[model->store_len] = '\0';
+
+    // text_box_set_text
+    memcpy(model->text, model->store, model->store_len + 1);
+
+    // Layout of the whole text
+    size_t out = 0;
+    size_t lines = 1;
+    size_t width = 0;
+    for(const char* c = model->text; *c; c++) {
+        if(*c == '\n') {
+            width = 0;
+            lines++;
+        } else {
+            width += model->glyph_width[(uint8_t)*c] + 1;
+            if(width > TEXT_BOX_WIDTH) {
+                model->formatted[out++] = '\n';
+                width = model->glyph_width[(uint8_t)*c] + 1;
+                lines++;
+            }
+        }
+        model->formatted[out++] = *c;
+    }
+    model->formatted[out] = '\0';
+    model->lines = lines;
+    model->laid_out += model->store_len;
+
+    // Draw the last lines
+    size_t shown = 0;
+    for(size_t i = out; i > 0 && shown <= TEXT_BOX_LINES; i--) {
+        if(model->formatted[i - 1] == '\n') shown++;
+        model->glyphs++;
+    }
+}
+
+// Rows of the whole output wrapped the way the ring should, for checking it
+typedef struct {
+    char (*rows)[WIFI_MARAUDER_LINES_WIDTH + 1];
+    size_t count;
+} Rows;
+
+static void expected_rows(const char* text, size_t len, Rows* rows) {
+    rows->rows = calloc(len + 1, sizeof(*rows->rows));
+    rows->count = 0;
+    size_t fill = 0;
+
+    for(size_t i = 0; i < len; i++) {
+        if(text[i] == '\r') continue;
+        if(text[i] == '\n') {
+            rows->count++;
+            fill = 0;
+            continue;
+        }
+        if(fill == WIFI_MARAUDER_LINES_WIDTH) {
+            rows->count++;
+            fill = 0;
+        }
+        rows->rows[rows->count][fill++] = text[i];
+    }
+    if(fill) rows->count++;
+}
+
+static void draw(View* view, Canvas* canvas) {
+    view->draw(canvas, view->model);
+}
+
+static void press(View* view, InputKey key) {
+    InputEvent event = {.key = key, .type = InputTypeShort};
+    view->input(&event, view->context);
+}
+
+// Rows on screen are rows first.. of the expected output
+static bool screen_shows(Canvas* canvas, const Rows* rows, size_t first, size_t count) {
+    for(size_t row = 0; row < count; row++) {
+        const char* expected = first + row < rows->count ? rows->rows[first + row] : "";
+        if(strcmp(canvas->rows[8 + row * ROW_HEIGHT], expected)) return false;
+    }
+    return true;
+}
+
+static void test_view(const char* text, size_t len, const Rows* rows) {
+    WifiMarauderConsoleView* console = wifi_marauder_console_view_alloc();
+    View* view = wifi_marauder_console_view_get_view(console);
+    Canvas canvas = {0};
+    size_t bottom = rows->count - SCREEN_ROWS;
+    // The output ends with a newline, the empty row after it takes a slot
+    size_t oldest = rows->count - (WIFI_MARAUDER_LINES_COUNT - 1);
+
+    CHECK(wifi_marauder_console_view_is_empty(console));
+    wifi_marauder_console_view_append(console, text, len);
+    CHECK(!wifi_marauder_console_view_is_empty(console));
+
+    // Follows the output
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, bottom, SCREEN_ROWS));
+
+    // Log viewer copy holds every row still kept, oldest first
+    FuriString* copy = furi_string_alloc();
+    FuriString* expected = furi_string_alloc();
+    wifi_marauder_console_view_get_text(console, copy);
+    for(size_t row = oldest; row < rows->count; row++) {
+        furi_string_cat_str(expected, rows->rows[row]);
+        furi_string_push_back(expected, '\n');
+    }
+    CHECK(!strcmp(furi_string_get_cstr(copy), furi_string_get_cstr(expected)));
+    furi_string_free(expected);
+    furi_string_free(copy);
+
+    // Scrollback, a row and a page at a time, stops at the oldest row kept
+    press(view, InputKeyUp);
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, bottom - 1, SCREEN_ROWS));
+    press(view, InputKeyLeft);
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, bottom - SCREEN_ROWS, SCREEN_ROWS));
+
+    // Scrolled back, new output doesn't move the screen
+    wifi_marauder_console_view_append(console, "w\n", 2);
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, bottom - SCREEN_ROWS, SCREEN_ROWS));
+    oldest++;
+
+    for(size_t i = 0; i < WIFI_MARAUDER_LINES_COUNT; i++) {
+        press(view, InputKeyUp);
+    }
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, oldest, SCREEN_ROWS));
+
+    // Unless the rows on it are overwritten
+    wifi_marauder_console_view_append(console, "x\n", 2);
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, oldest + 1, SCREEN_ROWS));
+
+    // Down to the bottom follows again
+    for(size_t i = 0; i < WIFI_MARAUDER_LINES_COUNT; i++) {
+        press(view, InputKeyRight);
+    }
+    wifi_marauder_console_view_append(console, "y\n", 2);
+    draw(view, &canvas);
+    CHECK(!strcmp(canvas.rows[8 + (SCREEN_ROWS - 1) * ROW_HEIGHT], "y"));
+
+    // Counters take the last row
+    WifiMarauderPcapStats stats = {.packets = 12, .pmkid = 1};
+    wifi_marauder_console_view_set_stats(console, &stats);
+    draw(view, &canvas);
+    CHECK(!strcmp(canvas.rows[8 + (SCREEN_ROWS - 2) * ROW_HEIGHT], "y"));
+    CHECK(!strcmp(canvas.rows[63], "P12 B0 D0 E0 K1"));
+
+    // Focus on start keeps the first rows up while output arrives
+    wifi_marauder_console_view_reset(console);
+    wifi_marauder_console_view_set_focus_start(console, true);
+    wifi_marauder_console_view_append(console, text, 1000);
+    draw(view, &canvas);
+    CHECK(screen_shows(&canvas, rows, 0, SCREEN_ROWS));
+    press(view, InputKeyOk);
+    wifi_marauder_console_view_append(console, "\nz\n", 3);
+    draw(view, &canvas);
+    CHECK(!strcmp(canvas.rows[8 + (SCREEN_ROWS - 1) * ROW_HEIGHT], "z"));
+
+    wifi_marauder_console_view_free(console);
+}
+
+int main(int argc, char** argv) {
+    size_t lines = DEFAULT_LINES;
+    size_t chunk = DEFAULT_CHUNK;
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:c:h")) != -1) {
+        if(opt == 'n') {
+            lines = strtoul(optarg, NULL, 0);
+        } else if(opt == 'c') {
+            chunk = strtoul(optarg, NULL, 0);
+        } else {
+            printf("Usage: %s [-n lines] [-c chunk bytes]\n", argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if(lines < 2 * WIFI_MARAUDER_LINES_COUNT || chunk == 0) {
+        fprintf(stderr, "Need at least %d lines\n", 2 * WIFI_MARAUDER_LINES_COUNT);
+        return 1;
+    }
+
+    srand(1);
+    size_t len;
+    char* text = build_output(lines, &len);
+    size_t updates = (len + chunk - 1) / chunk;
+    Rows rows;
+    expected_rows(text, len, &rows);
+
+    TextBoxModel* model = malloc(sizeof(TextBoxModel));
+    text_box_model_init(model);
+    double start = get_time();
+    for(size_t pos = 0; pos < len; pos += chunk) {
+        text_box_model_update(model, text + pos, MIN(chunk, len - pos));
+    }
+    double text_box = get_time() - start;
+
+    WifiMarauderConsoleView* console = wifi_marauder_console_view_alloc();
+    View* view = wifi_marauder_console_view_get_view(console);
+    Canvas canvas = {0};
+    start = get_time();
+    for(size_t pos = 0; pos < len; pos += chunk) {
+        wifi_marauder_console_view_append(console, text + pos, MIN(chunk, len - pos));
+        draw(view, &canvas);
+    }
+    double ring = get_time() - start;
+    CHECK(screen_shows(&canvas, &rows, rows.count - SCREEN_ROWS, SCREEN_ROWS));
+    wifi_marauder_console_view_free(console);
+
+    printf("%zu lines, %zu bytes in %zu byte chunks, redraw after each\n", lines, len, chunk);
+    printf(
+        "text box: %8.0f ns/update %9.0f lines/s, %.0f bytes laid out/update\n",
+        text_box * 1e9 / updates,
+        lines / text_box,
+        (double)model->laid_out / updates);
+    printf(
+        "ring:     %8.0f ns/update %9.0f lines/s, %.1f glyphs drawn/update\n",
+        ring * 1e9 / updates,
+        lines / ring,
+        (double)canvas.glyphs / updates);
+
+    test_view(text, len, &rows);
+
+    free(rows.rows);
+    free(model);
+    free(text);
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
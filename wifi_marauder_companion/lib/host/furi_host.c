@@ -0,0 +1,144 @@
+#include "furi_host.h"
+
+#include "file/capture_writer.h"
+
+uint32_t host_tick = 0;
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    string->capacity = 16;
+    string->data = calloc(1, string->capacity);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+static void furi_string_append(FuriString* string, const char* data, size_t size) {
+    if(string->size + size + 1 > string->capacity) {
+        string->capacity = MAX(string->capacity * 2, string->size + size + 1);
+        string->data = realloc(string->data, string->capacity);
+    }
+    memcpy(string->data + string->size, data, size);
+    string->size += size;
+    string->data[string->size] = '\0';
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    furi_string_append(string, &c, 1);
+}
+
+void furi_string_cat_str(FuriString* string, const char* str) {
+    furi_string_append(string, str, strlen(str));
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+File* host_file_open(const char* path) {
+    FILE* stdio_file = fopen(path, "wb");
+    if(!stdio_file) return NULL;
+
+    File* file = calloc(1, sizeof(File));
+    file->file = stdio_file;
+    return file;
+}
+
+void host_file_close(File* file) {
+    fclose(file->file);
+    free(file);
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t to_write) {
+    size_t written = fwrite(buff, 1, to_write, file->file);
+    file->writes++;
+    file->written_bytes += written;
+    if(file->written_bytes % CAPTURE_WRITER_SECTOR_SIZE) file->unaligned_writes++;
+    return written;
+}
+
+void canvas_clear(Canvas* canvas) {
+    memset(canvas->rows, 0, sizeof(canvas->rows));
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    UNUSED(x);
+    canvas->strings++;
+    canvas->glyphs += strlen(str);
+    if(y >= 0 && y < 64) {
+        snprintf(canvas->rows[y], sizeof(canvas->rows[y]), "%s", str);
+    }
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    UNUSED(canvas);
+    UNUSED(x1);
+    UNUSED(y1);
+    UNUSED(x2);
+    UNUSED(y2);
+}
+
+void elements_scrollbar_pos(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t height,
+    size_t pos,
+    size_t total) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(height);
+    assert(pos < total);
+}
+
+View* view_alloc(void) {
+    return calloc(1, sizeof(View));
+}
+
+void view_free(View* view) {
+    free(view->model);
+    free(view);
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    UNUSED(type);
+    view->model = calloc(1, size);
+}
+
+void view_set_context(View* view, void* context) {
+    view->context = context;
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    view->draw = callback;
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    view->input = callback;
+}
+
+void* view_get_model(View* view) {
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    if(update) view->updates++;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+// Just enough of the firmware API for the console view and the capture writer to build on a
+// host, shared by the harnesses in lib. Every firmware header they include is generated by
+// host.mk as a one-line include of this. The View holds its model and callbacks without locking,
+// the Canvas only counts what would be drawn, the File is backed by a stdio FILE and records the
+// size of every write that reaches it.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define UNUSED(x) (void)(x)
+#define furi_assert(x) assert(x)
+#define furi_check(x) assert(x)
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#ifndef CLAMP
+#define CLAMP(x, upper, lower) (MIN(upper, MAX(x, lower)))
+#endif
+
+// Host clock in ms, advanced by the harness
+extern uint32_t host_tick;
+
+static inline uint32_t furi_get_tick(void) {
+    return host_tick;
+}
+
+static inline uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
+
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+} FuriString;
+
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+void furi_string_push_back(FuriString* string, char c);
+void furi_string_cat_str(FuriString* string, const char* str);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+
+typedef struct {
+    FILE* file;
+    size_t writes;
+    size_t written_bytes;
+    // Writes that left the file at an offset that isn't a whole sector
+    size_t unaligned_writes;
+} File;
+
+File* host_file_open(const char* path);
+void host_file_close(File* file);
+
+size_t storage_file_write(File* file, const void* buff, size_t to_write);
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+    FontKeyboard,
+} Font;
+
+typedef struct {
+    size_t strings;
+    size_t glyphs;
+    // Text of the last string drawn at each baseline, for checking what is on screen
+    char rows[64][64];
+} Canvas;
+
+void canvas_clear(Canvas* canvas);
+void canvas_set_font(Canvas* canvas, Font font);
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str);
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void elements_scrollbar_pos(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t height,
+    size_t pos,
+    size_t total);
+
+typedef enum {
+    InputKeyUp,
+    InputKeyDown,
+    InputKeyRight,
+    InputKeyLeft,
+    InputKeyOk,
+    InputKeyBack,
+} InputKey;
+
+typedef enum {
+    InputTypePress,
+    InputTypeRelease,
+    InputTypeShort,
+    InputTypeLong,
+    InputTypeRepeat,
+} InputType;
+
+typedef struct {
+    InputKey key;
+    InputType type;
+} InputEvent;
+
+typedef void (*ViewDrawCallback)(Canvas* canvas, void* model);
+typedef bool (*ViewInputCallback)(InputEvent* event, void* context);
+
+typedef enum {
+    ViewModelTypeLocking,
+} ViewModelType;
+
+typedef struct {
+    void* model;
+    void* context;
+    ViewDrawCallback draw;
+    ViewInputCallback input;
+    size_t updates;
+} View;
+
+View* view_alloc(void);
+void view_free(View* view);
+void view_allocate_model(View* view, ViewModelType type, size_t size);
+void view_set_context(View* view, void* context);
+void view_set_draw_callback(View* view, ViewDrawCallback callback);
+void view_set_input_callback(View* view, ViewInputCallback callback);
+void* view_get_model(View* view);
+void view_commit_model(View* view, bool update);
+
+#define with_view_model(view, type, code, update) \
+    {                                             \
+        type = view_get_model(view);              \
+        {code};                                   \
+        view_commit_model(view, update);          \
+    }
@@ -0,0 +1,43 @@
+# Build rules shared by the host harnesses in lib, not part of the app. A harness Makefile sets
+# NAME and SRCS (paths relative to the harness or the app root) and includes this, then
+#   make run [ARGS="..."]
+
+CC ?= gcc
+APP = ../..
+HOST = ../host
+BUILD = build
+
+# Firmware headers reached from the app sources, each one resolves to host/furi_host.h
+STUB_HEADERS = \
+	furi.h \
+	gui/view.h \
+	gui/elements.h \
+	storage/storage.h
+STUBS = $(addprefix $(BUILD)/include/,$(STUB_HEADERS))
+
+OBJS = $(addprefix $(BUILD)/,$(SRCS:.c=.o) furi_host.o)
+
+vpath %.c . $(HOST) $(APP)
+
+CPPFLAGS += -I$(HOST) -I$(BUILD)/include -I$(APP)
+CFLAGS += -O2 -g --std=gnu11
+WARNINGS += -W -Wall
+
+$(NAME): $(OBJS)
+	$(CC) $(CFLAGS) $(LDFLAGS) $^ $(LDLIBS) -o $@
+
+$(OBJS): $(BUILD)/%.o: %.c $(STUBS) $(HOST)/furi_host.h
+	@mkdir -p $(dir $@)
+	$(CC) $(CPPFLAGS) $(CFLAGS) $(WARNINGS) -c $< -o $@
+
+$(STUBS):
+	@mkdir -p $(dir $@)
+	@echo '#include "furi_host.h"' > $@
+
+run: $(NAME)
+	./$(NAME) $(ARGS)
+
+clean:
+	rm -rf $(BUILD) $(NAME)
+
+.PHONY: run clean
@@ -0,0 +1,394 @@
+// Host test of the capture path: writes sample pcap files with known numbers of beacons,
+// deauthentications, EAPOL frames and PMKIDs, runs the streaming parser over them cut into
+// chunks of every kind, then streams a capture through the writer in UART-sized pieces and
+// checks the file and the alignment of every write. Files given with -f are parsed too.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "wifi_marauder_pcap.h"
+#include "file/capture_writer.h"
+
+#define SAMPLE_PACKETS (5000)
+#define SAMPLE_DIR "/tmp"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+typedef enum {
+    SampleLe80211,
+    SampleBe80211,
+    SampleRadiotap,
+    SampleText,
+    SampleCount,
+} Sample;
+
+static const char* sample_names[SampleCount] = {
+    [SampleLe80211] = "le_80211.pcap",
+    [SampleBe80211] = "be_80211.pcap",
+    [SampleRadiotap] = "radiotap.pcap",
+    [SampleText] = "wardrive.txt",
+};
+
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t capacity;
+} Buffer;
+
+static void buffer_append(Buffer* buffer, const void* data, size_t len) {
+    if(buffer->len + len > buffer->capacity) {
+        buffer->capacity = (buffer->len + len) * 2;
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+}
+
+static void buffer_append32(Buffer* buffer, uint32_t value, bool swapped) {
+    uint8_t bytes[4];
+    for(size_t i = 0; i < 4; i++) {
+        bytes[swapped ? 3 - i : i] = value >> (8 * i);
+    }
+    buffer_append(buffer, bytes, sizeof(bytes));
+}
+
+static void buffer_append_random(Buffer* buffer, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        uint8_t byte = rand();
+        buffer_append(buffer, &byte, 1);
+    }
+}
+
+static void frame_header(Buffer* frame, uint8_t fc0, uint8_t fc1) {
+    const uint8_t header[] = {fc0, fc1, 0x3a, 0x01};
+    buffer_append(frame, header, sizeof(header));
+    // Three addresses and the sequence number
+    buffer_append_random(frame, 3 * 6 + 2);
+    // Four address frames
+    if((fc1 & 0x03) == 0x03) buffer_append_random(frame, 6);
+    // QoS control
+    if((fc0 & 0x0c) == 0x08 && (fc0 & 0x80)) buffer_append_random(frame, 2);
+}
+
+static void eapol_key(Buffer* frame, uint16_t key_info, const uint8_t* key_data, size_t len) {
+    const uint8_t llc[] = {0xaa, 0xaa, 0x03, 0x00, 0x00, 0x00, 0x88, 0x8e};
+    buffer_append(frame, llc, sizeof(llc));
+
+    size_t body_len = 95 + len;
+    const uint8_t header[] = {
+        0x02, 0x03, body_len >> 8, body_len, 0x02, key_info >> 8, key_info, 0x00, 0x10};
+    buffer_append(frame, header, sizeof(header));
+    // Replay counter, nonce, IV, RSC, ID and MIC
+    buffer_append_random(frame, 8 + 32 + 16 + 8 + 8 + 16);
+    const uint8_t key_data_len[] = {len >> 8, len};
+    buffer_append(frame, key_data_len, sizeof(key_data_len));
+    buffer_append(frame, key_data, len);
+}
+
+// One random frame, the counters of the kind it is are bumped
+static void sample_frame(Buffer* frame, WifiMarauderPcapStats* expected) {
+    uint8_t pmkid[22] = {0xdd, 0x14, 0x00, 0x0f, 0xac, 0x04};
+    const uint8_t rsn[] = {0x30, 0x14, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x04, 0x01, 0x00, 0x00,
+                           0x0f, 0xac, 0x04, 0x01, 0x00, 0x00, 0x0f, 0xac, 0x02, 0x00, 0x00};
+    expected->packets++;
+
+    switch(rand() % 10) {
+    case 0:
+    case 1:
+    case 2:
+        // Beacon with an SSID
+        frame_header(frame, 0x80, 0x00);
+        buffer_append_random(frame, 12 + rand() % 200);
+        expected->beacons++;
+        break;
+    case 3:
+        frame_header(frame, 0xc0, 0x00);
+        buffer_append_random(frame, 2);
+        expected->deauths++;
+        break;
+    case 4:
+        // Message 1 with a PMKID, plain or QoS data from the AP
+        frame_header(frame, rand() % 2 ? 0x88 : 0x08, 0x02);
+        for(size_t i = 6; i < sizeof(pmkid); i++) pmkid[i] = 1 + rand() % 255;
+        eapol_key(frame, 0x008a, pmkid, sizeof(pmkid));
+        expected->eapol++;
+        expected->pmkid++;
+        break;
+    case 5:
+        // Message 1 without key data, or with a zeroed PMKID
+        frame_header(frame, 0x08, 0x02);
+        eapol_key(frame, 0x008a, pmkid, rand() % 2 ? sizeof(pmkid) : 0);
+        expected->eapol++;
+        break;
+    case 6:
+        // Message 2 from the station, RSN IE in the key data
+        frame_header(frame, 0x08, 0x01);
+        eapol_key(frame, 0x010a, rsn, sizeof(rsn));
+        expected->eapol++;
+        break;
+    case 7:
+        // Protected data, even if it looked like EAPOL it can't be read
+        frame_header(frame, 0x08, 0x41);
+        eapol_key(frame, 0x008a, pmkid, sizeof(pmkid));
+        break;
+    case 8:
+        // Probe request
+        frame_header(frame, 0x40, 0x00);
+        buffer_append_random(frame, rand() % 100);
+        break;
+    default:
+        // Bare control frame, too short for a full header
+        frame_header(frame, 0xd4, 0x00);
+        frame->len -= 14;
+        break;
+    }
+}
+
+static void build_pcap(Buffer* file, Sample sample, WifiMarauderPcapStats* expected) {
+    bool swapped = sample == SampleBe80211;
+    uint32_t linktype = sample == SampleRadiotap ? WIFI_MARAUDER_PCAP_LINKTYPE_RADIOTAP :
+                                                   WIFI_MARAUDER_PCAP_LINKTYPE_80211;
+
+    buffer_append32(file, 0xa1b2c3d4, swapped);
+    // Version 2.4 as two 16 bit fields
+    buffer_append32(file, swapped ? 2 << 16 | 4 : 2 | 4 << 16, swapped);
+    buffer_append32(file, 0, swapped);
+    buffer_append32(file, 0, swapped);
+    buffer_append32(file, 65535, swapped);
+    buffer_append32(file, linktype, swapped);
+
+    Buffer frame = {0};
+    for(size_t i = 0; i < SAMPLE_PACKETS; i++) {
+        frame.len = 0;
+        if(sample == SampleRadiotap) {
+            // Version, pad, length and present flags, then the fields
+            const uint8_t radiotap[] = {0x00, 0x00, 0x12, 0x00, 0x2e, 0x48, 0x00, 0x00};
+            buffer_append(&frame, radiotap, sizeof(radiotap));
+            buffer_append_random(&frame, 0x12 - sizeof(radiotap));
+        }
+        sample_frame(&frame, expected);
+
+        buffer_append32(file, 1700000000 + i, swapped);
+        buffer_append32(file, i * 100, swapped);
+        buffer_append32(file, frame.len, swapped);
+        buffer_append32(file, frame.len, swapped);
+        buffer_append(file, frame.data, frame.len);
+    }
+    free(frame.data);
+}
+
+static void build_sample(Buffer* file, Sample sample, WifiMarauderPcapStats* expected) {
+    memset(expected, 0, sizeof(*expected));
+    file->len = 0;
+
+    if(sample == SampleText) {
+        // What wardrive and evil portal dumps look like, nothing to count
+        for(size_t i = 0; i < 500; i++) {
+            char line[80];
+            int len = snprintf(
+                line, sizeof(line), "%02zx:11:22:33:44:55,Net%zu,WPA2,6,-70\n", i & 0xff, i);
+            buffer_append(file, line, len);
+        }
+    } else {
+        build_pcap(file, sample, expected);
+    }
+}
+
+static bool write_file(const char* path, const Buffer* data) {
+    FILE* file = fopen(path, "wb");
+    if(!file) return false;
+    bool ok = fwrite(data->data, 1, data->len, file) == data->len;
+    fclose(file);
+    return ok;
+}
+
+static bool read_file(const char* path, Buffer* data) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return false;
+
+    uint8_t chunk[4096];
+    size_t len;
+    data->len = 0;
+    while((len = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        buffer_append(data, chunk, len);
+    }
+    fclose(file);
+    return true;
+}
+
+// Parse the file cut into pieces of the given size, 0 for random ones
+static void parse(const Buffer* file, size_t size, WifiMarauderPcap* pcap) {
+    wifi_marauder_pcap_reset(pcap);
+    for(size_t pos = 0; pos < file->len;) {
+        size_t chunk = size ? size : (size_t)(1 + rand() % 2048);
+        if(chunk > file->len - pos) chunk = file->len - pos;
+        wifi_marauder_pcap_feed(pcap, file->data + pos, chunk);
+        pos += chunk;
+    }
+}
+
+static bool stats_equal(const WifiMarauderPcapStats* a, const WifiMarauderPcapStats* b) {
+    return a->packets == b->packets && a->beacons == b->beacons && a->deauths == b->deauths &&
+           a->eapol == b->eapol && a->pmkid == b->pmkid;
+}
+
+static void print_stats(const char* name, const WifiMarauderPcap* pcap) {
+    const WifiMarauderPcapStats* stats = &pcap->stats;
+    printf(
+        "%-14s %s %6u pkts %6u bcn %5u deauth %5u eapol %5u pmkid\n",
+        name,
+        wifi_marauder_pcap_is_valid(pcap) ? "pcap" : "    ",
+        stats->packets,
+        stats->beacons,
+        stats->deauths,
+        stats->eapol,
+        stats->pmkid);
+}
+
+// Same counts however the file is cut
+static void check_chunking(const Buffer* file, const WifiMarauderPcap* whole) {
+    const size_t sizes[] = {1, 3, 16, 17, 64, 511, 0, 0};
+    WifiMarauderPcap pcap;
+
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        parse(file, sizes[i], &pcap);
+        CHECK(stats_equal(&pcap.stats, &whole->stats));
+        CHECK(wifi_marauder_pcap_is_valid(&pcap) == wifi_marauder_pcap_is_valid(whole));
+    }
+}
+
+static void test_sample(Sample sample) {
+    char path[128];
+    Buffer file = {0};
+    Buffer read = {0};
+    WifiMarauderPcapStats expected;
+    WifiMarauderPcap pcap;
+
+    snprintf(path, sizeof(path), SAMPLE_DIR "/%s", sample_names[sample]);
+    build_sample(&file, sample, &expected);
+    CHECK(write_file(path, &file));
+    CHECK(read_file(path, &read));
+
+    parse(&read, read.len, &pcap);
+    print_stats(sample_names[sample], &pcap);
+    CHECK(stats_equal(&pcap.stats, &expected));
+    CHECK(wifi_marauder_pcap_is_valid(&pcap) == (sample != SampleText));
+    check_chunking(&read, &pcap);
+
+    unlink(path);
+    free(file.data);
+    free(read.data);
+}
+
+static void test_corrupt(void) {
+    Buffer file = {0};
+    WifiMarauderPcapStats expected;
+    WifiMarauderPcap pcap;
+    build_sample(&file, SampleLe80211, &expected);
+
+    // A record length nobody would capture stops parsing instead of skipping megabytes
+    const size_t record = 24 + 8;
+    memset(file.data + record, 0xff, 4);
+    parse(&file, 0, &pcap);
+    CHECK(!wifi_marauder_pcap_is_valid(&pcap));
+    CHECK(pcap.stats.packets == 0);
+
+    free(file.data);
+}
+
+static void test_writer(void) {
+    const char* path = SAMPLE_DIR "/capture_writer.pcap";
+    Buffer capture = {0};
+    Buffer result = {0};
+    WifiMarauderPcapStats expected;
+    build_sample(&capture, SampleRadiotap, &expected);
+
+    File* file = host_file_open(path);
+    CaptureWriter* writer = capture_writer_alloc(file);
+    size_t pieces = 0;
+
+    // Bursts of UART-sized pieces with quiet gaps in between
+    for(size_t pos = 0; pos < capture.len; pieces++) {
+        size_t len = 1 + rand() % 600;
+        if(pieces % 97 == 0) len = 1 + rand() % 20000;
+        if(len > capture.len - pos) len = capture.len - pos;
+
+        host_tick += rand() % 20;
+        if(pieces % 211 == 0) host_tick += CAPTURE_WRITER_FLUSH_MS + 1;
+        CHECK(capture_writer_write(writer, capture.data + pos, len));
+        pos += len;
+    }
+    CHECK(file->unaligned_writes == 0);
+    CHECK(capture_writer_flush(writer));
+    CHECK(file->unaligned_writes <= 1);
+    CHECK(file->written_bytes == capture.len);
+
+    printf(
+        "writer: %zu pieces -> %zu writes, %zu bytes per write, %zu unaligned\n",
+        pieces,
+        file->writes,
+        file->written_bytes / file->writes,
+        file->unaligned_writes);
+
+    capture_writer_free(writer);
+    host_file_close(file);
+    CHECK(read_file(path, &result));
+    CHECK(result.len == capture.len && !memcmp(result.data, capture.data, capture.len));
+
+    unlink(path);
+    free(capture.data);
+    free(result.data);
+}
+
+static bool test_file(const char* path) {
+    Buffer file = {0};
+    WifiMarauderPcap pcap;
+
+    if(!read_file(path, &file)) {
+        printf("Unable to open %s\n", path);
+        return false;
+    }
+    parse(&file, file.len, &pcap);
+    print_stats(path, &pcap);
+    check_chunking(&file, &pcap);
+
+    free(file.data);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int opt;
+
+    while((opt = getopt(argc, argv, "f:h")) != -1) {
+        if(opt == 'f') {
+            if(!test_file(optarg)) failures++;
+        } else {
+            printf("Usage: %s [-f capture.pcap]...\n", argv[0]);
+            printf("  sample captures are written to " SAMPLE_DIR " and removed\n");
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    srand(1);
+    for(Sample sample = 0; sample < SampleCount; sample++) {
+        test_sample(sample);
+    }
+    test_corrupt();
+    test_writer();
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,369 @@
+// Host tests of the UART marker demux: replays serial streams of console text and marker-framed
+// PCAP buffers cut into chunks at every size and split point, checks both channels against the
+// byte-by-byte parser the IRQ handler used to run, and times the two on a long capture.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wifi_marauder_demux.h"
+
+// Same sizes as the app's worker and the DMA drain buffer
+#define RX_BUF_SIZE (2048)
+#define DMA_CHUNK (64)
+
+#define BENCH_SIZE (8 * 1024 * 1024)
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if(!(cond)) {                                                              \
+            printf("%s:%d: %s: CHECK(%s)\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++;                                                            \
+        }                                                                          \
+    } while(0)
+
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t capacity;
+} Buffer;
+
+typedef struct {
+    Buffer text;
+    Buffer pcap;
+    size_t runs;
+} Output;
+
+static double get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void buffer_append(Buffer* buffer, const void* data, size_t len) {
+    if(buffer->len + len > buffer->capacity) {
+        buffer->capacity = (buffer->len + len) * 2;
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+}
+
+static void buffer_append_str(Buffer* buffer, const char* str) {
+    buffer_append(buffer, str, strlen(str));
+}
+
+static void output_reset(Output* output) {
+    output->text.len = 0;
+    output->pcap.len = 0;
+    output->runs = 0;
+}
+
+static void output_free(Output* output) {
+    free(output->text.data);
+    free(output->pcap.data);
+}
+
+static void output_cb(bool pcap, uint8_t* data, size_t len, void* context) {
+    Output* output = context;
+    buffer_append(pcap ? &output->pcap : &output->text, data, len);
+    output->runs++;
+}
+
+static void output_cb_discard(bool pcap, uint8_t* data, size_t len, void* context) {
+    size_t* total = context;
+    (void)pcap;
+    (void)data;
+    *total += len;
+}
+
+// The per-byte parser from the old IRQ handler, matching one marker candidate at a time
+typedef struct {
+    bool pcap;
+    size_t idx;
+    uint8_t buf[WIFI_MARAUDER_MARK_LEN];
+} ByteParser;
+
+static void byte_parser_feed(ByteParser* parser, uint8_t data, Output* output) {
+    Buffer* out = parser->pcap ? &output->pcap : &output->text;
+
+    if(parser->idx) {
+        bool begin = !memcmp(parser->buf, WIFI_MARAUDER_MARK_BEGIN, parser->idx) &&
+                     data == (uint8_t)WIFI_MARAUDER_MARK_BEGIN[parser->idx];
+        bool close = !memcmp(parser->buf, WIFI_MARAUDER_MARK_CLOSE, parser->idx) &&
+                     data == (uint8_t)WIFI_MARAUDER_MARK_CLOSE[parser->idx];
+        if(begin || close) {
+            parser->buf[parser->idx++] = data;
+            if(parser->idx == WIFI_MARAUDER_MARK_LEN) {
+                parser->pcap = begin;
+                parser->idx = 0;
+            }
+            return;
+        }
+        buffer_append(out, parser->buf, parser->idx);
+        parser->idx = 0;
+    }
+    if(data == '[') {
+        parser->buf[parser->idx++] = data;
+    } else {
+        buffer_append(out, &data, 1);
+    }
+}
+
+static void byte_parser_flush(ByteParser* parser, Output* output) {
+    buffer_append(parser->pcap ? &output->pcap : &output->text, parser->buf, parser->idx);
+    parser->idx = 0;
+}
+
+static void demux_flush(WifiMarauderDemux* demux, Output* output) {
+    output_cb(demux->pcap, demux->partial, demux->partial_len, output);
+    demux->partial_len = 0;
+}
+
+// Feed stream cut into chunks from sizes[], cycling through it
+static void demux_replay(
+    const uint8_t* stream,
+    size_t len,
+    const size_t* sizes,
+    size_t sizes_count,
+    Output* output) {
+    WifiMarauderDemux demux;
+    uint8_t chunk[RX_BUF_SIZE];
+    wifi_marauder_demux_reset(&demux);
+    output_reset(output);
+
+    for(size_t pos = 0, i = 0; pos < len; i++) {
+        size_t size = sizes[i % sizes_count];
+        if(size > len - pos) size = len - pos;
+        // The worker hands the demux its own receive buffer, not the stream
+        memcpy(chunk, stream + pos, size);
+        wifi_marauder_demux_feed(&demux, chunk, size, output_cb, output);
+        pos += size;
+    }
+    demux_flush(&demux, output);
+}
+
+static bool output_equal(const Output* a, const Output* b) {
+    return a->text.len == b->text.len && a->pcap.len == b->pcap.len &&
+           !memcmp(a->text.data, b->text.data, a->text.len) &&
+           !memcmp(a->pcap.data, b->pcap.data, a->pcap.len);
+}
+
+static void reference_parse(const uint8_t* stream, size_t len, Output* output) {
+    ByteParser parser = {0};
+    output_reset(output);
+    for(size_t i = 0; i < len; i++) {
+        byte_parser_feed(&parser, stream[i], output);
+    }
+    byte_parser_flush(&parser, output);
+}
+
+// Marauder-like session: console lines, then sniffer buffers wrapped in markers. PCAP payload
+// is random and salted with '[' and marker prefixes that never complete.
+static void build_session(Buffer* stream, Output* expected, size_t buffers) {
+    static const char* lines[] = {
+        "> sniffpmkid -serial\n",
+        "Starting PMKID sniff on channel 1\n",
+        "[+] Received EAPOL: 0a:1b:2c:3d:4e:5f\n",
+        "[BUF/BEGI",
+        "N without the bracket\n",
+        "[[BUF/CLOSE\n",
+        "[BUF/\n",
+        "Ch: 6 [BUF] not a marker\n",
+    };
+    static const char* salt[] = {"[", "[[", "[B", "[BUF/", "[BUF/BEGIN", "[BUF/CLOSE", "[BUF/C"};
+    const uint8_t pcap_header[24] = {0xd4, 0xc3, 0xb2, 0xa1, 0x02, 0x00, 0x04, 0x00, 0, 0, 0, 0,
+                                     0,    0,    0,    0,    0xff, 0xff, 0,    0,    105, 0, 0, 0};
+
+    for(size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+        buffer_append_str(stream, lines[i]);
+        buffer_append_str(&expected->text, lines[i]);
+    }
+
+    buffer_append_str(stream, WIFI_MARAUDER_MARK_BEGIN);
+    buffer_append(stream, pcap_header, sizeof(pcap_header));
+    buffer_append(&expected->pcap, pcap_header, sizeof(pcap_header));
+    buffer_append_str(stream, WIFI_MARAUDER_MARK_CLOSE);
+
+    for(size_t i = 0; i < buffers; i++) {
+        uint8_t payload[512];
+        size_t len = 16 + rand() % (sizeof(payload) - 16);
+        for(size_t j = 0; j < len; j++) {
+            payload[j] = rand();
+        }
+        if(rand() % 2) {
+            const char* s = salt[rand() % (sizeof(salt) / sizeof(salt[0]))];
+            size_t at = rand() % (len - strlen(s));
+            memcpy(payload + at, s, strlen(s));
+            // A completed salt would be a real marker
+            if(payload[at + strlen(s)] == ']') payload[at + strlen(s)] = 0;
+        }
+
+        buffer_append_str(stream, WIFI_MARAUDER_MARK_BEGIN);
+        buffer_append(stream, payload, len);
+        buffer_append(&expected->pcap, payload, len);
+        buffer_append_str(stream, WIFI_MARAUDER_MARK_CLOSE);
+
+        if(rand() % 4 == 0) {
+            const char* line = lines[rand() % (sizeof(lines) / sizeof(lines[0]))];
+            buffer_append_str(stream, line);
+            buffer_append_str(&expected->text, line);
+        }
+    }
+}
+
+static void test_markers(void) {
+    const char* stream = "a[BUF/BEGIN]b[BUF/CLOSE]c[BUF/BEGIN][BUF/CLOSE]d[BUF/CLOS[BUF/BEGIN]e";
+    Output output = {0};
+    size_t whole = strlen(stream);
+
+    demux_replay((const uint8_t*)stream, strlen(stream), &whole, 1, &output);
+    CHECK(output.text.len == 12);
+    CHECK(!memcmp(output.text.data, "acd[BUF/CLOS", 12));
+    CHECK(output.pcap.len == 2);
+    CHECK(!memcmp(output.pcap.data, "be", 2));
+
+    // Every way to cut it in two, markers split anywhere
+    for(size_t split = 1; split < whole; split++) {
+        Output split_output = {0};
+        size_t sizes[] = {split, whole};
+        demux_replay((const uint8_t*)stream, whole, sizes, 2, &split_output);
+        CHECK(output_equal(&output, &split_output));
+        output_free(&split_output);
+    }
+    output_free(&output);
+}
+
+static void test_session(void) {
+    Buffer stream = {0};
+    Output expected = {0};
+    Output output = {0};
+    srand(1);
+    build_session(&stream, &expected, 200);
+
+    Output reference = {0};
+    reference_parse(stream.data, stream.len, &reference);
+    CHECK(output_equal(&expected, &reference));
+
+    for(size_t size = 1; size <= 2 * WIFI_MARAUDER_MARK_LEN + 64; size++) {
+        demux_replay(stream.data, stream.len, &size, 1, &output);
+        CHECK(output_equal(&expected, &output));
+    }
+
+    // Idle-line interrupts cut bursts anywhere, up to a full receive buffer
+    for(size_t round = 0; round < 100; round++) {
+        size_t sizes[64];
+        for(size_t i = 0; i < 64; i++) {
+            sizes[i] = 1 + rand() % (round % 2 ? RX_BUF_SIZE : DMA_CHUNK);
+        }
+        demux_replay(stream.data, stream.len, sizes, 64, &output);
+        CHECK(output_equal(&expected, &output));
+    }
+
+    free(stream.data);
+    output_free(&expected);
+    output_free(&reference);
+    output_free(&output);
+}
+
+static bool replay_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if(!file) {
+        printf("Unable to open %s\n", path);
+        return false;
+    }
+    Buffer stream = {0};
+    uint8_t data[4096];
+    size_t len;
+    while((len = fread(data, 1, sizeof(data), file)) > 0) {
+        buffer_append(&stream, data, len);
+    }
+    fclose(file);
+
+    Output reference = {0};
+    Output output = {0};
+    reference_parse(stream.data, stream.len, &reference);
+    printf(
+        "%s: %zu bytes, %zu text, %zu pcap\n",
+        path,
+        stream.len,
+        reference.text.len,
+        reference.pcap.len);
+
+    const size_t sizes[] = {1, 7, 11, DMA_CHUNK, 1000, RX_BUF_SIZE};
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        demux_replay(stream.data, stream.len, &sizes[i], 1, &output);
+        CHECK(output_equal(&reference, &output));
+    }
+
+    free(stream.data);
+    output_free(&reference);
+    output_free(&output);
+    return true;
+}
+
+static void bench(void) {
+    Buffer stream = {0};
+    Output expected = {0};
+    srand(2);
+    while(stream.len < BENCH_SIZE) {
+        build_session(&stream, &expected, 1000);
+    }
+
+    // What the IRQ used to do: one parser step per byte
+    Output reference = {0};
+    double start = get_time();
+    reference_parse(stream.data, stream.len, &reference);
+    double bytewise = get_time() - start;
+    CHECK(output_equal(&expected, &reference));
+
+    // DMA chunks drained into the worker's buffer and split in one pass
+    WifiMarauderDemux demux;
+    size_t total = 0;
+    wifi_marauder_demux_reset(&demux);
+    start = get_time();
+    for(size_t pos = 0; pos < stream.len; pos += RX_BUF_SIZE) {
+        size_t size = stream.len - pos < RX_BUF_SIZE ? stream.len - pos : RX_BUF_SIZE;
+        wifi_marauder_demux_feed(&demux, stream.data + pos, size, output_cb_discard, &total);
+    }
+    double chunked = get_time() - start;
+    CHECK(total + demux.partial_len == expected.text.len + expected.pcap.len);
+
+    printf(
+        "%zu bytes: bytewise %.1f MB/s, chunked %.1f MB/s\n",
+        stream.len,
+        stream.len / bytewise / 1e6,
+        stream.len / chunked / 1e6);
+
+    free(stream.data);
+    output_free(&expected);
+    output_free(&reference);
+}
+
+int main(int argc, char** argv) {
+    int opt;
+
+    while((opt = getopt(argc, argv, "f:h")) != -1) {
+        if(opt == 'f') {
+            if(!replay_file(optarg)) failures++;
+        } else {
+            printf("Usage: %s [-f capture]...\n", argv[0]);
+            printf("  captures are raw dumps of the board's serial output\n");
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    test_markers();
+    test_session();
+    bench();
+
+    if(failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
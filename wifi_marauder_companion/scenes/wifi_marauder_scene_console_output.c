@@ -44,68 +44,72 @@ void wifi_marauder_console_output_handle_rx_data_cb(uint8_t* buf, size_t len, vo
     furi_assert(context);
     WifiMarauderApp* app = context;
 
+    furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
     if(app->is_writing_log) {
         app->has_saved_logs_this_session = true;
         storage_file_write(app->log_file, buf, len);
     }
+    furi_mutex_release(app->rx_mutex);
 
-    // If text box store gets too big, then truncate it
-    app->text_box_store_strlen += len;
-    if(app->text_box_store_strlen >= WIFI_MARAUDER_TEXT_BOX_STORE_SIZE - 1) {
-        furi_string_right(app->text_box_store, app->text_box_store_strlen / 2);
-        app->text_box_store_strlen = furi_string_size(app->text_box_store) + len;
-    }
-
-    // Null-terminate buf and append to text box store
-    buf[len] = '\0';
-    furi_string_cat_printf(app->text_box_store, "%s", buf);
-    view_dispatcher_send_custom_event(app->view_dispatcher, WifiMarauderEventRefreshConsoleOutput);
+    // The console keeps a fixed number of rows and redraws only what is on screen
+    wifi_marauder_console_view_append(app->console_view, (const char*)buf, len);
 }
 
 void wifi_marauder_console_output_handle_rx_packets_cb(uint8_t* buf, size_t len, void* context) {
     furi_assert(context);
     WifiMarauderApp* app = context;
 
+    furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
+    wifi_marauder_pcap_feed(&app->capture_stats, buf, len);
+
     if(app->is_writing_pcap) {
-        storage_file_write(app->capture_file, buf, len);
+        capture_writer_write(app->capture_writer, buf, len);
     }
+    furi_mutex_release(app->rx_mutex);
 }
 
-void wifi_marauder_scene_console_output_on_enter(void* context) {
-    WifiMarauderApp* app = context;
+// Stats are fed from the UART worker, GUI only works with a copy
+static bool
+    wifi_marauder_console_output_get_stats(WifiMarauderApp* app, WifiMarauderPcapStats* stats) {
+    furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
+    bool valid = wifi_marauder_pcap_is_valid(&app->capture_stats);
+    *stats = app->capture_stats.stats;
+    furi_mutex_release(app->rx_mutex);
+    return valid;
+}
 
-    // Reset text box and set font
-    TextBox* text_box = app->text_box;
-    text_box_reset(text_box);
-    text_box_set_font(text_box, TextBoxFontText);
+static void wifi_marauder_console_output_refresh_stats(WifiMarauderApp* app) {
+    WifiMarauderPcapStats stats;
 
-    // Set focus on start or end
-    if(app->focus_console_start) {
-        text_box_set_focus(text_box, TextBoxFocusStart);
+    // Live capture counters stay under the newest output
+    if(wifi_marauder_console_output_get_stats(app, &stats)) {
+        app->capture_stats_shown = stats.packets;
+        wifi_marauder_console_view_set_stats(app->console_view, &stats);
     } else {
-        text_box_set_focus(text_box, TextBoxFocusEnd);
+        wifi_marauder_console_view_set_stats(app->console_view, NULL);
     }
+}
+
+void wifi_marauder_scene_console_output_on_enter(void* context) {
+    WifiMarauderApp* app = context;
 
     // Set command-related messages
     if(app->is_command) {
-        furi_string_reset(app->text_box_store);
-        app->text_box_store_strlen = 0;
+        wifi_marauder_console_view_reset(app->console_view);
         // Help message
         if(0 == strncmp("help", app->selected_tx_string, strlen("help"))) {
             const char* help_msg = "Marauder companion " WIFI_MARAUDER_APP_VERSION "\n";
-            furi_string_cat_str(app->text_box_store, help_msg);
-            app->text_box_store_strlen += strlen(help_msg);
+            wifi_marauder_console_view_append(app->console_view, help_msg, strlen(help_msg));
         }
         // Stopscan message
         if(app->show_stopscan_tip) {
             const char* help_msg = "Press BACK to send stopscan\n";
-            furi_string_cat_str(app->text_box_store, help_msg);
-            app->text_box_store_strlen += strlen(help_msg);
+            wifi_marauder_console_view_append(app->console_view, help_msg, strlen(help_msg));
         }
     }
 
-    // Set starting text
-    text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
+    // Set focus on start or end
+    wifi_marauder_console_view_set_focus_start(app->console_view, app->focus_console_start);
 
     // Set scene state and switch view
     scene_manager_set_scene_state(app->scene_manager, WifiMarauderSceneConsoleOutput, 0);
@@ -121,6 +125,9 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
 
     // Get ready to send command
     if((app->is_command && app->selected_tx_string) || app->script) {
+        furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
+        wifi_marauder_pcap_reset(&app->capture_stats);
+        furi_mutex_release(app->rx_mutex);
         char* prefix_buf = NULL;
         if(strlen(app->selected_tx_string) > 0) {
             prefix_buf = _wifi_marauder_get_prefix_from_cmd(app->selected_tx_string);
@@ -138,7 +145,9 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
                 free(resolved_path);
                 if(storage_file_open(
                        app->log_file, app->log_file_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+                    furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
                     app->is_writing_log = true;
+                    furi_mutex_release(app->rx_mutex);
                 } else {
                     dialog_message_show_storage_error(app->dialogs, "Cannot open log file");
                 }
@@ -160,7 +169,10 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
                 extension = "txt";
             }
             if(sequential_file_open(app->storage, app->capture_file, folder, prefix, extension)) {
+                furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
+                capture_writer_reset(app->capture_writer);
                 app->is_writing_pcap = true;
+                furi_mutex_release(app->rx_mutex);
             } else {
                 dialog_message_show_storage_error(app->dialogs, "Cannot open capture file");
             }
@@ -208,6 +220,9 @@ void wifi_marauder_scene_console_output_on_enter(void* context) {
             free(prefix_buf);
         }
     }
+
+    // A new command hides the counters until its capture starts
+    wifi_marauder_console_output_refresh_stats(app);
 }
 
 bool wifi_marauder_scene_console_output_on_event(void* context, SceneManagerEvent event) {
@@ -216,9 +231,15 @@ bool wifi_marauder_scene_console_output_on_event(void* context, SceneManagerEven
     bool consumed = false;
 
     if(event.type == SceneManagerEventTypeCustom) {
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_store));
         consumed = true;
     } else if(event.type == SceneManagerEventTypeTick) {
+        // PCAP data doesn't redraw the console, pick up new counters here
+        WifiMarauderPcapStats stats;
+        if(wifi_marauder_console_output_get_stats(app, &stats) &&
+           stats.packets != app->capture_stats_shown) {
+            app->capture_stats_shown = stats.packets;
+            wifi_marauder_console_view_set_stats(app->console_view, &stats);
+        }
         consumed = true;
     }
 
@@ -243,12 +264,17 @@ void wifi_marauder_scene_console_output_on_exit(void* context) {
         app->script_worker = NULL;
     }
 
+    // UART worker may still be inside a callback it picked up before they were cleared
+    furi_mutex_acquire(app->rx_mutex, FuriWaitForever);
     app->is_writing_pcap = false;
+    app->is_writing_log = false;
+    furi_mutex_release(app->rx_mutex);
+
     if(app->capture_file && storage_file_is_open(app->capture_file)) {
+        capture_writer_flush(app->capture_writer);
         storage_file_close(app->capture_file);
     }
 
-    app->is_writing_log = false;
     if(app->log_file && storage_file_is_open(app->log_file)) {
         storage_file_close(app->log_file);
     }
@@ -41,8 +41,10 @@ void wifi_marauder_scene_log_viewer_setup_widget(WifiMarauderApp* app, bool call
         app->open_log_file_page = 1;
         _read_log_page_into_text_store(app);
     } else {
+        // No log file, show this session's output
         app->open_log_file_page = 0;
         app->open_log_file_num_pages = 0;
+        wifi_marauder_console_view_get_text(app->console_view, app->text_box_store);
     }
 
     widget_reset(widget);
@@ -112,7 +114,8 @@ void wifi_marauder_scene_log_viewer_on_enter(void* context) {
     app->open_log_file_page = 0;
     app->open_log_file_num_pages = 0;
     bool saved_logs_exist = false;
-    if(!app->has_saved_logs_this_session && furi_string_empty(app->text_box_store)) {
+    if(!app->has_saved_logs_this_session &&
+       wifi_marauder_console_view_is_empty(app->console_view)) {
         // no commands sent yet this session, find last saved log
         if(storage_dir_open(app->log_file, MARAUDER_APP_FOLDER_LOGS)) {
             char name[70];
@@ -29,6 +29,9 @@ WifiMarauderApp* wifi_marauder_app_alloc() {
     app->dialogs = furi_record_open(RECORD_DIALOGS);
     app->storage = furi_record_open(RECORD_STORAGE);
     app->capture_file = storage_file_alloc(app->storage);
+    app->capture_writer = capture_writer_alloc(app->capture_file);
+    wifi_marauder_pcap_reset(&app->capture_stats);
+    app->rx_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     app->log_file = storage_file_alloc(app->storage);
     app->save_pcap_setting_file = storage_file_alloc(app->storage);
     app->save_logs_setting_file = storage_file_alloc(app->storage);
@@ -59,9 +62,11 @@ WifiMarauderApp* wifi_marauder_app_alloc() {
 
     app->special_case_input_step = 0;
 
-    app->text_box = text_box_alloc();
+    app->console_view = wifi_marauder_console_view_alloc();
     view_dispatcher_add_view(
-        app->view_dispatcher, WifiMarauderAppViewConsoleOutput, text_box_get_view(app->text_box));
+        app->view_dispatcher,
+        WifiMarauderAppViewConsoleOutput,
+        wifi_marauder_console_view_get_view(app->console_view));
     app->text_box_store = furi_string_alloc();
     furi_string_reserve(app->text_box_store, WIFI_MARAUDER_TEXT_BOX_STORE_SIZE);
 
@@ -153,11 +158,13 @@ void wifi_marauder_app_free(WifiMarauderApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, WifiMarauderAppViewSubmenu);
 
     widget_free(app->widget);
-    text_box_free(app->text_box);
+    wifi_marauder_console_view_free(app->console_view);
     furi_string_free(app->text_box_store);
     text_input_free(app->text_input);
     submenu_free(app->submenu);
     variable_item_list_free(app->var_item_list);
+    capture_writer_free(app->capture_writer);
+    furi_mutex_free(app->rx_mutex);
     storage_file_free(app->capture_file);
     storage_file_free(app->log_file);
     storage_file_free(app->save_pcap_setting_file);
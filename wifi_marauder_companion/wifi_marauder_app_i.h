@@ -7,7 +7,10 @@
 #include "wifi_marauder_custom_event.h"
 #include "wifi_marauder_uart.h"
 #include "wifi_marauder_ep.h"
+#include "wifi_marauder_pcap.h"
+#include "wifi_marauder_console_view.h"
 #include "file/sequential_file.h"
+#include "file/capture_writer.h"
 #include "script/wifi_marauder_script.h"
 #include "script/wifi_marauder_script_worker.h"
 #include "script/wifi_marauder_script_executor.h"
@@ -16,7 +19,6 @@
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
 #include <gui/scene_manager.h>
-#include <gui/modules/text_box.h>
 #include <gui/modules/submenu.h>
 #include <gui/modules/variable_item_list.h>
 #include <gui/modules/widget.h>
@@ -60,11 +62,15 @@ struct WifiMarauderApp {
 
     char text_input_store[WIFI_MARAUDER_TEXT_INPUT_STORE_SIZE + 1];
     FuriString* text_box_store;
-    size_t text_box_store_strlen;
-    TextBox* text_box;
+    WifiMarauderConsoleView* console_view;
     TextInput* text_input;
     Storage* storage;
     File* capture_file;
+    CaptureWriter* capture_writer;
+    WifiMarauderPcap capture_stats;
+    uint32_t capture_stats_shown;
+    // Held by UART rx callbacks while they use capture_writer, capture_stats and log_file
+    FuriMutex* rx_mutex;
     File* log_file;
     char log_file_path[100];
     File* save_pcap_setting_file;
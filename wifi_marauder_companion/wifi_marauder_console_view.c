@@ -0,0 +1,221 @@
+#include "wifi_marauder_console_view.h"
+#include "wifi_marauder_lines.h"
+
+#include <furi.h>
+#include <gui/elements.h>
+
+#define ROW_HEIGHT (10)
+#define ROWS (6)
+#define STATS_HEIGHT (10)
+
+struct WifiMarauderConsoleView {
+    View* view;
+};
+
+typedef struct {
+    WifiMarauderLines lines;
+    // First row on screen, follows the output while the newest row is shown
+    uint32_t top;
+    bool follow;
+    bool show_stats;
+    WifiMarauderPcapStats stats;
+} WifiMarauderConsoleViewModel;
+
+static uint8_t wifi_marauder_console_view_rows(const WifiMarauderConsoleViewModel* model) {
+    return model->show_stats ? ROWS - 1 : ROWS;
+}
+
+// Top row that puts the newest output on the last line
+static uint32_t wifi_marauder_console_view_bottom(const WifiMarauderConsoleViewModel* model) {
+    uint32_t first = wifi_marauder_lines_first(&model->lines);
+    uint32_t end = wifi_marauder_lines_end(&model->lines);
+    uint8_t rows = wifi_marauder_console_view_rows(model);
+    return end - first > rows ? end - rows : first;
+}
+
+static void wifi_marauder_console_view_scroll(WifiMarauderConsoleViewModel* model, int32_t rows) {
+    uint32_t first = wifi_marauder_lines_first(&model->lines);
+    uint32_t bottom = wifi_marauder_console_view_bottom(model);
+    int64_t top = (int64_t)MAX(model->top, first) + rows;
+
+    model->top = CLAMP(top, (int64_t)bottom, (int64_t)first);
+    model->follow = model->top == bottom;
+}
+
+static void wifi_marauder_console_view_draw_callback(Canvas* canvas, void* context) {
+    WifiMarauderConsoleViewModel* model = context;
+    uint32_t first = wifi_marauder_lines_first(&model->lines);
+    uint32_t end = wifi_marauder_lines_end(&model->lines);
+    uint32_t bottom = wifi_marauder_console_view_bottom(model);
+    uint8_t rows = wifi_marauder_console_view_rows(model);
+    // Rows scrolled back to may have been overwritten since
+    uint32_t top = model->follow ? bottom : CLAMP(model->top, bottom, first);
+
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontKeyboard);
+
+    for(uint8_t row = 0; row < rows && top + row < end; row++) {
+        canvas_draw_str(
+            canvas, 0, 8 + row * ROW_HEIGHT, wifi_marauder_lines_get(&model->lines, top + row));
+    }
+    if(bottom > first) {
+        elements_scrollbar_pos(
+            canvas, 128, 0, rows * ROW_HEIGHT, top - first, bottom - first + 1);
+    }
+
+    if(model->show_stats) {
+        char text[64];
+        snprintf(
+            text,
+            sizeof(text),
+            "P%lu B%lu D%lu E%lu K%lu",
+            (unsigned long)model->stats.packets,
+            (unsigned long)model->stats.beacons,
+            (unsigned long)model->stats.deauths,
+            (unsigned long)model->stats.eapol,
+            (unsigned long)model->stats.pmkid);
+        canvas_draw_line(canvas, 0, 64 - STATS_HEIGHT, 127, 64 - STATS_HEIGHT);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str(canvas, 0, 63, text);
+    }
+}
+
+static bool wifi_marauder_console_view_input_callback(InputEvent* event, void* context) {
+    WifiMarauderConsoleView* console = context;
+    bool consumed = false;
+
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) {
+        return false;
+    }
+
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        {
+            int32_t page = wifi_marauder_console_view_rows(model) - 1;
+            if(model->follow) {
+                model->top = wifi_marauder_console_view_bottom(model);
+            }
+            consumed = true;
+            if(event->key == InputKeyUp) {
+                wifi_marauder_console_view_scroll(model, -1);
+            } else if(event->key == InputKeyDown) {
+                wifi_marauder_console_view_scroll(model, 1);
+            } else if(event->key == InputKeyLeft) {
+                wifi_marauder_console_view_scroll(model, -page);
+            } else if(event->key == InputKeyRight) {
+                wifi_marauder_console_view_scroll(model, page);
+            } else if(event->key == InputKeyOk) {
+                // Back to the newest output
+                model->follow = true;
+            } else {
+                consumed = false;
+            }
+        },
+        consumed);
+
+    return consumed;
+}
+
+WifiMarauderConsoleView* wifi_marauder_console_view_alloc() {
+    WifiMarauderConsoleView* console = malloc(sizeof(WifiMarauderConsoleView));
+    console->view = view_alloc();
+    view_allocate_model(console->view, ViewModelTypeLocking, sizeof(WifiMarauderConsoleViewModel));
+    view_set_context(console->view, console);
+    view_set_draw_callback(console->view, wifi_marauder_console_view_draw_callback);
+    view_set_input_callback(console->view, wifi_marauder_console_view_input_callback);
+    wifi_marauder_console_view_reset(console);
+    return console;
+}
+
+void wifi_marauder_console_view_free(WifiMarauderConsoleView* console) {
+    furi_assert(console);
+    view_free(console->view);
+    free(console);
+}
+
+View* wifi_marauder_console_view_get_view(WifiMarauderConsoleView* console) {
+    furi_assert(console);
+    return console->view;
+}
+
+void wifi_marauder_console_view_reset(WifiMarauderConsoleView* console) {
+    furi_assert(console);
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        {
+            wifi_marauder_lines_reset(&model->lines);
+            model->top = 0;
+            model->follow = true;
+            model->show_stats = false;
+        },
+        true);
+}
+
+bool wifi_marauder_console_view_is_empty(WifiMarauderConsoleView* console) {
+    furi_assert(console);
+    bool empty = true;
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        { empty = wifi_marauder_lines_end(&model->lines) == 0; },
+        false);
+    return empty;
+}
+
+void wifi_marauder_console_view_get_text(WifiMarauderConsoleView* console, FuriString* text) {
+    furi_assert(console);
+    furi_assert(text);
+    furi_string_reset(text);
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        {
+            uint32_t end = wifi_marauder_lines_end(&model->lines);
+            for(uint32_t row = wifi_marauder_lines_first(&model->lines); row < end; row++) {
+                furi_string_cat_str(text, wifi_marauder_lines_get(&model->lines, row));
+                furi_string_push_back(text, '\n');
+            }
+        },
+        false);
+}
+
+void wifi_marauder_console_view_set_focus_start(WifiMarauderConsoleView* console, bool start) {
+    furi_assert(console);
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        {
+            model->follow = !start;
+            model->top = start ? wifi_marauder_lines_first(&model->lines) :
+                                 wifi_marauder_console_view_bottom(model);
+        },
+        true);
+}
+
+void wifi_marauder_console_view_append(
+    WifiMarauderConsoleView* console,
+    const char* text,
+    size_t len) {
+    furi_assert(console);
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        { wifi_marauder_lines_append(&model->lines, text, len); },
+        true);
+}
+
+void wifi_marauder_console_view_set_stats(
+    WifiMarauderConsoleView* console,
+    const WifiMarauderPcapStats* stats) {
+    furi_assert(console);
+    with_view_model(
+        console->view,
+        WifiMarauderConsoleViewModel * model,
+        {
+            model->show_stats = stats != NULL;
+            if(stats) model->stats = *stats;
+        },
+        true);
+}
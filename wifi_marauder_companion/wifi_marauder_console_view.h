@@ -0,0 +1,35 @@
+#pragma once
+
+#include <gui/view.h>
+
+#include "wifi_marauder_pcap.h"
+
+typedef struct WifiMarauderConsoleView WifiMarauderConsoleView;
+
+WifiMarauderConsoleView* wifi_marauder_console_view_alloc();
+
+void wifi_marauder_console_view_free(WifiMarauderConsoleView* console);
+
+View* wifi_marauder_console_view_get_view(WifiMarauderConsoleView* console);
+
+/** Drop all output */
+void wifi_marauder_console_view_reset(WifiMarauderConsoleView* console);
+
+bool wifi_marauder_console_view_is_empty(WifiMarauderConsoleView* console);
+
+/** Copy the rows still in the scrollback into text, one per line */
+void wifi_marauder_console_view_get_text(WifiMarauderConsoleView* console, FuriString* text);
+
+/** Keep the first rows on screen instead of following new output */
+void wifi_marauder_console_view_set_focus_start(WifiMarauderConsoleView* console, bool start);
+
+/** Add received text, safe to call from the UART worker */
+void wifi_marauder_console_view_append(
+    WifiMarauderConsoleView* console,
+    const char* text,
+    size_t len);
+
+/** Show capture counters under the output, NULL hides them */
+void wifi_marauder_console_view_set_stats(
+    WifiMarauderConsoleView* console,
+    const WifiMarauderPcapStats* stats);
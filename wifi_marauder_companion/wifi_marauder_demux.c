@@ -0,0 +1,93 @@
+#include "wifi_marauder_demux.h"
+
+#include <string.h>
+
+typedef enum {
+    WifiMarauderDemuxMatchNone,
+    WifiMarauderDemuxMatchPrefix,
+    WifiMarauderDemuxMatchBegin,
+    WifiMarauderDemuxMatchClose,
+} WifiMarauderDemuxMatch;
+
+// len is at most WIFI_MARAUDER_MARK_LEN, shorter means the data ends inside a possible marker
+static WifiMarauderDemuxMatch wifi_marauder_demux_match(const uint8_t* data, size_t len) {
+    if(!memcmp(data, WIFI_MARAUDER_MARK_BEGIN, len)) {
+        return len == WIFI_MARAUDER_MARK_LEN ? WifiMarauderDemuxMatchBegin :
+                                               WifiMarauderDemuxMatchPrefix;
+    }
+    if(!memcmp(data, WIFI_MARAUDER_MARK_CLOSE, len)) {
+        return len == WIFI_MARAUDER_MARK_LEN ? WifiMarauderDemuxMatchClose :
+                                               WifiMarauderDemuxMatchPrefix;
+    }
+    return WifiMarauderDemuxMatchNone;
+}
+
+void wifi_marauder_demux_reset(WifiMarauderDemux* demux) {
+    demux->pcap = false;
+    demux->partial_len = 0;
+}
+
+void wifi_marauder_demux_feed(
+    WifiMarauderDemux* demux,
+    uint8_t* data,
+    size_t len,
+    WifiMarauderDemuxCallback callback,
+    void* context) {
+    size_t pos = 0;
+
+    // Finish the marker the previous chunk ended in
+    if(demux->partial_len) {
+        uint8_t candidate[WIFI_MARAUDER_MARK_LEN];
+        size_t take = WIFI_MARAUDER_MARK_LEN - demux->partial_len;
+        if(take > len) take = len;
+        memcpy(candidate, demux->partial, demux->partial_len);
+        memcpy(candidate + demux->partial_len, data, take);
+
+        WifiMarauderDemuxMatch match =
+            wifi_marauder_demux_match(candidate, demux->partial_len + take);
+        if(match == WifiMarauderDemuxMatchPrefix) {
+            memcpy(demux->partial, candidate, demux->partial_len + take);
+            demux->partial_len += take;
+            return;
+        }
+        if(match == WifiMarauderDemuxMatchNone) {
+            // Only the first byte was a '[', so the chunk is scanned from its start again
+            callback(demux->pcap, demux->partial, demux->partial_len, context);
+        } else {
+            demux->pcap = match == WifiMarauderDemuxMatchBegin;
+            pos = take;
+        }
+        demux->partial_len = 0;
+    }
+
+    size_t start = pos;
+    while(pos < len) {
+        uint8_t* mark = memchr(data + pos, '[', len - pos);
+        if(!mark) break;
+
+        size_t at = mark - data;
+        size_t avail = len - at;
+        if(avail > WIFI_MARAUDER_MARK_LEN) avail = WIFI_MARAUDER_MARK_LEN;
+
+        WifiMarauderDemuxMatch match = wifi_marauder_demux_match(mark, avail);
+        if(match == WifiMarauderDemuxMatchNone) {
+            pos = at + 1;
+            continue;
+        }
+
+        if(at > start) {
+            callback(demux->pcap, data + start, at - start, context);
+        }
+        if(match == WifiMarauderDemuxMatchPrefix) {
+            memcpy(demux->partial, mark, avail);
+            demux->partial_len = avail;
+            return;
+        }
+        demux->pcap = match == WifiMarauderDemuxMatchBegin;
+        pos = start = at + WIFI_MARAUDER_MARK_LEN;
+    }
+
+    if(len > start) {
+        callback(demux->pcap, data + start, len - start, context);
+    }
+}
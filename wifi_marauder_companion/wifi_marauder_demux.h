@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define WIFI_MARAUDER_MARK_BEGIN "[BUF/BEGIN]"
+#define WIFI_MARAUDER_MARK_CLOSE "[BUF/CLOSE]"
+#define WIFI_MARAUDER_MARK_LEN (sizeof(WIFI_MARAUDER_MARK_BEGIN) - 1)
+
+/** Called with each run of bytes between markers, pcap tells which side of them it is on */
+typedef void (*WifiMarauderDemuxCallback)(bool pcap, uint8_t* data, size_t len, void* context);
+
+/*
+ * Splits the UART stream into console text and PCAP data on the [BUF/BEGIN] and [BUF/CLOSE]
+ * markers the board wraps capture buffers in.
+ *
+ * Works on whole received chunks: runs of data are found with memchr on '[' and handed out as
+ * pointers into the chunk, only a marker cut by the end of a chunk is kept back until the next
+ * one arrives. Bytes that start like a marker but turn out not to be one are passed on as data.
+ */
+typedef struct {
+    bool pcap;
+    size_t partial_len;
+    uint8_t partial[WIFI_MARAUDER_MARK_LEN];
+} WifiMarauderDemux;
+
+void wifi_marauder_demux_reset(WifiMarauderDemux* demux);
+
+/** Split one received chunk, runs handed to the callback are only valid during the call */
+void wifi_marauder_demux_feed(
+    WifiMarauderDemux* demux,
+    uint8_t* data,
+    size_t len,
+    WifiMarauderDemuxCallback callback,
+    void* context);
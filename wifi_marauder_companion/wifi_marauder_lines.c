@@ -0,0 +1,63 @@
+#include "wifi_marauder_lines.h"
+
+_Static_assert(
+    (WIFI_MARAUDER_LINES_COUNT & (WIFI_MARAUDER_LINES_COUNT - 1)) == 0,
+    "WIFI_MARAUDER_LINES_COUNT must be a power of two");
+
+#define WIFI_MARAUDER_LINES_ROW(lines, row) \
+    ((lines)->rows[(row) & (WIFI_MARAUDER_LINES_COUNT - 1)])
+
+static void wifi_marauder_lines_next(WifiMarauderLines* lines) {
+    lines->last++;
+    lines->fill = 0;
+    WIFI_MARAUDER_LINES_ROW(lines, lines->last)[0] = '\0';
+}
+
+void wifi_marauder_lines_reset(WifiMarauderLines* lines) {
+    lines->last = 0;
+    lines->fill = 0;
+    lines->rows[0][0] = '\0';
+}
+
+void wifi_marauder_lines_append(WifiMarauderLines* lines, const char* text, size_t len) {
+    char* row = WIFI_MARAUDER_LINES_ROW(lines, lines->last);
+
+    for(size_t i = 0; i < len; i++) {
+        uint8_t c = text[i];
+
+        if(c == '\n') {
+            wifi_marauder_lines_next(lines);
+            row = WIFI_MARAUDER_LINES_ROW(lines, lines->last);
+            continue;
+        }
+        if(c == '\t') {
+            c = ' ';
+        } else if(c < ' ' || c == 0x7f || (c & 0xc0) == 0x80) {
+            // Control characters and UTF-8 continuation bytes take no room
+            continue;
+        } else if(c & 0x80) {
+            // The font has ASCII only, one placeholder per UTF-8 character
+            c = '?';
+        }
+
+        if(lines->fill == WIFI_MARAUDER_LINES_WIDTH) {
+            wifi_marauder_lines_next(lines);
+            row = WIFI_MARAUDER_LINES_ROW(lines, lines->last);
+        }
+        row[lines->fill++] = c;
+        row[lines->fill] = '\0';
+    }
+}
+
+uint32_t wifi_marauder_lines_first(const WifiMarauderLines* lines) {
+    return lines->last >= WIFI_MARAUDER_LINES_COUNT ? lines->last - WIFI_MARAUDER_LINES_COUNT + 1 :
+                                                      0;
+}
+
+uint32_t wifi_marauder_lines_end(const WifiMarauderLines* lines) {
+    return lines->fill ? lines->last + 1 : lines->last;
+}
+
+const char* wifi_marauder_lines_get(const WifiMarauderLines* lines, uint32_t row) {
+    return WIFI_MARAUDER_LINES_ROW(lines, row);
+}
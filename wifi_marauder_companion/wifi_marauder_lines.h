@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Columns of FontKeyboard that fit next to the scrollbar
+#define WIFI_MARAUDER_LINES_WIDTH (20)
+// Scrollback in screen rows, a power of two
+#define WIFI_MARAUDER_LINES_COUNT (256)
+
+/*
+ * Fixed-size ring of console rows.
+ *
+ * Text is wrapped to the screen width as it arrives, so every slot is exactly one row on the
+ * screen and drawing never looks at more than the rows it shows. Rows are addressed by an
+ * absolute number that keeps counting up, the oldest ones are overwritten once the ring is
+ * full and the bottom row is the one still being filled.
+ */
+typedef struct {
+    char rows[WIFI_MARAUDER_LINES_COUNT][WIFI_MARAUDER_LINES_WIDTH + 1];
+    uint32_t last;
+    uint8_t fill;
+} WifiMarauderLines;
+
+void wifi_marauder_lines_reset(WifiMarauderLines* lines);
+
+void wifi_marauder_lines_append(WifiMarauderLines* lines, const char* text, size_t len);
+
+/** Number of the oldest row still in the ring */
+uint32_t wifi_marauder_lines_first(const WifiMarauderLines* lines);
+
+/** One past the newest row, an empty row still being filled doesn't count */
+uint32_t wifi_marauder_lines_end(const WifiMarauderLines* lines);
+
+/** Row between first and end, null-terminated */
+const char* wifi_marauder_lines_get(const WifiMarauderLines* lines, uint32_t row);
@@ -0,0 +1,176 @@
+#include "wifi_marauder_pcap.h"
+
+#include <string.h>
+
+#define PCAP_MAGIC (0xa1b2c3d4)
+#define PCAP_MAGIC_NSEC (0xa1b23c4d)
+#define PCAP_GLOBAL_HEADER_LEN (24)
+#define PCAP_RECORD_HEADER_LEN (16)
+
+#define IEEE80211_HEADER_LEN (24)
+#define IEEE80211_TYPE_MGMT (0)
+#define IEEE80211_TYPE_DATA (2)
+#define IEEE80211_SUBTYPE_BEACON (8)
+#define IEEE80211_SUBTYPE_DEAUTH (12)
+#define IEEE80211_FC1_DS_MASK (0x03)
+#define IEEE80211_FC1_PROTECTED (0x40)
+
+// EAPOL header, then descriptor type, key info .. key MIC, then the key data length
+#define EAPOL_KEY_INFO (5)
+#define EAPOL_KEY_DATA_LEN (97)
+#define EAPOL_KEY_DATA (99)
+#define EAPOL_TYPE_KEY (3)
+#define EAPOL_KEY_INFO_PAIRWISE (0x0008)
+#define EAPOL_KEY_INFO_ACK (0x0080)
+#define EAPOL_KEY_INFO_MIC (0x0100)
+
+#define KDE_PMKID_LEN (6 + 16)
+
+typedef enum {
+    WifiMarauderPcapStateGlobalHeader,
+    WifiMarauderPcapStateRecordHeader,
+    WifiMarauderPcapStatePacket,
+    WifiMarauderPcapStateInvalid,
+} WifiMarauderPcapState;
+
+static const uint8_t llc_snap_eapol[] = {0xaa, 0xaa, 0x03, 0x00, 0x00, 0x00, 0x88, 0x8e};
+static const uint8_t kde_pmkid[] = {0xdd, 0x14, 0x00, 0x0f, 0xac, 0x04};
+
+static uint32_t wifi_marauder_pcap_read32(const WifiMarauderPcap* pcap, const uint8_t* data) {
+    if(pcap->swapped) {
+        return (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 |
+               data[3];
+    }
+    return (uint32_t)data[3] << 24 | (uint32_t)data[2] << 16 | (uint32_t)data[1] << 8 | data[0];
+}
+
+static bool wifi_marauder_pcap_has_pmkid(const uint8_t* eapol, size_t len) {
+    if(len < EAPOL_KEY_DATA || eapol[1] != EAPOL_TYPE_KEY) return false;
+
+    // Message 1 of the 4-way handshake: pairwise, ACK set and no MIC yet
+    uint16_t key_info = eapol[EAPOL_KEY_INFO] << 8 | eapol[EAPOL_KEY_INFO + 1];
+    uint16_t mask = EAPOL_KEY_INFO_PAIRWISE | EAPOL_KEY_INFO_ACK | EAPOL_KEY_INFO_MIC;
+    if((key_info & mask) != (EAPOL_KEY_INFO_PAIRWISE | EAPOL_KEY_INFO_ACK)) return false;
+
+    size_t key_data_len = eapol[EAPOL_KEY_DATA_LEN] << 8 | eapol[EAPOL_KEY_DATA_LEN + 1];
+    const uint8_t* kde = eapol + EAPOL_KEY_DATA;
+    const uint8_t* end = eapol + len;
+    // Key data may continue past the head kept of the packet
+    if(key_data_len < len - EAPOL_KEY_DATA) end = kde + key_data_len;
+
+    while(kde + 2 <= end) {
+        if(kde + KDE_PMKID_LEN <= end && !memcmp(kde, kde_pmkid, sizeof(kde_pmkid))) {
+            // Some APs send an all-zero PMKID, which is useless for cracking
+            for(size_t i = sizeof(kde_pmkid); i < KDE_PMKID_LEN; i++) {
+                if(kde[i]) return true;
+            }
+            return false;
+        }
+        kde += 2 + kde[1];
+    }
+    return false;
+}
+
+static void wifi_marauder_pcap_packet(WifiMarauderPcap* pcap, const uint8_t* frame, size_t len) {
+    pcap->stats.packets++;
+
+    if(pcap->linktype == WIFI_MARAUDER_PCAP_LINKTYPE_RADIOTAP) {
+        if(len < 4) return;
+        size_t radiotap_len = frame[2] | frame[3] << 8;
+        if(radiotap_len > len) return;
+        frame += radiotap_len;
+        len -= radiotap_len;
+    } else if(pcap->linktype != WIFI_MARAUDER_PCAP_LINKTYPE_80211) {
+        return;
+    }
+    if(len < IEEE80211_HEADER_LEN) return;
+
+    uint8_t type = (frame[0] >> 2) & 0x3;
+    uint8_t subtype = frame[0] >> 4;
+
+    if(type == IEEE80211_TYPE_MGMT) {
+        if(subtype == IEEE80211_SUBTYPE_BEACON) {
+            pcap->stats.beacons++;
+        } else if(subtype == IEEE80211_SUBTYPE_DEAUTH) {
+            pcap->stats.deauths++;
+        }
+    } else if(type == IEEE80211_TYPE_DATA && !(frame[1] & IEEE80211_FC1_PROTECTED)) {
+        size_t header_len = IEEE80211_HEADER_LEN;
+        // Four address frames between access points, QoS data carries a control field
+        if((frame[1] & IEEE80211_FC1_DS_MASK) == IEEE80211_FC1_DS_MASK) header_len += 6;
+        if(subtype & 0x8) header_len += 2;
+
+        if(len < header_len + sizeof(llc_snap_eapol) ||
+           memcmp(frame + header_len, llc_snap_eapol, sizeof(llc_snap_eapol))) {
+            return;
+        }
+        pcap->stats.eapol++;
+
+        const uint8_t* eapol = frame + header_len + sizeof(llc_snap_eapol);
+        if(wifi_marauder_pcap_has_pmkid(eapol, frame + len - eapol)) {
+            pcap->stats.pmkid++;
+        }
+    }
+}
+
+void wifi_marauder_pcap_reset(WifiMarauderPcap* pcap) {
+    memset(&pcap->stats, 0, sizeof(pcap->stats));
+    pcap->state = WifiMarauderPcapStateGlobalHeader;
+    pcap->swapped = false;
+    pcap->linktype = 0;
+    pcap->remaining = PCAP_GLOBAL_HEADER_LEN;
+    pcap->head_len = 0;
+}
+
+bool wifi_marauder_pcap_is_valid(const WifiMarauderPcap* pcap) {
+    return pcap->state == WifiMarauderPcapStateRecordHeader ||
+           pcap->state == WifiMarauderPcapStatePacket;
+}
+
+void wifi_marauder_pcap_feed(WifiMarauderPcap* pcap, const uint8_t* data, size_t len) {
+    while(len && pcap->state != WifiMarauderPcapStateInvalid) {
+        size_t chunk = len < pcap->remaining ? len : pcap->remaining;
+        size_t keep = WIFI_MARAUDER_PCAP_HEAD_SIZE - pcap->head_len;
+        if(keep > chunk) keep = chunk;
+
+        memcpy(pcap->head + pcap->head_len, data, keep);
+        pcap->head_len += keep;
+        pcap->remaining -= chunk;
+        data += chunk;
+        len -= chunk;
+        if(pcap->remaining) break;
+
+        if(pcap->state == WifiMarauderPcapStateGlobalHeader) {
+            uint32_t magic = wifi_marauder_pcap_read32(pcap, pcap->head);
+            if(magic != PCAP_MAGIC && magic != PCAP_MAGIC_NSEC) {
+                pcap->swapped = true;
+                magic = wifi_marauder_pcap_read32(pcap, pcap->head);
+            }
+            if(magic != PCAP_MAGIC && magic != PCAP_MAGIC_NSEC) {
+                pcap->state = WifiMarauderPcapStateInvalid;
+                break;
+            }
+            pcap->linktype = wifi_marauder_pcap_read32(pcap, pcap->head + 20);
+            pcap->state = WifiMarauderPcapStateRecordHeader;
+            pcap->remaining = PCAP_RECORD_HEADER_LEN;
+        } else if(pcap->state == WifiMarauderPcapStateRecordHeader) {
+            uint32_t captured = wifi_marauder_pcap_read32(pcap, pcap->head + 8);
+            if(captured > WIFI_MARAUDER_PCAP_MAX_RECORD) {
+                pcap->state = WifiMarauderPcapStateInvalid;
+                break;
+            }
+            if(captured) {
+                pcap->state = WifiMarauderPcapStatePacket;
+                pcap->remaining = captured;
+            } else {
+                wifi_marauder_pcap_packet(pcap, pcap->head, 0);
+                pcap->remaining = PCAP_RECORD_HEADER_LEN;
+            }
+        } else {
+            wifi_marauder_pcap_packet(pcap, pcap->head, pcap->head_len);
+            pcap->state = WifiMarauderPcapStateRecordHeader;
+            pcap->remaining = PCAP_RECORD_HEADER_LEN;
+        }
+        pcap->head_len = 0;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// LINKTYPE_IEEE802_11 and LINKTYPE_IEEE802_11_RADIOTAP
+#define WIFI_MARAUDER_PCAP_LINKTYPE_80211 (105)
+#define WIFI_MARAUDER_PCAP_LINKTYPE_RADIOTAP (127)
+
+// Leading bytes of each packet kept for classification, enough to reach a PMKID KDE behind
+// a radiotap header
+#define WIFI_MARAUDER_PCAP_HEAD_SIZE (256)
+// Larger records mean the stream is not a pcap or lost sync, parsing stops there
+#define WIFI_MARAUDER_PCAP_MAX_RECORD (0x40000)
+
+typedef struct {
+    uint32_t packets;
+    uint32_t beacons;
+    uint32_t deauths;
+    uint32_t eapol;
+    uint32_t pmkid;
+} WifiMarauderPcapStats;
+
+/*
+ * Streaming pcap parser for the capture as it is received.
+ *
+ * Follows the global header and record headers across arbitrary chunk boundaries and keeps
+ * only the head of each packet, which is enough to count 802.11 beacons, deauthentications,
+ * EAPOL frames and EAPOL-Key message 1 frames carrying a PMKID. Packet bodies are skipped
+ * without copying.
+ */
+typedef struct {
+    WifiMarauderPcapStats stats;
+    uint8_t state;
+    bool swapped;
+    uint32_t linktype;
+    uint32_t remaining;
+    size_t head_len;
+    uint8_t head[WIFI_MARAUDER_PCAP_HEAD_SIZE];
+} WifiMarauderPcap;
+
+void wifi_marauder_pcap_reset(WifiMarauderPcap* pcap);
+
+void wifi_marauder_pcap_feed(WifiMarauderPcap* pcap, const uint8_t* data, size_t len);
+
+/** True once a pcap global header was seen and records are being followed */
+bool wifi_marauder_pcap_is_valid(const WifiMarauderPcap* pcap);
@@ -1,5 +1,6 @@
 #include "wifi_marauder_app_i.h"
 #include "wifi_marauder_uart.h"
+#include "wifi_marauder_demux.h"
 
 #include <xtreme/xtreme.h>
 
@@ -10,12 +11,10 @@ struct WifiMarauderUart {
     WifiMarauderApp* app;
     FuriThread* rx_thread;
     FuriStreamBuffer* rx_stream;
-    FuriStreamBuffer* pcap_stream;
     FuriHalSerialHandle* serial_handle;
-    bool pcap;
-    uint8_t mark_test_buf[11];
-    uint8_t mark_test_idx;
-    uint8_t rx_buf[RX_BUF_SIZE + 1];
+    WifiMarauderDemux demux;
+    uint8_t dma_buf[FURI_HAL_SERIAL_DMA_BUFFER_SIZE];
+    uint8_t rx_buf[RX_BUF_SIZE];
     void (*handle_rx_data_cb)(uint8_t* buf, size_t len, void* context);
     void (*handle_rx_pcap_cb)(uint8_t* buf, size_t len, void* context);
 };
@@ -23,7 +22,6 @@ struct WifiMarauderUart {
 typedef enum {
     WorkerEvtStop = (1 << 0),
     WorkerEvtRxDone = (1 << 1),
-    WorkerEvtPcapDone = (1 << 2),
 } WorkerEvtFlags;
 
 void wifi_marauder_uart_set_handle_rx_data_cb(
@@ -40,71 +38,38 @@ void wifi_marauder_uart_set_handle_rx_pcap_cb(
     uart->handle_rx_pcap_cb = handle_rx_pcap_cb;
 }
 
-#define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone | WorkerEvtPcapDone)
+#define WORKER_ALL_RX_EVENTS (WorkerEvtStop | WorkerEvtRxDone)
 
-void wifi_marauder_uart_on_irq_cb(
+// DMA fills a circular buffer and interrupts on half/full and when the line goes idle, so the
+// handler runs once per burst and moves it to the worker in one piece
+static void wifi_marauder_uart_on_irq_rx_dma_cb(
     FuriHalSerialHandle* handle,
     FuriHalSerialRxEvent event,
+    size_t size,
     void* context) {
     WifiMarauderUart* uart = (WifiMarauderUart*)context;
 
-    if(event == FuriHalSerialRxEventData) {
-        uint8_t data = furi_hal_serial_async_rx(handle);
-        const char* mark_begin = "[BUF/BEGIN]";
-        const char* mark_close = "[BUF/CLOSE]";
-        if(uart->mark_test_idx != 0) {
-            // We are trying to match a marker
-            if(data == mark_begin[uart->mark_test_idx] ||
-               data == mark_close[uart->mark_test_idx]) {
-                // Received char matches next char in a marker, append to test buffer
-                uart->mark_test_buf[uart->mark_test_idx++] = data;
-                if(uart->mark_test_idx == sizeof(uart->mark_test_buf)) {
-                    // Test buffer reached max length, parse what marker this is and discard buffer
-                    if(!memcmp(
-                           uart->mark_test_buf, (void*)mark_begin, sizeof(uart->mark_test_buf))) {
-                        uart->pcap = true;
-                    } else if(!memcmp(
-                                  uart->mark_test_buf,
-                                  (void*)mark_close,
-                                  sizeof(uart->mark_test_buf))) {
-                        uart->pcap = false;
-                    }
-                    uart->mark_test_idx = 0;
-                }
-                // Don't pass to stream
-                return;
-            } else {
-                // Received char doesn't match any expected next char, send current test buffer
-                if(uart->pcap) {
-                    furi_stream_buffer_send(
-                        uart->pcap_stream, uart->mark_test_buf, uart->mark_test_idx, 0);
-                    furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtPcapDone);
-                } else {
-                    furi_stream_buffer_send(
-                        uart->rx_stream, uart->mark_test_buf, uart->mark_test_idx, 0);
-                    furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-                }
-                // Reset test buffer and try parsing this char from scratch
-                uart->mark_test_idx = 0;
-            }
-        }
-        // If we reach here the buffer is empty
-        if(data == mark_begin[0]) {
-            // Received marker start, append to test buffer
-            uart->mark_test_buf[uart->mark_test_idx++] = data;
-        } else {
-            // Not a marker start and we aren't matching a marker, this is just data
-            if(uart->pcap) {
-                furi_stream_buffer_send(uart->pcap_stream, &data, 1, 0);
-                furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtPcapDone);
-            } else {
-                furi_stream_buffer_send(uart->rx_stream, &data, 1, 0);
-                furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
-            }
+    if(event & (FuriHalSerialRxEventData | FuriHalSerialRxEventIdle)) {
+        while(size) {
+            size_t len =
+                furi_hal_serial_dma_rx(handle, uart->dma_buf, MIN(size, sizeof(uart->dma_buf)));
+            if(!len) break;
+            furi_stream_buffer_send(uart->rx_stream, uart->dma_buf, len, 0);
+            size -= len;
         }
+        furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtRxDone);
     }
 }
 
+static void wifi_marauder_uart_demux_cb(bool pcap, uint8_t* data, size_t len, void* context) {
+    WifiMarauderUart* uart = (WifiMarauderUart*)context;
+
+    // Scenes clear callbacks from GUI thread, read each one once
+    void (*handle_rx_cb)(uint8_t* buf, size_t len, void* context) =
+        pcap ? uart->handle_rx_pcap_cb : uart->handle_rx_data_cb;
+    if(handle_rx_cb) handle_rx_cb(data, len, uart->app);
+}
+
 static int32_t uart_worker(void* context) {
     WifiMarauderUart* uart = (void*)context;
 
@@ -114,22 +79,16 @@ static int32_t uart_worker(void* context) {
         furi_check((events & FuriFlagError) == 0);
         if(events & WorkerEvtStop) break;
         if(events & WorkerEvtRxDone) {
-            size_t len = furi_stream_buffer_receive(uart->rx_stream, uart->rx_buf, RX_BUF_SIZE, 0);
-            if(len > 0) {
-                if(uart->handle_rx_data_cb) uart->handle_rx_data_cb(uart->rx_buf, len, uart->app);
-            }
-        }
-        if(events & WorkerEvtPcapDone) {
-            size_t len =
-                furi_stream_buffer_receive(uart->pcap_stream, uart->rx_buf, RX_BUF_SIZE, 0);
-            if(len > 0) {
-                if(uart->handle_rx_pcap_cb) uart->handle_rx_pcap_cb(uart->rx_buf, len, uart->app);
+            size_t len;
+            while((len = furi_stream_buffer_receive(
+                       uart->rx_stream, uart->rx_buf, RX_BUF_SIZE, 0)) > 0) {
+                wifi_marauder_demux_feed(
+                    &uart->demux, uart->rx_buf, len, wifi_marauder_uart_demux_cb, uart);
             }
         }
     }
 
     furi_stream_buffer_free(uart->rx_stream);
-    furi_stream_buffer_free(uart->pcap_stream);
 
     return 0;
 }
@@ -145,8 +104,8 @@ WifiMarauderUart* wifi_marauder_uart_init(
     WifiMarauderUart* uart = malloc(sizeof(WifiMarauderUart));
 
     uart->app = app;
-    uart->rx_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
-    uart->pcap_stream = furi_stream_buffer_alloc(RX_BUF_SIZE, 1);
+    uart->rx_stream = furi_stream_buffer_alloc(RX_STREAM_SIZE, 1);
+    wifi_marauder_demux_reset(&uart->demux);
     uart->rx_thread = furi_thread_alloc();
     furi_thread_set_name(uart->rx_thread, thread_name);
     furi_thread_set_stack_size(uart->rx_thread, 1024);
@@ -156,7 +115,8 @@ WifiMarauderUart* wifi_marauder_uart_init(
     uart->serial_handle = furi_hal_serial_control_acquire(channel);
     furi_check(uart->serial_handle);
     furi_hal_serial_init(uart->serial_handle, BAUDRATE);
-    furi_hal_serial_async_rx_start(uart->serial_handle, wifi_marauder_uart_on_irq_cb, uart, false);
+    furi_hal_serial_dma_rx_start(
+        uart->serial_handle, wifi_marauder_uart_on_irq_rx_dma_cb, uart, false);
 
     return uart;
 }
@@ -168,12 +128,13 @@ WifiMarauderUart* wifi_marauder_usart_init(WifiMarauderApp* app) {
 void wifi_marauder_uart_free(WifiMarauderUart* uart) {
     furi_assert(uart);
 
+    // Stop DMA first, its handler feeds the stream the worker frees on exit
+    furi_hal_serial_deinit(uart->serial_handle);
+    furi_hal_serial_control_release(uart->serial_handle);
+
     furi_thread_flags_set(furi_thread_get_id(uart->rx_thread), WorkerEvtStop);
     furi_thread_join(uart->rx_thread);
     furi_thread_free(uart->rx_thread);
 
-    furi_hal_serial_deinit(uart->serial_handle);
-    furi_hal_serial_control_release(uart->serial_handle);
-
     free(uart);
 }
@@ -3,6 +3,8 @@
 #include "furi_hal.h"
 
 #define RX_BUF_SIZE (2048)
+// Raw bytes waiting for the worker, room for a couple of PCAP bursts
+#define RX_STREAM_SIZE (RX_BUF_SIZE * 2)
 
 typedef struct WifiMarauderUart WifiMarauderUart;
 